@@ -0,0 +1,42 @@
+# This work is licensed under the MIT license.
+# Copyright (c) 2013-2023 OpenMV LLC. All rights reserved.
+# https://github.com/openmv/openmv/blob/master/LICENSE
+#
+# Image Ring Stream Pre-Trigger Recording Example
+#
+# Note: You will need an SD card to run this example.
+#
+# This example keeps the last few seconds of video in a memory ring stream. When motion is
+# detected the frames captured before the trigger are dumped to a file stream while recording
+# continues. The dump is written out one frame per captured frame so the frame rate is kept.
+import sensor
+import image
+import time
+import random
+
+# Number of frames to size the ring buffer for (more frames fit if they are smaller).
+N_FRAMES = 100
+# Seconds of video to keep from before the trigger.
+PRE_TRIGGER_S = 3
+
+sensor.reset()  # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.GRAYSCALE)  # Set pixel format to RGB565 (or GRAYSCALE)
+sensor.set_framesize(sensor.QQVGA)  # Set frame size to QQVGA (160x120)
+sensor.skip_frames(time=2000)
+
+stream = image.ImageIO((160, 120, sensor.GRAYSCALE), N_FRAMES, ring=True)
+bg = sensor.snapshot().copy()  # Background image to detect motion against.
+
+clock = time.clock()
+
+while True:
+    clock.tick()
+    img = sensor.snapshot()
+    stream.write(img)  # The stream keeps a copy so the image can be modified below.
+
+    # Trigger when the scene changes from the background image.
+    if stream.dump_pending() == 0 and img.difference(bg).get_statistics().max() > 64:
+        n = stream.dump("pre_trigger-%d.bin" % random.getrandbits(32), PRE_TRIGGER_S * 1000)
+        print("Triggered, dumping %d frames" % n)
+
+    print(clock.fps(), stream.count(), stream.dump_pending())
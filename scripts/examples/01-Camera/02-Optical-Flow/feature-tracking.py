@@ -0,0 +1,36 @@
+# This work is licensed under the MIT license.
+# Copyright (c) 2013-2024 OpenMV LLC. All rights reserved.
+# https://github.com/openmv/openmv/blob/master/LICENSE
+#
+# Feature Tracking
+#
+# This example shows off tracking corners from frame to frame with a pyramidal
+# Lucas-Kanade tracker. Each point is returned as (x, y, id, age). Points that
+# can't be tracked are dropped and new corners are found to keep up to 50 points.
+# Tracking points is much cheaper than finding and matching keypoints every frame.
+
+import sensor
+import time
+
+sensor.reset()  # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.GRAYSCALE)  # The tracker works on grayscale images.
+sensor.set_framesize(sensor.QQVGA)  # Set frame size to QQVGA (160x120)
+sensor.skip_frames(time=2000)  # Wait for settings take effect.
+clock = time.clock()  # Create a clock object to track the FPS.
+
+# Keep the previous frame in a second frame buffer.
+extra_fb = sensor.alloc_extra_fb(sensor.width(), sensor.height(), sensor.GRAYSCALE)
+extra_fb.replace(sensor.snapshot())
+points = []
+
+while True:
+    clock.tick()  # Track elapsed milliseconds between snapshots().
+    img = sensor.snapshot()  # Take a picture and return the image.
+
+    points = img.track_features(extra_fb, points, features=50)
+    extra_fb.replace(img)
+
+    for x, y, i, age in points:
+        img.draw_cross(int(x), int(y), size=age if age < 10 else 10)
+
+    print(len(points), clock.fps())
@@ -0,0 +1,41 @@
+# This work is licensed under the MIT license.
+# Copyright (c) 2013-2024 OpenMV LLC. All rights reserved.
+# https://github.com/openmv/openmv/blob/master/LICENSE
+#
+# Motion Vectors
+#
+# This example shows off block-matching motion estimation. The image is split
+# into 16x16 blocks and each block is matched against the previous frame. The
+# result is a list of rows of (dx, dy, sad) tuples, one per block, where sad is
+# the sum of absolute differences of the best match (lower is better).
+
+import sensor
+import time
+
+BLOCK_SIZE = 16
+
+sensor.reset()  # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.GRAYSCALE)  # Motion search works on grayscale images.
+sensor.set_framesize(sensor.QQVGA)  # Set frame size to QQVGA (160x120)
+sensor.skip_frames(time=2000)  # Wait for settings take effect.
+clock = time.clock()  # Create a clock object to track the FPS.
+
+# Keep the previous frame in a second frame buffer.
+extra_fb = sensor.alloc_extra_fb(sensor.width(), sensor.height(), sensor.GRAYSCALE)
+extra_fb.replace(sensor.snapshot())
+
+while True:
+    clock.tick()  # Track elapsed milliseconds between snapshots().
+    img = sensor.snapshot()  # Take a picture and return the image.
+
+    field = img.find_motion_vectors(extra_fb, block_size=BLOCK_SIZE, search_range=7)
+    extra_fb.replace(img)
+
+    for j, row in enumerate(field):
+        for i, (dx, dy, sad) in enumerate(row):
+            x = (i * BLOCK_SIZE) + (BLOCK_SIZE // 2)
+            y = (j * BLOCK_SIZE) + (BLOCK_SIZE // 2)
+            if dx or dy:
+                img.draw_line(x, y, x + dx, y + dy, color=255)
+
+    print(clock.fps())
@@ -0,0 +1,28 @@
+# This work is licensed under the MIT license.
+# Copyright (c) 2013-2024 OpenMV LLC. All rights reserved.
+# https://github.com/openmv/openmv/blob/master/LICENSE
+#
+# Line Processing Example
+#
+# This example shows off how to process the image while it is being captured. The sensor
+# outputs raw bayer data which is thresholded line by line as it is received, and a luma
+# histogram is accumulated at the same time, so no extra pass over the image is needed.
+
+import sensor
+import time
+
+sensor.reset()  # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.BAYER)  # Capture raw bayer data.
+sensor.set_framesize(sensor.QVGA)  # Set frame size to QVGA (320x240).
+
+# Debayer and threshold each line into a binary image, keeping the bright pixels.
+sensor.set_isp(sensor.BINARY, threshold=(160, 255), histogram=True)
+sensor.skip_frames(time=2000)  # Wait for settings take effect.
+clock = time.clock()  # Create a clock object to track the FPS.
+
+while True:
+    clock.tick()  # Update the FPS clock.
+    img = sensor.snapshot()  # Take a picture, the image is already binary.
+    bins = sensor.get_isp_histogram()  # Luma histogram of the last frame.
+    bright = sum(bins[160:]) * 100 // sum(bins)
+    print(bright, "% bright", clock.fps())
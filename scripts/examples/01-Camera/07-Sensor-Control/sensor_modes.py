@@ -0,0 +1,33 @@
+# This work is licensed under the MIT license.
+# Copyright (c) 2013-2024 OpenMV LLC. All rights reserved.
+# https://github.com/openmv/openmv/blob/master/LICENSE
+#
+# Sensor Modes Example
+#
+# This example shows off how to define sensor modes and switch between them. Switching
+# to a mode changes the frame size, pixel format and window in one step, which is faster
+# than calling set_pixformat() and set_framesize() one after another.
+
+import sensor
+import time
+
+sensor.reset()  # Reset and initialize the sensor.
+
+# Low resolution grayscale mode for detection.
+sensor.define_mode(0, sensor.GRAYSCALE, sensor.QVGA)
+# High resolution color mode for capture.
+sensor.define_mode(1, sensor.RGB565, sensor.VGA)
+
+sensor.set_mode(0)
+sensor.skip_frames(time=2000)  # Wait for settings take effect.
+clock = time.clock()  # Create a clock object to track the FPS.
+
+while True:
+    clock.tick()  # Update the FPS clock.
+    img = sensor.snapshot()  # Take a picture at QVGA.
+    if img.get_statistics().mean() > 128:
+        sensor.set_mode(1)
+        img = sensor.snapshot()  # Take a picture at VGA.
+        print("Captured", img.width(), "x", img.height())
+        sensor.set_mode(0)
+    print(clock.fps())
@@ -0,0 +1,28 @@
+# This work is licensed under the MIT license.
+# Copyright (c) 2013-2024 OpenMV LLC. All rights reserved.
+# https://github.com/openmv/openmv/blob/master/LICENSE
+#
+# Multi-ROI Capture Example
+#
+# This example shows off how to capture several regions of interest in one frame. Only
+# the window that covers all ROIs is read out of the sensor, and each captured line is
+# split between the ROIs, optionally keeping only every 2nd or 4th pixel and line.
+
+import sensor
+import time
+
+sensor.reset()  # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.GRAYSCALE)  # Set pixel format to GRAYSCALE.
+sensor.set_framesize(sensor.VGA)  # Set frame size to VGA (640x480).
+
+# Two ROIs in the top half of the frame, both kept at half resolution.
+sensor.set_rois([(0, 0, 320, 240), (320, 0, 320, 240)], decimation=2)
+sensor.skip_frames(time=2000)  # Wait for settings take effect.
+clock = time.clock()  # Create a clock object to track the FPS.
+
+while True:
+    clock.tick()  # Update the FPS clock.
+    rois = sensor.snapshot_rois()  # Returns one image per ROI.
+    for i, img in enumerate(rois):
+        print(i, img.width(), "x", img.height(), img.get_statistics().mean())
+    print(clock.fps())
@@ -4,12 +4,12 @@
 #
 # Find Rects Example
 #
-# This example shows off how to find rectangles in the image using the quad threshold
-# detection code from our April Tags code. The quad threshold detection algorithm
-# detects rectangles in an extremely robust way and is much better than Hough
-# Transform based methods. For example, it can still detect rectangles even when lens
-# distortion causes those rectangles to look bent. Rounded rectangles are no problem!
-# (But, given this the code will also detect small radius circles too)...
+# This example shows off how to find rectangles in the image. The image is adaptively
+# thresholded and the borders of dark and bright regions are traced and fitted with
+# quads whose sides must be straight. This is much more robust than Hough Transform
+# based methods and only needs memory proportional to the image width and height plus
+# a bit per pixel, so it also runs on larger resolutions. Lens distortion bending the
+# rectangle sides a little is no problem, but strongly rounded rectangles are rejected.
 
 import sensor
 import time
@@ -0,0 +1,38 @@
+# This work is licensed under the MIT license.
+# Copyright (c) 2013-2024 OpenMV LLC. All rights reserved.
+# https://github.com/openmv/openmv/blob/master/LICENSE
+#
+# HoG + Linear SVM Example
+#
+# This example shows off sliding window object detection with HoG features and a
+# linear SVM. Image.get_hog() returns the HoG descriptor of an ROI as bytes (255 is
+# 1.0) which can be used to train a linear SVM offline (e.g. with scikit-learn on
+# descriptors saved from the camera). The trained weights and bias are then passed
+# to Image.find_hog_objects() which scores every window position in the image.
+#
+# The weights file is a list of floats, one per line, followed by the bias.
+
+import sensor
+import time
+
+WINDOW = (32, 64)  # Must match the window used for training.
+CELL_SIZE = 8
+
+sensor.reset()
+sensor.set_framesize(sensor.QVGA)
+sensor.set_pixformat(sensor.GRAYSCALE)
+sensor.skip_frames(time=2000)
+
+with open("/hog_svm.txt") as f:
+    weights = [float(line) for line in f]
+bias = weights.pop()
+
+clock = time.clock()  # Tracks FPS.
+while True:
+    clock.tick()
+    img = sensor.snapshot()
+
+    for x, y, w, h, score in img.find_hog_objects(weights, bias, window=WINDOW, cell_size=CELL_SIZE, threshold=0.5):
+        img.draw_rectangle(x, y, w, h)
+
+    print(clock.fps())
@@ -0,0 +1,15 @@
+def unittest(data_path, temp_path):
+    import image
+    img = image.Image(data_path+"/graffiti.pgm", copy_to_fb=True)
+    jpg = img.to_jpeg(quality=95, copy=True)
+    # Decoding at 1/4 scale in the DCT domain should match a full decode followed by an area downscale.
+    ref = jpg.to_grayscale(copy=True).to_grayscale(x_scale=0.25, y_scale=0.25, hint=image.AREA, copy=True)
+    out = jpg.to_grayscale(x_scale=0.25, y_scale=0.25, copy=True)
+    if (out.width() != ref.width()) or (out.height() != ref.height()):
+        return False
+    # Cropped decodes only reconstruct the MCUs inside the roi.
+    roi = (40, 24, 160, 120)
+    crop_ref = jpg.to_grayscale(copy=True).to_grayscale(roi=roi, copy=True)
+    crop_out = jpg.to_grayscale(roi=roi, copy=True)
+    return (out.difference(ref).get_statistics().mean() < 3) and \
+           (crop_out.difference(crop_ref).get_statistics().max() == 0)
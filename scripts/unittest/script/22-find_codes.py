@@ -0,0 +1,16 @@
+def unittest(data_path, temp_path):
+    import image
+    img = image.Image("unittest/data/qrcode.pgm", copy_to_fb=True)
+    qrcodes = img.find_codes()
+    qrcode_type = type(img.find_qrcodes()[0])
+    img = image.Image("unittest/data/barcode.pgm", copy_to_fb=True)
+    barcodes = img.find_codes()
+    img = image.Image("unittest/data/datamatrix.pgm", copy_to_fb=True)
+    matrices = img.find_codes(codes=image.DATAMATRIX)
+    matrix_type = type(img.find_datamatrices()[0])
+    return len(qrcodes) == 1 and type(qrcodes[0]) is qrcode_type and \
+        qrcodes[0].rect() == (76, 36, 168, 168) and qrcodes[0].payload() == 'https://openmv.io' and \
+        len(barcodes) == 1 and barcodes[0].type() == image.CODE128 and \
+        barcodes[0].rect() == (61, 46, 514, 39) and barcodes[0].payload() == 'https://openmv.io/' and \
+        len(matrices) == 1 and type(matrices[0]) is matrix_type and \
+        matrices[0].rect() == (34, 15, 90, 89) and matrices[0].payload() == 'https://openmv.io/'
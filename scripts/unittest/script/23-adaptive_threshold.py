@@ -0,0 +1,28 @@
+def unittest(data_path, temp_path):
+    import image
+    # Dark square on a horizontal gradient, a global threshold can't separate it.
+    img = image.Image(64, 64, image.GRAYSCALE)
+    for y in range(64):
+        for x in range(64):
+            v = 40 + x * 3
+            if 26 <= x < 38 and 26 <= y < 38:
+                v -= 40
+            img.set_pixel(x, y, v)
+    for method in [image.ADAPTIVE_MEAN, image.ADAPTIVE_BRADLEY, image.ADAPTIVE_SAUVOLA]:
+        out = img.adaptive_threshold(8, method=method, offset=10, k=0.1, to_bitmap=True, copy=True)
+        if out.get_pixel(32, 32) or not out.get_pixel(8, 32) or not out.get_pixel(56, 32):
+            return False
+    for method, offset in [(image.ADAPTIVE_MEAN, 256), (image.ADAPTIVE_BRADLEY, -1), (image.ADAPTIVE_BRADLEY, 101)]:
+        try:
+            img.adaptive_threshold(8, method=method, offset=offset, copy=True)
+            return False
+        except ValueError:
+            pass
+    for pixformat in [image.BAYER, image.YUV422]:
+        try:
+            image.Image(16, 16, pixformat).adaptive_threshold(8)
+            return False
+        except ValueError:
+            pass
+    img.adaptive_threshold(8, offset=10, invert=True)
+    return img.get_pixel(32, 32) == 255 and img.get_pixel(8, 32) == 0
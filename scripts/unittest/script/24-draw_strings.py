@@ -0,0 +1,28 @@
+def unittest(data_path, temp_path):
+    import image
+    # Known pixels: the 'L' glyph rows are 0x20 (x = 2) for y = 2..7 and 0x38 (x = 2..4) for y = 7.
+    rows = [0x00, 0x00, 0x20, 0x20, 0x20, 0x20, 0x20, 0x38, 0x00, 0x00]
+    for antialias in [False, True]:
+        img = image.Image(32, 40, image.GRAYSCALE)
+        img.draw_string(10, 20, "L", color=255, scale=2, antialias=antialias)
+        for y in range(40):
+            for x in range(32):
+                gx, gy = (x - 10) // 2, (y - 20) // 2
+                lit = (0 <= gx < 8) and (0 <= gy < 10) and (rows[gy] & (0x80 >> gx))
+                if img.get_pixel(x, y) != (255 if lit else 0):
+                    return False
+    # The cached path of draw_strings() must match draw_string().
+    labels = [(10, 10, "person 0.87"), (40, 60, "cat 0.91", (255, 0, 0)), (100, 100, "dog\n0.55")]
+    for rotation, antialias in [(0, False), (90, False), (0, True)]:
+        a = image.Image(160, 120, image.RGB565)
+        b = image.Image(160, 120, image.RGB565)
+        for label in labels:
+            color = label[3] if len(label) > 3 else (255, 255, 255)
+            a.draw_string(label[0], label[1], label[2], color=color, scale=2,
+                          string_rotation=rotation, antialias=antialias)
+        b.draw_strings(labels, scale=2, string_rotation=rotation, antialias=antialias)
+        a.difference(b)
+        stats = a.get_statistics()
+        if (stats.max() != 0) or (stats.min() != 0):
+            return False
+    return True
@@ -0,0 +1,37 @@
+def unittest(data_path, temp_path):
+    import image
+    rects = [(10, 10, 40, 30), (-5, 60, 50, 20, (255, 0, 0)), (90, 40, 60, 70)]
+    a = image.Image(160, 120, image.RGB565)
+    b = image.Image(160, 120, image.RGB565)
+    for r in rects:
+        color = r[4] if len(r) > 4 else (255, 255, 255)
+        a.draw_rectangle(r[0], r[1], r[2], r[3], color=color, thickness=3)
+    b.draw_batch(rectangles=rects, thickness=3)
+    a.difference(b)
+    stats = a.get_statistics()
+    if (stats.max() != 0) or (stats.min() != 0):
+        return False
+    b.clear()
+    b.draw_batch(circles=[(80, 60, 20)], lines=[(0, 0, 159, 119)], fill=True, color=(0, 255, 0))
+    if (b.get_pixel(80, 60) != (0, 255, 0)) or (b.get_pixel(0, 0) != (0, 255, 0)) or (b.get_pixel(150, 10) != (0, 0, 0)):
+        return False
+    # A zero radius circle is a single pixel whatever the thickness, on both paths.
+    for fill in (False, True):
+        a.clear()
+        b.clear()
+        a.draw_circle(80, 60, 0, color=(255, 255, 255), thickness=5, fill=fill)
+        b.draw_batch(circles=[(80, 60, 0)], thickness=5, fill=fill)
+        if (b.get_pixel(80, 60) != (255, 255, 255)) or (b.get_pixel(81, 60) != (0, 0, 0)):
+            return False
+        a.difference(b)
+        stats = a.get_statistics()
+        if (stats.max() != 0) or (stats.min() != 0):
+            return False
+    # Bad items raise before anything is drawn.
+    b.clear()
+    try:
+        b.draw_batch(rectangles=[(10, 10, 20, 20)], circles=[(80, 60)])
+        return False
+    except ValueError:
+        pass
+    return b.get_pixel(10, 10) == (0, 0, 0)
@@ -0,0 +1,21 @@
+def unittest(data_path, temp_path):
+    import image
+    # Lossless round trip of a natural image.
+    img = image.Image(data_path+"/graffiti.pgm", copy_to_fb=True)
+    qoi = img.to_qoi(copy=True)
+    if qoi.to_grayscale(copy=True).difference(img).get_statistics().max() != 0:
+        return False
+    # Synthetic images should compress well in both native formats.
+    for fmt in (image.GRAYSCALE, image.RGB565):
+        img = image.Image(160, 120, fmt)
+        for y in range(0, 120, 8):
+            img.draw_line(0, y, 159, 119 - y, color=(y * 2, 255 - y, 128))
+        img.draw_circle(80, 60, 30, color=(255, 0, 0), fill=True)
+        qoi = img.compress(format=image.QOI, copy=True)
+        if qoi.format() != image.QOI or qoi.size() * 2 > img.size():
+            return False
+        out = qoi.to_grayscale(copy=True) if fmt == image.GRAYSCALE else qoi.to_rgb565(copy=True)
+        stats = out.difference(img).get_statistics()
+        if (stats.max() != 0) or (stats.min() != 0):
+            return False
+    return True
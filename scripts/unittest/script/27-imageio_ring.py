@@ -0,0 +1,23 @@
+def unittest(data_path, temp_path):
+    import image
+    # Write more frames than fit and check the ring keeps the newest ones in order.
+    stream = image.ImageIO((32, 32, image.GRAYSCALE), 4, ring=True)
+    for i in range(10):
+        img = image.Image(32, 32, image.GRAYSCALE)
+        img.set_pixel(0, 0, i + 1)
+        stream.write(img)
+    if stream.type() != image.ImageIO.RING_STREAM or stream.count() != 4:
+        return False
+    for i in range(6, 10):
+        if stream.read(copy_to_fb=False, pause=False).get_pixel(0, 0) != i + 1:
+            return False
+    # Dump the ring to a file stream and read it back.
+    if stream.dump(temp_path + "/ring.bin", block=True) != 4 or stream.dump_pending() != 0:
+        return False
+    stream.close()
+    stream = image.ImageIO(temp_path + "/ring.bin", "r")
+    for i in range(6, 10):
+        if stream.read(copy_to_fb=False, loop=False, pause=False).get_pixel(0, 0) != i + 1:
+            return False
+    stream.close()
+    return True
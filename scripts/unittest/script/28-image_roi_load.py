@@ -0,0 +1,31 @@
+def unittest(data_path, temp_path):
+    import image
+    img = image.Image(data_path+"/graffiti.pgm", copy_to_fb=True).to_rgb565(copy=True)
+    roi = (17, 9, 61, 33)
+    for ext in ("bmp", "ppm"):
+        path = temp_path + "/roi." + ext
+        img.save(path)
+        # Full and ROI loads must match the saved image.
+        full = image.Image(path, copy_to_fb=False)
+        part = image.Image(path, roi=roi, copy_to_fb=False)
+        if (part.width() != roi[2]) or (part.height() != roi[3]):
+            return False
+        if full.copy(roi=roi).difference(part).get_statistics().max() != 0:
+            return False
+        if ext == "bmp" and full.difference(img).get_statistics().max() != 0:
+            return False
+    # ASCII files, the last value is not followed by whitespace.
+    for fmt, values in (("P2", 1), ("P3", 3)):
+        path = temp_path + "/ascii." + ("pgm" if values == 1 else "ppm")
+        with open(path, "w") as f:
+            f.write("%s\n# comment\n7 5\n255\n" % fmt)
+            f.write(" ".join(str((i * 37) % 256) for i in range(7 * 5 * values)))
+        full = image.Image(path, copy_to_fb=False)
+        part = image.Image(path, roi=(2, 1, 4, 3), copy_to_fb=False)
+        if (full.width() != 7) or (full.height() != 5) or (part.width() != 4) or (part.height() != 3):
+            return False
+        if full.copy(roi=(2, 1, 4, 3)).difference(part).get_statistics().max() != 0:
+            return False
+        if (values == 1) and ((full.get_pixel(6, 4) != ((34 * 37) % 256)) or (part.get_pixel(0, 0) != ((9 * 37) % 256))):
+            return False
+    return True
@@ -0,0 +1,18 @@
+def unittest(data_path, temp_path):
+    import image
+    # Textured image and a copy shifted by (3, 2) pixels.
+    prev = image.Image(data_path+"/graffiti.pgm", copy_to_fb=False)
+    img = prev.copy()
+    img.clear()
+    img.draw_image(prev, 3, 2)
+    points = prev.track_features(prev, [], features=20, threshold=20)
+    if not points:
+        return False
+    tracked = img.track_features(prev, points)
+    if len(tracked) < len(points) // 2:
+        return False
+    for x, y, i, age in tracked:
+        p = points[i]
+        if abs(x - p[0] - 3) > 0.5 or abs(y - p[1] - 2) > 0.5 or age != 1:
+            return False
+    return True
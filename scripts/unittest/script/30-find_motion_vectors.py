@@ -0,0 +1,22 @@
+def unittest(data_path, temp_path):
+    import image
+    # Textured image and a copy shifted by (3, 2) pixels.
+    prev = image.Image(data_path+"/graffiti.pgm", copy_to_fb=False)
+    img = prev.copy()
+    img.clear()
+    img.draw_image(prev, 3, 2)
+    for block_size in (0, 12):
+        try:
+            img.find_motion_vectors(prev, block_size=block_size)
+            return False
+        except ValueError:
+            pass
+    field = img.find_motion_vectors(prev, block_size=16, search_range=7)
+    if len(field) != prev.height() // 16 or len(field[0]) != prev.width() // 16:
+        return False
+    # Skip the border blocks which see the cleared edge.
+    for row in field[1:-1]:
+        for dx, dy, sad in row[1:-1]:
+            if dx != 3 or dy != 2:
+                return False
+    return True
@@ -0,0 +1,15 @@
+def unittest(data_path, temp_path):
+    import image
+    img = image.Image(data_path+"/graffiti.pgm", copy_to_fb=False)
+    # 2x2 cell blocks with a stride of 1 cell, 36 bins each.
+    desc = img.get_hog(roi=(0, 0, 64, 32), cell_size=8)
+    if len(desc) != 7 * 3 * 36:
+        return False
+    # Blocks are unit length, so a window's own descriptor as the weights scores highest.
+    desc = img.get_hog(roi=(16, 8, 32, 32), cell_size=8)
+    weights = list(desc)
+    objs = img.find_hog_objects(weights, window=(32, 32), cell_size=8, sigma=0)
+    if not objs:
+        return False
+    best = max(objs, key=lambda o: o[4])
+    return best[:4] == (16, 8, 32, 32)
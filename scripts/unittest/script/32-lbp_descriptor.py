@@ -0,0 +1,14 @@
+def unittest(data_path, temp_path):
+    import image
+    img = image.Image(data_path+"/graffiti.pgm", copy_to_fb=True)
+    d0 = img.find_lbp((0, 0, 70, 70))
+    d1 = img.find_lbp((100, 50, 70, 70))
+
+    # Save and reload the descriptor.
+    image.save_descriptor(d0, temp_path+"/graffiti.lbp")
+    d2 = image.load_descriptor(temp_path+"/graffiti.lbp")
+
+    return  (image.match_descriptor(d0, d2) == 0 and \
+             image.match_descriptor(d0, d2, intersection=True) == 0 and \
+             image.match_descriptor(d0, d1) > 0 and \
+             image.match_descriptor(d0, d1, intersection=True) > 0)
@@ -0,0 +1,22 @@
+def unittest(data_path, temp_path):
+    import image
+    # Odd width and an unaligned mask to cover both the word and the tail paths.
+    w, h = 37, 4
+    mask = image.Image(w, h, image.BINARY)
+    mask.draw_rectangle(3, 1, 27, 2, color=1, fill=True)
+    for pixfmt in [image.GRAYSCALE, image.RGB565]:
+        a = image.Image(w, h, pixfmt)
+        b = image.Image(w, h, pixfmt)
+        for y in range(h):
+            for x in range(w):
+                a.set_pixel(x, y, (200, 160, 120))
+                b.set_pixel(x, y, (40 + x * 4, 40 + x * 4, 40 + x * 4))
+        orig = a.copy()
+        ref = a.copy().difference(b)
+        a.difference(b, mask=mask)
+        for y in range(h):
+            for x in range(w):
+                expected = ref if mask.get_pixel(x, y) else orig
+                if a.get_pixel(x, y) != expected.get_pixel(x, y):
+                    return False
+    return True
@@ -0,0 +1,11 @@
+def unittest(data_path, temp_path):
+    import image
+    # The outer and inner borders of a thick frame are the same rectangle.
+    img = image.Image(160, 120, image.GRAYSCALE)
+    img.draw_rectangle(0, 0, 160, 120, color=200, fill=True)
+    img.draw_rectangle(30, 20, 100, 80, color=40, fill=True)
+    img.draw_rectangle(40, 30, 80, 60, color=200, fill=True)
+    rects = img.find_rects(threshold=1000)
+    roi_rects = img.find_rects(roi=(10, 5, 140, 110), threshold=1000)
+    return len(rects) == 1 and rects[0][0:4] == (30, 20, 100, 80) and\
+        len(roi_rects) == 1 and roi_rects[0][0:4] == (30, 20, 100, 80)
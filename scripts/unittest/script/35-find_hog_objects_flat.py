@@ -0,0 +1,17 @@
+def unittest(data_path, temp_path):
+    import image
+    # A flat image has an all zero descriptor, so every window scores the bias.
+    img = image.Image(32, 32, image.GRAYSCALE)
+    img.draw_rectangle(0, 0, 32, 32, color=128, fill=True)
+    weights = [1.0] * 36
+    for bias, threshold in [(0, 0), (1, 0), (-1, -3)]:
+        objs = img.find_hog_objects(weights, bias, window=(16, 16), cell_size=8, threshold=threshold)
+        rects = [o[:4] for o in objs]
+        if not objs or objs[0][4] != bias or len(set(rects)) != len(rects):
+            return False
+        if any(o[4] < threshold or o[4] > bias for o in objs):
+            return False
+        # Zero scores are not decayed, none of the 3x3 windows is removed.
+        if bias == 0 and len(objs) != 9:
+            return False
+    return True
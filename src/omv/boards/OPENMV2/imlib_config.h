@@ -73,6 +73,9 @@
 //#define IMLIB_ENABLE_FIND_DISPLACEMENT
 #endif
 
+// Enable find_motion_vectors()
+//#define IMLIB_ENABLE_FIND_MOTION_VECTORS
+
 // Enable get_similarity()
 //#define IMLIB_ENABLE_GET_SIMILARITY
 
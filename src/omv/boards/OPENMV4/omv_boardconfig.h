@@ -203,6 +203,7 @@
 #define OMV_CSI_TIM_PCLK_FREQ()               HAL_RCC_GetPCLK2Freq()
 #define OMV_CSI_DMA_MEMCPY_ENABLE             (1)
 #define OMV_CSI_HW_CROP_ENABLE                (1)
+#define OMV_CSI_PROBE_CACHE_BKP               (24)  // Uses RTC backup registers 24-27.
 
 #define OMV_CSI_D0_PIN                        (&omv_pin_C6_DCMI)
 #define OMV_CSI_D1_PIN                        (&omv_pin_C7_DCMI)
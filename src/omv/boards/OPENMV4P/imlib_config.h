@@ -76,6 +76,9 @@
 #define IMLIB_ENABLE_FIND_DISPLACEMENT
 #endif
 
+// Enable find_motion_vectors()
+#define IMLIB_ENABLE_FIND_MOTION_VECTORS
+
 // Enable get_similarity()
 #define IMLIB_ENABLE_GET_SIMILARITY
 
@@ -139,7 +142,7 @@
 #define IMLIB_ENABLE_DESCRIPTOR
 
 // Enable find_hog()
-// #define IMLIB_ENABLE_HOG
+#define IMLIB_ENABLE_HOG
 
 // Enable selective_search()
 // #define IMLIB_ENABLE_SELECTIVE_SEARCH
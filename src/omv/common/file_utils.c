@@ -183,12 +183,14 @@ static uint32_t file_buffer_offset = 0;
 static uint8_t *file_buffer_pointer = 0;
 static uint32_t file_buffer_size = 0;
 static uint32_t file_buffer_index = 0;
+static uint32_t file_buffer_count = 0; // Bytes read into the buffer by the last fill.
 
 void file_buffer_init0() {
     file_buffer_offset = 0;
     file_buffer_pointer = 0;
     file_buffer_size = 0;
     file_buffer_index = 0;
+    file_buffer_count = 0;
 }
 
 OMV_ATTR_ALWAYS_INLINE static void file_fill(FIL *fp) {
@@ -207,6 +209,7 @@ OMV_ATTR_ALWAYS_INLINE static void file_fill(FIL *fp) {
         if (bytes != can_do) {
             ff_read_fail(fp);
         }
+        file_buffer_count = can_do;
     }
 }
 
@@ -246,6 +249,7 @@ void file_buffer_on(FIL *fp) {
         if (bytes != can_do) {
             ff_read_fail(fp);
         }
+        file_buffer_count = can_do;
     }
 }
 
@@ -309,7 +313,7 @@ void file_sync(FIL *fp) {
 uint32_t file_tell(FIL *fp) {
     if (file_buffer_pointer) {
         if (fp->flag & FA_READ) {
-            return f_tell(fp) - file_buffer_size + file_buffer_index;
+            return f_tell(fp) - file_buffer_count + file_buffer_index;
         } else {
             return f_tell(fp) + file_buffer_index;
         }
@@ -51,4 +51,7 @@ int omv_gpu_draw_image(image_t *src_img,
                        const uint16_t *color_palette,
                        const uint8_t *alpha_palette,
                        image_hint_t hint);
+
+// Fills dst_rect in dst_img with color (in the destination pixel format).
+int omv_gpu_fill_rect(image_t *dst_img, rectangle_t *dst_rect, int color);
 #endif // __OMV_GPU_H__
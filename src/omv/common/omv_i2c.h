@@ -84,4 +84,46 @@ int omv_i2c_readw2(omv_i2c_t *i2c, uint8_t slv_addr, uint16_t reg_addr,  uint16_
 int omv_i2c_writew2(omv_i2c_t *i2c, uint8_t slv_addr, uint16_t reg_addr, uint16_t reg_data);
 int omv_i2c_read_bytes(omv_i2c_t *i2c, uint8_t slv_addr, uint8_t *buf, int len, uint32_t flags);
 int omv_i2c_write_bytes(omv_i2c_t *i2c, uint8_t slv_addr, uint8_t *buf, int len, uint32_t flags);
+
+// Register sequence engine.
+//
+// Queues 8-bit register writes, coalescing writes to consecutive addresses into
+// a single auto-increment burst (one bus transaction), and keeps a direct-mapped
+// shadow copy of the registers written or read through it. Redundant writes and
+// cached reads never touch the bus. Only use it for driver-owned control registers:
+// registers that the sensor changes by itself (status, AEC/AGC readback) or that
+// trigger an action when written must use the plain functions above, or
+// omv_i2c_regseq_write_force() for the latter.
+//
+// Errors are sticky and returned (then cleared) by omv_i2c_regseq_flush().
+#ifndef OMV_I2C_REGSEQ_BURST_MAX
+#define OMV_I2C_REGSEQ_BURST_MAX    (32)
+#endif
+
+#ifndef OMV_I2C_REGSEQ_CACHE_SIZE
+#define OMV_I2C_REGSEQ_CACHE_SIZE   (256) // Must be a power of 2.
+#endif
+
+typedef struct _omv_i2c_regseq {
+    omv_i2c_t *i2c;
+    uint8_t slv_addr;
+    uint8_t addr_size;  // Register address size in bytes (1 or 2).
+    int error;
+    // Pending burst: register address followed by data.
+    uint16_t burst_reg;
+    uint16_t burst_len;
+    uint8_t burst[2 + OMV_I2C_REGSEQ_BURST_MAX];
+    // Shadow registers.
+    uint16_t cache_reg[OMV_I2C_REGSEQ_CACHE_SIZE];
+    uint8_t cache_data[OMV_I2C_REGSEQ_CACHE_SIZE];
+    uint32_t cache_valid[OMV_I2C_REGSEQ_CACHE_SIZE / 32];
+} omv_i2c_regseq_t;
+
+void omv_i2c_regseq_init(omv_i2c_regseq_t *seq, omv_i2c_t *i2c, uint8_t slv_addr, uint8_t addr_size);
+void omv_i2c_regseq_invalidate(omv_i2c_regseq_t *seq);
+int omv_i2c_regseq_flush(omv_i2c_regseq_t *seq);
+int omv_i2c_regseq_write(omv_i2c_regseq_t *seq, uint16_t reg_addr, uint8_t reg_data);
+int omv_i2c_regseq_write_force(omv_i2c_regseq_t *seq, uint16_t reg_addr, uint8_t reg_data);
+int omv_i2c_regseq_read(omv_i2c_regseq_t *seq, uint16_t reg_addr, uint8_t *reg_data);
+int omv_i2c_regseq_modify(omv_i2c_regseq_t *seq, uint16_t reg_addr, uint8_t mask, uint8_t value);
 #endif // __OMV_I2C_H__
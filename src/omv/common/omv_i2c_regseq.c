@@ -0,0 +1,160 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * I2C register sequence engine with a shadow register cache.
+ */
+#include <stddef.h>
+#include <string.h>
+#include "omv_i2c.h"
+
+#define REGSEQ_CACHE_MASK       (OMV_I2C_REGSEQ_CACHE_SIZE - 1)
+#define REGSEQ_CACHE_INDEX(r)   (((r) ^ ((r) >> 8)) & REGSEQ_CACHE_MASK)
+
+static bool omv_i2c_regseq_cache_get(omv_i2c_regseq_t *seq, uint16_t reg_addr, uint8_t *reg_data) {
+    size_t i = REGSEQ_CACHE_INDEX(reg_addr);
+    if ((seq->cache_valid[i / 32] & (1U << (i % 32))) && (seq->cache_reg[i] == reg_addr)) {
+        *reg_data = seq->cache_data[i];
+        return true;
+    }
+    return false;
+}
+
+static void omv_i2c_regseq_cache_put(omv_i2c_regseq_t *seq, uint16_t reg_addr, uint8_t reg_data) {
+    size_t i = REGSEQ_CACHE_INDEX(reg_addr);
+    seq->cache_reg[i] = reg_addr;
+    seq->cache_data[i] = reg_data;
+    seq->cache_valid[i / 32] |= (1U << (i % 32));
+}
+
+static void omv_i2c_regseq_cache_drop(omv_i2c_regseq_t *seq, uint16_t reg_addr) {
+    size_t i = REGSEQ_CACHE_INDEX(reg_addr);
+    if (seq->cache_reg[i] == reg_addr) {
+        seq->cache_valid[i / 32] &= ~(1U << (i % 32));
+    }
+}
+
+void omv_i2c_regseq_init(omv_i2c_regseq_t *seq, omv_i2c_t *i2c, uint8_t slv_addr, uint8_t addr_size) {
+    seq->i2c = i2c;
+    seq->slv_addr = slv_addr;
+    seq->addr_size = addr_size;
+    seq->error = 0;
+    seq->burst_len = 0;
+    omv_i2c_regseq_invalidate(seq);
+}
+
+void omv_i2c_regseq_invalidate(omv_i2c_regseq_t *seq) {
+    memset(seq->cache_valid, 0, sizeof(seq->cache_valid));
+}
+
+int omv_i2c_regseq_flush(omv_i2c_regseq_t *seq) {
+    if (seq->burst_len) {
+        if (omv_i2c_write_bytes(seq->i2c, seq->slv_addr, seq->burst,
+                                seq->addr_size + seq->burst_len, OMV_I2C_XFER_NO_FLAGS) != 0) {
+            // The device state is unknown, don't trust the shadow copy.
+            for (int i = 0; i < seq->burst_len; i++) {
+                omv_i2c_regseq_cache_drop(seq, seq->burst_reg + i);
+            }
+            seq->error = -1;
+        }
+        seq->burst_len = 0;
+    }
+
+    int ret = seq->error;
+    seq->error = 0;
+    return ret;
+}
+
+int omv_i2c_regseq_write_force(omv_i2c_regseq_t *seq, uint16_t reg_addr, uint8_t reg_data) {
+    int ret = 0;
+
+    // Extend the pending burst if this register follows it, otherwise start a new one.
+    if (!seq->burst_len
+        || (reg_addr != (uint16_t) (seq->burst_reg + seq->burst_len))
+        || (seq->burst_len == OMV_I2C_REGSEQ_BURST_MAX)) {
+        if (seq->burst_len) {
+            int error = seq->error;
+            ret = omv_i2c_regseq_flush(seq);
+            seq->error = ret | error;
+        }
+
+        seq->burst_reg = reg_addr;
+        if (seq->addr_size == 2) {
+            seq->burst[0] = reg_addr >> 8;
+            seq->burst[1] = reg_addr;
+        } else {
+            seq->burst[0] = reg_addr;
+        }
+    }
+
+    seq->burst[seq->addr_size + seq->burst_len++] = reg_data;
+    omv_i2c_regseq_cache_put(seq, reg_addr, reg_data);
+    return ret;
+}
+
+int omv_i2c_regseq_write(omv_i2c_regseq_t *seq, uint16_t reg_addr, uint8_t reg_data) {
+    uint8_t cached;
+    if (omv_i2c_regseq_cache_get(seq, reg_addr, &cached) && (cached == reg_data)) {
+        return 0;
+    }
+
+    // Overwrite a register that's still pending in the burst instead of writing it twice.
+    uint16_t offset = reg_addr - seq->burst_reg;
+    if (offset < seq->burst_len) {
+        seq->burst[seq->addr_size + offset] = reg_data;
+        omv_i2c_regseq_cache_put(seq, reg_addr, reg_data);
+        return 0;
+    }
+
+    return omv_i2c_regseq_write_force(seq, reg_addr, reg_data);
+}
+
+int omv_i2c_regseq_read(omv_i2c_regseq_t *seq, uint16_t reg_addr, uint8_t *reg_data) {
+    if (omv_i2c_regseq_cache_get(seq, reg_addr, reg_data)) {
+        return 0;
+    }
+
+    // Cache miss: pending writes must reach the device before reading it back.
+    int error = seq->error;
+    int ret = omv_i2c_regseq_flush(seq);
+
+    if (seq->addr_size == 2) {
+        ret |= omv_i2c_readb2(seq->i2c, seq->slv_addr, reg_addr, reg_data);
+    } else {
+        ret |= omv_i2c_readb(seq->i2c, seq->slv_addr, reg_addr, reg_data);
+    }
+
+    if (ret == 0) {
+        omv_i2c_regseq_cache_put(seq, reg_addr, *reg_data);
+    }
+
+    seq->error = error | ret;
+    return ret;
+}
+
+int omv_i2c_regseq_modify(omv_i2c_regseq_t *seq, uint16_t reg_addr, uint8_t mask, uint8_t value) {
+    uint8_t reg_data;
+    if (omv_i2c_regseq_read(seq, reg_addr, &reg_data) != 0) {
+        return -1;
+    }
+    return omv_i2c_regseq_write(seq, reg_addr, (reg_data & ~mask) | (value & mask));
+}
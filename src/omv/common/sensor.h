@@ -28,6 +28,8 @@
 #include <stdarg.h>
 #include "omv_i2c.h"
 #include "imlib.h"
+#include "sensor_roi.h"
+#include "sensor_isp.h"
 
 #define OV2640_SLV_ADDR         (0x60)
 #define OV5640_SLV_ADDR         (0x78)
@@ -230,8 +232,36 @@ typedef enum {
     SENSOR_CONFIG_WINDOWING = (1 << 3),
 } sensor_config_t;
 
+// Result of the last successful probe, kept in persistent storage by the
+// port so that the next boot can skip the bus scan and polarity search.
+#define SENSOR_PROBE_CACHE_MAGIC    (0x43534E53U)
+typedef struct _sensor_probe_cache {
+    uint32_t magic;
+    uint32_t chip_id;           // Chip ID as read from the sensor.
+    uint8_t bus_id;
+    uint8_t bus_speed;
+    uint8_t slv_addr;
+    uint8_t reset_pol : 1;
+    uint8_t power_pol : 1;
+    uint32_t checksum;
+} sensor_probe_cache_t;
+
+// Maximum number of sensor modes that can be defined.
+#define SENSOR_MAX_MODES    (8)
+
+// A sensor mode is a frame size, pixel format, window and frame rate that can be switched
+// to in one step. The window and frame buffer size are computed when the mode is defined.
+typedef struct _sensor_mode {
+    pixformat_t pixformat;      // Pixel format.
+    framesize_t framesize;      // Frame size, FRAMESIZE_INVALID if the mode is not defined.
+    int framerate;              // Frame rate, or 0 to keep the current frame rate.
+    uint16_t x, y, w, h;        // Window.
+    uint32_t frame_size;        // Raw frame size in bytes.
+} sensor_mode_t;
+
 typedef void (*vsync_cb_t) (uint32_t vsync);
 typedef void (*frame_cb_t) ();
+typedef void (*line_cb_t) (uint32_t line, const uint8_t *src, uint8_t *dst);
 
 typedef struct _sensor sensor_t;
 typedef struct _sensor {
@@ -262,6 +292,8 @@ typedef struct _sensor {
 
     vsync_cb_t vsync_callback;  // VSYNC callback.
     frame_cb_t frame_callback;  // Frame callback.
+    line_cb_t line_callback;    // Line callback, writes each captured line to the frame buffer.
+    pixformat_t line_pixfmt;    // Pixel format written by the line callback.
 
     // Sensor state
     sde_t sde;                  // Special digital effects
@@ -280,6 +312,9 @@ typedef struct _sensor {
     bool detected;              // Set to true when the sensor is initialized.
 
     omv_i2c_t i2c_bus;          // SCCB/I2C bus.
+    sensor_mode_t modes[SENSOR_MAX_MODES]; // User-defined sensor modes.
+    sensor_roi_list_t roi_list; // Multi-ROI capture, the window is set to the union of all ROIs.
+    sensor_isp_t isp;           // Built-in line processing stages.
 
     // Sensor function pointers
     int (*reset) (sensor_t *sensor);
@@ -289,6 +324,7 @@ typedef struct _sensor {
     int (*set_pixformat) (sensor_t *sensor, pixformat_t pixformat);
     int (*set_framesize) (sensor_t *sensor, framesize_t framesize);
     int (*set_framerate) (sensor_t *sensor, int framerate);
+    int (*set_mode) (sensor_t *sensor, const sensor_mode_t *mode);
     int (*set_contrast) (sensor_t *sensor, int level);
     int (*set_brightness) (sensor_t *sensor, int level);
     int (*set_saturation) (sensor_t *sensor, int level);
@@ -325,6 +361,11 @@ int sensor_init();
 // Detect and initialize the image sensor.
 int sensor_probe_init(uint32_t bus_id, uint32_t bus_speed);
 
+// Load/store the probe cache from/to persistent storage. Return 0 on success
+// or -1 if the port has no storage for it (the default).
+int sensor_probe_cache_load(sensor_probe_cache_t *cache);
+int sensor_probe_cache_save(const sensor_probe_cache_t *cache);
+
 // This function is called after a setting that may require reconfiguring
 // the hardware changes, such as window size, frame size, or pixel format.
 int sensor_config(sensor_config_t config);
@@ -368,6 +409,38 @@ int sensor_set_framesize(framesize_t framesize);
 // Set the sensor frame rate.
 int sensor_set_framerate(int framerate);
 
+// Define a sensor mode. A zero width/height window selects the full frame, and a
+// zero frame rate keeps the current one. The mode is validated when it is defined.
+int sensor_define_mode(uint32_t id, pixformat_t pixformat, framesize_t framesize,
+                       int x, int y, int w, int h, int framerate);
+
+// Switch to a previously defined mode. The sensor registers for the frame size and
+// pixel format are written in one batch, and the frame buffers are only reallocated
+// when the largest defined mode changes.
+int sensor_set_mode(uint32_t id);
+
+// Return the id of the mode matching the current sensor state, or -1 if none.
+int sensor_get_mode();
+
+// Capture several ROIs in one pass, or disable multi-ROI capture if count is 0. Each
+// captured line is split between the ROIs, keeping every Nth pixel and line, and the
+// ROI images are packed in the frame buffer. The frame buffer image is the first ROI.
+int sensor_set_rois(const rectangle_t *rois, uint32_t count, uint32_t decimation);
+
+// Set the line callback. The callback receives each captured line as it completes, with
+// `src` pointing to the first pixel of the window, and writes the frame buffer `dst` in
+// the given pixel format. Set to NULL to disable it.
+int sensor_set_line_callback(line_cb_t line_cb, pixformat_t pixfmt);
+
+// Set the built-in line processing stages. Captured lines are debayered or converted to
+// `pixfmt` (RGB565, GRAYSCALE or BINARY) while the frame is received. BINARY output keeps
+// the pixels with a luma in [lo, hi], and a luma histogram is accumulated if enabled.
+// Set `pixfmt` to PIXFORMAT_INVALID to disable.
+int sensor_set_isp(pixformat_t pixfmt, uint32_t lo, uint32_t hi, bool invert, bool histogram);
+
+// Returns the size in bytes the line callback output needs in the frame buffer.
+uint32_t sensor_get_line_frame_size();
+
 // Return the number of bytes per pixel to read from the image sensor.
 uint32_t sensor_get_src_bpp();
 
@@ -0,0 +1,201 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *
+ * Per-line image signal processing stages.
+ */
+#include <string.h>
+#include "sensor_isp.h"
+
+static bool isp_is_bayer(pixformat_t pixfmt) {
+    image_t img = { .pixfmt = pixfmt };
+    return img.is_bayer;
+}
+
+static uint32_t isp_dst_size(const sensor_isp_t *isp, uint32_t w, uint32_t h) {
+    image_t img = { .w = w, .h = h, .pixfmt = isp->dst_pixfmt };
+    // The scratch space starts at the next word.
+    return (image_size(&img) + 3) & ~3;
+}
+
+uint32_t sensor_isp_frame_size(const sensor_isp_t *isp, pixformat_t src_pixfmt, uint32_t w, uint32_t h) {
+    // One grayscale line, plus the raw line ring stored twice so any 4 lines are contiguous.
+    uint32_t scratch = w + (isp_is_bayer(src_pixfmt) ? (w * SENSOR_ISP_RING_LINES * 2) : 0);
+    return isp_dst_size(isp, w, h) + scratch;
+}
+
+void sensor_isp_start(sensor_isp_t *isp, pixformat_t src_pixfmt, uint32_t src_bpp,
+                      bool src_swap, uint32_t w, uint32_t h, uint8_t *fb) {
+    isp->src_pixfmt = src_pixfmt;
+    isp->src_bpp = src_bpp;
+    isp->src_swap = src_swap;
+    isp->w = w;
+    isp->h = h;
+    isp->scratch = fb + isp_dst_size(isp, w, h);
+    memset(isp->bins[isp->bins_index], 0, sizeof(isp->bins[0]));
+}
+
+const uint32_t *sensor_isp_get_histogram(const sensor_isp_t *isp) {
+    return isp->bins[isp->bins_index ^ 1];
+}
+
+// Writes one output line given a source line in the output format or grayscale.
+static void isp_output_gray(sensor_isp_t *isp, uint32_t y, const uint8_t *gray, uint8_t *fb) {
+    if (isp->histogram) {
+        uint32_t *bins = isp->bins[isp->bins_index];
+        for (uint32_t x = 0; x < isp->w; x++) {
+            bins[gray[x]]++;
+        }
+    }
+
+    if (isp->dst_pixfmt == PIXFORMAT_BINARY) {
+        image_t img = { .w = isp->w, .h = isp->h, .pixfmt = PIXFORMAT_BINARY, .data = fb };
+        uint32_t *row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(&img, y);
+        uint32_t lo = isp->threshold_lo, hi = isp->threshold_hi;
+        memset(row, 0, IMAGE_BINARY_LINE_LEN_BYTES(&img));
+        for (uint32_t x = 0; x < isp->w; x++) {
+            if (((gray[x] >= lo) && (gray[x] <= hi)) ^ isp->invert) {
+                IMAGE_SET_BINARY_PIXEL_FAST(row, x);
+            }
+        }
+    }
+}
+
+static void isp_output_rgb565(sensor_isp_t *isp, uint32_t y, uint16_t *row, uint8_t *fb) {
+    uint8_t *gray = isp->scratch;
+
+    // RGB565 output doesn't need a grayscale line unless a histogram is accumulated.
+    if ((isp->dst_pixfmt == PIXFORMAT_RGB565) && !isp->histogram) {
+        return;
+    }
+
+    uint8_t *dst = (isp->dst_pixfmt == PIXFORMAT_GRAYSCALE) ? (fb + (y * isp->w)) : gray;
+    for (uint32_t x = 0; x < isp->w; x++) {
+        uint16_t pixel = row[x];
+        dst[x] = COLOR_RGB565_TO_Y(pixel);
+    }
+
+    isp_output_gray(isp, y, dst, fb);
+}
+
+static void isp_line_bayer(sensor_isp_t *isp, uint32_t line, const uint8_t *src, uint8_t *fb) {
+    uint32_t w = isp->w, h = isp->h;
+    uint32_t ring_h = IM_MIN(h, (uint32_t) SENSOR_ISP_RING_LINES);
+    uint8_t *ring = isp->scratch + w;
+
+    // Store the raw line twice so that any ring_h consecutive lines are contiguous.
+    uint32_t slot = line % SENSOR_ISP_RING_LINES;
+    memcpy(ring + (slot * w), src, w);
+    memcpy(ring + ((slot + SENSOR_ISP_RING_LINES) * w), src, w);
+
+    if ((line == 0) && (h > 1)) {
+        return;
+    }
+
+    // Each line is debayered once the next line is received, the last two at the end.
+    for (uint32_t y = line ? (line - 1) : 0, y_end = (line == (h - 1)) ? h : line; y < y_end; y++) {
+        // First line of the ring_h lines around the debayered line.
+        uint32_t s = IM_CLAMP((int32_t) y - 1, 0, (int32_t) (h - ring_h));
+        image_t raw = {
+            .w = w,
+            .h = ring_h,
+            // The CFA pattern is relative to the debayered line.
+            .pixfmt = imlib_bayer_shift(isp->src_pixfmt, 0, y, false),
+            .data = ring + ((s % SENSOR_ISP_RING_LINES) * w),
+        };
+
+        switch (isp->dst_pixfmt) {
+            case PIXFORMAT_RGB565: {
+                uint16_t *row = ((uint16_t *) fb) + (y * w);
+                imlib_debayer_line(0, w, y - s, row, PIXFORMAT_RGB565, &raw);
+                isp_output_rgb565(isp, y, row, fb);
+                break;
+            }
+            case PIXFORMAT_GRAYSCALE: {
+                uint8_t *row = fb + (y * w);
+                imlib_debayer_line(0, w, y - s, row, PIXFORMAT_GRAYSCALE, &raw);
+                isp_output_gray(isp, y, row, fb);
+                break;
+            }
+            default: {
+                imlib_debayer_line(0, w, y - s, isp->scratch, PIXFORMAT_GRAYSCALE, &raw);
+                isp_output_gray(isp, y, isp->scratch, fb);
+                break;
+            }
+        }
+    }
+}
+
+static void isp_line_rgb565(sensor_isp_t *isp, uint32_t line, const uint8_t *src, uint8_t *fb) {
+    uint16_t *row = (isp->dst_pixfmt == PIXFORMAT_RGB565) ? (((uint16_t *) fb) + (line * isp->w)) : NULL;
+    uint16_t pixel;
+
+    if (row) {
+        for (uint32_t x = 0; x < isp->w; x++, src += 2) {
+            pixel = src[0] | (src[1] << 8);
+            row[x] = isp->src_swap ? __REV16(pixel) : pixel;
+        }
+        isp_output_rgb565(isp, line, row, fb);
+        return;
+    }
+
+    uint8_t *dst = (isp->dst_pixfmt == PIXFORMAT_GRAYSCALE) ? (fb + (line * isp->w)) : isp->scratch;
+    for (uint32_t x = 0; x < isp->w; x++, src += 2) {
+        pixel = src[0] | (src[1] << 8);
+        dst[x] = COLOR_RGB565_TO_Y(isp->src_swap ? __REV16(pixel) : pixel);
+    }
+    isp_output_gray(isp, line, dst, fb);
+}
+
+static void isp_line_gray(sensor_isp_t *isp, uint32_t line, const uint8_t *src, uint8_t *fb) {
+    uint8_t *dst = (isp->dst_pixfmt == PIXFORMAT_GRAYSCALE) ? (fb + (line * isp->w)) : isp->scratch;
+
+    if (isp->src_bpp == 1) {
+        memcpy(dst, src, isp->w);
+    } else {
+        // YUV422 source, keep the Y channel.
+        for (uint32_t x = 0; x < isp->w; x++, src += 2) {
+            dst[x] = src[0];
+        }
+    }
+    isp_output_gray(isp, line, dst, fb);
+}
+
+void sensor_isp_line(sensor_isp_t *isp, uint32_t line, const uint8_t *src, uint8_t *fb) {
+    if (line >= isp->h) {
+        return;
+    }
+
+    if (isp_is_bayer(isp->src_pixfmt)) {
+        isp_line_bayer(isp, line, src, fb);
+    } else if (isp->src_pixfmt == PIXFORMAT_RGB565) {
+        isp_line_rgb565(isp, line, src, fb);
+    } else {
+        isp_line_gray(isp, line, src, fb);
+    }
+
+    // The histogram is complete at the end of the frame.
+    if (isp->histogram && (line == (isp->h - 1))) {
+        isp->bins_index ^= 1;
+    }
+}
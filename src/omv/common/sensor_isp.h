@@ -0,0 +1,69 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *
+ * Per-line image signal processing stages.
+ *
+ * Captured lines are converted to the output format while the frame is being received,
+ * so the frame is already debayered, converted or thresholded when the capture ends.
+ * Debayering keeps a small ring of raw lines and outputs each line one line late.
+ */
+#ifndef __SENSOR_ISP_H__
+#define __SENSOR_ISP_H__
+#include <stdbool.h>
+#include <stdint.h>
+#include "imlib.h"
+
+#define SENSOR_ISP_RING_LINES       (4)     // Raw lines kept for debayering.
+#define SENSOR_ISP_HISTOGRAM_BINS   (256)
+
+typedef struct _sensor_isp {
+    pixformat_t dst_pixfmt;     // Output format: RGB565, GRAYSCALE or BINARY.
+    uint8_t threshold_lo;       // Binary output luma lower bound.
+    uint8_t threshold_hi;       // Binary output luma upper bound.
+    bool invert;                // Invert the binary output.
+    bool histogram;             // Accumulate a luma histogram.
+    // Per-frame state set by sensor_isp_start().
+    pixformat_t src_pixfmt;     // Captured format: BAYER_*, RGB565 or GRAYSCALE.
+    uint8_t src_bpp;            // Captured bytes per pixel.
+    bool src_swap;              // Byte-swap captured RGB565 pixels.
+    uint16_t w, h;              // Window size.
+    uint8_t *scratch;           // Raw line ring and one grayscale line.
+    uint32_t bins_index;        // Bins being accumulated.
+    uint32_t bins[2][SENSOR_ISP_HISTOGRAM_BINS];
+} sensor_isp_t;
+
+// Returns the size in bytes of the output image plus the scratch space used past it.
+uint32_t sensor_isp_frame_size(const sensor_isp_t *isp, pixformat_t src_pixfmt, uint32_t w, uint32_t h);
+
+// Prepares to process a new frame written to `fb`.
+void sensor_isp_start(sensor_isp_t *isp, pixformat_t src_pixfmt, uint32_t src_bpp,
+                      bool src_swap, uint32_t w, uint32_t h, uint8_t *fb);
+
+// Processes one captured line. `src` points to the first pixel of the window and `fb`
+// is the frame buffer.
+void sensor_isp_line(sensor_isp_t *isp, uint32_t line, const uint8_t *src, uint8_t *fb);
+
+// Returns the luma histogram of the last complete frame.
+const uint32_t *sensor_isp_get_histogram(const sensor_isp_t *isp);
+#endif // __SENSOR_ISP_H__
@@ -0,0 +1,116 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * Multi-ROI capture line splitter.
+ */
+#include <string.h>
+#include "sensor_roi.h"
+
+// ROI images start on a cache line so each one can be used as a separate image.
+#define SENSOR_ROI_ALIGN    (32)
+
+uint32_t sensor_roi_dst_bpp(const sensor_roi_list_t *list) {
+    return ((list->copy == SENSOR_ROI_COPY_8) || (list->copy == SENSOR_ROI_COPY_Y)) ? 1 : 2;
+}
+
+uint32_t sensor_roi_layout(sensor_roi_list_t *list) {
+    uint32_t dec = list->decimation;
+    uint32_t bpp = sensor_roi_dst_bpp(list);
+    uint32_t offset = 0;
+
+    for (uint32_t i = 0; i < list->count; i++) {
+        sensor_roi_t *roi = &list->rois[i];
+        roi->w -= roi->w % dec;
+        roi->h -= roi->h % dec;
+        roi->offset = offset;
+        offset += (roi->w / dec) * (roi->h / dec) * bpp;
+        offset = (offset + SENSOR_ROI_ALIGN - 1) & ~(SENSOR_ROI_ALIGN - 1);
+    }
+
+    list->size = offset;
+    return offset;
+}
+
+static void copy_8(uint8_t *dst, const uint8_t *src, uint32_t n, uint32_t step) {
+    if (step == 1) {
+        memcpy(dst, src, n);
+    } else {
+        for (uint32_t i = 0; i < n; i++, src += step) {
+            dst[i] = *src;
+        }
+    }
+}
+
+static void copy_16(uint16_t *dst, const uint8_t *src, uint32_t n, uint32_t step) {
+    if (step == 1) {
+        memcpy(dst, src, n * sizeof(uint16_t));
+    } else {
+        for (uint32_t i = 0; i < n; i++, src += step * sizeof(uint16_t)) {
+            uint16_t pixel;
+            memcpy(&pixel, src, sizeof(uint16_t));
+            dst[i] = pixel;
+        }
+    }
+}
+
+static void copy_16_rev(uint16_t *dst, const uint8_t *src, uint32_t n, uint32_t step) {
+    for (uint32_t i = 0; i < n; i++, src += step * sizeof(uint16_t)) {
+        dst[i] = (src[0] << 8) | src[1];
+    }
+}
+
+static void copy_y(uint8_t *dst, const uint8_t *src, uint32_t n, uint32_t step) {
+    for (uint32_t i = 0; i < n; i++, src += step * sizeof(uint16_t)) {
+        dst[i] = *src;
+    }
+}
+
+void sensor_roi_copy_line(const sensor_roi_list_t *list, uint32_t line, const uint8_t *src, uint8_t *dst) {
+    uint32_t dec = list->decimation;
+
+    for (uint32_t i = 0; i < list->count; i++) {
+        const sensor_roi_t *roi = &list->rois[i];
+
+        if ((line < roi->y) || (line >= (roi->y + roi->h)) || ((line - roi->y) % dec)) {
+            continue;
+        }
+
+        uint32_t w = roi->w / dec;
+        uint32_t row = (line - roi->y) / dec;
+
+        switch (list->copy) {
+            case SENSOR_ROI_COPY_8:
+                copy_8(dst + roi->offset + (row * w), src + roi->x, w, dec);
+                break;
+            case SENSOR_ROI_COPY_16:
+                copy_16((uint16_t *) (dst + roi->offset) + (row * w), src + (roi->x * 2), w, dec);
+                break;
+            case SENSOR_ROI_COPY_16_REV:
+                copy_16_rev((uint16_t *) (dst + roi->offset) + (row * w), src + (roi->x * 2), w, dec);
+                break;
+            case SENSOR_ROI_COPY_Y:
+                copy_y(dst + roi->offset + (row * w), src + (roi->x * 2), w, dec);
+                break;
+        }
+    }
+}
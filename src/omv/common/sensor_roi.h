@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * Multi-ROI capture line splitter.
+ *
+ * Each captured line is copied to every ROI that contains it, optionally keeping
+ * only every Nth pixel and line. The ROI images are packed one after another in
+ * the frame buffer. This code has no hardware dependencies.
+ */
+#ifndef __SENSOR_ROI_H__
+#define __SENSOR_ROI_H__
+#include <stdint.h>
+
+#define SENSOR_ROI_MAX      (8)
+
+typedef enum {
+    SENSOR_ROI_COPY_8,          // 1 byte per pixel.
+    SENSOR_ROI_COPY_16,         // 2 bytes per pixel.
+    SENSOR_ROI_COPY_16_REV,     // 2 bytes per pixel, byte-swapped.
+    SENSOR_ROI_COPY_Y,          // 2 bytes per pixel YUV422 source, Y channel destination.
+} sensor_roi_copy_t;
+
+typedef struct _sensor_roi {
+    uint16_t x, y, w, h;        // Source window, relative to the captured window.
+    uint32_t offset;            // Byte offset of the ROI image in the frame buffer.
+} sensor_roi_t;
+
+typedef struct _sensor_roi_list {
+    uint8_t count;              // Number of ROIs, 0 if disabled.
+    uint8_t decimation;         // Keep every Nth pixel and line (1, 2 or 4).
+    uint8_t copy;               // Line copy mode (sensor_roi_copy_t).
+    uint32_t size;              // Total size in bytes of all ROI images.
+    sensor_roi_t rois[SENSOR_ROI_MAX];
+} sensor_roi_list_t;
+
+// Returns the number of destination bytes per pixel for the copy mode.
+uint32_t sensor_roi_dst_bpp(const sensor_roi_list_t *list);
+
+// Trims the ROIs to a multiple of the decimation and packs the ROI images in the
+// frame buffer. Sets and returns the total size in bytes of all ROI images.
+uint32_t sensor_roi_layout(sensor_roi_list_t *list);
+
+// Copies one captured line to all ROIs that contain it. `src` points to the first pixel
+// of the captured window, `line` is the line index in the captured window, and `dst` is
+// the frame buffer.
+void sensor_roi_copy_line(const sensor_roi_list_t *list, uint32_t line, const uint8_t *src, uint8_t *dst);
+#endif // __SENSOR_ROI_H__
@@ -26,6 +26,7 @@
  */
 #if MICROPY_PY_SENSOR
 #include <string.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "py/mphal.h"
@@ -156,6 +157,10 @@ __weak int sensor_reset() {
     #endif // MICROPY_PY_IMU
     sensor.vsync_callback = NULL;
     sensor.frame_callback = NULL;
+    sensor.line_callback = NULL;
+    sensor.isp.histogram = false;
+    memset(sensor.modes, 0, sizeof(sensor.modes));
+    sensor.roi_list.count = 0;
 
     // Reset default color palette.
     sensor.color_palette = rainbow_table;
@@ -198,99 +203,158 @@ __weak int sensor_reset() {
     return 0;
 }
 
+// Read the chip ID of a sensor at a known address. Returns the address
+// if it belongs to a supported sensor family, or 0 otherwise.
+static int sensor_read_id(uint8_t slv_addr) {
+    switch (slv_addr) {
+        #if (OMV_OV2640_ENABLE == 1)
+        case OV2640_SLV_ADDR: // Or OV9650.
+            omv_i2c_readb(&sensor.i2c_bus, slv_addr, OV_CHIP_ID, (uint8_t *) &sensor.chip_id);
+            return slv_addr;
+        #endif // (OMV_OV2640_ENABLE == 1)
+
+        #if (OMV_OV5640_ENABLE == 1) || (OMV_GC2145_ENABLE == 1) || (OMV_GENX320_ENABLE == 1)
+        // OV5640, GC2145, and GENX320 share the same I2C address
+        case OV5640_SLV_ADDR:   // Or GC2145, or GENX320.
+            // Try to read GC2145 chip ID first
+            omv_i2c_readb(&sensor.i2c_bus, slv_addr, GC_CHIP_ID, (uint8_t *) &sensor.chip_id);
+            if (sensor.chip_id != GC2145_ID) {
+                // If it fails, try reading OV5640 chip ID.
+                omv_i2c_readb2(&sensor.i2c_bus, slv_addr, OV5640_CHIP_ID, (uint8_t *) &sensor.chip_id);
+
+                #if (OMV_GENX320_ENABLE == 1)
+                if (sensor.chip_id != OV5640_ID) {
+                    // If it fails, try reading GENX320 chip ID.
+                    uint8_t buf[] = {(GENX320_CHIP_ID >> 8), GENX320_CHIP_ID};
+                    omv_i2c_write_bytes(&sensor.i2c_bus, slv_addr, buf, 2, OMV_I2C_XFER_NO_STOP);
+                    omv_i2c_read_bytes(&sensor.i2c_bus, slv_addr, (uint8_t *) &sensor.chip_id, 4, OMV_I2C_XFER_NO_FLAGS);
+                    sensor.chip_id = __REV(sensor.chip_id);
+                }
+                #endif // (OMV_GENX320_ENABLE == 1)
+            }
+            return slv_addr;
+        #endif // (OMV_OV5640_ENABLE == 1) || (OMV_GC2145_ENABLE == 1) || (OMV_GENX320_ENABLE == 1)
+
+        #if (OMV_OV7725_ENABLE == 1) || (OMV_OV7670_ENABLE == 1) || (OMV_OV7690_ENABLE == 1)
+        case OV7725_SLV_ADDR: // Or OV7690 or OV7670.
+            omv_i2c_readb(&sensor.i2c_bus, slv_addr, OV_CHIP_ID, (uint8_t *) &sensor.chip_id);
+            return slv_addr;
+        #endif //(OMV_OV7725_ENABLE == 1) || (OMV_OV7670_ENABLE == 1) || (OMV_OV7690_ENABLE == 1)
+
+        #if (OMV_MT9V0XX_ENABLE == 1)
+        case MT9V0XX_SLV_ADDR:
+            omv_i2c_readw(&sensor.i2c_bus, slv_addr, ON_CHIP_ID, (uint16_t *) &sensor.chip_id);
+            return slv_addr;
+        #endif //(OMV_MT9V0XX_ENABLE == 1)
+
+        #if (OMV_MT9M114_ENABLE == 1)
+        case MT9M114_SLV_ADDR:
+            omv_i2c_readw2(&sensor.i2c_bus, slv_addr, ON_CHIP_ID, (uint16_t *) &sensor.chip_id);
+            return slv_addr;
+        #endif // (OMV_MT9M114_ENABLE == 1)
+
+        #if (OMV_LEPTON_ENABLE == 1)
+        case LEPTON_SLV_ADDR:
+            sensor.chip_id = LEPTON_ID;
+            return slv_addr;
+        #endif // (OMV_LEPTON_ENABLE == 1)
+
+        #if (OMV_HM01B0_ENABLE == 1) || (OMV_HM0360_ENABLE == 1)
+        case HM0XX0_SLV_ADDR:
+            omv_i2c_readb2(&sensor.i2c_bus, slv_addr, HIMAX_CHIP_ID, (uint8_t *) &sensor.chip_id);
+            return slv_addr;
+        #endif // (OMV_HM01B0_ENABLE == 1) || (OMV_HM0360_ENABLE == 1)
+
+        #if (OMV_FROGEYE2020_ENABLE == 1)
+        case FROGEYE2020_SLV_ADDR:
+            sensor.chip_id = FROGEYE2020_ID;
+            return slv_addr;
+        #endif // (OMV_FROGEYE2020_ENABLE == 1)
+
+        #if (OMV_PAG7920_ENABLE == 1)
+        case PAG7920_SLV_ADDR:
+            omv_i2c_readw2(&sensor.i2c_bus, slv_addr, PIXART_CHIP_ID, (uint16_t *) &sensor.chip_id);
+            sensor.chip_id = ((sensor.chip_id << 8) | (sensor.chip_id >> 8)) & 0xFFFF;
+            return slv_addr;
+        #endif // (OMV_PAG7920_ENABLE == 1)
+
+        #if (OMV_PAG7936_ENABLE == 1)
+        case PAG7936_SLV_ADDR:
+            omv_i2c_readw2(&sensor.i2c_bus, slv_addr, PIXART_CHIP_ID, (uint16_t *) &sensor.chip_id);
+            sensor.chip_id = ((sensor.chip_id << 8) | (sensor.chip_id >> 8)) & 0xFFFF;
+            return slv_addr;
+        #endif // (OMV_PAG7936_ENABLE == 1)
+    }
+
+    return 0;
+}
+
 static int sensor_detect() {
     uint8_t devs_list[OMV_CSI_MAX_DEVICES];
     int n_devs = omv_i2c_scan(&sensor.i2c_bus, devs_list, OMV_ARRAY_SIZE(devs_list));
 
     for (int i = 0; i < OMV_MIN(n_devs, OMV_CSI_MAX_DEVICES); i++) {
-        uint8_t slv_addr = devs_list[i];
-        switch (slv_addr) {
-            #if (OMV_OV2640_ENABLE == 1)
-            case OV2640_SLV_ADDR: // Or OV9650.
-                omv_i2c_readb(&sensor.i2c_bus, slv_addr, OV_CHIP_ID, (uint8_t *) &sensor.chip_id);
-                return slv_addr;
-            #endif // (OMV_OV2640_ENABLE == 1)
-
-            #if (OMV_OV5640_ENABLE == 1) || (OMV_GC2145_ENABLE == 1) || (OMV_GENX320_ENABLE == 1)
-            // OV5640, GC2145, and GENX320 share the same I2C address
-            case OV5640_SLV_ADDR:   // Or GC2145, or GENX320.
-                // Try to read GC2145 chip ID first
-                omv_i2c_readb(&sensor.i2c_bus, slv_addr, GC_CHIP_ID, (uint8_t *) &sensor.chip_id);
-                if (sensor.chip_id != GC2145_ID) {
-                    // If it fails, try reading OV5640 chip ID.
-                    omv_i2c_readb2(&sensor.i2c_bus, slv_addr, OV5640_CHIP_ID, (uint8_t *) &sensor.chip_id);
-
-                    #if (OMV_GENX320_ENABLE == 1)
-                    if (sensor.chip_id != OV5640_ID) {
-                        // If it fails, try reading GENX320 chip ID.
-                        uint8_t buf[] = {(GENX320_CHIP_ID >> 8), GENX320_CHIP_ID};
-                        omv_i2c_write_bytes(&sensor.i2c_bus, slv_addr, buf, 2, OMV_I2C_XFER_NO_STOP);
-                        omv_i2c_read_bytes(&sensor.i2c_bus, slv_addr, (uint8_t *) &sensor.chip_id, 4, OMV_I2C_XFER_NO_FLAGS);
-                        sensor.chip_id = __REV(sensor.chip_id);
-                    }
-                    #endif // (OMV_GENX320_ENABLE == 1)
-                }
-                return slv_addr;
-            #endif // (OMV_OV5640_ENABLE == 1) || (OMV_GC2145_ENABLE == 1) || (OMV_GENX320_ENABLE == 1)
-
-            #if (OMV_OV7725_ENABLE == 1) || (OMV_OV7670_ENABLE == 1) || (OMV_OV7690_ENABLE == 1)
-            case OV7725_SLV_ADDR: // Or OV7690 or OV7670.
-                omv_i2c_readb(&sensor.i2c_bus, slv_addr, OV_CHIP_ID, (uint8_t *) &sensor.chip_id);
-                return slv_addr;
-            #endif //(OMV_OV7725_ENABLE == 1) || (OMV_OV7670_ENABLE == 1) || (OMV_OV7690_ENABLE == 1)
-
-            #if (OMV_MT9V0XX_ENABLE == 1)
-            case MT9V0XX_SLV_ADDR:
-                omv_i2c_readw(&sensor.i2c_bus, slv_addr, ON_CHIP_ID, (uint16_t *) &sensor.chip_id);
-                return slv_addr;
-            #endif //(OMV_MT9V0XX_ENABLE == 1)
-
-            #if (OMV_MT9M114_ENABLE == 1)
-            case MT9M114_SLV_ADDR:
-                omv_i2c_readw2(&sensor.i2c_bus, slv_addr, ON_CHIP_ID, (uint16_t *) &sensor.chip_id);
-                return slv_addr;
-            #endif // (OMV_MT9M114_ENABLE == 1)
-
-            #if (OMV_LEPTON_ENABLE == 1)
-            case LEPTON_SLV_ADDR:
-                sensor.chip_id = LEPTON_ID;
-                return slv_addr;
-            #endif // (OMV_LEPTON_ENABLE == 1)
-
-            #if (OMV_HM01B0_ENABLE == 1) || (OMV_HM0360_ENABLE == 1)
-            case HM0XX0_SLV_ADDR:
-                omv_i2c_readb2(&sensor.i2c_bus, slv_addr, HIMAX_CHIP_ID, (uint8_t *) &sensor.chip_id);
-                return slv_addr;
-            #endif // (OMV_HM01B0_ENABLE == 1) || (OMV_HM0360_ENABLE == 1)
-
-            #if (OMV_FROGEYE2020_ENABLE == 1)
-            case FROGEYE2020_SLV_ADDR:
-                sensor.chip_id = FROGEYE2020_ID;
-                return slv_addr;
-            #endif // (OMV_FROGEYE2020_ENABLE == 1)
-
-            #if (OMV_PAG7920_ENABLE == 1)
-            case PAG7920_SLV_ADDR:
-                omv_i2c_readw2(&sensor.i2c_bus, slv_addr, PIXART_CHIP_ID, (uint16_t *) &sensor.chip_id);
-                sensor.chip_id = ((sensor.chip_id << 8) | (sensor.chip_id >> 8)) & 0xFFFF;
-                return slv_addr;
-            #endif // (OMV_PAG7920_ENABLE == 1)
-
-            #if (OMV_PAG7936_ENABLE == 1)
-            case PAG7936_SLV_ADDR:
-                omv_i2c_readw2(&sensor.i2c_bus, slv_addr, PIXART_CHIP_ID, (uint16_t *) &sensor.chip_id);
-                sensor.chip_id = ((sensor.chip_id << 8) | (sensor.chip_id >> 8)) & 0xFFFF;
-                return slv_addr;
-            #endif // (OMV_PAG7936_ENABLE == 1)
+        if (sensor_read_id(devs_list[i]) != 0) {
+            return devs_list[i];
         }
     }
 
     return 0;
 }
 
-int sensor_probe_init(uint32_t bus_id, uint32_t bus_speed) {
-    int init_ret = 0;
+static uint32_t sensor_probe_cache_checksum(const sensor_probe_cache_t *cache) {
+    const uint32_t *words = (const uint32_t *) cache;
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < offsetof(sensor_probe_cache_t, checksum) / 4; i++) {
+        hash = (hash ^ words[i]) * 16777619U;
+    }
+    return hash;
+}
+
+// Try the result of the last successful probe: release power-down and reset with the
+// cached polarities and read the chip ID at the cached address, without scanning the
+// bus. Returns 0 if the same sensor was found, or -1 to fall back to the full probe.
+static int sensor_probe_cached(uint32_t bus_id, uint32_t bus_speed, sensor_probe_cache_t *cache) {
+    uint8_t buf;
+
+    if (sensor_probe_cache_load(cache) != 0 ||
+        cache->magic != SENSOR_PROBE_CACHE_MAGIC ||
+        cache->checksum != sensor_probe_cache_checksum(cache) ||
+        cache->bus_id != bus_id || cache->bus_speed != bus_speed) {
+        return -1;
+    }
 
+    #if defined(OMV_CSI_POWER_PIN)
+    sensor.power_pol = cache->power_pol;
+    omv_gpio_write(OMV_CSI_POWER_PIN, !sensor.power_pol);
+    mp_hal_delay_ms(OMV_CSI_POWER_DELAY);
+    #endif
+
+    #if defined(OMV_CSI_RESET_PIN)
+    sensor.reset_pol = cache->reset_pol;
+    omv_gpio_write(OMV_CSI_RESET_PIN, !sensor.reset_pol);
+    mp_hal_delay_ms(OMV_CSI_RESET_DELAY);
+    #endif
+
+    // Initialize the camera bus.
+    omv_i2c_init(&sensor.i2c_bus, bus_id, bus_speed);
+    mp_hal_delay_ms(10);
+
+    // Check that the device acks before reading its ID, some
+    // sensors don't have an ID register and are assumed present.
+    if (omv_i2c_read_bytes(&sensor.i2c_bus, cache->slv_addr, &buf, 1, OMV_I2C_XFER_NO_FLAGS) != 0 ||
+        sensor_read_id(cache->slv_addr) == 0 || sensor.chip_id != cache->chip_id) {
+        omv_i2c_deinit(&sensor.i2c_bus);
+        return -1;
+    }
+
+    sensor.slv_addr = cache->slv_addr;
+    return 0;
+}
+
+// Run the full probe: power cycle the sensor, and scan the bus using all
+// reset/power-down polarities until a supported sensor is detected.
+static int sensor_probe_detect(uint32_t bus_id, uint32_t bus_speed) {
     #if defined(OMV_CSI_POWER_PIN)
     sensor.power_pol = ACTIVE_HIGH;
     // Do a power cycle
@@ -359,6 +423,23 @@ int sensor_probe_init(uint32_t bus_id, uint32_t bus_speed) {
         }
     }
 
+    return 0;
+}
+
+int sensor_probe_init(uint32_t bus_id, uint32_t bus_speed) {
+    int init_ret = 0;
+    bool cache_hit = false;
+    sensor_probe_cache_t cache;
+
+    if (sensor_probe_cached(bus_id, bus_speed, &cache) == 0) {
+        cache_hit = true;
+    } else if ((init_ret = sensor_probe_detect(bus_id, bus_speed)) != 0) {
+        return init_ret;
+    }
+
+    // Keep the chip ID as read, some drivers remap it below.
+    uint32_t chip_id = sensor.chip_id;
+
     // A supported sensor was detected, try to initialize it.
     switch (sensor.chip_id) {
         #if (OMV_OV2640_ENABLE == 1)
@@ -532,9 +613,32 @@ int sensor_probe_init(uint32_t bus_id, uint32_t bus_speed) {
         return SENSOR_ERROR_ISC_INIT_FAILED;
     }
 
+    // Update the probe cache. Sensors on the SPI bus have no slave address
+    // and are not cached, nor is the cache rewritten if nothing changed.
+    if (!cache_hit && sensor.slv_addr != 0) {
+        memset(&cache, 0, sizeof(cache));
+        cache.magic = SENSOR_PROBE_CACHE_MAGIC;
+        cache.chip_id = chip_id;
+        cache.bus_id = bus_id;
+        cache.bus_speed = bus_speed;
+        cache.slv_addr = sensor.slv_addr;
+        cache.reset_pol = sensor.reset_pol;
+        cache.power_pol = sensor.power_pol;
+        cache.checksum = sensor_probe_cache_checksum(&cache);
+        sensor_probe_cache_save(&cache);
+    }
+
     return 0;
 }
 
+__weak int sensor_probe_cache_load(sensor_probe_cache_t *cache) {
+    return -1;
+}
+
+__weak int sensor_probe_cache_save(const sensor_probe_cache_t *cache) {
+    return -1;
+}
+
 __weak int sensor_config(sensor_config_t config) {
     return 0;
 }
@@ -629,6 +733,47 @@ __weak int sensor_write_reg(uint16_t reg_addr, uint16_t reg_data) {
     return 0;
 }
 
+// Returns the pixel format of the captured window for the line processing stages.
+static pixformat_t sensor_isp_src_pixfmt() {
+    if (sensor.raw_output || (sensor.pixformat == PIXFORMAT_BAYER)) {
+        image_t img = { .pixfmt = PIXFORMAT_BAYER };
+        img.subfmt_id = sensor.cfa_format;
+        return imlib_bayer_shift(img.pixfmt, MAIN_FB()->x, MAIN_FB()->y, false);
+    }
+
+    switch (sensor.pixformat) {
+        case PIXFORMAT_GRAYSCALE:
+        case PIXFORMAT_RGB565:
+            return sensor.pixformat;
+        default:
+            return PIXFORMAT_INVALID;
+    }
+}
+
+// Returns true if the line processing stages can output pixfmt from the current pixel format.
+static bool sensor_isp_supported(pixformat_t pixfmt) {
+    switch (sensor_isp_src_pixfmt()) {
+        case PIXFORMAT_INVALID:
+            return false;
+        case PIXFORMAT_GRAYSCALE:
+            return (pixfmt == PIXFORMAT_GRAYSCALE) || (pixfmt == PIXFORMAT_BINARY);
+        default:
+            return (pixfmt == PIXFORMAT_RGB565) || (pixfmt == PIXFORMAT_GRAYSCALE) || (pixfmt == PIXFORMAT_BINARY);
+    }
+}
+
+static void sensor_isp_line_cb(uint32_t line, const uint8_t *src, uint8_t *dst) {
+    if (line == 0) {
+        bool src_swap = false;
+        #if !OMV_CSI_HW_SWAP_ENABLE
+        src_swap = (sensor.pixformat == PIXFORMAT_RGB565) && sensor.rgb_swap;
+        #endif
+        sensor_isp_start(&sensor.isp, sensor_isp_src_pixfmt(), sensor_get_src_bpp(),
+                         src_swap, MAIN_FB()->u, MAIN_FB()->v, dst);
+    }
+    sensor_isp_line(&sensor.isp, line, src, dst);
+}
+
 __weak int sensor_set_pixformat(pixformat_t pixformat) {
     // Check if the value has changed.
     if (sensor.pixformat == pixformat) {
@@ -675,6 +820,21 @@ __weak int sensor_set_pixformat(pixformat_t pixformat) {
     // Set pixel format
     sensor.pixformat = pixformat;
 
+    // Disable the line processing stages if they don't support the new pixel format.
+    if ((sensor.line_callback == sensor_isp_line_cb) && !sensor_isp_supported(sensor.isp.dst_pixfmt)) {
+        sensor.line_callback = NULL;
+        sensor.isp.histogram = false;
+    }
+
+    // The ROI layout depends on the pixel format, disable multi-ROI capture.
+    if (sensor.roi_list.count) {
+        sensor.roi_list.count = 0;
+        MAIN_FB()->x = 0;
+        MAIN_FB()->y = 0;
+        MAIN_FB()->w = MAIN_FB()->u = resolution[sensor.framesize][0];
+        MAIN_FB()->h = MAIN_FB()->v = resolution[sensor.framesize][1];
+    }
+
     // Reset pixel format to skip the first frame.
     MAIN_FB()->pixfmt = PIXFORMAT_INVALID;
 
@@ -712,6 +872,7 @@ __weak int sensor_set_framesize(framesize_t framesize) {
 
     // Set framebuffer size
     sensor.framesize = framesize;
+    sensor.roi_list.count = 0;
 
     // Set x and y offsets.
     MAIN_FB()->x = 0;
@@ -753,6 +914,216 @@ __weak int sensor_set_framerate(int framerate) {
     return 0;
 }
 
+__weak int sensor_define_mode(uint32_t id, pixformat_t pixformat, framesize_t framesize,
+                              int x, int y, int w, int h, int framerate) {
+    if (id >= SENSOR_MAX_MODES) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    if ((framesize == FRAMESIZE_INVALID) || (framesize > FRAMESIZE_WQXGA2)) {
+        return SENSOR_ERROR_INVALID_FRAMESIZE;
+    }
+
+    switch (pixformat) {
+        case PIXFORMAT_GRAYSCALE:
+        case PIXFORMAT_BAYER:
+        case PIXFORMAT_RGB565:
+        case PIXFORMAT_YUV422:
+        case PIXFORMAT_JPEG:
+            break;
+        default:
+            return SENSOR_ERROR_INVALID_PIXFORMAT;
+    }
+
+    if (framerate < 0) {
+        return SENSOR_ERROR_INVALID_FRAMERATE;
+    }
+
+    int res_w = resolution[framesize][0];
+    int res_h = resolution[framesize][1];
+
+    if ((w == 0) || (h == 0)) {
+        x = 0;
+        y = 0;
+        w = res_w;
+        h = res_h;
+    } else if ((x < 0) || (y < 0) || (w < 0) || (h < 0) || ((x + w) > res_w) || ((y + h) > res_h)) {
+        return SENSOR_ERROR_INVALID_WINDOW;
+    }
+
+    // Cropping doesn't work in JPEG mode.
+    if ((pixformat == PIXFORMAT_JPEG) && ((w != res_w) || (h != res_h))) {
+        return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
+    }
+
+    sensor_mode_t *mode = &sensor.modes[id];
+    mode->pixformat = pixformat;
+    mode->framesize = framesize;
+    mode->framerate = framerate;
+    mode->x = x;
+    mode->y = y;
+    mode->w = w;
+    mode->h = h;
+    #if OMV_CSI_HW_CROP_ENABLE
+    mode->frame_size = w * h * 2;
+    #else
+    mode->frame_size = res_w * res_h * 2;
+    #endif
+    return 0;
+}
+
+// Returns the frame buffer size needed to capture a raw frame of frame_size bytes,
+// which may be larger with overlapping ROIs or a line callback.
+static uint32_t sensor_get_buffer_frame_size(uint32_t frame_size) {
+    // Overlapping ROIs may need more space than the window.
+    if (sensor.roi_list.count) {
+        frame_size = IM_MAX(frame_size, sensor.roi_list.size);
+    }
+
+    // The line callback output may be larger than the captured frame.
+    if (sensor.line_callback) {
+        frame_size = IM_MAX(frame_size, sensor_get_line_frame_size());
+    }
+
+    return frame_size;
+}
+
+__weak int sensor_set_mode(uint32_t id) {
+    int ret = 0;
+
+    if ((id >= SENSOR_MAX_MODES) || (sensor.modes[id].framesize == FRAMESIZE_INVALID)) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Disable multi-ROI capture, the mode window replaces it.
+    if (sensor.roi_list.count) {
+        sensor_abort(true, false);
+        sensor.roi_list.count = 0;
+    }
+
+    const sensor_mode_t *mode = &sensor.modes[id];
+    bool pixformat_changed = (sensor.pixformat != mode->pixformat);
+    bool framesize_changed = (sensor.framesize != mode->framesize);
+    bool window_changed = (MAIN_FB()->x != mode->x) || (MAIN_FB()->y != mode->y) ||
+                          (MAIN_FB()->u != mode->w) || (MAIN_FB()->v != mode->h);
+
+    // Transposing (and thus auto rotation) doesn't work in YUV or JPEG mode.
+    if (((mode->pixformat == PIXFORMAT_YUV422) || (mode->pixformat == PIXFORMAT_JPEG)) &&
+        (sensor.transpose || sensor.auto_rotation)) {
+        return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
+    }
+
+    if (!pixformat_changed && !framesize_changed && !window_changed) {
+        return (mode->framerate) ? sensor_set_framerate(mode->framerate) : 0;
+    }
+
+    // Disable any ongoing frame capture.
+    sensor_abort(true, false);
+
+    // Flush previous frame.
+    framebuffer_update_jpeg_buffer();
+
+    if (pixformat_changed || framesize_changed) {
+        if (sensor.set_mode != NULL) {
+            // The driver writes the frame size and pixel format registers in one batch.
+            if (sensor.set_mode(&sensor, mode) != 0) {
+                return SENSOR_ERROR_CTL_FAILED;
+            }
+            sensor.framesize = mode->framesize;
+            sensor.pixformat = mode->pixformat;
+        } else {
+            if ((sensor.set_framesize == NULL) || (sensor.set_pixformat == NULL)) {
+                return SENSOR_ERROR_CTL_UNSUPPORTED;
+            }
+
+            if (framesize_changed) {
+                if (sensor.set_framesize(&sensor, mode->framesize) != 0) {
+                    return SENSOR_ERROR_CTL_FAILED;
+                }
+                sensor.framesize = mode->framesize;
+            }
+
+            // If this fails the new frame size is still applied below.
+            if (pixformat_changed) {
+                if (sensor.set_pixformat(&sensor, mode->pixformat) != 0) {
+                    ret = SENSOR_ERROR_CTL_FAILED;
+                } else {
+                    sensor.pixformat = mode->pixformat;
+                }
+            }
+        }
+
+        if (!sensor.disable_delays) {
+            mp_hal_delay_ms(100); // wait for the camera to settle
+        }
+    }
+
+    // Set x and y offsets.
+    MAIN_FB()->x = mode->x;
+    MAIN_FB()->y = mode->y;
+    // Set width and height.
+    MAIN_FB()->w = mode->w;
+    MAIN_FB()->h = mode->h;
+    // Set backup width and height.
+    MAIN_FB()->u = mode->w;
+    MAIN_FB()->v = mode->h;
+    // Reset pixel format to skip the first frame.
+    MAIN_FB()->pixfmt = PIXFORMAT_INVALID;
+
+    // Size the frame buffers for the largest defined mode, so that switching
+    // between modes only flushes the frame buffers instead of reallocating them.
+    uint32_t frame_size = 0;
+    for (int i = 0; i < SENSOR_MAX_MODES; i++) {
+        if (sensor.modes[i].framesize != FRAMESIZE_INVALID) {
+            frame_size = IM_MAX(frame_size, sensor.modes[i].frame_size);
+        }
+    }
+
+    frame_size = sensor_get_buffer_frame_size(frame_size);
+
+    if (MAIN_FB()->frame_size != frame_size) {
+        MAIN_FB()->frame_size = frame_size;
+        if (framebuffer_set_buffers(-1) != 0) {
+            return SENSOR_ERROR_FRAMEBUFFER_ERROR;
+        }
+    } else {
+        framebuffer_flush_buffers(true);
+    }
+
+    // Reconfigure the hardware if needed.
+    if (pixformat_changed && (sensor_config(SENSOR_CONFIG_PIXFORMAT) != 0)) {
+        return SENSOR_ERROR_CTL_FAILED;
+    }
+
+    if (framesize_changed && (sensor_config(SENSOR_CONFIG_FRAMESIZE) != 0)) {
+        return SENSOR_ERROR_CTL_FAILED;
+    }
+
+    if (window_changed && (sensor_config(SENSOR_CONFIG_WINDOWING) != 0)) {
+        return SENSOR_ERROR_CTL_FAILED;
+    }
+
+    if ((ret == 0) && mode->framerate) {
+        ret = sensor_set_framerate(mode->framerate);
+    }
+
+    return ret;
+}
+
+__weak int sensor_get_mode() {
+    for (int i = 0; i < SENSOR_MAX_MODES; i++) {
+        const sensor_mode_t *mode = &sensor.modes[i];
+        if ((mode->framesize != FRAMESIZE_INVALID) &&
+            (mode->framesize == sensor.framesize) &&
+            (mode->pixformat == sensor.pixformat) &&
+            (mode->x == MAIN_FB()->x) && (mode->y == MAIN_FB()->y) &&
+            (mode->w == MAIN_FB()->u) && (mode->h == MAIN_FB()->v)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 __weak void sensor_throttle_framerate() {
     if (!sensor.first_line) {
         sensor.first_line = true;
@@ -814,6 +1185,12 @@ __weak uint32_t sensor_get_dst_bpp() {
 }
 
 __weak int sensor_set_windowing(int x, int y, int w, int h) {
+    // Disable multi-ROI capture.
+    if (sensor.roi_list.count) {
+        sensor_abort(true, false);
+        sensor.roi_list.count = 0;
+    }
+
     // Check if the value has changed.
     if ((MAIN_FB()->x == x) && (MAIN_FB()->y == y) &&
         (MAIN_FB()->u == w) && (MAIN_FB()->v == h)) {
@@ -849,6 +1226,165 @@ __weak int sensor_set_windowing(int x, int y, int w, int h) {
     return sensor_config(SENSOR_CONFIG_WINDOWING);
 }
 
+__weak int sensor_set_rois(const rectangle_t *rois, uint32_t count, uint32_t decimation) {
+    sensor_roi_list_t *list = &sensor.roi_list;
+
+    if (sensor.framesize == FRAMESIZE_INVALID) {
+        return SENSOR_ERROR_INVALID_FRAMESIZE;
+    }
+
+    if ((count > SENSOR_ROI_MAX) || ((decimation != 1) && (decimation != 2) && (decimation != 4))) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Disable any ongoing frame capture.
+    sensor_abort(true, false);
+
+    // Flush previous frame.
+    framebuffer_update_jpeg_buffer();
+
+    int res_w = resolution[sensor.framesize][0];
+    int res_h = resolution[sensor.framesize][1];
+
+    if (count == 0) {
+        if (list->count) {
+            list->count = 0;
+            return sensor_set_windowing(0, 0, res_w, res_h);
+        }
+        return 0;
+    }
+
+    switch (sensor.pixformat) {
+        case PIXFORMAT_GRAYSCALE:
+            list->copy = (sensor.mono_bpp == 2) ? SENSOR_ROI_COPY_Y : SENSOR_ROI_COPY_8;
+            break;
+        case PIXFORMAT_RGB565:
+            #if !OMV_CSI_HW_SWAP_ENABLE
+            if (sensor.rgb_swap) {
+                list->copy = SENSOR_ROI_COPY_16_REV;
+                break;
+            }
+            #endif
+            list->copy = SENSOR_ROI_COPY_16;
+            break;
+        default:
+            return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
+    }
+
+    if (sensor.transpose || sensor.auto_rotation || sensor.line_callback) {
+        return SENSOR_ERROR_CTL_UNSUPPORTED;
+    }
+
+    // The captured window is the union of all ROIs.
+    int x0 = res_w, y0 = res_h, x1 = 0, y1 = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        const rectangle_t *r = &rois[i];
+        if ((r->x < 0) || (r->y < 0) || (r->w < (int) decimation) || (r->h < (int) decimation) ||
+            ((r->x + r->w) > res_w) || ((r->y + r->h) > res_h)) {
+            return SENSOR_ERROR_INVALID_WINDOW;
+        }
+        x0 = IM_MIN(x0, r->x);
+        y0 = IM_MIN(y0, r->y);
+        x1 = IM_MAX(x1, r->x + r->w);
+        y1 = IM_MAX(y1, r->y + r->h);
+    }
+
+    list->count = count;
+    list->decimation = decimation;
+    for (uint32_t i = 0; i < count; i++) {
+        list->rois[i].x = rois[i].x - x0;
+        list->rois[i].y = rois[i].y - y0;
+        list->rois[i].w = rois[i].w;
+        list->rois[i].h = rois[i].h;
+    }
+    sensor_roi_layout(list);
+
+    // Set the window to the union.
+    MAIN_FB()->x = x0;
+    MAIN_FB()->y = y0;
+    MAIN_FB()->w = MAIN_FB()->u = x1 - x0;
+    MAIN_FB()->h = MAIN_FB()->v = y1 - y0;
+    // Reset pixel format to skip the first frame.
+    MAIN_FB()->pixfmt = PIXFORMAT_INVALID;
+
+    // Auto-adjust the number of frame buffers.
+    if ((sensor_set_framebuffers(-1) != 0) || (list->size > framebuffer_get_buffer_size())) {
+        list->count = 0;
+        sensor_set_windowing(0, 0, res_w, res_h);
+        return SENSOR_ERROR_FRAMEBUFFER_OVERFLOW;
+    }
+
+    // Reconfigure the hardware if needed.
+    return sensor_config(SENSOR_CONFIG_WINDOWING);
+}
+
+__weak int sensor_set_line_callback(line_cb_t line_cb, pixformat_t pixfmt) {
+    // The line callback writes whole lines in capture order.
+    if (line_cb && (sensor.roi_list.count || sensor.transpose || sensor.auto_rotation)) {
+        return SENSOR_ERROR_CTL_UNSUPPORTED;
+    }
+
+    // Disable any ongoing frame capture.
+    sensor_abort(true, false);
+
+    // Flush previous frame.
+    framebuffer_update_jpeg_buffer();
+
+    sensor.line_callback = line_cb;
+    sensor.line_pixfmt = pixfmt;
+
+    // The histogram is only accumulated by the built-in line processing stages.
+    if (line_cb != sensor_isp_line_cb) {
+        sensor.isp.histogram = false;
+    }
+
+    // Reset pixel format to skip the first frame.
+    MAIN_FB()->pixfmt = PIXFORMAT_INVALID;
+
+    // Auto-adjust the number of frame buffers.
+    sensor_set_framebuffers(-1);
+    return 0;
+}
+
+__weak int sensor_set_isp(pixformat_t pixfmt, uint32_t lo, uint32_t hi, bool invert, bool histogram) {
+    if (pixfmt == PIXFORMAT_INVALID) {
+        if (sensor.line_callback == sensor_isp_line_cb) {
+            return sensor_set_line_callback(NULL, PIXFORMAT_INVALID);
+        }
+        return 0;
+    }
+
+    if ((lo > hi) || (hi > 255)) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!sensor_isp_supported(pixfmt)) {
+        return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
+    }
+
+    // Disable any ongoing frame capture.
+    sensor_abort(true, false);
+
+    sensor.isp.dst_pixfmt = pixfmt;
+    sensor.isp.threshold_lo = lo;
+    sensor.isp.threshold_hi = hi;
+    sensor.isp.invert = invert;
+    sensor.isp.histogram = histogram;
+    memset(sensor.isp.bins, 0, sizeof(sensor.isp.bins));
+
+    return sensor_set_line_callback(sensor_isp_line_cb, pixfmt);
+}
+
+__weak uint32_t sensor_get_line_frame_size() {
+    if (sensor.line_callback == sensor_isp_line_cb) {
+        return sensor_isp_frame_size(&sensor.isp, sensor_isp_src_pixfmt(), MAIN_FB()->u, MAIN_FB()->v);
+    }
+
+    image_t img = { .w = MAIN_FB()->u, .h = MAIN_FB()->v, .pixfmt = sensor.line_pixfmt };
+    return image_size(&img);
+}
+
 __weak int sensor_set_contrast(int level) {
     // Check if the control is supported.
     if (sensor.set_contrast == NULL) {
@@ -1134,6 +1670,11 @@ __weak int sensor_set_transpose(bool enable) {
         return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
     }
 
+    // Multi-ROI capture and the line callback don't support transposing.
+    if (enable && (sensor.roi_list.count || sensor.line_callback)) {
+        return SENSOR_ERROR_CTL_UNSUPPORTED;
+    }
+
     // Set the new control value.
     sensor.transpose = enable;
 
@@ -1158,6 +1699,11 @@ __weak int sensor_set_auto_rotation(bool enable) {
         return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
     }
 
+    // Multi-ROI capture and the line callback don't support transposing.
+    if (enable && (sensor.roi_list.count || sensor.line_callback)) {
+        return SENSOR_ERROR_CTL_UNSUPPORTED;
+    }
+
     // Set the new control value.
     sensor.auto_rotation = enable;
     return 0;
@@ -1184,10 +1730,11 @@ __weak int sensor_set_framebuffers(int count) {
 
     #if OMV_CSI_HW_CROP_ENABLE
     // If hardware cropping is supported, use window size.
-    MAIN_FB()->frame_size = MAIN_FB()->u * MAIN_FB()->v * 2;
+    MAIN_FB()->frame_size = sensor_get_buffer_frame_size(MAIN_FB()->u * MAIN_FB()->v * 2);
     #else
     // Otherwise, use the real frame size.
-    MAIN_FB()->frame_size = resolution[sensor.framesize][0] * resolution[sensor.framesize][1] * 2;
+    MAIN_FB()->frame_size = sensor_get_buffer_frame_size(resolution[sensor.framesize][0] *
+                                                         resolution[sensor.framesize][1] * 2);
     #endif
     return framebuffer_set_buffers(count);
 }
@@ -1270,6 +1817,9 @@ __weak const uint16_t *sensor_get_color_palette() {
 __weak int sensor_check_framebuffer_size() {
     uint32_t bpp = sensor_get_dst_bpp();
     uint32_t size = framebuffer_get_buffer_size();
+    if (sensor.line_callback) {
+        return ((sensor_get_line_frame_size() <= size) ? 0 : -1);
+    }
     return (((MAIN_FB()->u * MAIN_FB()->v * bpp) <= size) ? 0 : -1);
 }
 
@@ -1278,7 +1828,9 @@ __weak int sensor_auto_crop_framebuffer() {
     uint32_t size = framebuffer_get_buffer_size();
 
     // If the pixformat is NULL/JPEG there we can't do anything to check if it fits before hand.
-    if (!bpp) {
+    // The multi-ROI layout was checked when it was set, and the line callback output is
+    // checked by sensor_check_framebuffer_size() before capturing.
+    if (!bpp || sensor.roi_list.count || sensor.line_callback) {
         return 0;
     }
 
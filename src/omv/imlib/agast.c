@@ -22,12 +22,6 @@
 #define MAX_CORNERS      (2000u)
 #define Compare(X, Y)    ((X) >= (Y))
 
-typedef struct {
-    uint16_t x;
-    uint16_t y;
-    uint16_t score;
-} corner_t;
-
 static int s_width = -1;
 static int_fast16_t s_offset0;
 static int_fast16_t s_offset1;
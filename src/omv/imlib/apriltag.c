@@ -3500,12 +3500,21 @@ float matd_max(matd_t *m)
 
 matd_t *homography_compute(zarray_t *correspondences, int flags);
 
+// Fixed-size variant of homography_compute() for exactly four
+// correspondences (c[i] = { x0, x1, y0, y1 }). Returns false if the
+// points are degenerate. Allocates nothing.
+bool homography_compute4(const float c[4][4], float H[3][3]);
+
+// Fixed-size 3x3 helpers used by the detector (no heap, no matd_op).
+bool mat33_inverse(const float A[3][3], float Ainv[3][3]);
+void mat33_mul(const float A[3][3], const float B[3][3], float C[3][3]);
+
 //void homography_project(const matd_t *H, float x, float y, float *ox, float *oy);
-static inline void homography_project(const matd_t *H, float x, float y, float *ox, float *oy)
+static inline void homography_project(const float H[3][3], float x, float y, float *ox, float *oy)
 {
-    float xx = MATD_EL(H, 0, 0)*x + MATD_EL(H, 0, 1)*y + MATD_EL(H, 0, 2);
-    float yy = MATD_EL(H, 1, 0)*x + MATD_EL(H, 1, 1)*y + MATD_EL(H, 1, 2);
-    float zz = MATD_EL(H, 2, 0)*x + MATD_EL(H, 2, 1)*y + MATD_EL(H, 2, 2);
+    float xx = H[0][0]*x + H[0][1]*y + H[0][2];
+    float yy = H[1][0]*x + H[1][1]*y + H[1][2];
+    float zz = H[2][0]*x + H[2][1]*y + H[2][2];
 
     *ox = xx / zz;
     *oy = yy / zz;
@@ -3536,7 +3545,9 @@ static inline void homography_project(const matd_t *H, float x, float y, float *
 // R20 = H20
 // R21 = H21
 // TZ  = H22
-matd_t *homography_to_pose(const matd_t *H, float fx, float fy, float cx, float cy);
+//
+// The rotation is returned in R and the translation in T.
+void homography_to_pose(const float H[3][3], float fx, float fy, float cx, float cy, float R[3][3], float T[3]);
 
 // Similar to above
 // Recover the model view matrix assuming that the projection matrix is:
@@ -3764,6 +3775,140 @@ matd_t *homography_compute(zarray_t *correspondences, int flags)
     return H2;
 }
 
+bool homography_compute4(const float c[4][4], float H[3][3])
+{
+    // compute centroids of both sets of points (yields a better
+    // conditioned system)
+    float x_cx = 0, x_cy = 0;
+    float y_cx = 0, y_cy = 0;
+
+    for (int i = 0; i < 4; i++) {
+        x_cx += c[i][0];
+        x_cy += c[i][1];
+        y_cx += c[i][2];
+        y_cy += c[i][3];
+    }
+
+    x_cx *= 0.25f;
+    x_cy *= 0.25f;
+    y_cx *= 0.25f;
+    y_cy *= 0.25f;
+
+    // With h22 fixed to 1 each correspondence contributes two rows to
+    // an 8x8 system A*h = b, stored augmented as A[8][9].
+    float A[8][9];
+
+    for (int i = 0; i < 4; i++) {
+        float worldx = c[i][0] - x_cx;
+        float worldy = c[i][1] - x_cy;
+        float imagex = c[i][2] - y_cx;
+        float imagey = c[i][3] - y_cy;
+
+        float *r0 = A[i*2+0], *r1 = A[i*2+1];
+
+        r0[0] = worldx; r0[1] = worldy; r0[2] = 1;
+        r0[3] = 0;      r0[4] = 0;      r0[5] = 0;
+        r0[6] = -worldx*imagex; r0[7] = -worldy*imagex; r0[8] = imagex;
+
+        r1[0] = 0;      r1[1] = 0;      r1[2] = 0;
+        r1[3] = worldx; r1[4] = worldy; r1[5] = 1;
+        r1[6] = -worldx*imagey; r1[7] = -worldy*imagey; r1[8] = imagey;
+    }
+
+    // Gaussian elimination with partial pivoting.
+    for (int col = 0; col < 8; col++) {
+        int pivot = col;
+        float pivot_abs = fabsf(A[col][col]);
+
+        for (int row = col + 1; row < 8; row++) {
+            float v = fabsf(A[row][col]);
+            if (v > pivot_abs) {
+                pivot = row;
+                pivot_abs = v;
+            }
+        }
+
+        if (pivot_abs < MATD_EPS)
+            return false;
+
+        if (pivot != col) {
+            for (int k = col; k < 9; k++) {
+                float tmp = A[col][k];
+                A[col][k] = A[pivot][k];
+                A[pivot][k] = tmp;
+            }
+        }
+
+        float inv = 1.0f / A[col][col];
+
+        for (int row = col + 1; row < 8; row++) {
+            float f = A[row][col] * inv;
+            if (f == 0)
+                continue;
+            for (int k = col + 1; k < 9; k++)
+                A[row][k] -= f * A[col][k];
+        }
+    }
+
+    float h[9];
+    h[8] = 1;
+
+    for (int row = 7; row >= 0; row--) {
+        float acc = A[row][8];
+        for (int k = row + 1; k < 8; k++)
+            acc -= A[row][k] * h[k];
+        h[row] = acc / A[row][row];
+    }
+
+    // Undo the centroid shift: H = Ty * Hn * Tx
+    for (int i = 0; i < 3; i++) {
+        float r0 = h[i*3+0], r1 = h[i*3+1];
+        H[i][0] = r0;
+        H[i][1] = r1;
+        H[i][2] = h[i*3+2] - r0*x_cx - r1*x_cy;
+    }
+
+    for (int j = 0; j < 3; j++) {
+        H[0][j] += y_cx * H[2][j];
+        H[1][j] += y_cy * H[2][j];
+    }
+
+    return true;
+}
+
+bool mat33_inverse(const float A[3][3], float Ainv[3][3])
+{
+    float c00 = A[1][1]*A[2][2] - A[1][2]*A[2][1];
+    float c01 = A[1][2]*A[2][0] - A[1][0]*A[2][2];
+    float c02 = A[1][0]*A[2][1] - A[1][1]*A[2][0];
+
+    float det = A[0][0]*c00 + A[0][1]*c01 + A[0][2]*c02;
+
+    if (fabsf(det) < MATD_EPS)
+        return false;
+
+    float inv = 1.0f / det;
+
+    Ainv[0][0] = c00 * inv;
+    Ainv[1][0] = c01 * inv;
+    Ainv[2][0] = c02 * inv;
+    Ainv[0][1] = (A[0][2]*A[2][1] - A[0][1]*A[2][2]) * inv;
+    Ainv[1][1] = (A[0][0]*A[2][2] - A[0][2]*A[2][0]) * inv;
+    Ainv[2][1] = (A[0][1]*A[2][0] - A[0][0]*A[2][1]) * inv;
+    Ainv[0][2] = (A[0][1]*A[1][2] - A[0][2]*A[1][1]) * inv;
+    Ainv[1][2] = (A[0][2]*A[1][0] - A[0][0]*A[1][2]) * inv;
+    Ainv[2][2] = (A[0][0]*A[1][1] - A[0][1]*A[1][0]) * inv;
+
+    return true;
+}
+
+void mat33_mul(const float A[3][3], const float B[3][3], float C[3][3])
+{
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            C[i][j] = A[i][0]*B[0][j] + A[i][1]*B[1][j] + A[i][2]*B[2][j];
+}
+
 
 // assuming that the projection matrix is:
 // [ fx 0  cx 0 ]
@@ -3792,18 +3937,79 @@ matd_t *homography_compute(zarray_t *correspondences, int flags)
 // R21 = H21
 // TZ  = H22
 
-matd_t *homography_to_pose(const matd_t *H, float fx, float fy, float cx, float cy)
+// Nearest rotation to an (almost orthonormal) 3x3 matrix via the Newton
+// iteration for the polar decomposition, R <- (R + R^-T) / 2. Starting
+// from a matrix with positive determinant this converges quadratically
+// to the same U*V' the SVD would give.
+static void mat33_orthonormalize(float R[3][3])
+{
+    for (int iter = 0; iter < 8; iter++) {
+        float Rinv[3][3];
+
+        if (!mat33_inverse(R, Rinv))
+            return;
+
+        float change = 0;
+
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                float v = 0.5f * (R[i][j] + Rinv[j][i]);
+                change += fabsf(v - R[i][j]);
+                R[i][j] = v;
+            }
+        }
+
+        if (change < 1e-6f)
+            return;
+    }
+}
+
+// Nearest matrix with orthonormal columns to the 3x2 matrix in the first
+// two columns of M (M2 * (M2' * M2)^-1/2), completed to a proper rotation
+// with their cross product. Closed form; the 2x2 inverse square root
+// does not need an eigen-decomposition.
+static bool mat33_procrustes_planar(const float M[3][3], float R[3][3])
+{
+    float a = M[0][0]*M[0][0] + M[1][0]*M[1][0] + M[2][0]*M[2][0];
+    float b = M[0][0]*M[0][1] + M[1][0]*M[1][1] + M[2][0]*M[2][1];
+    float d = M[0][1]*M[0][1] + M[1][1]*M[1][1] + M[2][1]*M[2][1];
+
+    float det = a*d - b*b;
+
+    if (det < MATD_EPS)
+        return false;
+
+    // sqrt(S) = (S + sqrt(det(S)) I) / sqrt(tr(S) + 2 sqrt(det(S)))
+    float sd = sqrtf(det);
+    float t = sqrtf(a + d + 2*sd);
+    float s00 = (a + sd) / t, s01 = b / t, s11 = (d + sd) / t;
+    float sdet = s00*s11 - s01*s01;
+    float i00 = s11 / sdet, i01 = -s01 / sdet, i11 = s00 / sdet;
+
+    for (int i = 0; i < 3; i++) {
+        float m0 = M[i][0], m1 = M[i][1];
+        R[i][0] = m0*i00 + m1*i01;
+        R[i][1] = m0*i01 + m1*i11;
+    }
+
+    R[0][2] = R[1][0]*R[2][1] - R[2][0]*R[1][1];
+    R[1][2] = R[2][0]*R[0][1] - R[0][0]*R[2][1];
+    R[2][2] = R[0][0]*R[1][1] - R[1][0]*R[0][1];
+    return true;
+}
+
+void homography_to_pose(const float H[3][3], float fx, float fy, float cx, float cy, float R[3][3], float T[3])
 {
     // Note that every variable that we compute is proportional to the scale factor of H.
-    float R20 = MATD_EL(H, 2, 0);
-    float R21 = MATD_EL(H, 2, 1);
-    float TZ  = MATD_EL(H, 2, 2);
-    float R00 = (MATD_EL(H, 0, 0) - cx*R20) / fx;
-    float R01 = (MATD_EL(H, 0, 1) - cx*R21) / fx;
-    float TX  = (MATD_EL(H, 0, 2) - cx*TZ)  / fx;
-    float R10 = (MATD_EL(H, 1, 0) - cy*R20) / fy;
-    float R11 = (MATD_EL(H, 1, 1) - cy*R21) / fy;
-    float TY  = (MATD_EL(H, 1, 2) - cy*TZ)  / fy;
+    float R20 = H[2][0];
+    float R21 = H[2][1];
+    float TZ  = H[2][2];
+    float R00 = (H[0][0] - cx*R20) / fx;
+    float R01 = (H[0][1] - cx*R21) / fx;
+    float TX  = (H[0][2] - cx*TZ)  / fx;
+    float R10 = (H[1][0] - cy*R20) / fy;
+    float R11 = (H[1][1] - cy*R21) / fy;
+    float TY  = (H[1][2] - cy*TZ)  / fy;
 
     // compute the scale by requiring that the rotation columns are unit length
     // (Use geometric average of the two length vectors we have)
@@ -3816,57 +4022,111 @@ matd_t *homography_to_pose(const matd_t *H, float fx, float fy, float cx, float
     if (TZ > 0)
         s *= -1;
 
-    R20 *= s;
-    R21 *= s;
-    TZ  *= s;
-    R00 *= s;
-    R01 *= s;
-    TX  *= s;
-    R10 *= s;
-    R11 *= s;
-    TY  *= s;
+    R[0][0] = R00 * s;
+    R[0][1] = R01 * s;
+    R[1][0] = R10 * s;
+    R[1][1] = R11 * s;
+    R[2][0] = R20 * s;
+    R[2][1] = R21 * s;
+    T[0] = TX * s;
+    T[1] = TY * s;
+    T[2] = TZ * s;
 
     // now recover [R02 R12 R22] by noting that it is the cross product of the other two columns.
-    float R02 = R10*R21 - R20*R11;
-    float R12 = R20*R01 - R00*R21;
-    float R22 = R00*R11 - R10*R01;
+    R[0][2] = R[1][0]*R[2][1] - R[2][0]*R[1][1];
+    R[1][2] = R[2][0]*R[0][1] - R[0][0]*R[2][1];
+    R[2][2] = R[0][0]*R[1][1] - R[1][0]*R[0][1];
 
-    // Improve rotation matrix by applying polar decomposition.
-    if (1) {
-        // do polar decomposition. This makes the rotation matrix
-        // "proper", but probably increases the reprojection error. An
-        // iterative alignment step would be superior.
+    // Make the rotation matrix "proper" (polar decomposition).
+    mat33_orthonormalize(R);
 
-        matd_t *R = matd_create_data(3, 3, (float[]) { R00, R01, R02,
-                                                       R10, R11, R12,
-                                                       R20, R21, R22 });
+    // The polar decomposition increases the reprojection error, so refine
+    // R and T with a few steps of orthogonal iteration (Lu, Hager and
+    // Mjolsness) on the four tag corners. Each step is a closed-form
+    // translation update followed by a planar Procrustes rotation update.
+    float p[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+    float F[4][3][3], Fsum[3][3] = { { 0 } };
 
-        matd_svd_t svd = matd_svd(R);
-        matd_destroy(R);
+    for (int i = 0; i < 4; i++) {
+        float px, py;
+        homography_project(H, p[i][0], p[i][1], &px, &py);
 
-        R = matd_op("M*M'", svd.U, svd.V);
+        // line of sight projection matrix F = v*v' / (v'*v)
+        float v[3] = { (px - cx) / fx, (py - cy) / fy, 1 };
+        float vv = 1.0f / (v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
 
-        matd_destroy(svd.U);
-        matd_destroy(svd.S);
-        matd_destroy(svd.V);
+        for (int j = 0; j < 3; j++) {
+            for (int k = 0; k < 3; k++) {
+                F[i][j][k] = v[j] * v[k] * vv;
+                Fsum[j][k] += F[i][j][k] * 0.25f;
+            }
+        }
+    }
 
-        R00 = MATD_EL(R, 0, 0);
-        R01 = MATD_EL(R, 0, 1);
-        R02 = MATD_EL(R, 0, 2);
-        R10 = MATD_EL(R, 1, 0);
-        R11 = MATD_EL(R, 1, 1);
-        R12 = MATD_EL(R, 1, 2);
-        R20 = MATD_EL(R, 2, 0);
-        R21 = MATD_EL(R, 2, 1);
-        R22 = MATD_EL(R, 2, 2);
+    // Tfactor = (I - mean(F))^-1 / n
+    float Tfactor[3][3];
 
-        matd_destroy(R);
+    for (int j = 0; j < 3; j++) {
+        for (int k = 0; k < 3; k++) {
+            Fsum[j][k] = ((j == k) ? 1 : 0) - Fsum[j][k];
+        }
     }
 
-    return matd_create_data(4, 4, (float[]) { R00, R01, R02, TX,
-                                               R10, R11, R12, TY,
-                                               R20, R21, R22, TZ,
-                                                0, 0, 0, 1 });
+    if (!mat33_inverse(Fsum, Tfactor))
+        return;
+
+    for (int iter = 0; iter < 4; iter++) {
+        // T = Tfactor * sum((F_i - I) * R * p_i)
+        float Rp[4][3], acc[3] = { 0, 0, 0 };
+
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 3; j++)
+                Rp[i][j] = R[j][0]*p[i][0] + R[j][1]*p[i][1];
+            for (int j = 0; j < 3; j++)
+                acc[j] += F[i][j][0]*Rp[i][0] + F[i][j][1]*Rp[i][1] + F[i][j][2]*Rp[i][2] - Rp[i][j];
+        }
+
+        for (int j = 0; j < 3; j++)
+            T[j] = 0.25f * (Tfactor[j][0]*acc[0] + Tfactor[j][1]*acc[1] + Tfactor[j][2]*acc[2]);
+
+        // q_i = F_i * (R * p_i + T), then fit R to (p_i, q_i). The mean of
+        // the p_i is zero so only the q_i need centering.
+        float q[4][3], qmean[3] = { 0, 0, 0 };
+
+        for (int i = 0; i < 4; i++) {
+            float x[3] = { Rp[i][0] + T[0], Rp[i][1] + T[1], Rp[i][2] + T[2] };
+            for (int j = 0; j < 3; j++) {
+                q[i][j] = F[i][j][0]*x[0] + F[i][j][1]*x[1] + F[i][j][2]*x[2];
+                qmean[j] += q[i][j] * 0.25f;
+            }
+        }
+
+        float M[3][3] = { { 0 } };
+
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 3; j++) {
+                M[j][0] += (q[i][j] - qmean[j]) * p[i][0];
+                M[j][1] += (q[i][j] - qmean[j]) * p[i][1];
+            }
+        }
+
+        if (!mat33_procrustes_planar(M, R))
+            break;
+    }
+
+    // final translation for the refined rotation
+    float acc[3] = { 0, 0, 0 };
+
+    for (int i = 0; i < 4; i++) {
+        float Rp[3];
+        for (int j = 0; j < 3; j++)
+            Rp[j] = R[j][0]*p[i][0] + R[j][1]*p[i][1];
+        for (int j = 0; j < 3; j++)
+            acc[j] += F[i][j][0]*Rp[0] + F[i][j][1]*Rp[1] + F[i][j][2]*Rp[2] - Rp[j];
+    }
+
+    for (int j = 0; j < 3; j++)
+        T[j] = 0.25f * (Tfactor[j][0]*acc[0] + Tfactor[j][1]*acc[1] + Tfactor[j][2]*acc[2]);
 }
 
 // Similar to above
@@ -5111,7 +5371,7 @@ struct quad
 
     // H: tag coordinates ([-1,1] at the black corners) to pixels
     // Hinv: pixels to tag
-    matd_t *H, *Hinv;
+    float H[3][3], Hinv[3][3];
 };
 
 // Represents a tag family. Every tag belongs to a tag family. Tag
@@ -5219,6 +5479,9 @@ struct apriltag_detector
     // between multiple users. The user should ultimately destroy the
     // tag family passed into the constructor.
     zarray_t *tag_families;
+
+    // Code lookup tables, one per tag family (struct quick_decode*).
+    zarray_t *quick_decodes;
 };
 
 // Represents the detection of a tag. These are returned to the user
@@ -5254,9 +5517,8 @@ struct apriltag_detection
 
     // The 3x3 homography matrix describing the projection from an
     // "ideal" tag (with corners at (-1,-1), (1,-1), (1,1), and (-1,
-    // 1)) to pixels in the image. This matrix will be freed by
-    // apriltag_detection_destroy.
-    matd_t *H;
+    // 1)) to pixels in the image.
+    float H[3][3];
 
     // The center of the detection in image pixel coordinates.
     float c[2];
@@ -10838,10 +11100,27 @@ struct quick_decode_entry
     bool vflip;
 };
 
+// The codes are split into (threshold + 1) chunks. A code with at most threshold bit errors
+// matches the original code exactly in at least one chunk, so each chunk value is indexed in a
+// bucket table and only the codes in the matching buckets have to be compared. The threshold is
+// capped so that there is always one chunk more than the bit errors corrected.
+#define QUICK_DECODE_MAX_CHUNKS 8
+#define QUICK_DECODE_NIBBLES 16
+
 struct quick_decode
 {
-    int nentries;
-    struct quick_decode_entry *entries;
+    apriltag_family_t *family;
+    int threshold;
+    int nchunks;
+    uint8_t chunk_shift[QUICK_DECODE_MAX_CHUNKS];
+    uint64_t chunk_mask[QUICK_DECODE_MAX_CHUNKS];
+    uint32_t bucket_mask;
+    uint16_t *buckets; // nchunks * (bucket_mask + 2) offsets into ids.
+    uint16_t *ids;     // nchunks * ncodes code indices ordered by bucket.
+
+    // Bit permutation tables, the rotated code is the OR of one entry per nibble.
+    uint64_t rotate90[QUICK_DECODE_NIBBLES][16];
+    uint64_t hmirror[QUICK_DECODE_NIBBLES][16];
 };
 
 /** if the bits in w were arranged in a d*d grid and that grid was
@@ -10888,31 +11167,11 @@ static uint64_t hmirror_code(uint64_t w, uint32_t d)
     return wr;
 }
 
-static uint64_t vflip_code(uint64_t w, uint32_t d)
-{
-    uint64_t wr = 0;
-
-    for (int32_t r = 0; r < d; r++) {
-        for (int32_t c = d-1; c >=0; c--) {
-            int32_t b = c + d*r;
-
-            wr = wr << 1;
-
-            if ((w & (((uint64_t) 1) << b))!=0)
-                wr |= 1;
-        }
-    }
-
-    return wr;
-}
-
 void quad_destroy(struct quad *quad)
 {
     if (!quad)
         return;
 
-    matd_destroy(quad->H);
-    matd_destroy(quad->Hinv);
     free(quad);
 }
 
@@ -10920,10 +11179,6 @@ struct quad *quad_copy(struct quad *quad)
 {
     struct quad *q = calloc(1, sizeof(struct quad));
     memcpy(q, quad, sizeof(struct quad));
-    if (quad->H)
-        q->H = matd_copy(quad->H);
-    if (quad->Hinv)
-        q->Hinv = matd_copy(quad->Hinv);
     return q;
 }
 
@@ -10979,88 +11234,134 @@ int popcount64c(uint64_t x)
     return (x * h01) >> 56;  //returns left 8 bits of x + (x<<8) + (x<<16) + (x<<24) + ...
 }
 
-// returns an entry with hamming set to 255 if no decode was found.
-static void quick_decode_codeword(apriltag_family_t *tf, uint64_t rcode,
-                                  struct quick_decode_entry *entry)
+static struct quick_decode *quick_decode_create(apriltag_family_t *tf)
 {
-    int threshold = imax(tf->h - tf->d - 1, 0);
+    struct quick_decode *qd = calloc(1, sizeof(struct quick_decode));
+    int nbits = tf->d * tf->d;
 
-    for (int ridx = 0; ridx < 4; ridx++) {
+    qd->family = tf;
+    qd->threshold = imin(imax(tf->h - tf->d - 1, 0), QUICK_DECODE_MAX_CHUNKS - 1);
+    qd->nchunks = qd->threshold + 1;
 
-        for (int i = 0, j = tf->ncodes; i < j; i++) {
-            int hamming = popcount64c(tf->codes[i] ^ rcode);
-            if(hamming <= threshold) {
-                entry->rcode = rcode;
-                entry->id = i;
-                entry->hamming = hamming;
-                entry->rotation = ridx;
-                entry->hmirror = false;
-                entry->vflip = false;
-                return;
-            }
-        }
+    for (int k = 0; k < qd->nchunks; k++) {
+        int lo = (k * nbits) / qd->nchunks, hi = ((k + 1) * nbits) / qd->nchunks;
+        qd->chunk_shift[k] = lo;
+        qd->chunk_mask[k] = (((uint64_t) 1) << (hi - lo)) - 1;
+    }
 
-        rcode = rotate90(rcode, tf->d);
+    // About one code per bucket.
+    uint32_t nbuckets = 1;
+    while (nbuckets < tf->ncodes) {
+        nbuckets <<= 1;
     }
 
-    rcode = hmirror_code(rcode, tf->d); // handle hmirror
+    qd->bucket_mask = nbuckets - 1;
+    qd->buckets = calloc(qd->nchunks * (nbuckets + 1), sizeof(uint16_t));
+    qd->ids = malloc(qd->nchunks * tf->ncodes * sizeof(uint16_t));
 
-    for (int ridx = 0; ridx < 4; ridx++) {
+    for (int k = 0; k < qd->nchunks; k++) {
+        uint16_t *buckets = qd->buckets + (k * (nbuckets + 1));
+        uint16_t *ids = qd->ids + (k * tf->ncodes);
 
-        for (int i = 0, j = tf->ncodes; i < j; i++) {
-            int hamming = popcount64c(tf->codes[i] ^ rcode);
-            if(hamming <= threshold) {
-                entry->rcode = rcode;
-                entry->id = i;
-                entry->hamming = hamming;
-                entry->rotation = ridx;
-                entry->hmirror = true;
-                entry->vflip = false;
-                return;
-            }
+        // Counting sort of the code indices by bucket.
+        for (int i = 0; i < tf->ncodes; i++) {
+            buckets[((tf->codes[i] >> qd->chunk_shift[k]) & qd->chunk_mask[k] & qd->bucket_mask) + 1] += 1;
         }
 
-        rcode = rotate90(rcode, tf->d);
+        for (int b = 0; b < nbuckets; b++) {
+            buckets[b + 1] += buckets[b];
+        }
+
+        for (int i = 0; i < tf->ncodes; i++) {
+            ids[buckets[(tf->codes[i] >> qd->chunk_shift[k]) & qd->chunk_mask[k] & qd->bucket_mask]++] = i;
+        }
+
+        // Filling moved each offset to the start of the next bucket.
+        for (int b = nbuckets; b > 0; b--) {
+            buckets[b] = buckets[b - 1];
+        }
+
+        buckets[0] = 0;
     }
 
-    rcode = vflip_code(rcode, tf->d); // handle hmirror+vflip
+    for (int n = 0; (n * 4) < nbits; n++) {
+        for (int v = 0; v < 16; v++) {
+            qd->rotate90[n][v] = rotate90(((uint64_t) v) << (n * 4), tf->d);
+            qd->hmirror[n][v] = hmirror_code(((uint64_t) v) << (n * 4), tf->d);
+        }
+    }
 
-    for (int ridx = 0; ridx < 4; ridx++) {
+    return qd;
+}
 
-        for (int i = 0, j = tf->ncodes; i < j; i++) {
-            int hamming = popcount64c(tf->codes[i] ^ rcode);
-            if(hamming <= threshold) {
-                entry->rcode = rcode;
-                entry->id = i;
-                entry->hamming = hamming;
-                entry->rotation = ridx;
-                entry->hmirror = true;
-                entry->vflip = true;
-                return;
+static void quick_decode_destroy(struct quick_decode *qd)
+{
+    free(qd->buckets);
+    free(qd->ids);
+    free(qd);
+}
+
+static inline uint64_t quick_decode_permute(uint64_t table[QUICK_DECODE_NIBBLES][16], uint64_t w)
+{
+    uint64_t wr = 0;
+
+    for (int n = 0; w; n++, w >>= 4) {
+        wr |= table[n][w & 0xF];
+    }
+
+    return wr;
+}
+
+// returns the index of the code within threshold bits of rcode or -1.
+static int quick_decode_lookup(struct quick_decode *qd, uint64_t rcode, int *hamming)
+{
+    apriltag_family_t *tf = qd->family;
+    uint32_t nbuckets = qd->bucket_mask + 1;
+
+    for (int k = 0; k < qd->nchunks; k++) {
+        uint16_t *buckets = qd->buckets + (k * (nbuckets + 1));
+        uint16_t *ids = qd->ids + (k * tf->ncodes);
+        uint32_t b = (rcode >> qd->chunk_shift[k]) & qd->chunk_mask[k] & qd->bucket_mask;
+
+        for (int i = buckets[b], j = buckets[b + 1]; i < j; i++) {
+            int h = popcount64c(tf->codes[ids[i]] ^ rcode);
+            if (h <= qd->threshold) {
+                *hamming = h;
+                return ids[i];
             }
         }
-
-        rcode = rotate90(rcode, tf->d);
     }
 
-    rcode = hmirror_code(rcode, tf->d); // handle vflip
+    return -1;
+}
 
-    for (int ridx = 0; ridx < 4; ridx++) {
+// returns an entry with hamming set to 255 if no decode was found.
+//
+// Only the 4 rotations of the code and of its mirror image are checked. Flipping both ways is
+// the same as rotating by 180 degrees and flipping vertically is the same as mirroring and
+// rotating by 180 degrees. Since codes differ by more than twice the threshold the match is
+// unique.
+static void quick_decode_codeword(struct quick_decode *qd, uint64_t rcode,
+                                  struct quick_decode_entry *entry)
+{
+    for (int mirror = 0; mirror < 2; mirror++) {
+        for (int ridx = 0; ridx < 4; ridx++) {
+            int hamming, id = quick_decode_lookup(qd, rcode, &hamming);
 
-        for (int i = 0, j = tf->ncodes; i < j; i++) {
-            int hamming = popcount64c(tf->codes[i] ^ rcode);
-            if(hamming <= threshold) {
+            if (id >= 0) {
                 entry->rcode = rcode;
-                entry->id = i;
+                entry->id = id;
                 entry->hamming = hamming;
                 entry->rotation = ridx;
-                entry->hmirror = false;
-                entry->vflip = true;
+                entry->hmirror = mirror;
+                entry->vflip = false;
                 return;
             }
+
+            rcode = quick_decode_permute(qd->rotate90, rcode);
         }
 
-        rcode = rotate90(rcode, tf->d);
+        rcode = quick_decode_permute(qd->hmirror, rcode); // handle hmirror
     }
 
     entry->rcode = 0;
@@ -11081,16 +11382,37 @@ static inline int detection_compare_function(const void *_a, const void *_b)
 
 void apriltag_detector_remove_family(apriltag_detector_t *td, apriltag_family_t *fam)
 {
-    zarray_remove_value(td->tag_families, &fam, 0);
+    for (int i = 0; i < zarray_size(td->tag_families); i++) {
+        apriltag_family_t *family;
+        zarray_get(td->tag_families, i, &family);
+
+        if (family == fam) {
+            struct quick_decode *qd;
+            zarray_get(td->quick_decodes, i, &qd);
+            quick_decode_destroy(qd);
+            zarray_remove_index(td->quick_decodes, i, 0);
+            zarray_remove_index(td->tag_families, i, 0);
+            break;
+        }
+    }
 }
 
 void apriltag_detector_add_family_bits(apriltag_detector_t *td, apriltag_family_t *fam, int bits_corrected)
 {
+    struct quick_decode *qd = quick_decode_create(fam);
     zarray_add(td->tag_families, &fam);
+    zarray_add(td->quick_decodes, &qd);
 }
 
 void apriltag_detector_clear_families(apriltag_detector_t *td)
 {
+    for (int i = 0; i < zarray_size(td->quick_decodes); i++) {
+        struct quick_decode *qd;
+        zarray_get(td->quick_decodes, i, &qd);
+        quick_decode_destroy(qd);
+    }
+
+    zarray_clear(td->quick_decodes);
     zarray_clear(td->tag_families);
 }
 
@@ -11107,6 +11429,7 @@ apriltag_detector_t *apriltag_detector_create()
     td->qtp.min_white_black_diff = 5;
 
     td->tag_families = zarray_create(sizeof(apriltag_family_t*));
+    td->quick_decodes = zarray_create(sizeof(struct quick_decode*));
 
     td->refine_edges = 1;
     td->refine_pose = 0;
@@ -11120,6 +11443,7 @@ void apriltag_detector_destroy(apriltag_detector_t *td)
     apriltag_detector_clear_families(td);
 
     zarray_destroy(td->tag_families);
+    zarray_destroy(td->quick_decodes);
     free(td);
 }
 
@@ -11136,36 +11460,22 @@ struct evaluate_quad_ret
 // returns non-zero if an error occurs (i.e., H has no inverse)
 int quad_update_homographies(struct quad *quad)
 {
-    zarray_t *correspondences = zarray_create(sizeof(float[4]));
+    float corr[4][4];
 
     for (int i = 0; i < 4; i++) {
-        float corr[4];
-
         // At this stage of the pipeline, we have not attempted to decode the
         // quad into an oriented tag. Thus, just act as if the quad is facing
         // "up" with respect to our desired corners. We'll fix the rotation
         // later.
         // [-1, -1], [1, -1], [1, 1], [-1, 1]
-        corr[0] = (i==0 || i==3) ? -1 : 1;
-        corr[1] = (i==0 || i==1) ? -1 : 1;
-
-        corr[2] = quad->p[i][0];
-        corr[3] = quad->p[i][1];
+        corr[i][0] = (i==0 || i==3) ? -1 : 1;
+        corr[i][1] = (i==0 || i==1) ? -1 : 1;
 
-        zarray_add(correspondences, &corr);
+        corr[i][2] = quad->p[i][0];
+        corr[i][3] = quad->p[i][1];
     }
 
-    if (quad->H)
-        matd_destroy(quad->H);
-    if (quad->Hinv)
-        matd_destroy(quad->Hinv);
-
-    // XXX Tunable
-    quad->H = homography_compute(correspondences, HOMOGRAPHY_COMPUTE_FLAG_SVD);
-    quad->Hinv = matd_inverse(quad->H);
-    zarray_destroy(correspondences);
-
-    if (quad->H && quad->Hinv)
+    if (homography_compute4(corr, quad->H) && mat33_inverse(quad->H, quad->Hinv))
         return 0;
 
     return -1;
@@ -11215,8 +11525,7 @@ float quad_goodness(apriltag_family_t *family, image_u8_t *im, struct quad *quad
     float wsz = bit_size*white_border;
     float bsz = bit_size*family->black_border;
 
-    matd_t *Hinv = quad->Hinv;
-//    matd_t *H = quad->H;
+    const float (*Hinv)[3] = quad->Hinv;
 
     // iterate over all the pixels in the tag. (Iterating in pixel space)
     for (int y = ymin; y <= ymax; y++) {
@@ -11225,12 +11534,12 @@ float quad_goodness(apriltag_family_t *family, image_u8_t *im, struct quad *quad
         // projections. Begin by evaluating the homogeneous position
         // [(xmin - .5f), y, 1]. Then, we'll update as we stride in
         // the +x direction.
-        float Hx = MATD_EL(Hinv, 0, 0) * (.5 + (int) xmin) +
-            MATD_EL(Hinv, 0, 1) * (y + .5) + MATD_EL(Hinv, 0, 2);
-        float Hy = MATD_EL(Hinv, 1, 0) * (.5 + (int) xmin) +
-            MATD_EL(Hinv, 1, 1) * (y + .5) + MATD_EL(Hinv, 1, 2);
-        float Hh = MATD_EL(Hinv, 2, 0) * (.5 + (int) xmin) +
-            MATD_EL(Hinv, 2, 1) * (y + .5) + MATD_EL(Hinv, 2, 2);
+        float Hx = Hinv[0][0] * (.5 + (int) xmin) +
+            Hinv[0][1] * (y + .5) + Hinv[0][2];
+        float Hy = Hinv[1][0] * (.5 + (int) xmin) +
+            Hinv[1][1] * (y + .5) + Hinv[1][2];
+        float Hh = Hinv[2][0] * (.5 + (int) xmin) +
+            Hinv[2][1] * (y + .5) + Hinv[2][2];
 
         for (int x = xmin; x <= xmax;  x++) {
             // project the pixel center.
@@ -11242,9 +11551,9 @@ float quad_goodness(apriltag_family_t *family, image_u8_t *im, struct quad *quad
 
             // if we move x one pixel to the right, here's what
             // happens to our three pre-normalized coordinates.
-            Hx += MATD_EL(Hinv, 0, 0);
-            Hy += MATD_EL(Hinv, 1, 0);
-            Hh += MATD_EL(Hinv, 2, 0);
+            Hx += Hinv[0][0];
+            Hy += Hinv[1][0];
+            Hh += Hinv[2][0];
 
             float txa = fabsf((float) tx), tya = fabsf((float) ty);
             float xymax = fmaxf(txa, tya);
@@ -11285,8 +11594,10 @@ float quad_goodness(apriltag_family_t *family, image_u8_t *im, struct quad *quad
 }
 
 // returns the decision margin. Return < 0 if the detection should be rejected.
-float quad_decode(apriltag_family_t *family, image_u8_t *im, struct quad *quad, struct quick_decode_entry *entry, image_u8_t *im_samples)
+float quad_decode(struct quick_decode *qd, image_u8_t *im, struct quad *quad, struct quick_decode_entry *entry, image_u8_t *im_samples)
 {
+    apriltag_family_t *family = qd->family;
+
     // decode the tag binary contents by sampling the pixel
     // closest to the center of each bit cell.
 
@@ -11438,7 +11749,7 @@ float quad_decode(apriltag_family_t *family, image_u8_t *im, struct quad *quad,
             im_samples->buf[iy*im_samples->stride + ix] = (1 - (rcode & 1)) * 255;
     }
 
-    quick_decode_codeword(family, rcode, entry);
+    quick_decode_codeword(qd, rcode, entry);
 
     return fmin(white_score / white_score_count, black_score / black_score_count);
 }
@@ -11452,7 +11763,7 @@ float score_decodability(apriltag_family_t *family, image_u8_t *im, struct quad
 {
     struct quick_decode_entry entry;
 
-    float decision_margin = quad_decode(family, im, quad, &entry, NULL);
+    float decision_margin = quad_decode((struct quick_decode *) user, im, quad, &entry, NULL);
 
     // hamming trumps decision margin; maximum value for decision_margin is 255.
     return decision_margin - entry.hamming*1000;
@@ -11501,8 +11812,10 @@ float optimize_quad_generic(apriltag_family_t *family, image_u8_t *im, struct qu
                         struct quad *this_quad = quad_copy(best_quad);
                         this_quad->p[i][0] = best_quad->p[i][0] + sx*stepsize;
                         this_quad->p[i][1] = best_quad->p[i][1] + sy*stepsize;
-                        if (quad_update_homographies(this_quad))
+                        if (quad_update_homographies(this_quad)) {
+                            quad_destroy(this_quad);
                             continue;
+                        }
 
                         float this_score = score(family, im, this_quad, user);
 
@@ -11527,9 +11840,7 @@ float optimize_quad_generic(apriltag_family_t *family, image_u8_t *im, struct qu
         }
     }
 
-    matd_destroy(quad0->H);
-    matd_destroy(quad0->Hinv);
-    memcpy(quad0, best_quad, sizeof(struct quad)); // copy pointers
+    memcpy(quad0, best_quad, sizeof(struct quad));
     free(best_quad);
     return best_score;
 }
@@ -11681,7 +11992,6 @@ void apriltag_detection_destroy(apriltag_detection_t *det)
     if (det == NULL)
         return;
 
-    matd_destroy(det->H);
     free(det);
 }
 
@@ -11740,6 +12050,9 @@ zarray_t *apriltag_detector_detect(apriltag_detector_t *td, image_u8_t *im_orig)
                 apriltag_family_t *family;
                 zarray_get(td->tag_families, famidx, &family);
 
+                struct quick_decode *qd;
+                zarray_get(td->quick_decodes, famidx, &qd);
+
                 float goodness = 0;
 
                 // since the geometry of tag families can vary, start any
@@ -11769,12 +12082,12 @@ zarray_t *apriltag_detector_detect(apriltag_detector_t *td, image_u8_t *im_orig)
                     float stepsizes[] = { .4 };
                     int nstepsizes = sizeof(stepsizes)/sizeof(float);
 
-                    optimize_quad_generic(family, im_orig, quad, stepsizes, nstepsizes, score_decodability, NULL);
+                    optimize_quad_generic(family, im_orig, quad, stepsizes, nstepsizes, score_decodability, qd);
                 }
 
                 struct quick_decode_entry entry;
 
-                float decision_margin = quad_decode(family, im_orig, quad, &entry, NULL);
+                float decision_margin = quad_decode(qd, im_orig, quad, &entry, NULL);
 
                 if (entry.hamming < 255 && decision_margin >= 0) {
                     apriltag_detection_t *det = calloc(1, sizeof(apriltag_detection_t));
@@ -11788,29 +12101,17 @@ zarray_t *apriltag_detector_detect(apriltag_detector_t *td, image_u8_t *im_orig)
                     float theta = -entry.rotation * M_PI / 2.0;
                     float c = cos(theta), s = sin(theta);
 
-                    // Fix the rotation of our homography to properly orient the tag
-                    matd_t *R = matd_create(3,3);
-                    MATD_EL(R, 0, 0) = c;
-                    MATD_EL(R, 0, 1) = -s;
-                    MATD_EL(R, 1, 0) = s;
-                    MATD_EL(R, 1, 1) = c;
-                    MATD_EL(R, 2, 2) = 1;
-
-                    matd_t *RHMirror = matd_create(3,3);
-                    MATD_EL(RHMirror, 0, 0) = entry.hmirror ? -1 : 1;
-                    MATD_EL(RHMirror, 1, 1) = 1;
-                    MATD_EL(RHMirror, 2, 2) = entry.hmirror ? -1 : 1;
+                    // Fix the rotation of our homography to properly orient the tag.
+                    // RHMirror and RVFlip are diagonal so R * RHMirror * RVFlip
+                    // just scales the columns of R.
+                    float hm = entry.hmirror ? -1 : 1, vf = entry.vflip ? -1 : 1;
+                    const float R[3][3] = {
+                        { c * hm, -s * vf, 0 },
+                        { s * hm,  c * vf, 0 },
+                        { 0,       0,      hm * vf }
+                    };
 
-                    matd_t *RVFlip = matd_create(3,3);
-                    MATD_EL(RVFlip, 0, 0) = 1;
-                    MATD_EL(RVFlip, 1, 1) = entry.vflip ? -1 : 1;
-                    MATD_EL(RVFlip, 2, 2) = entry.vflip ? -1 : 1;
-
-                    det->H = matd_op("M*M*M*M", quad->H, R, RHMirror, RVFlip);
-
-                    matd_destroy(R);
-                    matd_destroy(RHMirror);
-                    matd_destroy(RVFlip);
+                    mat33_mul(quad->H, R, det->H);
 
                     homography_project(det->H, 0, 0, &det->c[0], &det->c[1]);
 
@@ -11910,13 +12211,6 @@ zarray_t *apriltag_detector_detect(apriltag_detector_t *td, image_u8_t *im_orig)
         zarray_destroy(poly1);
     }
 
-    for (int i = 0; i < zarray_size(quads); i++) {
-        struct quad *quad;
-        zarray_get_volatile(quads, i, &quad);
-        matd_destroy(quad->H);
-        matd_destroy(quad->Hinv);
-    }
-
     zarray_destroy(quads);
 
     zarray_sort(detections, detection_compare_function);
@@ -12074,16 +12368,15 @@ void imlib_find_apriltags(list_t *out, image_t *ptr, rectangle_t *roi, apriltag_
         lnk_data.goodness = det->goodness / 255.0; // scale to [0:1]
         lnk_data.decision_margin = det->decision_margin / 255.0; // scale to [0:1]
 
-        matd_t *pose = homography_to_pose(det->H, -fx, fy, cx, cy);
-
-        lnk_data.x_translation = MATD_EL(pose, 0, 3);
-        lnk_data.y_translation = MATD_EL(pose, 1, 3);
-        lnk_data.z_translation = MATD_EL(pose, 2, 3);
-        lnk_data.x_rotation = fast_atan2f(MATD_EL(pose, 2, 1), MATD_EL(pose, 2, 2));
-        lnk_data.y_rotation = fast_atan2f(-MATD_EL(pose, 2, 0), fast_sqrtf(sq(MATD_EL(pose, 2, 1)) + sq(MATD_EL(pose, 2, 2))));
-        lnk_data.z_rotation = fast_atan2f(MATD_EL(pose, 1, 0), MATD_EL(pose, 0, 0));
+        float R[3][3], T[3];
+        homography_to_pose(det->H, -fx, fy, cx, cy, R, T);
 
-        matd_destroy(pose);
+        lnk_data.x_translation = T[0];
+        lnk_data.y_translation = T[1];
+        lnk_data.z_translation = T[2];
+        lnk_data.x_rotation = fast_atan2f(R[2][1], R[2][2]);
+        lnk_data.y_rotation = fast_atan2f(-R[2][0], fast_sqrtf(sq(R[2][1]) + sq(R[2][2])));
+        lnk_data.z_rotation = fast_atan2f(R[1][0], R[0][0]);
 
         list_push_back(out, &lnk_data);
     }
@@ -12094,202 +12387,6 @@ void imlib_find_apriltags(list_t *out, image_t *ptr, rectangle_t *roi, apriltag_
     fb_free(); // umm_init_x();
 }
 
-#ifdef IMLIB_ENABLE_FIND_RECTS
-void imlib_find_rects(list_t *out, image_t *ptr, rectangle_t *roi, uint32_t threshold)
-{
-    // Frame Buffer Memory Usage...
-    // -> GRAYSCALE Input Image = w*h*1
-    // -> GRAYSCALE Threhsolded Image = w*h*1
-    // -> UnionFind = w*h*2 (+w*h*1 for hash table)
-    size_t resolution = roi->w * roi->h;
-    size_t fb_alloc_need = resolution * (1 + 1 + 2 + 2); // read above...
-    umm_init_x(((fb_avail() - fb_alloc_need) / resolution) * resolution);
-    apriltag_detector_t *td = apriltag_detector_create();
-
-    image_t img;
-    img.w = roi->w;
-    img.h = roi->h;
-    img.pixfmt = PIXFORMAT_GRAYSCALE;
-    img.data = fb_alloc(image_size(&img), FB_ALLOC_NO_HINT);
-    imlib_draw_image(&img, ptr, 0, 0, 1.f, 1.f, roi, -1, 256, NULL, NULL, 0, NULL, NULL, NULL);
-
-    image_u8_t im;
-    im.width = roi->w;
-    im.height = roi->h;
-    im.stride = roi->w;
-    im.buf = img.data;
-
-    ///////////////////////////////////////////////////////////
-    // Detect quads according to requested image decimation
-    // and blurring parameters.
-
-//    zarray_t *detections = apriltag_quad_gradient(td, &im, true);
-    zarray_t *detections = apriltag_quad_thresh(td, &im, true);
-
-    td->nquads = zarray_size(detections);
-
-    ////////////////////////////////////////////////////////////////
-    // Decode tags from each quad.
-    if (1) {
-        for (int i = 0; i < zarray_size(detections); i++) {
-            struct quad *quad_original;
-            zarray_get_volatile(detections, i, &quad_original);
-
-            // refine edges is not dependent upon the tag family, thus
-            // apply this optimization BEFORE the other work.
-            //if (td->quad_decimate > 1 && td->refine_edges) {
-            if (td->refine_edges) {
-                refine_edges(td, &im, quad_original);
-            }
-
-            // make sure the homographies are computed...
-            if (quad_update_homographies(quad_original))
-                continue;
-        }
-    }
-
-    ////////////////////////////////////////////////////////////////
-    // Reconcile detections--- don't report the same tag more
-    // than once. (Allow non-overlapping duplicate detections.)
-    if (1) {
-        zarray_t *poly0 = g2d_polygon_create_zeros(4);
-        zarray_t *poly1 = g2d_polygon_create_zeros(4);
-
-        for (int i0 = 0; i0 < zarray_size(detections); i0++) {
-
-            struct quad *det0;
-            zarray_get_volatile(detections, i0, &det0);
-
-            for (int k = 0; k < 4; k++)
-                zarray_set(poly0, k, det0->p[k], NULL);
-
-            for (int i1 = i0+1; i1 < zarray_size(detections); i1++) {
-
-                struct quad *det1;
-                zarray_get_volatile(detections, i1, &det1);
-
-                for (int k = 0; k < 4; k++)
-                    zarray_set(poly1, k, det1->p[k], NULL);
-
-                if (g2d_polygon_overlaps_polygon(poly0, poly1)) {
-                    // the tags overlap. Delete one, keep the other.
-
-                    int pref = 0; // 0 means undecided which one we'll keep.
-
-                    // if we STILL don't prefer one detection over the other, then pick
-                    // any deterministic criterion.
-                    for (int i = 0; i < 4; i++) {
-                        pref = prefer_smaller(pref, det0->p[i][0], det1->p[i][0]);
-                        pref = prefer_smaller(pref, det0->p[i][1], det1->p[i][1]);
-                    }
-
-                    if (pref == 0) {
-                        // at this point, we should only be undecided if the tag detections
-                        // are *exactly* the same. How would that happen?
-                        // printf("uh oh, no preference for overlappingdetection\n");
-                    }
-
-                    if (pref < 0) {
-                        // keep det0, destroy det1
-                        matd_destroy(det1->H);
-                        matd_destroy(det1->Hinv);
-                        zarray_remove_index(detections, i1, 1);
-                        i1--; // retry the same index
-                        goto retry1;
-                    } else {
-                        // keep det1, destroy det0
-                        matd_destroy(det0->H);
-                        matd_destroy(det0->Hinv);
-                        zarray_remove_index(detections, i0, 1);
-                        i0--; // retry the same index.
-                        goto retry0;
-                    }
-                }
-
-              retry1: ;
-            }
-
-          retry0: ;
-        }
-
-        zarray_destroy(poly0);
-        zarray_destroy(poly1);
-    }
-
-    list_init(out, sizeof(find_rects_list_lnk_data_t));
-
-    const int r_diag_len = fast_roundf(fast_sqrtf((roi->w * roi->w) + (roi->h * roi->h))) * 2;
-    int *theta_buffer = fb_alloc(sizeof(int) * r_diag_len, FB_ALLOC_NO_HINT);
-    uint32_t *mag_buffer = fb_alloc(sizeof(uint32_t) * r_diag_len, FB_ALLOC_NO_HINT);
-    point_t *point_buffer = fb_alloc(sizeof(point_t) * r_diag_len, FB_ALLOC_NO_HINT);
-
-    for (int i = 0, j = zarray_size(detections); i < j; i++) {
-        struct quad *det;
-        zarray_get_volatile(detections, i, &det);
-
-        line_t lines[4];
-        lines[0].x1 = fast_roundf(det->p[0][0]) + roi->x; lines[0].y1 = fast_roundf(det->p[0][1]) + roi->y;
-        lines[0].x2 = fast_roundf(det->p[1][0]) + roi->x; lines[0].y2 = fast_roundf(det->p[1][1]) + roi->y;
-        lines[1].x1 = fast_roundf(det->p[1][0]) + roi->x; lines[1].y1 = fast_roundf(det->p[1][1]) + roi->y;
-        lines[1].x2 = fast_roundf(det->p[2][0]) + roi->x; lines[1].y2 = fast_roundf(det->p[2][1]) + roi->y;
-        lines[2].x1 = fast_roundf(det->p[2][0]) + roi->x; lines[2].y1 = fast_roundf(det->p[2][1]) + roi->y;
-        lines[2].x2 = fast_roundf(det->p[3][0]) + roi->x; lines[2].y2 = fast_roundf(det->p[3][1]) + roi->y;
-        lines[3].x1 = fast_roundf(det->p[3][0]) + roi->x; lines[3].y1 = fast_roundf(det->p[3][1]) + roi->y;
-        lines[3].x2 = fast_roundf(det->p[0][0]) + roi->x; lines[3].y2 = fast_roundf(det->p[0][1]) + roi->y;
-
-        uint32_t magnitude = 0;
-
-        for (int i = 0; i < 4; i++) {
-            if(!lb_clip_line(&lines[i], 0, 0, ptr->w, ptr->h)) {
-                continue;
-            }
-
-            size_t index = trace_line(ptr, &lines[i], theta_buffer, mag_buffer, point_buffer);
-
-            for (int j = 0; j < index; j++) {
-                magnitude += mag_buffer[j];
-            }
-        }
-
-        if (magnitude < threshold) {
-            continue;
-        }
-
-        find_rects_list_lnk_data_t lnk_data;
-        rectangle_init(&(lnk_data.rect), fast_roundf(det->p[0][0]) + roi->x, fast_roundf(det->p[0][1]) + roi->y, 0, 0);
-
-        for (size_t k = 1, l = (sizeof(det->p) / sizeof(det->p[0])); k < l; k++) {
-            rectangle_t temp;
-            rectangle_init(&temp, fast_roundf(det->p[k][0]) + roi->x, fast_roundf(det->p[k][1]) + roi->y, 0, 0);
-            rectangle_united(&(lnk_data.rect), &temp);
-        }
-
-        // Add corners...
-        lnk_data.corners[0].x = fast_roundf(det->p[3][0]) + roi->x; // top-left
-        lnk_data.corners[0].y = fast_roundf(det->p[3][1]) + roi->y; // top-left
-        lnk_data.corners[1].x = fast_roundf(det->p[2][0]) + roi->x; // top-right
-        lnk_data.corners[1].y = fast_roundf(det->p[2][1]) + roi->y; // top-right
-        lnk_data.corners[2].x = fast_roundf(det->p[1][0]) + roi->x; // bottom-right
-        lnk_data.corners[2].y = fast_roundf(det->p[1][1]) + roi->y; // bottom-right
-        lnk_data.corners[3].x = fast_roundf(det->p[0][0]) + roi->x; // bottom-left
-        lnk_data.corners[3].y = fast_roundf(det->p[0][1]) + roi->y; // bottom-left
-
-        lnk_data.magnitude = magnitude;
-
-        list_push_back(out, &lnk_data);
-    }
-
-    fb_free(); // point_buffer
-    fb_free(); // mag_buffer
-    fb_free(); // theta_buffer
-
-    zarray_destroy(detections);
-    fb_free(); // grayscale_image;
-    apriltag_detector_destroy(td);
-    fb_free(); // umm_init_x();
-}
-#endif //IMLIB_ENABLE_FIND_RECTS
-
 #ifdef IMLIB_ENABLE_ROTATION_CORR
 // http://jepsonsblog.blogspot.com/2012/11/rotation-in-3d-using-opencvs.html
 void imlib_rotation_corr(image_t *img, float x_rotation, float y_rotation, float z_rotation,
@@ -51,6 +51,7 @@ bool bmp_read_geometry(FIL *fp, image_t *img, const char *path, bmp_read_setting
     if (data_size % 4) {
         file_raise_corrupted(fp);
     }
+    rs->bmp_offset = header_size;
 
     uint32_t header_type;
     file_read(fp, &header_type, 4);
@@ -177,102 +178,90 @@ bool bmp_read_geometry(FIL *fp, image_t *img, const char *path, bmp_read_setting
     return (rs->bmp_h >= 0);
 }
 
-// This function reads the pixel values of an image.
-void bmp_read_pixels(FIL *fp, image_t *img, int n_lines, bmp_read_settings_t *rs) {
-    if (rs->bmp_bpp == 8) {
-        if ((rs->bmp_h < 0) && (rs->bmp_w >= 0) && (img->w == rs->bmp_row_bytes)) {
-            file_read(fp, img->pixels, n_lines * img->w);
-        } else {
-            for (int i = 0; i < n_lines; i++) {
-                for (int j = 0; j < rs->bmp_row_bytes; j++) {
-                    uint8_t pixel;
-                    file_read(fp, &pixel, 1);
-                    if (j < img->w) {
-                        if (rs->bmp_h < 0) {
-                            // vertical flip (BMP file perspective)
-                            if (rs->bmp_w < 0) {
-                                // horizontal flip (BMP file perspective)
-                                IM_SET_GS_PIXEL(img, (img->w - j - 1), i, pixel);
-                            } else {
-                                IM_SET_GS_PIXEL(img, j, i, pixel);
-                            }
-                        } else {
-                            if (rs->bmp_w < 0) {
-                                IM_SET_GS_PIXEL(img, (img->w - j - 1), (img->h - i - 1), pixel);
-                            } else {
-                                IM_SET_GS_PIXEL(img, j, (img->h - i - 1), pixel);
-                            }
-                        }
-                    }
-                }
-            }
+// Converts a row of BGR888 pixels to RGB565 (optionally mirrored).
+static void bmp_bgr888_to_rgb565(uint16_t *dst, const uint8_t *src, int w, bool hflip) {
+    if (hflip) {
+        for (int x = w - 1; x >= 0; x--, src += 3) {
+            dst[x] = COLOR_R8_G8_B8_TO_RGB565(src[2], src[1], src[0]);
         }
-    } else if (rs->bmp_bpp == 16) {
-        for (int i = 0; i < n_lines; i++) {
-            for (int j = 0, jj = rs->bmp_row_bytes / 2; j < jj; j++) {
-                uint16_t pixel;
-                file_read(fp, &pixel, 2);
-                if (j < img->w) {
-                    if (rs->bmp_h < 0) {
-                        // vertical flip (BMP file perspective)
-                        if (rs->bmp_w < 0) {
-                            // horizontal flip (BMP file perspective)
-                            IM_SET_RGB565_PIXEL(img, (img->w - j - 1), i, pixel);
-                        } else {
-                            IM_SET_RGB565_PIXEL(img, j, i, pixel);
-                        }
-                    } else {
-                        if (rs->bmp_w < 0) {
-                            IM_SET_RGB565_PIXEL(img, (img->w - j - 1), (img->h - i - 1), pixel);
-                        } else {
-                            IM_SET_RGB565_PIXEL(img, j, (img->h - i - 1), pixel);
-                        }
+    } else {
+        for (int x = 0; x < w; x++, src += 3) {
+            dst[x] = COLOR_R8_G8_B8_TO_RGB565(src[2], src[1], src[0]);
+        }
+    }
+}
+
+// This function reads the pixel values of the r sub-image of a BMP file into img. Rows are
+// read a chunk at a time into a line buffer, rows outside of r are not read.
+void bmp_read_pixels(FIL *fp, image_t *img, rectangle_t *r, bmp_read_settings_t *rs) {
+    int w = abs(rs->bmp_w), h = abs(rs->bmp_h);
+    bool hflip = rs->bmp_w < 0, bottom_up = rs->bmp_h >= 0;
+    int file_x = hflip ? (w - r->x - r->w) : r->x;
+    int file_y = bottom_up ? (h - r->y - r->h) : r->y;
+    int bytes_per_pixel = rs->bmp_bpp / 8;
+
+    uint32_t size;
+    uint8_t *buffer = fb_alloc_all(&size, FB_ALLOC_PREFER_SIZE | FB_ALLOC_CACHE_ALIGN);
+    int chunk_rows = IM_MIN(size / rs->bmp_row_bytes, r->h);
+
+    if (!chunk_rows) {
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Out of Memory!"));
+    }
+
+    file_seek(fp, rs->bmp_offset + (file_y * rs->bmp_row_bytes));
+
+    for (int i = 0; i < r->h; i += chunk_rows) {
+        int n = IM_MIN(chunk_rows, r->h - i);
+        file_read(fp, buffer, n * rs->bmp_row_bytes);
+
+        for (int j = 0; j < n; j++) {
+            int y = bottom_up ? (r->h - 1 - i - j) : (i + j);
+            uint8_t *src = buffer + (j * rs->bmp_row_bytes) + (file_x * bytes_per_pixel);
+
+            if (rs->bmp_bpp == 8) {
+                uint8_t *dst = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y);
+                if (hflip) {
+                    for (int x = r->w - 1; x >= 0; x--) {
+                        dst[x] = *src++;
                     }
+                } else {
+                    memcpy(dst, src, r->w);
                 }
-            }
-        }
-    } else if (rs->bmp_bpp == 24) {
-        for (int i = 0; i < n_lines; i++) {
-            for (int j = 0, jj = rs->bmp_row_bytes / 3; j < jj; j++) {
-                uint8_t b, g, r;
-                file_read(fp, &b, 1);
-                file_read(fp, &g, 1);
-                file_read(fp, &r, 1);
-                uint16_t pixel = COLOR_R8_G8_B8_TO_RGB565(r, g, b);
-                if (j < img->w) {
-                    if (rs->bmp_h < 0) {
-                        // vertical flip
-                        if (rs->bmp_w < 0) {
-                            // horizontal flip
-                            IM_SET_RGB565_PIXEL(img, (img->w - j - 1), i, pixel);
-                        } else {
-                            IM_SET_RGB565_PIXEL(img, j, i, pixel);
-                        }
-                    } else {
-                        if (rs->bmp_w < 0) {
-                            IM_SET_RGB565_PIXEL(img, (img->w - j - 1), (img->h - i - 1), pixel);
-                        } else {
-                            IM_SET_RGB565_PIXEL(img, j, (img->h - i - 1), pixel);
-                        }
+            } else if (rs->bmp_bpp == 16) {
+                uint16_t *dst = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
+                if (hflip) {
+                    for (int x = r->w - 1; x >= 0; x--, src += 2) {
+                        dst[x] = src[0] | (src[1] << 8);
                     }
+                } else {
+                    memcpy(dst, src, r->w * sizeof(uint16_t));
                 }
-            }
-            for (int j = 0, jj = rs->bmp_row_bytes % 3; j < jj; j++) {
-                file_read(fp, NULL, 1);
+            } else {
+                bmp_bgr888_to_rgb565(IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y), src, r->w, hflip);
             }
         }
     }
+
+    fb_free();
 }
 
-void bmp_read(image_t *img, const char *path) {
+void bmp_read(image_t *img, const char *path, rectangle_t *roi) {
     FIL fp;
     bmp_read_settings_t rs;
-    file_open(&fp, path, true, FA_READ | FA_OPEN_EXISTING);
+    file_open(&fp, path, false, FA_READ | FA_OPEN_EXISTING);
     bmp_read_geometry(&fp, img, path, &rs);
+    rectangle_t r = {0, 0, img->w, img->h};
+    if (roi) {
+        if (!rectangle_subimg(img, roi, &r)) {
+            mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("No intersection!"));
+        }
+        img->w = r.w;
+        img->h = r.h;
+    }
     if (!img->pixels) {
         img->pixels = xalloc(img->w * img->h * img->bpp);
     }
-    bmp_read_pixels(&fp, img, img->h, &rs);
+    bmp_read_pixels(&fp, img, &r, &rs);
     file_close(&fp);
 }
 
@@ -301,47 +290,57 @@ void bmp_write_subimg(image_t *img, const char *path, rectangle_t *r) {
     }
 
     FIL fp;
-    file_open(&fp, path, true, FA_WRITE | FA_CREATE_ALWAYS);
+    file_open(&fp, path, false, FA_WRITE | FA_CREATE_ALWAYS);
+
+    const int bpp = IM_IS_GS(img) ? 8 : 16;
+    const int row_bytes = (((rect.w * bpp) + 31) / 32) * 4;
+    const int data_size = (row_bytes * rect.h);
 
     if (IM_IS_GS(img)) {
-        const int row_bytes = (((rect.w * 8) + 31) / 32) * 4;
-        const int data_size = (row_bytes * rect.h);
-        const int waste = (row_bytes / sizeof(uint8_t)) - rect.w;
         // Write BMP file header
         bmp_write_header(&fp, 1024, data_size, 8, 0, &rect);
         // Write color Table (1024 bytes)
+        uint32_t table[256];
         for (int i = 0; i < 256; i++) {
-            file_write_long(&fp, ((i) << 16) | ((i) << 8) | i);
-        }
-        if ((rect.x == 0) && (rect.w == img->w) && (img->w == row_bytes)) {
-            file_write(&fp, img->pixels + (rect.y * img->w), rect.w * rect.h);
-        } else {
-            for (int i = 0; i < rect.h; i++) {
-                file_write(&fp, img->pixels + ((rect.y + i) * img->w) + rect.x, rect.w);
-                for (int j = 0; j < waste; j++) {
-                    file_write_byte(&fp, 0);
-                }
-            }
+            table[i] = ((i) << 16) | ((i) << 8) | i;
         }
+        file_write(&fp, table, sizeof(table));
     } else {
-        const int row_bytes = (((rect.w * 16) + 31) / 32) * 4;
-        const int data_size = (row_bytes * rect.h);
-        const int waste = (row_bytes / sizeof(uint16_t)) - rect.w;
         // Write BMP file header
         bmp_write_header(&fp, 12, data_size, 16, 3, &rect);
         // Write Bit Masks (12 bytes)
-        file_write_long(&fp, 0x1F << 11);
-        file_write_long(&fp, 0x3F << 5);
-        file_write_long(&fp, 0x1F);
-        for (int i = 0; i < rect.h; i++) {
-            for (int j = 0; j < rect.w; j++) {
-                file_write_short(&fp, IM_GET_RGB565_PIXEL(img, (rect.x + j), (rect.y + i)));
-            }
-            for (int j = 0; j < waste; j++) {
-                file_write_short(&fp, 0);
+        file_write(&fp, (uint32_t [3]) {0x1F << 11, 0x3F << 5, 0x1F}, 12);
+    }
+
+    if ((rect.x == 0) && (rect.w == img->w) && ((img->w * (bpp / 8)) == row_bytes)) {
+        // Rows are already padded, write the whole sub-image at once.
+        file_write(&fp, img->pixels + (rect.y * row_bytes), data_size);
+    } else {
+        // Pack padded rows into a line buffer and write a chunk of rows at a time.
+        uint32_t size;
+        uint8_t *buffer = fb_alloc_all(&size, FB_ALLOC_PREFER_SIZE | FB_ALLOC_CACHE_ALIGN);
+        int chunk_rows = IM_MIN(size / row_bytes, rect.h);
+
+        if (!chunk_rows) {
+            mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Out of Memory!"));
+        }
+
+        for (int i = 0; i < rect.h; i += chunk_rows) {
+            int n = IM_MIN(chunk_rows, rect.h - i);
+
+            for (int j = 0; j < n; j++) {
+                uint8_t *dst = buffer + (j * row_bytes);
+                uint8_t *src = img->pixels + ((((rect.y + i + j) * img->w) + rect.x) * (bpp / 8));
+                memcpy(dst, src, rect.w * (bpp / 8));
+                memset(dst + (rect.w * (bpp / 8)), 0, row_bytes - (rect.w * (bpp / 8)));
             }
+
+            file_write(&fp, buffer, n * row_bytes);
         }
+
+        fb_free();
     }
+
     file_close(&fp);
 }
 #endif //IMLIB_ENABLE_IMAGE_FILE_IO
@@ -0,0 +1,288 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * Combined 1D/2D code scanner.
+ *
+ * The ROI is converted to grayscale once and split into cells. Each cell accumulates the
+ * gradient structure tensor (gxx, gyy, gxy). Cells with enough gradient energy are grouped
+ * into connected regions and the coherence of each region's summed tensor decides where it
+ * is sent: bars produce a single dominant gradient direction (high coherence) while QR and
+ * data matrix modules produce gradients in two directions (low coherence). Only the padded
+ * candidate regions are handed to the decoders.
+ */
+#include "imlib.h"
+#if defined(IMLIB_ENABLE_QRCODES) || defined(IMLIB_ENABLE_DATAMATRICES) || \
+    (defined(IMLIB_ENABLE_BARCODES) && (!defined(OMV_NO_GPL)))
+
+#define CODES_CELL_SIZE         (8)
+#define CODES_CELL_SHIFT        (7)     // Keeps per-cell tensor sums in 16-bits.
+#define CODES_CELL_MARGIN       (2)     // Quiet zone added around candidates (in cells).
+#define CODES_MIN_CELLS         (2)
+#define CODES_MIN_ENERGY        (256)   // Mean squared gradient magnitude per pixel.
+#define CODES_1D_COHERENCE      (0.3f)  // Regions above this are 1D, the rest are 2D.
+
+typedef struct codes_cell {
+    uint16_t gxx, gyy;
+    int16_t gxy;
+} codes_cell_t;
+
+typedef struct codes_candidate {
+    rectangle_t rect;
+    bool is_1d;
+} codes_candidate_t;
+
+#define CODES_MOVE_RESULTS(type, out, in, ox, oy)         \
+    ({                                                    \
+        while (list_size(in)) {                           \
+            type lnk_data;                                \
+            list_pop_front((in), &lnk_data);              \
+            lnk_data.rect.x += (ox);                      \
+            lnk_data.rect.y += (oy);                      \
+            for (int k = 0; k < 4; k++) {                 \
+                lnk_data.corners[k].x += (ox);            \
+                lnk_data.corners[k].y += (oy);            \
+            }                                             \
+            list_push_back((out), &lnk_data);             \
+        }                                                 \
+    })
+
+// Computes the gradient structure tensor of each cell in the region.
+static void codes_compute_cells(codes_cell_t *cells, int cw, int ch, image_t *img, rectangle_t *r) {
+    for (int cy = 0; cy < ch; cy++) {
+        for (int cx = 0; cx < cw; cx++) {
+            int x_start = r->x + (cx * CODES_CELL_SIZE);
+            int x_end = IM_MIN(x_start + CODES_CELL_SIZE, r->x + r->w);
+            int y_start = r->y + (cy * CODES_CELL_SIZE);
+            int y_end = IM_MIN(y_start + CODES_CELL_SIZE, r->y + r->h);
+            uint32_t gxx = 0, gyy = 0;
+            int32_t gxy = 0;
+
+            for (int y = y_start; y < y_end; y++) {
+                uint8_t *row_ptr = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y);
+                uint8_t *row_ptr_m1 = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, IM_MAX(y - 1, r->y));
+                uint8_t *row_ptr_p1 = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, IM_MIN(y + 1, r->y + r->h - 1));
+
+                for (int x = x_start; x < x_end; x++) {
+                    int gx = row_ptr[IM_MIN(x + 1, r->x + r->w - 1)] - row_ptr[IM_MAX(x - 1, r->x)];
+                    int gy = row_ptr_p1[x] - row_ptr_m1[x];
+                    gxx += gx * gx;
+                    gyy += gy * gy;
+                    gxy += gx * gy;
+                }
+            }
+
+            codes_cell_t *cell = cells + (cy * cw) + cx;
+            cell->gxx = gxx >> CODES_CELL_SHIFT;
+            cell->gyy = gyy >> CODES_CELL_SHIFT;
+            cell->gxy = gxy / (1 << CODES_CELL_SHIFT);
+        }
+    }
+}
+
+// Groups textured cells into candidate regions (in image coordinates of the region).
+static void codes_find_candidates(list_t *out, codes_cell_t *cells, int cw, int ch, rectangle_t *r) {
+    int cell_count = cw * ch;
+    uint8_t *flags = fb_alloc(cell_count, FB_ALLOC_NO_HINT);
+    uint32_t *stack = fb_alloc(cell_count * sizeof(uint32_t), FB_ALLOC_NO_HINT);
+    uint32_t min_energy = (CODES_MIN_ENERGY * CODES_CELL_SIZE * CODES_CELL_SIZE) >> CODES_CELL_SHIFT;
+
+    for (int i = 0; i < cell_count; i++) {
+        flags[i] = (cells[i].gxx + cells[i].gyy) >= min_energy;
+    }
+
+    list_init(out, sizeof(codes_candidate_t));
+
+    for (int i = 0; i < cell_count; i++) {
+        if (!flags[i]) {
+            continue;
+        }
+
+        int64_t gxx = 0, gyy = 0, gxy = 0;
+        int x_min = cw, y_min = ch, x_max = 0, y_max = 0, count = 0, top = 0;
+        stack[top++] = i;
+        flags[i] = 0;
+
+        while (top) {
+            int index = stack[--top];
+            int cx = index % cw, cy = index / cw;
+            gxx += cells[index].gxx;
+            gyy += cells[index].gyy;
+            gxy += cells[index].gxy;
+            x_min = IM_MIN(x_min, cx);
+            y_min = IM_MIN(y_min, cy);
+            x_max = IM_MAX(x_max, cx);
+            y_max = IM_MAX(y_max, cy);
+            count += 1;
+
+            // 8-way connectivity so that diagonal bars stay in one region.
+            for (int ny = IM_MAX(cy - 1, 0), ny_end = IM_MIN(cy + 1, ch - 1); ny <= ny_end; ny++) {
+                for (int nx = IM_MAX(cx - 1, 0), nx_end = IM_MIN(cx + 1, cw - 1); nx <= nx_end; nx++) {
+                    int n = (ny * cw) + nx;
+                    if (flags[n]) {
+                        flags[n] = 0;
+                        stack[top++] = n;
+                    }
+                }
+            }
+        }
+
+        if (count < CODES_MIN_CELLS) {
+            continue;
+        }
+
+        float energy = gxx + gyy;
+        float coherence = (((float) (gxx - gyy) * (gxx - gyy)) + (4.0f * gxy * gxy)) / (energy * energy);
+
+        codes_candidate_t candidate;
+        candidate.is_1d = coherence > CODES_1D_COHERENCE;
+
+        int x = r->x + ((x_min - CODES_CELL_MARGIN) * CODES_CELL_SIZE);
+        int y = r->y + ((y_min - CODES_CELL_MARGIN) * CODES_CELL_SIZE);
+        int x_end = r->x + ((x_max + CODES_CELL_MARGIN + 1) * CODES_CELL_SIZE);
+        int y_end = r->y + ((y_max + CODES_CELL_MARGIN + 1) * CODES_CELL_SIZE);
+        rectangle_init(&candidate.rect, x, y, x_end - x, y_end - y);
+        rectangle_intersected(&candidate.rect, r);
+
+        list_push_back(out, &candidate);
+    }
+
+    fb_free(); // stack
+    fb_free(); // flags
+
+    for (;;) { // Merge overlapping candidates of the same kind.
+        bool merge_occured = false;
+
+        list_t out_temp;
+        list_init(&out_temp, sizeof(codes_candidate_t));
+
+        while (list_size(out)) {
+            codes_candidate_t lnk_candidate;
+            list_pop_front(out, &lnk_candidate);
+
+            for (size_t k = 0, l = list_size(out); k < l; k++) {
+                codes_candidate_t tmp_candidate;
+                list_pop_front(out, &tmp_candidate);
+
+                if ((lnk_candidate.is_1d == tmp_candidate.is_1d) &&
+                    rectangle_overlap(&(lnk_candidate.rect), &(tmp_candidate.rect))) {
+                    rectangle_united(&(lnk_candidate.rect), &(tmp_candidate.rect));
+                    merge_occured = true;
+                } else {
+                    list_push_back(out, &tmp_candidate);
+                }
+            }
+
+            list_push_back(&out_temp, &lnk_candidate);
+        }
+
+        list_copy(out, &out_temp);
+
+        if (!merge_occured) {
+            break;
+        }
+    }
+}
+
+void imlib_find_codes(list_t *qrcodes, list_t *datamatrices, list_t *barcodes,
+                      image_t *ptr, rectangle_t *roi, int effort) {
+    if (qrcodes) {
+        list_init(qrcodes, sizeof(find_qrcodes_list_lnk_data_t));
+    }
+
+    if (datamatrices) {
+        list_init(datamatrices, sizeof(find_datamatrices_list_lnk_data_t));
+    }
+
+    if (barcodes) {
+        list_init(barcodes, sizeof(find_barcodes_list_lnk_data_t));
+    }
+
+    // Grayscale images are scanned in place, everything else is converted once here and all
+    // decoders below work on the same grayscale copy.
+    image_t img;
+    rectangle_t region;
+    int ox = 0, oy = 0;
+
+    if (ptr->pixfmt == PIXFORMAT_GRAYSCALE) {
+        img = *ptr;
+        region = *roi;
+    } else {
+        img.w = roi->w;
+        img.h = roi->h;
+        img.pixfmt = PIXFORMAT_GRAYSCALE;
+        img.data = fb_alloc(roi->w * roi->h, FB_ALLOC_NO_HINT);
+        imlib_draw_image(&img, ptr, 0, 0, 1.f, 1.f, roi, -1, 256, NULL, NULL, 0, NULL, NULL, NULL);
+        rectangle_init(&region, 0, 0, roi->w, roi->h);
+        ox = roi->x;
+        oy = roi->y;
+    }
+
+    int cw = (region.w + CODES_CELL_SIZE - 1) / CODES_CELL_SIZE;
+    int ch = (region.h + CODES_CELL_SIZE - 1) / CODES_CELL_SIZE;
+    codes_cell_t *cells = fb_alloc(cw * ch * sizeof(codes_cell_t), FB_ALLOC_NO_HINT);
+
+    list_t candidates;
+    codes_compute_cells(cells, cw, ch, &img, &region);
+    codes_find_candidates(&candidates, cells, cw, ch, &region);
+    fb_free(); // cells
+
+    while (list_size(&candidates)) {
+        codes_candidate_t candidate;
+        list_pop_front(&candidates, &candidate);
+
+        #if defined(IMLIB_ENABLE_QRCODES)
+        if (qrcodes && (!candidate.is_1d)) {
+            list_t out;
+            fb_alloc_mark();
+            imlib_find_qrcodes(&out, &img, &candidate.rect);
+            fb_alloc_free_till_mark();
+            CODES_MOVE_RESULTS(find_qrcodes_list_lnk_data_t, qrcodes, &out, ox, oy);
+        }
+        #endif
+
+        #if defined(IMLIB_ENABLE_DATAMATRICES)
+        if (datamatrices && (!candidate.is_1d)) {
+            list_t out;
+            fb_alloc_mark();
+            imlib_find_datamatrices(&out, &img, &candidate.rect, effort);
+            fb_alloc_free_till_mark();
+            CODES_MOVE_RESULTS(find_datamatrices_list_lnk_data_t, datamatrices, &out, ox, oy);
+        }
+        #endif
+
+        #if defined(IMLIB_ENABLE_BARCODES) && (!defined(OMV_NO_GPL))
+        if (barcodes && candidate.is_1d) {
+            list_t out;
+            fb_alloc_mark();
+            imlib_find_barcodes(&out, &img, &candidate.rect);
+            fb_alloc_free_till_mark();
+            CODES_MOVE_RESULTS(find_barcodes_list_lnk_data_t, barcodes, &out, ox, oy);
+        }
+        #endif
+    }
+
+    if (ptr->pixfmt != PIXFORMAT_GRAYSCALE) {
+        fb_free(); // img.data
+    }
+}
+#endif // IMLIB_ENABLE_QRCODES || IMLIB_ENABLE_DATAMATRICES || IMLIB_ENABLE_BARCODES
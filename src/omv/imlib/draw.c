@@ -553,32 +553,350 @@ void imlib_draw_ellipse(image_t *img, int cx, int cy, int rx, int ry, int rotati
 
 // char rotation == 0, 90, 180, 360, etc.
 // string rotation == 0, 90, 180, 360, etc.
-void imlib_draw_string(image_t *img,
-                       int x_off,
-                       int y_off,
-                       const char *str,
-                       int c,
-                       float scale,
-                       int x_spacing,
-                       int y_spacing,
-                       bool mono_space,
-                       int char_rotation,
-                       bool char_hmirror,
-                       bool char_vflip,
-                       int string_rotation,
-                       bool string_hmirror,
-                       bool string_vflip) {
+typedef struct glyph_span {
+    int16_t y, x0, x1;  // Covers pixels [x0, x1) of row y.
+} glyph_span_t;
+
+typedef struct glyph_cache_entry {
+    int16_t x, y, w, h; // Bounds of the pre-rotated glyph relative to the character origin.
+    uint8_t *alpha;     // w * h coverage (0-16) when anti-aliased, NULL otherwise.
+    int n_spans;
+    glyph_span_t spans[];
+} glyph_cache_entry_t;
+
+// Rotates x, y by a multiple of 90 degrees (same direction as point_rotate()).
+static void glyph_rotate(int rotation, int x, int y, int *new_x, int *new_y) {
+    switch (rotation % 360) {
+        case 90: {
+            *new_x = -y;
+            *new_y = x;
+            break;
+        }
+        case 180: {
+            *new_x = -x;
+            *new_y = -y;
+            break;
+        }
+        case 270: {
+            *new_x = y;
+            *new_y = -x;
+            break;
+        }
+        default: {
+            *new_x = x;
+            *new_y = y;
+            break;
+        }
+    }
+}
+
+// Returns the coverage (0-16) of pixel (u, v) of the pre-rotated glyph.
+static int glyph_coverage(const glyph_cache_t *cache, const glyph_t *g, int xx, int yy, int u, int v) {
+    int x, y;
+    // Undo the string rotation and then the character rotation around the character center.
+    glyph_rotate(360 - cache->string_rotation, u, v, &x, &y);
+    glyph_rotate(360 - cache->char_rotation, x - (xx / 2), y - (yy / 2), &x, &y);
+    x += xx / 2;
+    y += yy / 2;
+
+    if (cache->char_hmirror) {
+        x = xx - 1 - x;
+    }
+
+    if (cache->char_vflip) {
+        y = yy - 1 - y;
+    }
+
+    if (!cache->antialias) {
+        return (g->data[fast_floorf(y / cache->scale)] & (1 << (g->w - 1 - fast_floorf(x / cache->scale)))) ? 16 : 0;
+    }
+
+    // 4x4 super-sampling of the scaled pixel footprint.
+    int sum = 0;
+    for (int j = 0; j < 4; j++) {
+        int row = g->data[fast_floorf((y + (j * 0.25f) + 0.125f) / cache->scale)];
+        for (int i = 0; i < 4; i++) {
+            sum += (row >> (g->w - 1 - fast_floorf((x + (i * 0.25f) + 0.125f) / cache->scale))) & 1;
+        }
+    }
+    return sum;
+}
+
+// Computes the bounds of the pre-rotated glyph (relative to the character origin) and the
+// size of the scaled character.
+static void glyph_bounds(const glyph_cache_t *cache, const glyph_t *g, int *xx, int *yy,
+                         int *min_x, int *min_y, int *w, int *h) {
+    int max_x = INT_MIN, max_y = INT_MIN;
+    *xx = fast_floorf(g->w * cache->scale);
+    *yy = fast_floorf(g->h * cache->scale);
+    *min_x = INT_MAX;
+    *min_y = INT_MAX;
+
+    // Map the corners of the scaled character to find the bounds of the pre-rotated glyph.
+    for (int i = 0; (i < 4) && *xx && *yy; i++) {
+        int x, y;
+        glyph_rotate(cache->char_rotation, ((i & 1) ? (*xx - 1) : 0) - (*xx / 2), ((i & 2) ? (*yy - 1) : 0) - (*yy / 2), &x, &y);
+        glyph_rotate(cache->string_rotation, x + (*xx / 2), y + (*yy / 2), &x, &y);
+        *min_x = IM_MIN(*min_x, x);
+        *min_y = IM_MIN(*min_y, y);
+        max_x = IM_MAX(max_x, x);
+        max_y = IM_MAX(max_y, y);
+    }
+
+    *w = (*xx && *yy) ? (max_x - *min_x + 1) : 0;
+    *h = (*xx && *yy) ? (max_y - *min_y + 1) : 0;
+}
+
+// Scans the coverage of the glyph row by row, fills in spans (when not NULL) and returns the
+// span count. Anti-aliased coverage is computed on the first scan into alpha (w * h) and kept,
+// otherwise alpha is a single row that is recomputed on every scan.
+static int glyph_cache_scan(const glyph_cache_t *cache, const glyph_t *g, int xx, int yy,
+                            int min_x, int min_y, int w, int h, uint8_t *alpha, glyph_span_t *spans) {
+    int n_spans = 0;
+
+    for (int v = 0; v < h; v++) {
+        uint8_t *row = cache->antialias ? (alpha + (v * w)) : alpha;
+
+        if ((!cache->antialias) || (!spans)) {
+            for (int u = 0; u < w; u++) {
+                row[u] = glyph_coverage(cache, g, xx, yy, min_x + u, min_y + v);
+            }
+        }
+
+        for (int u = 0, prev = 0; u <= w; u++) {
+            int cov = (u == w) ? 0 : row[u];
+            if (cov && !prev) {
+                if (spans) {
+                    spans[n_spans].y = v;
+                    spans[n_spans].x0 = u;
+                }
+            } else if (!cov && prev) {
+                if (spans) {
+                    spans[n_spans].x1 = u;
+                }
+                n_spans += 1;
+            }
+            prev = cov;
+        }
+    }
+
+    return n_spans;
+}
+
+// Renders a glyph on first use. Entries stay allocated until imlib_glyph_cache_free().
+static glyph_cache_entry_t *glyph_cache_get(glyph_cache_t *cache, int index) {
+    if (cache->glyphs[index]) {
+        return cache->glyphs[index];
+    }
+
+    const glyph_t *g = &font[index];
+    int xx, yy, min_x, min_y, w, h;
+    glyph_bounds(cache, g, &xx, &yy, &min_x, &min_y, &w, &h);
+
+    // Count the spans first so the entry can be allocated in one piece. The alpha map stays
+    // allocated below the entry when anti-aliased, the row buffer is freed before it.
+    uint8_t *alpha = fb_alloc(cache->antialias ? (w * h) : w, FB_ALLOC_NO_HINT);
+    int n_spans = glyph_cache_scan(cache, g, xx, yy, min_x, min_y, w, h, alpha, NULL);
+
+    if ((!cache->antialias) && alpha) {
+        fb_free(); // row
+    }
+
+    glyph_cache_entry_t *e = fb_alloc(sizeof(glyph_cache_entry_t) + (n_spans * sizeof(glyph_span_t)), FB_ALLOC_NO_HINT);
+    e->x = min_x;
+    e->y = min_y;
+    e->w = w;
+    e->h = h;
+    e->alpha = cache->antialias ? alpha : NULL;
+
+    if (!cache->antialias) {
+        alpha = fb_alloc(w, FB_ALLOC_NO_HINT);
+    }
+
+    e->n_spans = glyph_cache_scan(cache, g, xx, yy, min_x, min_y, w, h, alpha, e->spans);
+
+    if ((!cache->antialias) && alpha) {
+        fb_free(); // row
+    }
+
+    cache->glyphs[index] = e;
+    return e;
+}
+
+// Fills pixels [x0, x1) of row y, the span must already be clipped.
+static void draw_hspan(image_t *img, int y, int x0, int x1, int c) {
+    switch (img->pixfmt) {
+        case PIXFORMAT_BINARY: {
+            uint32_t *row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(img, y);
+            for (int x = x0; x < x1; x++) {
+                IMAGE_PUT_BINARY_PIXEL_FAST(row_ptr, x, c);
+            }
+            break;
+        }
+        case PIXFORMAT_GRAYSCALE: {
+            uint8_t *row_ptr = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y);
+            memset(row_ptr + x0, c, x1 - x0);
+            break;
+        }
+        case PIXFORMAT_RGB565: {
+            uint16_t *row_ptr = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
+            for (int x = x0; x < x1; x++) {
+                IMAGE_PUT_RGB565_PIXEL_FAST(row_ptr, x, c);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+// Blends pixels [x0, x1) of row y with c using alpha[x - x0] (0-16) as the coverage.
+static void draw_hspan_alpha(image_t *img, int y, int x0, int x1, int c, const uint8_t *alpha) {
+    switch (img->pixfmt) {
+        case PIXFORMAT_BINARY: {
+            uint32_t *row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(img, y);
+            for (int x = x0; x < x1; x++) {
+                int p = (alpha[x - x0] >= 8) ? c : IMAGE_GET_BINARY_PIXEL_FAST(row_ptr, x);
+                IMAGE_PUT_BINARY_PIXEL_FAST(row_ptr, x, p);
+            }
+            break;
+        }
+        case PIXFORMAT_GRAYSCALE: {
+            uint8_t *row_ptr = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y);
+            int c_y = c & 0xff;
+            for (int x = x0; x < x1; x++) {
+                int a = alpha[x - x0] << 4;
+                row_ptr[x] = ((c_y * a) + (row_ptr[x] * (256 - a))) >> 8;
+            }
+            break;
+        }
+        case PIXFORMAT_RGB565: {
+            uint16_t *row_ptr = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
+            int c_r5 = COLOR_RGB565_TO_R5(c);
+            int c_g6 = COLOR_RGB565_TO_G6(c);
+            int c_b5 = COLOR_RGB565_TO_B5(c);
+            for (int x = x0; x < x1; x++) {
+                int a = alpha[x - x0] << 4;
+                int p = IMAGE_GET_RGB565_PIXEL_FAST(row_ptr, x);
+                int r5 = ((c_r5 * a) + (COLOR_RGB565_TO_R5(p) * (256 - a))) >> 8;
+                int g6 = ((c_g6 * a) + (COLOR_RGB565_TO_G6(p) * (256 - a))) >> 8;
+                int b5 = ((c_b5 * a) + (COLOR_RGB565_TO_B5(p) * (256 - a))) >> 8;
+                IMAGE_PUT_RGB565_PIXEL_FAST(row_ptr, x, COLOR_R5_G6_B5_TO_RGB565(r5, g6, b5));
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+static void glyph_blit(image_t *img, const glyph_cache_entry_t *e, int x_off, int y_off, int c) {
+    if (((x_off + e->w) <= 0) || (x_off >= img->w) || ((y_off + e->h) <= 0) || (y_off >= img->h)) {
+        return;
+    }
+
+    for (int i = 0; i < e->n_spans; i++) {
+        const glyph_span_t *span = &e->spans[i];
+        int y = y_off + span->y;
+        int x0 = IM_MAX(x_off + span->x0, 0);
+        int x1 = IM_MIN(x_off + span->x1, img->w);
+
+        if ((y < 0) || (y >= img->h) || (x0 >= x1)) {
+            continue;
+        }
+
+        if (e->alpha) {
+            draw_hspan_alpha(img, y, x0, x1, c, e->alpha + (span->y * e->w) + (x0 - x_off));
+        } else {
+            draw_hspan(img, y, x0, x1, c);
+        }
+    }
+}
+
+// Draws a glyph without caching it, for a single string this avoids any fb_alloc().
+static void glyph_draw(image_t *img, const glyph_cache_t *cache, int index, int x_off, int y_off, int c) {
+    const glyph_t *g = &font[index];
+    int xx, yy, min_x, min_y, w, h;
+    glyph_bounds(cache, g, &xx, &yy, &min_x, &min_y, &w, &h);
+    x_off += min_x;
+    y_off += min_y;
+
+    for (int v = IM_MAX(-y_off, 0), vv = IM_MIN(img->h - y_off, h); v < vv; v++) {
+        for (int u = IM_MAX(-x_off, 0), uu = IM_MIN(img->w - x_off, w); u < uu; u++) {
+            uint8_t cov = glyph_coverage(cache, g, xx, yy, min_x + u, min_y + v);
+
+            if (!cov) {
+                continue;
+            }
+
+            if (cache->antialias) {
+                draw_hspan_alpha(img, y_off + v, x_off + u, x_off + u + 1, c, &cov);
+            } else {
+                draw_hspan(img, y_off + v, x_off + u, x_off + u + 1, c);
+            }
+        }
+    }
+}
+
+static void glyph_cache_setup(glyph_cache_t *cache,
+                              float scale,
+                              int char_rotation,
+                              bool char_hmirror,
+                              bool char_vflip,
+                              int string_rotation,
+                              bool antialias) {
     char_rotation %= 360;
     if (char_rotation < 0) {
         char_rotation += 360;
     }
-    char_rotation = (char_rotation / 90) * 90;
 
     string_rotation %= 360;
     if (string_rotation < 0) {
         string_rotation += 360;
     }
-    string_rotation = (string_rotation / 90) * 90;
+
+    memset(cache, 0, sizeof(glyph_cache_t));
+    cache->scale = scale;
+    cache->char_rotation = (char_rotation / 90) * 90;
+    cache->string_rotation = (string_rotation / 90) * 90;
+    cache->char_hmirror = char_hmirror;
+    cache->char_vflip = char_vflip;
+    cache->antialias = antialias;
+}
+
+void imlib_glyph_cache_init(glyph_cache_t *cache,
+                            float scale,
+                            int char_rotation,
+                            bool char_hmirror,
+                            bool char_vflip,
+                            int string_rotation,
+                            bool antialias) {
+    glyph_cache_setup(cache, scale, char_rotation, char_hmirror, char_vflip, string_rotation, antialias);
+    cache->enabled = true;
+    fb_alloc_mark();
+}
+
+void imlib_glyph_cache_free(glyph_cache_t *cache) {
+    fb_alloc_free_till_mark();
+}
+
+void imlib_draw_string_cached(image_t *img,
+                              glyph_cache_t *cache,
+                              int x_off,
+                              int y_off,
+                              const char *str,
+                              int c,
+                              int x_spacing,
+                              int y_spacing,
+                              bool mono_space,
+                              bool string_hmirror,
+                              bool string_vflip) {
+    float scale = cache->scale;
+    int char_rotation = cache->char_rotation;
+    bool char_hmirror = cache->char_hmirror;
+    bool char_vflip = cache->char_vflip;
 
     bool char_swap_w_h = (char_rotation == 90) || (char_rotation == 270);
     bool char_upsidedown = (char_rotation == 180) || (char_rotation == 270);
@@ -652,15 +970,15 @@ void imlib_draw_string(image_t *img,
             }
         }
 
-        for (int y = 0, yy = fast_floorf(g->h * scale); y < yy; y++) {
-            for (int x = 0, xx = fast_floorf(g->w * scale); x < xx; x++) {
-                if (g->data[fast_floorf(y / scale)] & (1 << (g->w - 1 - fast_floorf(x / scale)))) {
-                    int16_t x_tmp = x_off + (char_hmirror ? (xx - x - 1) : x), y_tmp = y_off + (char_vflip ? (yy - y - 1) : y);
-                    point_rotate(x_tmp, y_tmp, IM_DEG2RAD(char_rotation), x_off + (xx / 2), y_off + (yy / 2), &x_tmp, &y_tmp);
-                    point_rotate(x_tmp, y_tmp, IM_DEG2RAD(string_rotation), org_x_off, org_y_off, &x_tmp, &y_tmp);
-                    imlib_set_pixel(img, x_tmp, y_tmp, c);
-                }
-            }
+        // The glyph is pre-rotated, only its origin is rotated around the string origin.
+        int glyph_x, glyph_y;
+        glyph_rotate(cache->string_rotation, x_off - org_x_off, y_off - org_y_off, &glyph_x, &glyph_y);
+
+        if (cache->enabled) {
+            const glyph_cache_entry_t *e = glyph_cache_get(cache, ch - ' ');
+            glyph_blit(img, e, org_x_off + glyph_x + e->x, org_y_off + glyph_y + e->y, c);
+        } else {
+            glyph_draw(img, cache, ch - ' ', org_x_off + glyph_x, org_y_off + glyph_y, c);
         }
 
         if (mono_space) {
@@ -708,6 +1026,287 @@ void imlib_draw_string(image_t *img,
     }
 }
 
+void imlib_draw_string(image_t *img,
+                       int x_off,
+                       int y_off,
+                       const char *str,
+                       int c,
+                       float scale,
+                       int x_spacing,
+                       int y_spacing,
+                       bool mono_space,
+                       int char_rotation,
+                       bool char_hmirror,
+                       bool char_vflip,
+                       int string_rotation,
+                       bool string_hmirror,
+                       bool string_vflip,
+                       bool antialias) {
+    // A single string is drawn without caching the glyphs, so it doesn't need any fb_alloc().
+    glyph_cache_t cache;
+    glyph_cache_setup(&cache, scale, char_rotation, char_hmirror, char_vflip, string_rotation, antialias);
+    imlib_draw_string_cached(img, &cache, x_off, y_off, str, c, x_spacing, y_spacing,
+                             mono_space, string_hmirror, string_vflip);
+}
+
+#define DRAW_LIST_BAND_ROWS    16
+#define DRAW_LIST_GPU_MIN_AREA 1024
+
+void imlib_draw_list_init(draw_list_t *list, int capacity) {
+    list->cmds = fb_alloc(capacity * sizeof(draw_list_cmd_t), FB_ALLOC_NO_HINT);
+    list->count = 0;
+    list->capacity = capacity;
+}
+
+void imlib_draw_list_free(draw_list_t *list) {
+    fb_free(); // list->cmds
+}
+
+static draw_list_cmd_t *draw_list_add(draw_list_t *list, int type, int c, int thickness, bool fill) {
+    if (list->count >= list->capacity) {
+        return NULL;
+    }
+
+    draw_list_cmd_t *cmd = &list->cmds[list->count++];
+    cmd->type = type;
+    cmd->fill = fill;
+    cmd->thickness = IM_MAX(thickness, 0);
+    cmd->c = c;
+    return cmd;
+}
+
+void imlib_draw_list_add_rectangle(draw_list_t *list, int rx, int ry, int rw, int rh, int c, int thickness, bool fill) {
+    if ((rw <= 0) || (rh <= 0) || ((!fill) && (thickness <= 0))) {
+        return;
+    }
+
+    draw_list_cmd_t *cmd = draw_list_add(list, DRAW_LIST_RECTANGLE, c, thickness, fill);
+    if (cmd) {
+        int t0 = fill ? 0 : (thickness / 2), t1 = fill ? 0 : ((thickness - 1) / 2);
+        cmd->x0 = rx;
+        cmd->y0 = ry;
+        cmd->x1 = rx + rw - 1;
+        cmd->y1 = ry + rh - 1;
+        cmd->y_start = ry - t0;
+        cmd->y_end = ry + rh - 1 + t1;
+    }
+}
+
+void imlib_draw_list_add_circle(draw_list_t *list, int cx, int cy, int r, int c, int thickness, bool fill) {
+    if ((r < 0) || ((!fill) && (thickness <= 0))) {
+        return;
+    }
+
+    draw_list_cmd_t *cmd = draw_list_add(list, DRAW_LIST_CIRCLE, c, thickness, fill);
+    if (cmd) {
+        // Outer and inner radius of the ring, a negative inner radius is a filled disk. A zero
+        // radius circle is a single pixel whatever the thickness, like imlib_draw_circle().
+        int ro = r ? (r + (IM_MAX(thickness, 0) / 2)) : 0;
+        cmd->x0 = cx;
+        cmd->y0 = cy;
+        cmd->x1 = ro;
+        cmd->y1 = (fill || (r == 0)) ? -1 : (r - ((thickness - 1) / 2) - 1);
+        cmd->y_start = cy - ro;
+        cmd->y_end = cy + ro;
+    }
+}
+
+void imlib_draw_list_add_line(draw_list_t *list, int x0, int y0, int x1, int y1, int c, int thickness) {
+    if (thickness <= 0) {
+        return;
+    }
+
+    draw_list_cmd_t *cmd = draw_list_add(list, DRAW_LIST_LINE, c, thickness, false);
+    if (cmd) {
+        int hw = thickness / 2;
+        cmd->x0 = x0;
+        cmd->y0 = y0;
+        cmd->x1 = x1;
+        cmd->y1 = y1;
+        cmd->y_start = IM_MIN(y0, y1) - hw;
+        cmd->y_end = IM_MAX(y0, y1) + hw;
+    }
+}
+
+// Returns the largest x such that (x * x) <= n.
+static int draw_list_isqrt(int n) {
+    int x = fast_sqrtf(n);
+    while ((x * x) > n) {
+        x--;
+    }
+    while (((x + 1) * (x + 1)) <= n) {
+        x++;
+    }
+    return x;
+}
+
+static void draw_list_span(image_t *img, int y, int x0, int x1, int c) {
+    x0 = IM_MAX(x0, 0);
+    x1 = IM_MIN(x1, img->w - 1);
+    if (x0 <= x1) {
+        draw_hspan(img, y, x0, x1 + 1, c);
+    }
+}
+
+static void draw_list_rectangle_rows(image_t *img, const draw_list_cmd_t *cmd, int y_start, int y_end) {
+    #if (OMV_GPU_ENABLE == 1)
+    if (cmd->fill) {
+        rectangle_t rect;
+        rect.x = IM_MAX(cmd->x0, 0);
+        rect.y = y_start;
+        rect.w = IM_MIN(cmd->x1, img->w - 1) - rect.x + 1;
+        rect.h = y_end - y_start + 1;
+
+        if ((rect.w > 0) && ((rect.w * rect.h) >= DRAW_LIST_GPU_MIN_AREA) && (!omv_gpu_fill_rect(img, &rect, cmd->c))) {
+            return;
+        }
+    }
+    #endif
+
+    // Same coverage as imlib_draw_rectangle().
+    int t0 = cmd->fill ? 0 : (cmd->thickness / 2), t1 = cmd->fill ? 0 : ((cmd->thickness - 1) / 2);
+
+    for (int y = y_start; y <= y_end; y++) {
+        if (cmd->fill || (y <= (cmd->y0 + t1)) || (y >= (cmd->y1 - t0))) {
+            draw_list_span(img, y, cmd->x0 - t0, cmd->x1 + t1, cmd->c);
+        } else {
+            draw_list_span(img, y, cmd->x0 - t0, cmd->x0 + t1, cmd->c);
+            draw_list_span(img, y, cmd->x1 - t0, cmd->x1 + t1, cmd->c);
+        }
+    }
+}
+
+static void draw_list_circle_rows(image_t *img, const draw_list_cmd_t *cmd, int y_start, int y_end) {
+    int ro = cmd->x1, ri = cmd->y1;
+
+    for (int y = y_start; y <= y_end; y++) {
+        int dy = y - cmd->y0;
+        int xo = draw_list_isqrt((ro * ro) + ro - (dy * dy));
+
+        if ((ri < 0) || (abs(dy) > ri)) {
+            draw_list_span(img, y, cmd->x0 - xo, cmd->x0 + xo, cmd->c);
+        } else {
+            int xi = draw_list_isqrt((ri * ri) + ri - (dy * dy));
+            draw_list_span(img, y, cmd->x0 - xo, cmd->x0 - xi - 1, cmd->c);
+            draw_list_span(img, y, cmd->x0 + xi + 1, cmd->x0 + xo, cmd->c);
+        }
+    }
+}
+
+static void draw_list_line_rows(image_t *img, const draw_list_cmd_t *cmd, int y_start, int y_end) {
+    // The line is a quad around the segment (thickness - 1) / 2 pixels wide on each side.
+    float dx = cmd->x1 - cmd->x0, dy = cmd->y1 - cmd->y0;
+    float len = fast_sqrtf((dx * dx) + (dy * dy));
+    float hw = (cmd->thickness - 1) * 0.5f;
+    float nx = len ? ((-dy * hw) / len) : 0, ny = len ? ((dx * hw) / len) : hw;
+    float px[4] = { cmd->x0 + nx, cmd->x1 + nx, cmd->x1 - nx, cmd->x0 - nx };
+    float py[4] = { cmd->y0 + ny, cmd->y1 + ny, cmd->y1 - ny, cmd->y0 - ny };
+
+    if (!len) {
+        px[0] = px[3] = cmd->x0 - hw;
+        px[1] = px[2] = cmd->x0 + hw;
+    }
+
+    for (int y = y_start; y <= y_end; y++) {
+        // Clip the quad edges against the row band [y - 0.5, y + 0.5] and keep the x extent.
+        float ya = y - 0.5f, yb = y + 0.5f, x_min = FLT_MAX, x_max = -FLT_MAX;
+
+        for (int i = 0; i < 4; i++) {
+            float ax = px[i], ay = py[i], bx = px[(i + 1) % 4], by = py[(i + 1) % 4];
+
+            if (IM_MAX(ay, by) < ya || IM_MIN(ay, by) > yb) {
+                continue;
+            }
+
+            float t_a = 0, t_b = 1;
+            if (ay != by) {
+                float t_ya = (ya - ay) / (by - ay), t_yb = (yb - ay) / (by - ay);
+                t_a = IM_MAX(IM_MIN(t_ya, t_yb), 0);
+                t_b = IM_MIN(IM_MAX(t_ya, t_yb), 1);
+            }
+
+            float xa = ax + ((bx - ax) * t_a), xb = ax + ((bx - ax) * t_b);
+            x_min = IM_MIN(x_min, IM_MIN(xa, xb));
+            x_max = IM_MAX(x_max, IM_MAX(xa, xb));
+        }
+
+        if (x_min > x_max) {
+            continue;
+        }
+
+        int x0 = fast_floorf(x_min + 0.5f), x1 = fast_ceilf(x_max - 0.5f);
+        if (x0 > x1) {
+            x0 = x1 = fast_roundf((x_min + x_max) * 0.5f);
+        }
+
+        draw_list_span(img, y, x0, x1, cmd->c);
+    }
+}
+
+void imlib_draw_list_render(image_t *img, draw_list_t *list) {
+    int n_bands = (img->h + DRAW_LIST_BAND_ROWS - 1) / DRAW_LIST_BAND_ROWS;
+    uint32_t *band_start = fb_alloc0((n_bands + 1) * sizeof(uint32_t), FB_ALLOC_NO_HINT);
+
+    // Bucket the commands by band (counting sort), keeping the command order in each band.
+    for (int i = 0; i < list->count; i++) {
+        draw_list_cmd_t *cmd = &list->cmds[i];
+        int y_start = IM_MAX(cmd->y_start, 0), y_end = IM_MIN(cmd->y_end, img->h - 1);
+        for (int b = y_start / DRAW_LIST_BAND_ROWS; (y_start <= y_end) && (b <= (y_end / DRAW_LIST_BAND_ROWS)); b++) {
+            band_start[b + 1] += 1;
+        }
+    }
+
+    for (int b = 0; b < n_bands; b++) {
+        band_start[b + 1] += band_start[b];
+    }
+
+    uint16_t *band_cmds = fb_alloc((band_start[n_bands] + 1) * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+    uint32_t *band_fill = fb_alloc(n_bands * sizeof(uint32_t), FB_ALLOC_NO_HINT);
+    memcpy(band_fill, band_start, n_bands * sizeof(uint32_t));
+
+    for (int i = 0; i < list->count; i++) {
+        draw_list_cmd_t *cmd = &list->cmds[i];
+        int y_start = IM_MAX(cmd->y_start, 0), y_end = IM_MIN(cmd->y_end, img->h - 1);
+        for (int b = y_start / DRAW_LIST_BAND_ROWS; (y_start <= y_end) && (b <= (y_end / DRAW_LIST_BAND_ROWS)); b++) {
+            band_cmds[band_fill[b]++] = i;
+        }
+    }
+
+    // Rasterize one band at a time so the rows being drawn on stay in the cache.
+    for (int b = 0; b < n_bands; b++) {
+        int band_y_start = b * DRAW_LIST_BAND_ROWS;
+        int band_y_end = IM_MIN(band_y_start + DRAW_LIST_BAND_ROWS, img->h) - 1;
+
+        for (uint32_t i = band_start[b]; i < band_start[b + 1]; i++) {
+            const draw_list_cmd_t *cmd = &list->cmds[band_cmds[i]];
+            int y_start = IM_MAX(cmd->y_start, band_y_start);
+            int y_end = IM_MIN(cmd->y_end, band_y_end);
+
+            switch (cmd->type) {
+                case DRAW_LIST_RECTANGLE: {
+                    draw_list_rectangle_rows(img, cmd, y_start, y_end);
+                    break;
+                }
+                case DRAW_LIST_CIRCLE: {
+                    draw_list_circle_rows(img, cmd, y_start, y_end);
+                    break;
+                }
+                case DRAW_LIST_LINE: {
+                    draw_list_line_rows(img, cmd, y_start, y_end);
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+        }
+    }
+
+    fb_free(); // band_fill
+    fb_free(); // band_cmds
+    fb_free(); // band_start
+}
+
 void imlib_draw_row_setup(imlib_draw_row_data_t *data) {
     image_t temp;
     temp.w = data->dst_img->w;
@@ -2749,6 +3348,22 @@ static void imlib_draw_image_scale_and_center_helper(image_t *dst_img,
     }
 }
 
+// Applies the scale and center hints for dst_img to the scale and offsets and clears them, so
+// that the image can then be drawn in parts (windows of dst_img) with the same placement.
+void imlib_draw_image_resolve_hints(image_t *dst_img,
+                                    image_t *src_img,
+                                    rectangle_t *roi,
+                                    int *dst_x_start,
+                                    int *dst_y_start,
+                                    float *x_scale,
+                                    float *y_scale,
+                                    image_hint_t *hint) {
+    int src_width_scaled, src_height_scaled;
+    imlib_draw_image_scale_and_center_helper(dst_img, roi ? roi->w : src_img->w, roi ? roi->h : src_img->h,
+                                             &src_width_scaled, &src_height_scaled,
+                                             dst_x_start, dst_y_start, x_scale, y_scale, hint);
+}
+
 // False == Image is black, True == rect valid
 void imlib_draw_image_get_bounds(image_t *dst_img,
                                  image_t *src_img,
@@ -2910,6 +3525,54 @@ void imlib_draw_image(image_t *dst_img,
         }
     }
 
+    // When a JPEG image is scaled down and/or cropped decode it directly into a smaller image.
+    // The decoder scales by 1/2, 1/4 or 1/8 in the DCT domain and only reconstructs the MCUs
+    // that overlap the roi, which costs a fraction of a full decode followed by a resize.
+    if (src_img->pixfmt == PIXFORMAT_JPEG) {
+        int jpeg_pixfmt = (rgb_channel != -1) ? PIXFORMAT_RGB565 :
+                          (color_palette ? PIXFORMAT_GRAYSCALE : dst_img->pixfmt);
+        int jpeg_scale = 1;
+
+        while ((jpeg_scale < 8) && ((x_scale * jpeg_scale * 2) <= 1.f) && ((y_scale * jpeg_scale * 2) <= 1.f)) {
+            jpeg_scale *= 2;
+        }
+
+        rectangle_t jpeg_roi = {0, 0, src_img->w, src_img->h};
+        if (roi) {
+            jpeg_roi = *roi;
+        }
+
+        bool jpeg_is_roi = (jpeg_roi.w != src_img->w) || (jpeg_roi.h != src_img->h);
+        #if (OMV_JPEG_CODEC_ENABLE == 1)
+        // The hardware decoder is faster at full scale even when most of the image is discarded.
+        jpeg_is_roi = false;
+        #endif
+
+        if (((jpeg_pixfmt == PIXFORMAT_BINARY) || (jpeg_pixfmt == PIXFORMAT_GRAYSCALE) ||
+             (jpeg_pixfmt == PIXFORMAT_RGB565)) && ((jpeg_scale > 1) || jpeg_is_roi)) {
+            image_t jpeg_img = {0};
+            jpeg_img.w = IM_MAX(jpeg_roi.w / jpeg_scale, 1);
+            jpeg_img.h = IM_MAX(jpeg_roi.h / jpeg_scale, 1);
+            jpeg_img.pixfmt = jpeg_pixfmt;
+            jpeg_img.data = fb_alloc(image_size(&jpeg_img), FB_ALLOC_CACHE_ALIGN);
+            jpeg_decompress_roi(&jpeg_img, src_img, &jpeg_roi, jpeg_scale);
+
+            // Restore the flip direction that was folded into dst_delta_x/y above.
+            bool x_flip = (dst_delta_x < 0) != ((hint & IMAGE_HINT_HMIRROR) != 0);
+            bool y_flip = (dst_delta_y < 0) != ((hint & IMAGE_HINT_VFLIP) != 0);
+            float jpeg_x_scale = x_scale * jpeg_scale;
+            float jpeg_y_scale = y_scale * jpeg_scale;
+
+            imlib_draw_image(dst_img, &jpeg_img, dst_x_start, dst_y_start,
+                             x_flip ? -jpeg_x_scale : jpeg_x_scale,
+                             y_flip ? -jpeg_y_scale : jpeg_y_scale,
+                             NULL, rgb_channel, alpha, color_palette, alpha_palette, hint,
+                             callback, callback_arg, dst_row_override);
+            fb_free();
+            return;
+        }
+    }
+
     int dst_x_start_backup = dst_x_start;
     int dst_y_start_backup = dst_y_start;
 
@@ -3040,6 +3703,7 @@ void imlib_draw_image(image_t *dst_img,
     // Special destination?
     bool is_jpeg = src_img->pixfmt == PIXFORMAT_JPEG;
     bool is_png = src_img->pixfmt == PIXFORMAT_PNG;
+    bool is_qoi = src_img->pixfmt == PIXFORMAT_QOI;
     // Best format to convert yuv/bayer/jpeg image to.
     int new_not_mutable_pixfmt = (rgb_channel != -1) ? PIXFORMAT_RGB565 :
                                  (color_palette ? PIXFORMAT_GRAYSCALE :
@@ -3070,7 +3734,7 @@ void imlib_draw_image(image_t *dst_img,
     bool is_color_conversion_scaling = is_color_conversion && is_scaling;
 
     // Make a deep copy of the source image.
-    if (need_deep_copy || is_color_conversion_scaling || is_jpeg || is_png) {
+    if (need_deep_copy || is_color_conversion_scaling || is_jpeg || is_png || is_qoi) {
         new_src_img.w = src_img->w; // same width as source image
         new_src_img.h = src_img->h; // same height as source image
 
@@ -3091,6 +3755,8 @@ void imlib_draw_image(image_t *dst_img,
                         jpeg_decompress(&new_src_img, src_img);
                     } else if (is_png) {
                         png_decompress(&new_src_img, src_img);
+                    } else if (is_qoi) {
+                        qoi_decompress(&new_src_img, src_img);
                     }
                     break;
                 }
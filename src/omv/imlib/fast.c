@@ -33,7 +33,9 @@
  * See https://www.edwardrosten.com/work/fast.html
  */
 #include <stdio.h>
+#include <string.h>
 #include "imlib.h"
+#include "simd.h"
 #include "xalloc.h"
 #include "fb_alloc.h"
 #include "gc.h"
@@ -43,17 +45,22 @@
 #define MIN_MEM          (10 * 1024)
 #define MAX_CORNERS      (2000U)
 #define Compare(X, Y)    ((X) >= (Y))
+// Number of pixels tested at once, one bit per pixel.
+#define FAST_BLOCK       (32)
+// Size of the score rows used for non-max suppression.
+#define FAST_ROWS_SIZE(w)    (((w) + 2) * 3)
 
 typedef struct {
-    uint16_t x;
-    uint16_t y;
-    uint16_t score;
-} corner_t;
+    const uint8_t *p;       // First center pixel.
+    int n;                  // Number of center pixels (up to FAST_BLOCK).
+    bool vector;            // True if all the circle pixels can be loaded with vector loads.
+    v128_t hi[FAST_BLOCK / UINT8_VECTOR_SIZE];
+    v128_t lo[FAST_BLOCK / UINT8_VECTOR_SIZE];
+    uint32_t bright[16];    // One bit per center pixel for each circle pixel.
+    uint32_t dark[16];
+} fast9_block_t;
 
 static int pixel[16];
-static corner_t *fast9_detect(image_t *image, rectangle_t *roi, int *n_corners, int b);
-static void fast9_score(image_t *image, corner_t *corners, int num_corners, int b);
-static void nonmax_suppression(corner_t *corners, int num_corners, array_t *keypoints);
 
 static kp_t *alloc_keypoint(uint16_t x, uint16_t y, uint16_t score) {
     // Note must set keypoint descriptor to zeros
@@ -83,130 +90,6 @@ static void make_offsets(int pixel[], int row_stride) {
     pixel[15] = -1 + row_stride * 3;
 }
 
-void fast_detect(image_t *image, array_t *keypoints, int threshold, rectangle_t *roi) {
-    int num_corners = 0;
-    make_offsets(pixel, image->w);
-
-    // Find corners
-    corner_t *corners = fast9_detect(image, roi, &num_corners, threshold);
-    if (num_corners) {
-        // Score corners
-        fast9_score(image, corners, num_corners, threshold);
-        // Non-max suppression
-        nonmax_suppression(corners, num_corners, keypoints);
-    }
-
-    // Free corners;
-    fb_free();
-}
-
-static void nonmax_suppression(corner_t *corners, int num_corners, array_t *keypoints) {
-    gc_info_t info;
-
-    int last_row;
-    int16_t *row_start;
-    const int sz = num_corners;
-
-    /* Point above points (roughly) to the pixel above
-       the one of interest, if there is a feature there.*/
-    int point_above = 0;
-    int point_below = 0;
-
-    /* Find where each row begins (the corners are output in raster scan order).
-       A beginning of -1 signifies that there are no corners on that row. */
-    last_row = corners[sz - 1].y;
-    row_start = fb_alloc((last_row + 1) * sizeof(uint16_t), FB_ALLOC_NO_HINT);
-
-    for (int i = 0; i < last_row + 1; i++) {
-        row_start[i] = -1;
-    }
-
-    for (int i = 0, prev_row = -1; i < sz; i++) {
-        corner_t *c = &corners[i];
-        if (c->y != prev_row) {
-            row_start[c->y] = i;
-            prev_row = c->y;
-        }
-    }
-
-    for (int i = 0; i < sz; i++) {
-        corner_t pos = corners[i];
-        uint16_t score = pos.score;
-
-        /*Check left */
-        if (i > 0) {
-            if (corners[i - 1].x == pos.x - 1 && corners[i - 1].y == pos.y && Compare(corners[i - 1].score, score)) {
-                goto nonmax;
-            }
-        }
-
-        /*Check right*/
-        if (i < (sz - 1)) {
-            if (corners[i + 1].x == pos.x + 1 && corners[i + 1].y == pos.y && Compare(corners[i + 1].score, score)) {
-                goto nonmax;
-            }
-        }
-
-        /*Check above (if there is a valid row above)*/
-        if (pos.y != 0 && row_start[pos.y - 1] != -1) {
-            /*Make sure that current point_above is one row above.*/
-            if (corners[point_above].y < pos.y - 1) {
-                point_above = row_start[pos.y - 1];
-            }
-
-            /*Make point_above point to the first of the pixels above the current point, if it exists.*/
-            for (; corners[point_above].y < pos.y && corners[point_above].x < pos.x - 1; point_above++) {
-
-            }
-
-            for (int j = point_above; corners[j].y < pos.y && corners[j].x <= pos.x + 1; j++) {
-                int x = corners[j].x;
-                if ( (x == pos.x - 1 || x == pos.x || x == pos.x + 1) && Compare(corners[j].score, score)) {
-                    goto nonmax;
-                }
-            }
-        }
-
-        /*Check below (if there is anything below)*/
-        if (pos.y != last_row && row_start[pos.y + 1] != -1 && point_below < sz) {
-            /*Nothing below*/
-            if (corners[point_below].y < pos.y + 1) {
-                point_below = row_start[pos.y + 1];
-            }
-
-            /* Make point below point to one of the pixels belowthe current point, if it exists.*/
-            for (; point_below < sz && corners[point_below].y == pos.y + 1 && corners[point_below].x < pos.x - 1;
-                 point_below++) {
-            }
-
-            for (int j = point_below; j < sz && corners[j].y == pos.y + 1 && corners[j].x <= pos.x + 1; j++) {
-                int x = corners[j].x;
-                if ( (x == pos.x - 1 || x == pos.x || x == pos.x + 1) && Compare(corners[j].score, score)) {
-                    goto nonmax;
-                }
-            }
-        }
-
-        gc_info(&info);
-        // Allocate keypoints until we're almost out of memory
-        if (info.free < MIN_MEM) {
-            // Try collecting memory
-            gc_collect();
-            // If it didn't work break
-            gc_info(&info);
-            if (info.free < MIN_MEM) {
-                break;
-            }
-        }
-        array_push_back(keypoints, alloc_keypoint(pos.x, pos.y, pos.score));
-        nonmax:
-        ;
-    }
-
-    // Free temp rows.
-    fb_free();
-}
-
 // *INDENT-OFF*
 static int fast9_corner_score(const uint8_t *p, int bstart)
 {    
@@ -3140,2942 +3023,242 @@ static int fast9_corner_score(const uint8_t *p, int bstart)
 }
 // *INDENT-ON*
 
-static void fast9_score(image_t *image, corner_t *corners, int num_corners, int b) {
-    for (int i = 0; i < num_corners; i++) {
-        corner_t *c = &corners[i];
-        c->score = fast9_corner_score(image->pixels + c->y * image->w + c->x, b);
+// Compares circle pixel k of all the pixels in the block against the center thresholds.
+static void fast9_block_test(fast9_block_t *blk, int k, int b) {
+    const uint8_t *p = blk->p;
+    uint32_t bright = 0;
+    uint32_t dark = 0;
+
+    if (blk->vector) {
+        for (int i = 0, j = 0; j < FAST_BLOCK; i++, j += UINT8_VECTOR_SIZE) {
+            v128_t v = vldr_u8(p + j + pixel[k]);
+            bright |= vcmphi_u8_get_mask(v, blk->hi[i]) << j;
+            dark |= vcmphi_u8_get_mask(blk->lo[i], v) << j;
+        }
+    } else {
+        for (int j = 0; j < blk->n; j++) {
+            int v = p[j + pixel[k]];
+            bright |= ((uint32_t) (v > (p[j] + b))) << j;
+            dark |= ((uint32_t) (v < (p[j] - b))) << j;
+        }
     }
+
+    blk->bright[k] = bright;
+    blk->dark[k] = dark;
 }
 
-// *INDENT-OFF*
-static corner_t *fast9_detect(image_t *image, rectangle_t *roi, int *n_corners, int b)
-{
+// Returns a mask of the pixels with 9 contiguous circle pixels set in m.
+static uint32_t fast9_arc_mask(const uint32_t *m) {
+    uint32_t m2[16], m4[16], arc = 0;
+
+    for (int k = 0; k < 16; k++) {
+        m2[k] = m[k] & m[(k + 1) & 15];
+    }
+
+    for (int k = 0; k < 16; k++) {
+        m4[k] = m2[k] & m2[(k + 2) & 15];
+    }
+
+    for (int k = 0; k < 16; k++) {
+        arc |= m4[k] & m4[(k + 4) & 15] & m[(k + 8) & 15];
+    }
+
+    return arc;
+}
+
+// Returns a mask of the FAST-9 corners in the block.
+static uint32_t fast9_block_detect(fast9_block_t *blk, int b) {
+    uint32_t *bright = blk->bright;
+    uint32_t *dark = blk->dark;
+    uint32_t valid = (blk->n == FAST_BLOCK) ? 0xFFFFFFFF : ((1U << blk->n) - 1);
+
+    if (blk->vector) {
+        v128_t t = vdup_u8(b);
+        for (int i = 0, j = 0; j < FAST_BLOCK; i++, j += UINT8_VECTOR_SIZE) {
+            v128_t c = vldr_u8(blk->p + j);
+            blk->hi[i] = vqadd_u8(c, t);
+            blk->lo[i] = vqsub_u8(c, t);
+        }
+    }
+
+    // A 9 pixel arc always covers two neighboring compass pixels.
+    for (int k = 0; k < 16; k += 4) {
+        fast9_block_test(blk, k, b);
+    }
+
+    uint32_t bright_candidates = ((bright[0] & bright[4]) | (bright[4] & bright[8]) |
+                                  (bright[8] & bright[12]) | (bright[12] & bright[0])) & valid;
+    uint32_t dark_candidates = ((dark[0] & dark[4]) | (dark[4] & dark[8]) |
+                                (dark[8] & dark[12]) | (dark[12] & dark[0])) & valid;
+
+    if (!(bright_candidates | dark_candidates)) {
+        return 0;
+    }
+
+    for (int k = 0; k < 16; k++) {
+        if (k & 3) {
+            fast9_block_test(blk, k, b);
+        }
+    }
+
+    uint32_t corners = 0;
+
+    if (bright_candidates) {
+        corners |= fast9_arc_mask(bright) & bright_candidates;
+    }
+
+    if (dark_candidates) {
+        corners |= fast9_arc_mask(dark) & dark_candidates;
+    }
+
+    return corners;
+}
+
+// Inserts a corner in a cell keeping the strongest cell_max corners sorted by score.
+static void fast_cell_insert(corner_t *cell, uint16_t *count, int cell_max, corner_t corner) {
+    int n = *count;
+
+    if (n == cell_max) {
+        if (cell[n - 1].score >= corner.score) {
+            return;
+        }
+        n -= 1;
+    } else {
+        *count += 1;
+    }
+
+    for (; (n > 0) && (cell[n - 1].score < corner.score); n--) {
+        cell[n] = cell[n - 1];
+    }
+
+    cell[n] = corner;
+}
+
+int fast_detect_corners(image_t *image, corner_t *corners, int max_corners, int threshold,
+                        rectangle_t *roi, int cell_size, int cell_max) {
     int num_corners = 0;
-    // Try to alloc MAX_CORNERS or the actual max corners we can alloc.
-    int max_corners = IM_MIN(MAX_CORNERS, (fb_avail() / sizeof(corner_t)));
-    corner_t *corners = (corner_t*) fb_alloc(max_corners * sizeof(corner_t), FB_ALLOC_NO_HINT);
+    int x_start = roi->x + 3, x_end = roi->x + roi->w - 3;
+    int y_start = roi->y + 3, y_end = roi->y + roi->h - 3;
+    int b = IM_CLAMP(threshold, 0, 255);
 
-    for(int y=roi->y+3; y<roi->y+roi->h-3; y++) {
-        for(int x=roi->x+3; x<roi->x+roi->w-3; x++) {
-            const uint8_t *p = image->pixels+(y * image->w + x);
-			int cb = *p + b;
-			int c_b= *p - b;
-            if(p[pixel[0]] > cb)
-             if(p[pixel[1]] > cb)
-              if(p[pixel[2]] > cb)
-               if(p[pixel[3]] > cb)
-                if(p[pixel[4]] > cb)
-                 if(p[pixel[5]] > cb)
-                  if(p[pixel[6]] > cb)
-                   if(p[pixel[7]] > cb)
-                    if(p[pixel[8]] > cb)
-                     {}
-                    else
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      continue;
-                   else if(p[pixel[7]] < c_b)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      continue;
-                    else if(p[pixel[14]] < c_b)
-                     if(p[pixel[8]] < c_b)
-                      if(p[pixel[9]] < c_b)
-                       if(p[pixel[10]] < c_b)
-                        if(p[pixel[11]] < c_b)
-                         if(p[pixel[12]] < c_b)
-                          if(p[pixel[13]] < c_b)
-                           if(p[pixel[15]] < c_b)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      continue;
-                    else
-                     continue;
-                  else if(p[pixel[6]] < c_b)
-                   if(p[pixel[15]] > cb)
-                    if(p[pixel[13]] > cb)
-                     if(p[pixel[14]] > cb)
-                      {}
-                     else
-                      continue;
-                    else if(p[pixel[13]] < c_b)
-                     if(p[pixel[7]] < c_b)
-                      if(p[pixel[8]] < c_b)
-                       if(p[pixel[9]] < c_b)
-                        if(p[pixel[10]] < c_b)
-                         if(p[pixel[11]] < c_b)
-                          if(p[pixel[12]] < c_b)
-                           if(p[pixel[14]] < c_b)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    if(p[pixel[7]] < c_b)
-                     if(p[pixel[8]] < c_b)
-                      if(p[pixel[9]] < c_b)
-                       if(p[pixel[10]] < c_b)
-                        if(p[pixel[11]] < c_b)
-                         if(p[pixel[12]] < c_b)
-                          if(p[pixel[13]] < c_b)
-                           if(p[pixel[14]] < c_b)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[13]] > cb)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      continue;
-                    else
-                     continue;
-                   else if(p[pixel[13]] < c_b)
-                    if(p[pixel[7]] < c_b)
-                     if(p[pixel[8]] < c_b)
-                      if(p[pixel[9]] < c_b)
-                       if(p[pixel[10]] < c_b)
-                        if(p[pixel[11]] < c_b)
-                         if(p[pixel[12]] < c_b)
-                          if(p[pixel[14]] < c_b)
-                           if(p[pixel[15]] < c_b)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else if(p[pixel[5]] < c_b)
-                  if(p[pixel[14]] > cb)
-                   if(p[pixel[12]] > cb)
-                    if(p[pixel[13]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          if(p[pixel[10]] > cb)
-                           if(p[pixel[11]] > cb)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     continue;
-                   else if(p[pixel[12]] < c_b)
-                    if(p[pixel[6]] < c_b)
-                     if(p[pixel[7]] < c_b)
-                      if(p[pixel[8]] < c_b)
-                       if(p[pixel[9]] < c_b)
-                        if(p[pixel[10]] < c_b)
-                         if(p[pixel[11]] < c_b)
-                          if(p[pixel[13]] < c_b)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else if(p[pixel[14]] < c_b)
-                   if(p[pixel[7]] < c_b)
-                    if(p[pixel[8]] < c_b)
-                     if(p[pixel[9]] < c_b)
-                      if(p[pixel[10]] < c_b)
-                       if(p[pixel[11]] < c_b)
-                        if(p[pixel[12]] < c_b)
-                         if(p[pixel[13]] < c_b)
-                          if(p[pixel[6]] < c_b)
-                           {}
-                          else
-                           if(p[pixel[15]] < c_b)
-                            {}
-                           else
-                            continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   if(p[pixel[6]] < c_b)
-                    if(p[pixel[7]] < c_b)
-                     if(p[pixel[8]] < c_b)
-                      if(p[pixel[9]] < c_b)
-                       if(p[pixel[10]] < c_b)
-                        if(p[pixel[11]] < c_b)
-                         if(p[pixel[12]] < c_b)
-                          if(p[pixel[13]] < c_b)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  if(p[pixel[12]] > cb)
-                   if(p[pixel[13]] > cb)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          if(p[pixel[10]] > cb)
-                           if(p[pixel[11]] > cb)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else if(p[pixel[12]] < c_b)
-                   if(p[pixel[7]] < c_b)
-                    if(p[pixel[8]] < c_b)
-                     if(p[pixel[9]] < c_b)
-                      if(p[pixel[10]] < c_b)
-                       if(p[pixel[11]] < c_b)
-                        if(p[pixel[13]] < c_b)
-                         if(p[pixel[14]] < c_b)
-                          if(p[pixel[6]] < c_b)
-                           {}
-                          else
-                           if(p[pixel[15]] < c_b)
-                            {}
-                           else
-                            continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else if(p[pixel[4]] < c_b)
-                 if(p[pixel[13]] > cb)
-                  if(p[pixel[11]] > cb)
-                   if(p[pixel[12]] > cb)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          if(p[pixel[10]] > cb)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          if(p[pixel[10]] > cb)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    continue;
-                  else if(p[pixel[11]] < c_b)
-                   if(p[pixel[5]] < c_b)
-                    if(p[pixel[6]] < c_b)
-                     if(p[pixel[7]] < c_b)
-                      if(p[pixel[8]] < c_b)
-                       if(p[pixel[9]] < c_b)
-                        if(p[pixel[10]] < c_b)
-                         if(p[pixel[12]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else if(p[pixel[13]] < c_b)
-                  if(p[pixel[7]] < c_b)
-                   if(p[pixel[8]] < c_b)
-                    if(p[pixel[9]] < c_b)
-                     if(p[pixel[10]] < c_b)
-                      if(p[pixel[11]] < c_b)
-                       if(p[pixel[12]] < c_b)
-                        if(p[pixel[6]] < c_b)
-                         if(p[pixel[5]] < c_b)
-                          {}
-                         else
-                          if(p[pixel[14]] < c_b)
-                           {}
-                          else
-                           continue;
-                        else
-                         if(p[pixel[14]] < c_b)
-                          if(p[pixel[15]] < c_b)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  if(p[pixel[5]] < c_b)
-                   if(p[pixel[6]] < c_b)
-                    if(p[pixel[7]] < c_b)
-                     if(p[pixel[8]] < c_b)
-                      if(p[pixel[9]] < c_b)
-                       if(p[pixel[10]] < c_b)
-                        if(p[pixel[11]] < c_b)
-                         if(p[pixel[12]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else
-                 if(p[pixel[11]] > cb)
-                  if(p[pixel[12]] > cb)
-                   if(p[pixel[13]] > cb)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          if(p[pixel[10]] > cb)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          if(p[pixel[10]] > cb)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else if(p[pixel[11]] < c_b)
-                  if(p[pixel[7]] < c_b)
-                   if(p[pixel[8]] < c_b)
-                    if(p[pixel[9]] < c_b)
-                     if(p[pixel[10]] < c_b)
-                      if(p[pixel[12]] < c_b)
-                       if(p[pixel[13]] < c_b)
-                        if(p[pixel[6]] < c_b)
-                         if(p[pixel[5]] < c_b)
-                          {}
-                         else
-                          if(p[pixel[14]] < c_b)
-                           {}
-                          else
-                           continue;
-                        else
-                         if(p[pixel[14]] < c_b)
-                          if(p[pixel[15]] < c_b)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  continue;
-               else if(p[pixel[3]] < c_b)
-                if(p[pixel[10]] > cb)
-                 if(p[pixel[11]] > cb)
-                  if(p[pixel[12]] > cb)
-                   if(p[pixel[13]] > cb)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else if(p[pixel[10]] < c_b)
-                 if(p[pixel[7]] < c_b)
-                  if(p[pixel[8]] < c_b)
-                   if(p[pixel[9]] < c_b)
-                    if(p[pixel[11]] < c_b)
-                     if(p[pixel[6]] < c_b)
-                      if(p[pixel[5]] < c_b)
-                       if(p[pixel[4]] < c_b)
-                        {}
-                       else
-                        if(p[pixel[12]] < c_b)
-                         if(p[pixel[13]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                      else
-                       if(p[pixel[12]] < c_b)
-                        if(p[pixel[13]] < c_b)
-                         if(p[pixel[14]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                     else
-                      if(p[pixel[12]] < c_b)
-                       if(p[pixel[13]] < c_b)
-                        if(p[pixel[14]] < c_b)
-                         if(p[pixel[15]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else
-                if(p[pixel[10]] > cb)
-                 if(p[pixel[11]] > cb)
-                  if(p[pixel[12]] > cb)
-                   if(p[pixel[13]] > cb)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         if(p[pixel[9]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else if(p[pixel[10]] < c_b)
-                 if(p[pixel[7]] < c_b)
-                  if(p[pixel[8]] < c_b)
-                   if(p[pixel[9]] < c_b)
-                    if(p[pixel[11]] < c_b)
-                     if(p[pixel[12]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[5]] < c_b)
-                        if(p[pixel[4]] < c_b)
-                         {}
-                        else
-                         if(p[pixel[13]] < c_b)
-                          {}
-                         else
-                          continue;
-                       else
-                        if(p[pixel[13]] < c_b)
-                         if(p[pixel[14]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                      else
-                       if(p[pixel[13]] < c_b)
-                        if(p[pixel[14]] < c_b)
-                         if(p[pixel[15]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else
-                 continue;
-              else if(p[pixel[2]] < c_b)
-               if(p[pixel[9]] > cb)
-                if(p[pixel[10]] > cb)
-                 if(p[pixel[11]] > cb)
-                  if(p[pixel[12]] > cb)
-                   if(p[pixel[13]] > cb)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[3]] > cb)
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else if(p[pixel[9]] < c_b)
-                if(p[pixel[7]] < c_b)
-                 if(p[pixel[8]] < c_b)
-                  if(p[pixel[10]] < c_b)
-                   if(p[pixel[6]] < c_b)
-                    if(p[pixel[5]] < c_b)
-                     if(p[pixel[4]] < c_b)
-                      if(p[pixel[3]] < c_b)
-                       {}
-                      else
-                       if(p[pixel[11]] < c_b)
-                        if(p[pixel[12]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                     else
-                      if(p[pixel[11]] < c_b)
-                       if(p[pixel[12]] < c_b)
-                        if(p[pixel[13]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[11]] < c_b)
-                      if(p[pixel[12]] < c_b)
-                       if(p[pixel[13]] < c_b)
-                        if(p[pixel[14]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[11]] < c_b)
-                     if(p[pixel[12]] < c_b)
-                      if(p[pixel[13]] < c_b)
-                       if(p[pixel[14]] < c_b)
-                        if(p[pixel[15]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else
-                continue;
-              else
-               if(p[pixel[9]] > cb)
-                if(p[pixel[10]] > cb)
-                 if(p[pixel[11]] > cb)
-                  if(p[pixel[12]] > cb)
-                   if(p[pixel[13]] > cb)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[3]] > cb)
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        if(p[pixel[8]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else if(p[pixel[9]] < c_b)
-                if(p[pixel[7]] < c_b)
-                 if(p[pixel[8]] < c_b)
-                  if(p[pixel[10]] < c_b)
-                   if(p[pixel[11]] < c_b)
-                    if(p[pixel[6]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[4]] < c_b)
-                       if(p[pixel[3]] < c_b)
-                        {}
-                       else
-                        if(p[pixel[12]] < c_b)
-                         {}
-                        else
-                         continue;
-                      else
-                       if(p[pixel[12]] < c_b)
-                        if(p[pixel[13]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                     else
-                      if(p[pixel[12]] < c_b)
-                       if(p[pixel[13]] < c_b)
-                        if(p[pixel[14]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[12]] < c_b)
-                      if(p[pixel[13]] < c_b)
-                       if(p[pixel[14]] < c_b)
-                        if(p[pixel[15]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else
-                continue;
-             else if(p[pixel[1]] < c_b)
-              if(p[pixel[8]] > cb)
-               if(p[pixel[9]] > cb)
-                if(p[pixel[10]] > cb)
-                 if(p[pixel[11]] > cb)
-                  if(p[pixel[12]] > cb)
-                   if(p[pixel[13]] > cb)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[3]] > cb)
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  if(p[pixel[2]] > cb)
-                   if(p[pixel[3]] > cb)
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else
-                 continue;
-               else
-                continue;
-              else if(p[pixel[8]] < c_b)
-               if(p[pixel[7]] < c_b)
-                if(p[pixel[9]] < c_b)
-                 if(p[pixel[6]] < c_b)
-                  if(p[pixel[5]] < c_b)
-                   if(p[pixel[4]] < c_b)
-                    if(p[pixel[3]] < c_b)
-                     if(p[pixel[2]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[10]] < c_b)
-                       if(p[pixel[11]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[10]] < c_b)
-                      if(p[pixel[11]] < c_b)
-                       if(p[pixel[12]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[10]] < c_b)
-                     if(p[pixel[11]] < c_b)
-                      if(p[pixel[12]] < c_b)
-                       if(p[pixel[13]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[10]] < c_b)
-                    if(p[pixel[11]] < c_b)
-                     if(p[pixel[12]] < c_b)
-                      if(p[pixel[13]] < c_b)
-                       if(p[pixel[14]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  if(p[pixel[10]] < c_b)
-                   if(p[pixel[11]] < c_b)
-                    if(p[pixel[12]] < c_b)
-                     if(p[pixel[13]] < c_b)
-                      if(p[pixel[14]] < c_b)
-                       if(p[pixel[15]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else
-                 continue;
-               else
-                continue;
-              else
-               continue;
-             else
-              if(p[pixel[8]] > cb)
-               if(p[pixel[9]] > cb)
-                if(p[pixel[10]] > cb)
-                 if(p[pixel[11]] > cb)
-                  if(p[pixel[12]] > cb)
-                   if(p[pixel[13]] > cb)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[15]] > cb)
-                      {}
-                     else
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[3]] > cb)
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  if(p[pixel[2]] > cb)
-                   if(p[pixel[3]] > cb)
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[7]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else
-                 continue;
-               else
-                continue;
-              else if(p[pixel[8]] < c_b)
-               if(p[pixel[7]] < c_b)
-                if(p[pixel[9]] < c_b)
-                 if(p[pixel[10]] < c_b)
-                  if(p[pixel[6]] < c_b)
-                   if(p[pixel[5]] < c_b)
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[3]] < c_b)
-                      if(p[pixel[2]] < c_b)
-                       {}
-                      else
-                       if(p[pixel[11]] < c_b)
-                        {}
-                       else
-                        continue;
-                     else
-                      if(p[pixel[11]] < c_b)
-                       if(p[pixel[12]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[11]] < c_b)
-                      if(p[pixel[12]] < c_b)
-                       if(p[pixel[13]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[11]] < c_b)
-                     if(p[pixel[12]] < c_b)
-                      if(p[pixel[13]] < c_b)
-                       if(p[pixel[14]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[11]] < c_b)
-                    if(p[pixel[12]] < c_b)
-                     if(p[pixel[13]] < c_b)
-                      if(p[pixel[14]] < c_b)
-                       if(p[pixel[15]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else
-                continue;
-              else
-               continue;
-            else if(p[pixel[0]] < c_b)
-             if(p[pixel[1]] > cb)
-              if(p[pixel[8]] > cb)
-               if(p[pixel[7]] > cb)
-                if(p[pixel[9]] > cb)
-                 if(p[pixel[6]] > cb)
-                  if(p[pixel[5]] > cb)
-                   if(p[pixel[4]] > cb)
-                    if(p[pixel[3]] > cb)
-                     if(p[pixel[2]] > cb)
-                      {}
-                     else
-                      if(p[pixel[10]] > cb)
-                       if(p[pixel[11]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[10]] > cb)
-                      if(p[pixel[11]] > cb)
-                       if(p[pixel[12]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[10]] > cb)
-                     if(p[pixel[11]] > cb)
-                      if(p[pixel[12]] > cb)
-                       if(p[pixel[13]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[10]] > cb)
-                    if(p[pixel[11]] > cb)
-                     if(p[pixel[12]] > cb)
-                      if(p[pixel[13]] > cb)
-                       if(p[pixel[14]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  if(p[pixel[10]] > cb)
-                   if(p[pixel[11]] > cb)
-                    if(p[pixel[12]] > cb)
-                     if(p[pixel[13]] > cb)
-                      if(p[pixel[14]] > cb)
-                       if(p[pixel[15]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else
-                 continue;
-               else
-                continue;
-              else if(p[pixel[8]] < c_b)
-               if(p[pixel[9]] < c_b)
-                if(p[pixel[10]] < c_b)
-                 if(p[pixel[11]] < c_b)
-                  if(p[pixel[12]] < c_b)
-                   if(p[pixel[13]] < c_b)
-                    if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[3]] < c_b)
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  if(p[pixel[2]] < c_b)
-                   if(p[pixel[3]] < c_b)
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else
-                 continue;
-               else
-                continue;
-              else
-               continue;
-             else if(p[pixel[1]] < c_b)
-              if(p[pixel[2]] > cb)
-               if(p[pixel[9]] > cb)
-                if(p[pixel[7]] > cb)
-                 if(p[pixel[8]] > cb)
-                  if(p[pixel[10]] > cb)
-                   if(p[pixel[6]] > cb)
-                    if(p[pixel[5]] > cb)
-                     if(p[pixel[4]] > cb)
-                      if(p[pixel[3]] > cb)
-                       {}
-                      else
-                       if(p[pixel[11]] > cb)
-                        if(p[pixel[12]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                     else
-                      if(p[pixel[11]] > cb)
-                       if(p[pixel[12]] > cb)
-                        if(p[pixel[13]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[11]] > cb)
-                      if(p[pixel[12]] > cb)
-                       if(p[pixel[13]] > cb)
-                        if(p[pixel[14]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[11]] > cb)
-                     if(p[pixel[12]] > cb)
-                      if(p[pixel[13]] > cb)
-                       if(p[pixel[14]] > cb)
-                        if(p[pixel[15]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else if(p[pixel[9]] < c_b)
-                if(p[pixel[10]] < c_b)
-                 if(p[pixel[11]] < c_b)
-                  if(p[pixel[12]] < c_b)
-                   if(p[pixel[13]] < c_b)
-                    if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[3]] < c_b)
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else
-                continue;
-              else if(p[pixel[2]] < c_b)
-               if(p[pixel[3]] > cb)
-                if(p[pixel[10]] > cb)
-                 if(p[pixel[7]] > cb)
-                  if(p[pixel[8]] > cb)
-                   if(p[pixel[9]] > cb)
-                    if(p[pixel[11]] > cb)
-                     if(p[pixel[6]] > cb)
-                      if(p[pixel[5]] > cb)
-                       if(p[pixel[4]] > cb)
-                        {}
-                       else
-                        if(p[pixel[12]] > cb)
-                         if(p[pixel[13]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                      else
-                       if(p[pixel[12]] > cb)
-                        if(p[pixel[13]] > cb)
-                         if(p[pixel[14]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                     else
-                      if(p[pixel[12]] > cb)
-                       if(p[pixel[13]] > cb)
-                        if(p[pixel[14]] > cb)
-                         if(p[pixel[15]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else if(p[pixel[10]] < c_b)
-                 if(p[pixel[11]] < c_b)
-                  if(p[pixel[12]] < c_b)
-                   if(p[pixel[13]] < c_b)
-                    if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else if(p[pixel[3]] < c_b)
-                if(p[pixel[4]] > cb)
-                 if(p[pixel[13]] > cb)
-                  if(p[pixel[7]] > cb)
-                   if(p[pixel[8]] > cb)
-                    if(p[pixel[9]] > cb)
-                     if(p[pixel[10]] > cb)
-                      if(p[pixel[11]] > cb)
-                       if(p[pixel[12]] > cb)
-                        if(p[pixel[6]] > cb)
-                         if(p[pixel[5]] > cb)
-                          {}
-                         else
-                          if(p[pixel[14]] > cb)
-                           {}
-                          else
-                           continue;
-                        else
-                         if(p[pixel[14]] > cb)
-                          if(p[pixel[15]] > cb)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else if(p[pixel[13]] < c_b)
-                  if(p[pixel[11]] > cb)
-                   if(p[pixel[5]] > cb)
-                    if(p[pixel[6]] > cb)
-                     if(p[pixel[7]] > cb)
-                      if(p[pixel[8]] > cb)
-                       if(p[pixel[9]] > cb)
-                        if(p[pixel[10]] > cb)
-                         if(p[pixel[12]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else if(p[pixel[11]] < c_b)
-                   if(p[pixel[12]] < c_b)
-                    if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          if(p[pixel[10]] < c_b)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          if(p[pixel[10]] < c_b)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  if(p[pixel[5]] > cb)
-                   if(p[pixel[6]] > cb)
-                    if(p[pixel[7]] > cb)
-                     if(p[pixel[8]] > cb)
-                      if(p[pixel[9]] > cb)
-                       if(p[pixel[10]] > cb)
-                        if(p[pixel[11]] > cb)
-                         if(p[pixel[12]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else if(p[pixel[4]] < c_b)
-                 if(p[pixel[5]] > cb)
-                  if(p[pixel[14]] > cb)
-                   if(p[pixel[7]] > cb)
-                    if(p[pixel[8]] > cb)
-                     if(p[pixel[9]] > cb)
-                      if(p[pixel[10]] > cb)
-                       if(p[pixel[11]] > cb)
-                        if(p[pixel[12]] > cb)
-                         if(p[pixel[13]] > cb)
-                          if(p[pixel[6]] > cb)
-                           {}
-                          else
-                           if(p[pixel[15]] > cb)
-                            {}
-                           else
-                            continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else if(p[pixel[14]] < c_b)
-                   if(p[pixel[12]] > cb)
-                    if(p[pixel[6]] > cb)
-                     if(p[pixel[7]] > cb)
-                      if(p[pixel[8]] > cb)
-                       if(p[pixel[9]] > cb)
-                        if(p[pixel[10]] > cb)
-                         if(p[pixel[11]] > cb)
-                          if(p[pixel[13]] > cb)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else if(p[pixel[12]] < c_b)
-                    if(p[pixel[13]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          if(p[pixel[10]] < c_b)
-                           if(p[pixel[11]] < c_b)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   if(p[pixel[6]] > cb)
-                    if(p[pixel[7]] > cb)
-                     if(p[pixel[8]] > cb)
-                      if(p[pixel[9]] > cb)
-                       if(p[pixel[10]] > cb)
-                        if(p[pixel[11]] > cb)
-                         if(p[pixel[12]] > cb)
-                          if(p[pixel[13]] > cb)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else if(p[pixel[5]] < c_b)
-                  if(p[pixel[6]] > cb)
-                   if(p[pixel[15]] < c_b)
-                    if(p[pixel[13]] > cb)
-                     if(p[pixel[7]] > cb)
-                      if(p[pixel[8]] > cb)
-                       if(p[pixel[9]] > cb)
-                        if(p[pixel[10]] > cb)
-                         if(p[pixel[11]] > cb)
-                          if(p[pixel[12]] > cb)
-                           if(p[pixel[14]] > cb)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else if(p[pixel[13]] < c_b)
-                     if(p[pixel[14]] < c_b)
-                      {}
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    if(p[pixel[7]] > cb)
-                     if(p[pixel[8]] > cb)
-                      if(p[pixel[9]] > cb)
-                       if(p[pixel[10]] > cb)
-                        if(p[pixel[11]] > cb)
-                         if(p[pixel[12]] > cb)
-                          if(p[pixel[13]] > cb)
-                           if(p[pixel[14]] > cb)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else if(p[pixel[6]] < c_b)
-                   if(p[pixel[7]] > cb)
-                    if(p[pixel[14]] > cb)
-                     if(p[pixel[8]] > cb)
-                      if(p[pixel[9]] > cb)
-                       if(p[pixel[10]] > cb)
-                        if(p[pixel[11]] > cb)
-                         if(p[pixel[12]] > cb)
-                          if(p[pixel[13]] > cb)
-                           if(p[pixel[15]] > cb)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      continue;
-                    else
-                     continue;
-                   else if(p[pixel[7]] < c_b)
-                    if(p[pixel[8]] < c_b)
-                     {}
-                    else
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      continue;
-                   else
-                    if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[13]] > cb)
-                    if(p[pixel[7]] > cb)
-                     if(p[pixel[8]] > cb)
-                      if(p[pixel[9]] > cb)
-                       if(p[pixel[10]] > cb)
-                        if(p[pixel[11]] > cb)
-                         if(p[pixel[12]] > cb)
-                          if(p[pixel[14]] > cb)
-                           if(p[pixel[15]] > cb)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else if(p[pixel[13]] < c_b)
-                    if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  if(p[pixel[12]] > cb)
-                   if(p[pixel[7]] > cb)
-                    if(p[pixel[8]] > cb)
-                     if(p[pixel[9]] > cb)
-                      if(p[pixel[10]] > cb)
-                       if(p[pixel[11]] > cb)
-                        if(p[pixel[13]] > cb)
-                         if(p[pixel[14]] > cb)
-                          if(p[pixel[6]] > cb)
-                           {}
-                          else
-                           if(p[pixel[15]] > cb)
-                            {}
-                           else
-                            continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else if(p[pixel[12]] < c_b)
-                   if(p[pixel[13]] < c_b)
-                    if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          if(p[pixel[10]] < c_b)
-                           if(p[pixel[11]] < c_b)
-                            {}
-                           else
-                            continue;
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else
-                 if(p[pixel[11]] > cb)
-                  if(p[pixel[7]] > cb)
-                   if(p[pixel[8]] > cb)
-                    if(p[pixel[9]] > cb)
-                     if(p[pixel[10]] > cb)
-                      if(p[pixel[12]] > cb)
-                       if(p[pixel[13]] > cb)
-                        if(p[pixel[6]] > cb)
-                         if(p[pixel[5]] > cb)
-                          {}
-                         else
-                          if(p[pixel[14]] > cb)
-                           {}
-                          else
-                           continue;
-                        else
-                         if(p[pixel[14]] > cb)
-                          if(p[pixel[15]] > cb)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else if(p[pixel[11]] < c_b)
-                  if(p[pixel[12]] < c_b)
-                   if(p[pixel[13]] < c_b)
-                    if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          if(p[pixel[10]] < c_b)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          if(p[pixel[10]] < c_b)
-                           {}
-                          else
-                           continue;
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  continue;
-               else
-                if(p[pixel[10]] > cb)
-                 if(p[pixel[7]] > cb)
-                  if(p[pixel[8]] > cb)
-                   if(p[pixel[9]] > cb)
-                    if(p[pixel[11]] > cb)
-                     if(p[pixel[12]] > cb)
-                      if(p[pixel[6]] > cb)
-                       if(p[pixel[5]] > cb)
-                        if(p[pixel[4]] > cb)
-                         {}
-                        else
-                         if(p[pixel[13]] > cb)
-                          {}
-                         else
-                          continue;
-                       else
-                        if(p[pixel[13]] > cb)
-                         if(p[pixel[14]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                      else
-                       if(p[pixel[13]] > cb)
-                        if(p[pixel[14]] > cb)
-                         if(p[pixel[15]] > cb)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else if(p[pixel[10]] < c_b)
-                 if(p[pixel[11]] < c_b)
-                  if(p[pixel[12]] < c_b)
-                   if(p[pixel[13]] < c_b)
-                    if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         if(p[pixel[9]] < c_b)
-                          {}
-                         else
-                          continue;
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else
-                 continue;
-              else
-               if(p[pixel[9]] > cb)
-                if(p[pixel[7]] > cb)
-                 if(p[pixel[8]] > cb)
-                  if(p[pixel[10]] > cb)
-                   if(p[pixel[11]] > cb)
-                    if(p[pixel[6]] > cb)
-                     if(p[pixel[5]] > cb)
-                      if(p[pixel[4]] > cb)
-                       if(p[pixel[3]] > cb)
-                        {}
-                       else
-                        if(p[pixel[12]] > cb)
-                         {}
-                        else
-                         continue;
-                      else
-                       if(p[pixel[12]] > cb)
-                        if(p[pixel[13]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                     else
-                      if(p[pixel[12]] > cb)
-                       if(p[pixel[13]] > cb)
-                        if(p[pixel[14]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[12]] > cb)
-                      if(p[pixel[13]] > cb)
-                       if(p[pixel[14]] > cb)
-                        if(p[pixel[15]] > cb)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else if(p[pixel[9]] < c_b)
-                if(p[pixel[10]] < c_b)
-                 if(p[pixel[11]] < c_b)
-                  if(p[pixel[12]] < c_b)
-                   if(p[pixel[13]] < c_b)
-                    if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[3]] < c_b)
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        if(p[pixel[8]] < c_b)
-                         {}
-                        else
-                         continue;
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else
-                continue;
-             else
-              if(p[pixel[8]] > cb)
-               if(p[pixel[7]] > cb)
-                if(p[pixel[9]] > cb)
-                 if(p[pixel[10]] > cb)
-                  if(p[pixel[6]] > cb)
-                   if(p[pixel[5]] > cb)
-                    if(p[pixel[4]] > cb)
-                     if(p[pixel[3]] > cb)
-                      if(p[pixel[2]] > cb)
-                       {}
-                      else
-                       if(p[pixel[11]] > cb)
-                        {}
-                       else
-                        continue;
-                     else
-                      if(p[pixel[11]] > cb)
-                       if(p[pixel[12]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[11]] > cb)
-                      if(p[pixel[12]] > cb)
-                       if(p[pixel[13]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[11]] > cb)
-                     if(p[pixel[12]] > cb)
-                      if(p[pixel[13]] > cb)
-                       if(p[pixel[14]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[11]] > cb)
-                    if(p[pixel[12]] > cb)
-                     if(p[pixel[13]] > cb)
-                      if(p[pixel[14]] > cb)
-                       if(p[pixel[15]] > cb)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  continue;
-                else
-                 continue;
-               else
-                continue;
-              else if(p[pixel[8]] < c_b)
-               if(p[pixel[9]] < c_b)
-                if(p[pixel[10]] < c_b)
-                 if(p[pixel[11]] < c_b)
-                  if(p[pixel[12]] < c_b)
-                   if(p[pixel[13]] < c_b)
-                    if(p[pixel[14]] < c_b)
-                     if(p[pixel[15]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                    else
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[3]] < c_b)
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  if(p[pixel[2]] < c_b)
-                   if(p[pixel[3]] < c_b)
-                    if(p[pixel[4]] < c_b)
-                     if(p[pixel[5]] < c_b)
-                      if(p[pixel[6]] < c_b)
-                       if(p[pixel[7]] < c_b)
-                        {}
-                       else
-                        continue;
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else
-                 continue;
-               else
-                continue;
-              else
-               continue;
-            else
-             if(p[pixel[7]] > cb)
-              if(p[pixel[8]] > cb)
-               if(p[pixel[9]] > cb)
-                if(p[pixel[6]] > cb)
-                 if(p[pixel[5]] > cb)
-                  if(p[pixel[4]] > cb)
-                   if(p[pixel[3]] > cb)
-                    if(p[pixel[2]] > cb)
-                     if(p[pixel[1]] > cb)
-                      {}
-                     else
-                      if(p[pixel[10]] > cb)
-                       {}
-                      else
-                       continue;
-                    else
-                     if(p[pixel[10]] > cb)
-                      if(p[pixel[11]] > cb)
-                       {}
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[10]] > cb)
-                     if(p[pixel[11]] > cb)
-                      if(p[pixel[12]] > cb)
-                       {}
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[10]] > cb)
-                    if(p[pixel[11]] > cb)
-                     if(p[pixel[12]] > cb)
-                      if(p[pixel[13]] > cb)
-                       {}
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  if(p[pixel[10]] > cb)
-                   if(p[pixel[11]] > cb)
-                    if(p[pixel[12]] > cb)
-                     if(p[pixel[13]] > cb)
-                      if(p[pixel[14]] > cb)
-                       {}
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else
-                 if(p[pixel[10]] > cb)
-                  if(p[pixel[11]] > cb)
-                   if(p[pixel[12]] > cb)
-                    if(p[pixel[13]] > cb)
-                     if(p[pixel[14]] > cb)
-                      if(p[pixel[15]] > cb)
-                       {}
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  continue;
-               else
-                continue;
-              else
-               continue;
-             else if(p[pixel[7]] < c_b)
-              if(p[pixel[8]] < c_b)
-               if(p[pixel[9]] < c_b)
-                if(p[pixel[6]] < c_b)
-                 if(p[pixel[5]] < c_b)
-                  if(p[pixel[4]] < c_b)
-                   if(p[pixel[3]] < c_b)
-                    if(p[pixel[2]] < c_b)
-                     if(p[pixel[1]] < c_b)
-                      {}
-                     else
-                      if(p[pixel[10]] < c_b)
-                       {}
-                      else
-                       continue;
-                    else
-                     if(p[pixel[10]] < c_b)
-                      if(p[pixel[11]] < c_b)
-                       {}
-                      else
-                       continue;
-                     else
-                      continue;
-                   else
-                    if(p[pixel[10]] < c_b)
-                     if(p[pixel[11]] < c_b)
-                      if(p[pixel[12]] < c_b)
-                       {}
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                  else
-                   if(p[pixel[10]] < c_b)
-                    if(p[pixel[11]] < c_b)
-                     if(p[pixel[12]] < c_b)
-                      if(p[pixel[13]] < c_b)
-                       {}
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                 else
-                  if(p[pixel[10]] < c_b)
-                   if(p[pixel[11]] < c_b)
-                    if(p[pixel[12]] < c_b)
-                     if(p[pixel[13]] < c_b)
-                      if(p[pixel[14]] < c_b)
-                       {}
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                else
-                 if(p[pixel[10]] < c_b)
-                  if(p[pixel[11]] < c_b)
-                   if(p[pixel[12]] < c_b)
-                    if(p[pixel[13]] < c_b)
-                     if(p[pixel[14]] < c_b)
-                      if(p[pixel[15]] < c_b)
-                       {}
-                      else
-                       continue;
-                     else
-                      continue;
-                    else
-                     continue;
-                   else
-                    continue;
-                  else
-                   continue;
-                 else
-                  continue;
-               else
+    if ((x_end <= x_start) || (y_end <= y_start) || (max_corners <= 0)) {
+        return 0;
+    }
+
+    make_offsets(pixel, image->w);
+
+    // Scores + 1 of the last 3 rows (0 if not a corner) with one column of padding on each side.
+    int row_w = x_end - x_start + 2;
+    uint8_t *rows = fb_alloc0(FAST_ROWS_SIZE(x_end - x_start), FB_ALLOC_NO_HINT);
+    uint8_t *prev = rows + 1;
+    uint8_t *curr = prev + row_w;
+    uint8_t *next = curr + row_w;
+
+    // Optional grid of cells each keeping its strongest corners.
+    int cells_w = 0;
+    uint16_t *cell_count = NULL;
+    corner_t *cells = NULL;
+
+    if ((cell_size > 0) && (cell_max > 0)) {
+        cells_w = (roi->w + cell_size - 1) / cell_size;
+        int cells_h = (roi->h + cell_size - 1) / cell_size;
+        cell_count = fb_alloc0(cells_w * cells_h * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+        cells = fb_alloc(cells_w * cells_h * cell_max * sizeof(corner_t), FB_ALLOC_NO_HINT);
+    }
+
+    fast9_block_t blk;
+
+    // Each row is scored and the row above it is suppressed. The extra last row is empty.
+    for (int y = y_start; y <= y_end; y++) {
+        memset(next - 1, 0, row_w);
+
+        if (y < y_end) {
+            const uint8_t *row = image->pixels + (y * image->w);
+            for (int x = x_start; x < x_end; x += FAST_BLOCK) {
+                blk.p = row + x;
+                blk.n = IM_MIN(FAST_BLOCK, x_end - x);
+                blk.vector = (x + FAST_BLOCK + 3) <= image->w;
+                for (uint32_t mask = fast9_block_detect(&blk, b); mask; mask &= mask - 1) {
+                    int i = __builtin_ctz(mask);
+                    next[x - x_start + i] = fast9_corner_score(row + x + i, b) + 1;
+                }
+            }
+        }
+
+        for (int i = 0; (y > y_start) && (i < (row_w - 2)); i++) {
+            int s = curr[i];
+            if ((!s) ||
+                Compare(curr[i - 1], s) || Compare(curr[i + 1], s) ||
+                Compare(prev[i - 1], s) || Compare(prev[i], s) || Compare(prev[i + 1], s) ||
+                Compare(next[i - 1], s) || Compare(next[i], s) || Compare(next[i + 1], s)) {
                 continue;
-              else
-               continue;
-             else
-              continue;
+            }
 
-            // Add corner
-            corners[num_corners].x = x;
-            corners[num_corners].y = y;
+            corner_t corner = { .x = x_start + i, .y = y - 1, .score = s - 1 };
 
-            if (++num_corners == max_corners) {
-                goto done;
+            if (cells) {
+                int index = (((corner.y - roi->y) / cell_size) * cells_w) + ((corner.x - roi->x) / cell_size);
+                fast_cell_insert(cells + (index * cell_max), cell_count + index, cell_max, corner);
+            } else {
+                corners[num_corners++] = corner;
+                if (num_corners == max_corners) {
+                    goto done;
+                }
+            }
+        }
+
+        uint8_t *tmp = prev;
+        prev = curr;
+        curr = next;
+        next = tmp;
+    }
+
+    // Copy out the cells in raster order.
+    if (cells) {
+        int cells_h = (roi->h + cell_size - 1) / cell_size;
+        for (int i = 0; i < (cells_w * cells_h); i++) {
+            for (int j = 0; (j < cell_count[i]) && (num_corners < max_corners); j++) {
+                corners[num_corners++] = cells[(i * cell_max) + j];
             }
-		}
+        }
     }
 
 done:
-    *n_corners = num_corners;
-    return corners;
+    if (cells) {
+        fb_free(); // cells
+        fb_free(); // cell_count
+    }
+    fb_free(); // rows
+    return num_corners;
+}
+
+void fast_detect(image_t *image, array_t *keypoints, int threshold, rectangle_t *roi) {
+    gc_info_t info;
+
+    // Try to alloc MAX_CORNERS or the actual max corners we can alloc, leaving room for the rows.
+    uint32_t avail = fb_avail();
+    uint32_t reserved = FAST_ROWS_SIZE(roi->w) + 64;
+    int max_corners = IM_MIN(MAX_CORNERS, (avail > reserved) ? ((avail - reserved) / sizeof(corner_t)) : 0);
+    corner_t *corners = fb_alloc(max_corners * sizeof(corner_t), FB_ALLOC_NO_HINT);
+    int num_corners = fast_detect_corners(image, corners, max_corners, threshold, roi, 0, 0);
+
+    for (int i = 0; i < num_corners; i++) {
+        gc_info(&info);
+        // Allocate keypoints until we're almost out of memory
+        if (info.free < MIN_MEM) {
+            // Try collecting memory
+            gc_collect();
+            // If it didn't work break
+            gc_info(&info);
+            if (info.free < MIN_MEM) {
+                break;
+            }
+        }
+        array_push_back(keypoints, alloc_keypoint(corners[i].x, corners[i].y, corners[i].score));
+    }
+
+    // Free corners;
+    fb_free();
 }
-// *INDENT-ON*
 
 #endif //IMLIB_ENABLE_FAST
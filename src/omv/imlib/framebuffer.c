@@ -147,7 +147,8 @@ void framebuffer_update_jpeg_buffer() {
     framebuffer_init_image(&main_fb_src);
     image_t *src = &main_fb_src;
 
-    if (src->pixfmt != PIXFORMAT_INVALID &&
+    // QOI frames are only for buffering in RAM and cannot be decoded by the IDE.
+    if (src->pixfmt != PIXFORMAT_INVALID && src->pixfmt != PIXFORMAT_QOI &&
         framebuffer->streaming_enabled && jpeg_framebuffer->enabled) {
         if (src->is_compressed) {
             bool does_not_fit = false;
@@ -83,7 +83,7 @@ void imlib_find_hog(image_t *src, rectangle_t *roi, int cell_size) {
                             t = (t == 9)? 0 : t;
 
                             // hog[((cy/cell_size) * x_cells + (cx/cell_size)) * N_BINS + t] += m;
-                            hog[hog_index + (((cy / 8) * 2 + (cx / 8)) * N_BINS) + t] += m;
+                            hog[hog_index + (((cy / cell_size) * 2 + (cx / cell_size)) * N_BINS) + t] += m;
                         }
                     }
                 }
@@ -148,4 +148,258 @@ void imlib_find_hog(image_t *src, rectangle_t *roi, int cell_size) {
     xfree(gds);
     fb_free();
 }
+
+// cos() and sin() of the bin centers (0, 20, ... 180 degrees) in Q12.
+static const int16_t hog_cos[HOG_BINS + 1] = {
+    4096, 3849, 3138, 2048, 711, -711, -2048, -3138, -3849, -4096
+};
+
+static const int16_t hog_sin[HOG_BINS + 1] = {
+    0, 1401, 2633, 3547, 4034, 4034, 3547, 2633, 1401, 0
+};
+
+static uint32_t hog_isqrt(uint32_t x) {
+    uint32_t r = 0;
+
+    for (uint32_t bit = 1UL << 30; bit; bit >>= 2) {
+        if (x >= (r + bit)) {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+    }
+
+    return r;
+}
+
+// Splits a cell grid axis into the cell to the left/top of each pixel center and the
+// Q8 weight of the cell to the right/bottom. Cells are offset by one for the border.
+static void hog_cell_weights(int cell_size, int n, int16_t *cell, uint16_t *weight) {
+    for (int i = 0; i < n; i++) {
+        int p = (i * 2) + 1 + cell_size;
+        int c = p / (cell_size * 2);
+        cell[i] = c;
+        weight[i] = ((p - (c * cell_size * 2)) * 256) / (cell_size * 2);
+    }
+}
+
+// Computes the cell histograms with a 1 cell border. Each pixel votes for the two nearest
+// orientation bins and is bilinearly interpolated between the four nearest cell centers.
+//
+// The orientation is found by comparing the gradient against the bin centers instead of
+// using atan2(). With the gradient folded into [0, 180) degrees, g x c[k] >= 0 means the
+// angle is past bin k. The cross products with the two neighbouring bin centers are
+// |g| * sin(a) and |g| * sin(20 - a) which sum to |g| * sin(20) within 1.5%, so they are
+// used directly as the interpolated votes for each bin without a sqrt() or a divide.
+static void hog_compute_cells(image_t *img, rectangle_t *roi, int cell_size,
+                              int cells_w, int cells_h, uint32_t *hist) {
+    int w = cells_w * cell_size;
+    int h = cells_h * cell_size;
+    int stride = (cells_w + 2) * HOG_BINS;
+
+    int16_t *col_cell = fb_alloc(w * sizeof(int16_t), FB_ALLOC_NO_HINT);
+    uint16_t *col_weight = fb_alloc(w * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+    int16_t *row_cell = fb_alloc(h * sizeof(int16_t), FB_ALLOC_NO_HINT);
+    uint16_t *row_weight = fb_alloc(h * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+
+    hog_cell_weights(cell_size, w, col_cell, col_weight);
+    hog_cell_weights(cell_size, h, row_cell, row_weight);
+
+    for (int y = 0; y < h; y++) {
+        int iy = roi->y + y;
+        uint8_t *row = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, iy);
+        uint8_t *row_up = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, IM_MAX(iy - 1, 0));
+        uint8_t *row_down = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, IM_MIN(iy + 1, img->h - 1));
+        uint32_t *hist_row = hist + (row_cell[y] * stride);
+        uint32_t wy1 = row_weight[y];
+        uint32_t wy0 = 256 - wy1;
+
+        for (int x = 0; x < w; x++) {
+            int ix = roi->x + x;
+            int gx = row[IM_MIN(ix + 1, img->w - 1)] - row[IM_MAX(ix - 1, 0)];
+            int gy = row_down[ix] - row_up[ix];
+
+            // Fold the gradient into [0, 180) degrees.
+            if ((gy < 0) || ((gy == 0) && (gx < 0))) {
+                gx = -gx;
+                gy = -gy;
+            }
+
+            if (!(gx | gy)) {
+                continue;
+            }
+
+            int k = 0;
+            for (int step = 8; step; step >>= 1) {
+                int i = k + step;
+                if ((i < HOG_BINS) && ((gy * hog_cos[i]) >= (gx * hog_sin[i]))) {
+                    k = i;
+                }
+            }
+
+            uint32_t v0 = ((gx * hog_sin[k + 1]) - (gy * hog_cos[k + 1])) >> 8;
+            uint32_t v1 = ((gy * hog_cos[k]) - (gx * hog_sin[k])) >> 8;
+            int k1 = (k + 1 == HOG_BINS) ? 0 : (k + 1);
+
+            uint32_t wx1 = col_weight[x];
+            uint32_t wx0 = 256 - wx1;
+            uint32_t w00 = (wy0 * wx0) >> 8, w01 = (wy0 * wx1) >> 8;
+            uint32_t w10 = (wy1 * wx0) >> 8, w11 = (wy1 * wx1) >> 8;
+            uint32_t *h00 = hist_row + (col_cell[x] * HOG_BINS);
+            uint32_t *h10 = h00 + stride;
+
+            h00[k] += v0 * w00;
+            h00[k1] += v1 * w00;
+            h00[HOG_BINS + k] += v0 * w01;
+            h00[HOG_BINS + k1] += v1 * w01;
+            h10[k] += v0 * w10;
+            h10[k1] += v1 * w10;
+            h10[HOG_BINS + k] += v0 * w11;
+            h10[HOG_BINS + k1] += v1 * w11;
+        }
+    }
+
+    fb_free(); // row_weight
+    fb_free(); // row_cell
+    fb_free(); // col_weight
+    fb_free(); // col_cell
+}
+
+// L2-Hys normalizes a 2x2 cell block: L2 normalize, clip to 0.2 and renormalize.
+static void hog_normalize_block(uint32_t *hist, int stride, uint8_t *out) {
+    uint32_t v[HOG_BLOCK_BINS];
+    uint32_t max = 0;
+
+    for (int i = 0; i < HOG_BINS; i++) {
+        v[i] = hist[i];
+        v[HOG_BINS + i] = hist[HOG_BINS + i];
+        v[(HOG_BINS * 2) + i] = hist[stride + i];
+        v[(HOG_BINS * 3) + i] = hist[stride + HOG_BINS + i];
+    }
+
+    for (int i = 0; i < HOG_BLOCK_BINS; i++) {
+        max = IM_MAX(max, v[i]);
+    }
+
+    if (!max) {
+        memset(out, 0, HOG_BLOCK_BINS);
+        return;
+    }
+
+    // Scale the block down to 12-bits so the sum of squares fits in 32-bits.
+    int shift = IM_MAX(0, 20 - __builtin_clz(max));
+    uint32_t sum = 1;
+
+    for (int i = 0; i < HOG_BLOCK_BINS; i++) {
+        v[i] >>= shift;
+        sum += v[i] * v[i];
+    }
+
+    // Q8 with the 0.2 clip at 51.
+    uint32_t norm = hog_isqrt(sum);
+    sum = 1;
+
+    for (int i = 0; i < HOG_BLOCK_BINS; i++) {
+        v[i] = IM_MIN((v[i] << 8) / norm, 51U);
+        sum += v[i] * v[i];
+    }
+
+    norm = hog_isqrt(sum);
+
+    for (int i = 0; i < HOG_BLOCK_BINS; i++) {
+        out[i] = IM_MIN(((v[i] * 255) + (norm / 2)) / norm, 255U);
+    }
+}
+
+void imlib_hog_compute(hog_t *hog, image_t *img, rectangle_t *roi, int cell_size) {
+    hog->x = roi->x;
+    hog->y = roi->y;
+    hog->cell_size = cell_size;
+    hog->cells_w = roi->w / cell_size;
+    hog->cells_h = roi->h / cell_size;
+    hog->blocks_w = IM_MAX(hog->cells_w - 1, 0);
+    hog->blocks_h = IM_MAX(hog->cells_h - 1, 0);
+    hog->blocks = fb_alloc(IM_MAX(hog->blocks_w * hog->blocks_h, 1) * HOG_BLOCK_BINS, FB_ALLOC_NO_HINT);
+
+    if (!(hog->blocks_w && hog->blocks_h)) {
+        return;
+    }
+
+    // Histograms with a 1 cell border to skip bounds checks.
+    int stride = (hog->cells_w + 2) * HOG_BINS;
+    uint32_t *hist = fb_alloc0(stride * (hog->cells_h + 2) * sizeof(uint32_t), FB_ALLOC_NO_HINT);
+    hog_compute_cells(img, roi, cell_size, hog->cells_w, hog->cells_h, hist);
+
+    for (int y = 0; y < hog->blocks_h; y++) {
+        for (int x = 0; x < hog->blocks_w; x++) {
+            uint32_t *block = hist + ((y + 1) * stride) + ((x + 1) * HOG_BINS);
+            hog_normalize_block(block, stride, hog->blocks + (((y * hog->blocks_w) + x) * HOG_BLOCK_BINS));
+        }
+    }
+
+    fb_free(); // hist
+}
+
+void imlib_hog_free(hog_t *hog) {
+    fb_free(); // blocks
+}
+
+int imlib_hog_descriptor_size(int cells_w, int cells_h) {
+    return (cells_w - 1) * (cells_h - 1) * HOG_BLOCK_BINS;
+}
+
+void imlib_hog_get_descriptor(hog_t *hog, int cell_x, int cell_y, int cells_w, int cells_h, uint8_t *out) {
+    int n = (cells_w - 1) * HOG_BLOCK_BINS;
+
+    for (int y = 0; y < (cells_h - 1); y++, out += n) {
+        memcpy(out, hog->blocks + ((((cell_y + y) * hog->blocks_w) + cell_x) * HOG_BLOCK_BINS), n);
+    }
+}
+
+int64_t imlib_hog_svm_score(hog_t *hog, int cell_x, int cell_y, int cells_w, int cells_h, const int16_t *weights) {
+    int n = (cells_w - 1) * HOG_BLOCK_BINS;
+    int64_t score = 0;
+
+    for (int y = 0; y < (cells_h - 1); y++) {
+        const uint8_t *block = hog->blocks + ((((cell_y + y) * hog->blocks_w) + cell_x) * HOG_BLOCK_BINS);
+
+        for (int x = 0; x < n; x += HOG_BLOCK_BINS, block += HOG_BLOCK_BINS, weights += HOG_BLOCK_BINS) {
+            // A single block can't overflow 32-bits.
+            int32_t acc = 0;
+
+            for (int i = 0; i < HOG_BLOCK_BINS; i++) {
+                acc += block[i] * weights[i];
+            }
+
+            score += acc;
+        }
+    }
+
+    return score;
+}
+
+void imlib_hog_detect(list_t *out, hog_t *hog, int cells_w, int cells_h, int step,
+                      const int16_t *weights, float scale, float bias, float threshold) {
+    list_init(out, sizeof(bounding_box_lnk_data_t));
+
+    // The blocks are shared by all overlapping windows so each window is only a dot product.
+    for (int y = 0; (y + cells_h) <= hog->cells_h; y += step) {
+        for (int x = 0; (x + cells_w) <= hog->cells_w; x += step) {
+            float score = (imlib_hog_svm_score(hog, x, y, cells_w, cells_h, weights) * scale) + bias;
+
+            if (score >= threshold) {
+                bounding_box_lnk_data_t lnk_data;
+                rectangle_init(&lnk_data.rect,
+                               hog->x + (x * hog->cell_size),
+                               hog->y + (y * hog->cell_size),
+                               cells_w * hog->cell_size,
+                               cells_h * hog->cell_size);
+                lnk_data.score = score;
+                lnk_data.label_index = 0;
+                rectangle_nms_add_bounding_box(out, &lnk_data);
+            }
+        }
+    }
+}
 #endif // IMLIB_ENABLE_HOG
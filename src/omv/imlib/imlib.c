@@ -624,7 +624,8 @@ bool imlib_read_geometry(FIL *fp, image_t *img, const char *path, img_read_setti
 #endif  //IMLIB_ENABLE_IMAGE_FILE_IO
 
 #if defined(IMLIB_ENABLE_IMAGE_FILE_IO)
-void imlib_load_image(image_t *img, const char *path) {
+// Loads an image file, roi (if not NULL) selects the part of a BMP or PPM/PGM file to load.
+void imlib_load_image(image_t *img, const char *path, rectangle_t *roi) {
     FIL fp;
     char magic[4];
     file_open(&fp, path, false, FA_READ | FA_OPEN_EXISTING);
@@ -635,10 +636,12 @@ void imlib_load_image(image_t *img, const char *path) {
         && ((magic[1] == '2') || (magic[1] == '3')
             || (magic[1] == '5') || (magic[1] == '6'))) {
         // PPM
-        ppm_read(img, path);
+        ppm_read(img, path, roi);
     } else if ((magic[0] == 'B') && (magic[1] == 'M')) {
         // BMP
-        bmp_read(img, path);
+        bmp_read(img, path, roi);
+    } else if (roi) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("ROI loading is only supported for BMP/PPM/PGM images!"));
     } else if ((magic[0] == 0xFF) && (magic[1] == 0xD8)) {
         // JPEG
         jpeg_read(img, path);
@@ -652,6 +655,10 @@ void imlib_load_image(image_t *img, const char *path) {
 }
 
 void imlib_save_image(image_t *img, const char *path, rectangle_t *roi, int quality) {
+    if (img->pixfmt == PIXFORMAT_QOI) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("QOI images must be decompressed before saving!"));
+    }
+
     switch (imblib_parse_extension(img, path)) {
         case FORMAT_BMP:
             bmp_write_subimg(img, path, roi);
@@ -399,6 +399,7 @@ typedef enum {
     PIXFORMAT_ID_JPEG   = 6,
     PIXFORMAT_ID_PNG    = 7,
     PIXFORMAT_ID_ARGB8  = 8,
+    PIXFORMAT_ID_QOI    = 9,
     /* Note: Update PIXFORMAT_IS_VALID when adding new formats */
 } pixformat_id_t;
 
@@ -442,7 +443,7 @@ typedef enum {
 #define PIXFORMAT_FLAGS_Y          (1 << 28) // YUV format.
 #define PIXFORMAT_FLAGS_M          (1 << 27) // Mutable format.
 #define PIXFORMAT_FLAGS_C          (1 << 26) // Colored format.
-#define PIXFORMAT_FLAGS_J          (1 << 25) // Compressed format (JPEG/PNG).
+#define PIXFORMAT_FLAGS_J          (1 << 25) // Compressed format (JPEG/PNG/QOI).
 #define PIXFORMAT_FLAGS_R          (1 << 24) // RAW/Bayer format.
 #define PIXFORMAT_FLAGS_CY         (PIXFORMAT_FLAGS_C | PIXFORMAT_FLAGS_Y)
 #define PIXFORMAT_FLAGS_CM         (PIXFORMAT_FLAGS_C | PIXFORMAT_FLAGS_M)
@@ -471,6 +472,7 @@ typedef enum {
   PIXFORMAT_YVU422     = (PIXFORMAT_FLAGS_CY | (PIXFORMAT_ID_YUV422 << 16) | (SUBFORMAT_ID_YVU422 << 8) | PIXFORMAT_BPP_YUV422 ),
   PIXFORMAT_JPEG       = (PIXFORMAT_FLAGS_CJ | (PIXFORMAT_ID_JPEG   << 16) | (0                   << 8) | 0                    ),
   PIXFORMAT_PNG        = (PIXFORMAT_FLAGS_CJ | (PIXFORMAT_ID_PNG    << 16) | (0                   << 8) | 0                    ),
+  PIXFORMAT_QOI        = (PIXFORMAT_FLAGS_CJ | (PIXFORMAT_ID_QOI    << 16) | (0                   << 8) | 0                    ),
   PIXFORMAT_LAST       = (0xFFFFFFFFU),
 } pixformat_t;
 // *INDENT-ON*
@@ -493,7 +495,8 @@ typedef enum {
 
 #define PIXFORMAT_COMPRESSED_ANY \
     PIXFORMAT_JPEG:              \
-    case PIXFORMAT_PNG           \
+    case PIXFORMAT_PNG:          \
+    case PIXFORMAT_QOI           \
 
 #define IMLIB_PIXFORMAT_IS_VALID(x) \
     ((x == PIXFORMAT_BINARY)        \
@@ -507,7 +510,8 @@ typedef enum {
      || (x == PIXFORMAT_YUV422)     \
      || (x == PIXFORMAT_YVU422)     \
      || (x == PIXFORMAT_JPEG)       \
-     || (x == PIXFORMAT_PNG))       \
+     || (x == PIXFORMAT_PNG)        \
+     || (x == PIXFORMAT_QOI))       \
 
 // *INDENT-OFF*
 #if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
@@ -563,6 +567,15 @@ typedef struct image {
     };
 } image_t;
 
+#define IMAGE_PYRAMID_MAX_LEVELS    (4)
+#define IMAGE_PYRAMID_MIN_SIZE      (16)
+
+// Level 0 is the source image, each level above it is half the size.
+typedef struct image_pyramid {
+    int levels;
+    image_t images[IMAGE_PYRAMID_MAX_LEVELS];
+} image_pyramid_t;
+
 void image_init(image_t *ptr, int w, int h, pixformat_t pixfmt, uint32_t size, void *pixels);
 void image_copy(image_t *dst, image_t *src);
 size_t image_line_size(image_t *ptr);
@@ -920,6 +933,40 @@ typedef struct kp {
     uint8_t desc[32];
 } kp_t;
 
+typedef struct corner {
+    uint16_t x;
+    uint16_t y;
+    uint16_t score;
+} corner_t;
+
+#define KLT_MAX_WINDOW  (15)
+
+typedef struct klt_point {
+    int32_t x;      // Position in 1/256 pixels.
+    int32_t y;
+    uint16_t id;
+    uint16_t age;   // Number of frames tracked.
+} klt_point_t;
+
+#define MOTION_MAX_RANGE    (15)
+
+typedef struct motion_vector {
+    int8_t x;       // Motion of the block from the previous image.
+    int8_t y;
+    uint16_t sad;   // Sum of absolute differences of the match.
+} motion_vector_t;
+
+#define HOG_BINS            (9)
+#define HOG_BLOCK_BINS      (HOG_BINS * 4)
+
+typedef struct hog {
+    int x, y;               // Origin of the cell grid.
+    int cell_size;
+    int cells_w, cells_h;
+    int blocks_w, blocks_h;
+    uint8_t *blocks;        // L2-Hys normalized 2x2 cell blocks where 255 is 1.0.
+} hog_t;
+
 typedef struct size {
     int w;
     int h;
@@ -954,12 +1001,14 @@ typedef struct bmp_read_settings {
     uint16_t bmp_bpp;
     uint32_t bmp_fmt;
     uint32_t bmp_row_bytes;
+    uint32_t bmp_offset;
 } bmp_read_settings_t;
 
 typedef struct ppm_read_settings {
     uint8_t read_int_c;
     bool read_int_c_valid;
     uint8_t ppm_fmt;
+    int32_t ppm_w;
 } ppm_read_settings_t;
 
 typedef struct jpg_read_settings {
@@ -1017,6 +1066,13 @@ typedef enum corner_detector_type {
     CORNER_AGAST
 } corner_detector_t;
 
+typedef enum adaptive_threshold_method {
+    ADAPTIVE_THRESHOLD_MEAN,    // pixel > local mean - offset
+    ADAPTIVE_THRESHOLD_BRADLEY, // pixel > local mean * (100 - offset) / 100
+    ADAPTIVE_THRESHOLD_SAUVOLA, // pixel > local mean * (1 + k * (local stdev / 128 - 1))
+    ADAPTIVE_THRESHOLD_MINMAX   // pixel > (tile min + tile max) / 2, offset = min contrast
+} adaptive_threshold_method_t;
+
 typedef struct histogram {
     int LBinCount;
     float *LBins;
@@ -1141,6 +1197,12 @@ typedef struct find_barcodes_list_lnk_data {
     int quality;
 } find_barcodes_list_lnk_data_t;
 
+typedef enum find_codes_type {
+    CODE_QRCODE     = 1,
+    CODE_DATAMATRIX = 2,
+    CODE_BARCODE    = 4
+} find_codes_type_t;
+
 typedef enum image_hint {
     IMAGE_HINT_AREA      = (1 << 0),
     IMAGE_HINT_BILINEAR  = (1 << 1),
@@ -1175,6 +1237,40 @@ typedef struct imlib_draw_row_data {
 
 typedef void (*imlib_draw_row_callback_t) (int x_start, int x_end, int y_row, imlib_draw_row_data_t *data);
 
+typedef enum {
+    DRAW_LIST_RECTANGLE,
+    DRAW_LIST_CIRCLE,
+    DRAW_LIST_LINE,
+} draw_list_cmd_type_t;
+
+// Recorded primitive, x0, y0, x1, y1 meaning depends on the type.
+typedef struct draw_list_cmd {
+    uint8_t type;
+    uint8_t fill;
+    uint16_t thickness;
+    int32_t x0, y0, x1, y1;
+    int32_t y_start, y_end; // Rows covered (inclusive).
+    int32_t c;
+} draw_list_cmd_t;
+
+typedef struct draw_list {
+    draw_list_cmd_t *cmds;
+    int count;
+    int capacity;
+} draw_list_t;
+
+// Glyphs pre-rendered for one text style, each glyph is rendered on first use.
+typedef struct glyph_cache {
+    float scale;
+    int char_rotation;
+    int string_rotation;
+    bool char_hmirror;
+    bool char_vflip;
+    bool antialias;
+    bool enabled; // Glyphs are drawn directly when false.
+    struct glyph_cache_entry *glyphs[95];
+} glyph_cache_t;
+
 // Library Hardware Init
 void imlib_init_all();
 void imlib_deinit_all();
@@ -1204,12 +1300,12 @@ uint16_t imlib_yuv_to_rgb(uint8_t y, int8_t u, int8_t v);
 
 /* Image file functions */
 void ppm_read_geometry(FIL *fp, image_t *img, const char *path, ppm_read_settings_t *rs);
-void ppm_read_pixels(FIL *fp, image_t *img, int n_lines, ppm_read_settings_t *rs);
-void ppm_read(image_t *img, const char *path);
+void ppm_read_pixels(FIL *fp, image_t *img, rectangle_t *r, ppm_read_settings_t *rs);
+void ppm_read(image_t *img, const char *path, rectangle_t *roi);
 void ppm_write_subimg(image_t *img, const char *path, rectangle_t *r);
 bool bmp_read_geometry(FIL *fp, image_t *img, const char *path, bmp_read_settings_t *rs);
-void bmp_read_pixels(FIL *fp, image_t *img, int n_lines, bmp_read_settings_t *rs);
-void bmp_read(image_t *img, const char *path);
+void bmp_read_pixels(FIL *fp, image_t *img, rectangle_t *r, bmp_read_settings_t *rs);
+void bmp_read(image_t *img, const char *path, rectangle_t *roi);
 void bmp_write_subimg(image_t *img, const char *path, rectangle_t *r);
 #if (OMV_JPEG_CODEC_ENABLE == 1)
 void imlib_hardware_jpeg_init();
@@ -1218,6 +1314,7 @@ void imlib_hardware_jpeg_deinit();
 void jpeg_get_mcu(image_t *src, int x_offset, int y_offset, int dx, int dy,
                   int8_t *Y0, int8_t *CB, int8_t *CR);
 void jpeg_decompress(image_t *dst, image_t *src);
+void jpeg_decompress_roi(image_t *dst, image_t *src, rectangle_t *roi, int scale);
 bool jpeg_compress(image_t *src, image_t *dst, int quality, bool realloc, jpeg_subsampling_t subsampling);
 bool jpeg_is_valid(image_t *img);
 int jpeg_clean_trailing_bytes(int bpp, uint8_t *data);
@@ -1231,9 +1328,12 @@ void png_read_geometry(FIL *fp, image_t *img, const char *path, png_read_setting
 void png_read_pixels(FIL *fp, image_t *img);
 void png_read(image_t *img, const char *path);
 void png_write(image_t *img, const char *path);
+#define QOI_HEADER_SIZE (4)
+bool qoi_compress(image_t *src, image_t *dst);
+void qoi_decompress(image_t *dst, image_t *src);
 bool imlib_read_geometry(FIL *fp, image_t *img, const char *path, img_read_settings_t *rs);
 void imlib_image_operation(image_t *img, const char *path, image_t *other, int scalar, line_op_t op, void *data);
-void imlib_load_image(image_t *img, const char *path);
+void imlib_load_image(image_t *img, const char *path, rectangle_t *roi);
 void imlib_save_image(image_t *img, const char *path, rectangle_t *roi, int quality);
 
 /* GIF functions */
@@ -1304,6 +1404,24 @@ array_t *imlib_detect_objects(struct image *image, struct cascade *cascade, stru
 
 /* Corner detectors */
 void fast_detect(image_t *image, array_t *keypoints, int threshold, rectangle_t *roi);
+// Finds up to max_corners FAST-9 corners after non-max suppression. If cell_size is non-zero only the
+// cell_max strongest corners of each cell_size x cell_size cell of the ROI are kept. Returns the count.
+int fast_detect_corners(image_t *image, corner_t *corners, int max_corners, int threshold,
+                        rectangle_t *roi, int cell_size, int cell_max);
+
+/* Image pyramid */
+void imlib_pyramid_build(image_pyramid_t *pyramid, image_t *img, int levels);
+void imlib_pyramid_free(image_pyramid_t *pyramid);
+
+/* KLT feature tracker */
+// Tracks the points from the prev to the curr pyramid in place. Lost points are removed and
+// the number of points left is returned.
+int imlib_klt_track(image_pyramid_t *prev, image_pyramid_t *curr, klt_point_t *points, int n,
+                    int window, int iterations, int max_error);
+// Adds the strongest corners of the cells without points until there are max_points points.
+// Returns the number of points.
+int imlib_klt_detect(image_t *img, klt_point_t *points, int n, int max_points,
+                     int threshold, int cell_size, uint16_t *next_id);
 void agast_detect(image_t *image, array_t *keypoints, int threshold, rectangle_t *roi);
 
 /* ORB descriptor */
@@ -1316,10 +1434,14 @@ int orb_load_descriptor(FIL *fp, array_t *kpts);
 float orb_cluster_dist(int cx, int cy, void *kp);
 
 /* LBP Operator */
-uint8_t *imlib_lbp_desc(image_t *image, rectangle_t *roi);
+#define LBP_HIST_SIZE      (59) //58 uniform hist + 1
+#define LBP_NUM_REGIONS    (7)  //7x7 regions
+#define LBP_DESC_SIZE      (LBP_NUM_REGIONS * LBP_NUM_REGIONS * LBP_HIST_SIZE)
+void imlib_lbp_desc(image_t *image, rectangle_t *roi, uint8_t *desc);
 int imlib_lbp_desc_distance(uint8_t *d0, uint8_t *d1);
+int imlib_lbp_desc_intersection(uint8_t *d0, uint8_t *d1);
 int imlib_lbp_desc_save(FIL *fp, uint8_t *desc);
-int imlib_lbp_desc_load(FIL *fp, uint8_t **desc);
+int imlib_lbp_desc_load(FIL *fp, uint8_t *desc);
 
 /* Iris detector */
 void imlib_find_iris(image_t *src, point_t *iris, rectangle_t *roi);
@@ -1334,12 +1456,27 @@ void imlib_edge_canny(image_t *src, rectangle_t *roi, int low_thresh, int high_t
 
 // HoG
 void imlib_find_hog(image_t *src, rectangle_t *roi, int cell_size);
+void imlib_hog_compute(hog_t *hog, image_t *img, rectangle_t *roi, int cell_size);
+void imlib_hog_free(hog_t *hog);
+int imlib_hog_descriptor_size(int cells_w, int cells_h);
+void imlib_hog_get_descriptor(hog_t *hog, int cell_x, int cell_y, int cells_w, int cells_h, uint8_t *out);
+int64_t imlib_hog_svm_score(hog_t *hog, int cell_x, int cell_y, int cells_w, int cells_h, const int16_t *weights);
+void imlib_hog_detect(list_t *out, hog_t *hog, int cells_w, int cells_h, int step,
+                      const int16_t *weights, float scale, float bias, float threshold);
 
 // Helper Functions
 void imlib_zero(image_t *img, image_t *mask, bool invert);
 void imlib_draw_row_setup(imlib_draw_row_data_t *data);
 void imlib_draw_row_teardown(imlib_draw_row_data_t *data);
 void imlib_draw_row(int x_start, int x_end, int y_row, imlib_draw_row_data_t *data);
+void imlib_draw_image_resolve_hints(image_t *dst_img,
+                                    image_t *src_img,
+                                    rectangle_t *roi,
+                                    int *dst_x_start,
+                                    int *dst_y_start,
+                                    float *x_scale,
+                                    float *y_scale,
+                                    image_hint_t *hint);
 void imlib_draw_image_get_bounds(image_t *dst_img,
                                  image_t *src_img,
                                  int dst_x_start,
@@ -1377,7 +1514,33 @@ void imlib_draw_string(image_t *img,
                        bool char_vflip,
                        int string_rotation,
                        bool string_hmirror,
-                       bool string_hflip);
+                       bool string_hflip,
+                       bool antialias);
+void imlib_glyph_cache_init(glyph_cache_t *cache,
+                            float scale,
+                            int char_rotation,
+                            bool char_hmirror,
+                            bool char_vflip,
+                            int string_rotation,
+                            bool antialias);
+void imlib_glyph_cache_free(glyph_cache_t *cache);
+void imlib_draw_list_init(draw_list_t *list, int capacity);
+void imlib_draw_list_free(draw_list_t *list);
+void imlib_draw_list_add_rectangle(draw_list_t *list, int rx, int ry, int rw, int rh, int c, int thickness, bool fill);
+void imlib_draw_list_add_circle(draw_list_t *list, int cx, int cy, int r, int c, int thickness, bool fill);
+void imlib_draw_list_add_line(draw_list_t *list, int x0, int y0, int x1, int y1, int c, int thickness);
+void imlib_draw_list_render(image_t *img, draw_list_t *list);
+void imlib_draw_string_cached(image_t *img,
+                              glyph_cache_t *cache,
+                              int x_off,
+                              int y_off,
+                              const char *str,
+                              int c,
+                              int x_spacing,
+                              int y_spacing,
+                              bool mono_space,
+                              bool string_hmirror,
+                              bool string_vflip);
 void imlib_draw_image(image_t *dst_img,
                       image_t *src_img,
                       int dst_x_start,
@@ -1407,6 +1570,9 @@ void imlib_zero_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data
 void imlib_mask_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data);
 void imlib_binary(image_t *out, image_t *img, list_t *thresholds, bool invert, bool zero, image_t *mask);
 void imlib_invert(image_t *img);
+// Adaptive Thresholding (ksize <= 128, out may alias img)
+void imlib_adaptive_threshold(image_t *out, image_t *img, adaptive_threshold_method_t method,
+                              int ksize, int offset, float k, bool invert);
 void imlib_b_and_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data);
 void imlib_b_nand_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data);
 void imlib_b_or_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data);
@@ -1522,6 +1688,8 @@ void imlib_find_apriltags(list_t *out, image_t *ptr, rectangle_t *roi, apriltag_
                           float fx, float fy, float cx, float cy);
 void imlib_find_datamatrices(list_t *out, image_t *ptr, rectangle_t *roi, int effort);
 void imlib_find_barcodes(list_t *out, image_t *ptr, rectangle_t *roi);
+void imlib_find_codes(list_t *qrcodes, list_t *datamatrices, list_t *barcodes,
+                      image_t *ptr, rectangle_t *roi, int effort);
 // Template Matching
 void imlib_phasecorrelate(image_t *img0,
                           image_t *img1,
@@ -1534,6 +1702,10 @@ void imlib_phasecorrelate(image_t *img0,
                           float *rotation,
                           float *scale,
                           float *response);
+// Motion Estimation
+// Finds a motion vector for each block_size (8 or 16) block of the ROI, in raster order.
+void imlib_find_motion_vectors(image_t *img, image_t *prev, rectangle_t *roi,
+                               int block_size, int range, motion_vector_t *vectors);
 // Stereo Imaging
 void imlib_stereo_disparity(image_t *img, bool reversed, int max_disparity, int threshold);
 
@@ -33,7 +33,6 @@
 #include "py/nlr.h"
 #include "py/runtime.h"
 
-#if (OMV_JPEG_CODEC_ENABLE == 0)
 /* Software JPEG decoder */
 #define FILE_HIGHWATER         1536
 #define JPEG_FILE_BUF_SIZE     2048
@@ -172,6 +171,10 @@ typedef struct jpeg_image_tag {
     int iVLCSize;                // current quantity of data in the VLC buffer
     int iResInterval, iResCount; // restart interval
     int iMaxMCUs;                // max MCUs of pixels per JPEGDraw call
+    int iPitch;                  // output line pitch in pixels
+    int iCropX, iCropY;          // output window origin (scaled pixels)
+    int iCropCX, iCropCY;        // output window size (scaled pixels), 0 == whole image
+    int bSkipMCU;                // entropy decode only, the MCU is outside of the output window
     JPEG_READ_CALLBACK *pfnRead;
     JPEG_SEEK_CALLBACK *pfnSeek;
     JPEG_DRAW_CALLBACK *pfnDraw;
@@ -384,7 +387,11 @@ int JPEG_openRAM(JPEGIMAGE *pJPEG, uint8_t *pData, int iDataSize, uint8_t *pImag
     pJPEG->JPEGFile.iSize = iDataSize;
     pJPEG->JPEGFile.pData = pData;
     pJPEG->iMaxMCUs = 1000;  // set to an unnaturally high value to start
-    return JPEGInit(pJPEG);
+    if (!JPEGInit(pJPEG)) {
+        return 0;
+    }
+    pJPEG->iPitch = pJPEG->iWidth;
+    return 1;
 }
 
 int JPEG_getLastError(JPEGIMAGE *pJPEG) {
@@ -1133,7 +1140,10 @@ static int JPEGDecodeMCU(JPEGIMAGE *pJPEG, int iMCU, int *iDCPredictor) {
         ulBitOff &= 7;
         ulBits = MOTOLONG(pBuf);
     }
-    if (pJPEG->iOptions & (JPEG_SCALE_QUARTER | JPEG_SCALE_EIGHTH)) {
+    if (pJPEG->bSkipMCU) {
+        // only the DC predictor has to be tracked, walk over the AC terms without storing them
+        pEnd2 = (uint8_t *) &cZigZag2[1];
+    } else if (pJPEG->iOptions & (JPEG_SCALE_QUARTER | JPEG_SCALE_EIGHTH)) {
         // reduced size DCT
         pMCU[1] = pMCU[8] = pMCU[9] = 0;
         pEnd2 = (uint8_t *) &cZigZag2[5];    // we only need to store the 4 elements we care about
@@ -1221,7 +1231,7 @@ static int JPEGDecodeMCU(JPEGIMAGE *pJPEG, int iMCU, int *iDCPredictor) {
             }
             pZig += (usHuff >> 4);   // get the skip amount (RRRR)
             usHuff &= 0xf;           // get (SSSS) - extra length
-            if (pZig < pEnd && usHuff) {
+            if (pZig < pEnd2 && usHuff) {
                 // && piHisto)
                 ulCode = ulBits << ulBitOff;
                 // slide sign bit across other 63 bits
@@ -1539,8 +1549,27 @@ static void JPEGPutMCUGray(JPEGIMAGE *pJPEG, int x, int y) {
     int i, j, xcount, ycount;
     uint8_t *pSrc = (uint8_t *) &pJPEG->sMCUs[0];
 
+    if ((pJPEG->ucPixelType != ONE_BIT_GRAYSCALE) && (pJPEG->iOptions & JPEG_SCALE_HALF)) {
+        // special handling of 1/2 size (pixel averaging)
+        const int iPitch = pJPEG->iPitch;
+        uint16_t *usDest = (uint16_t *) &pJPEG->pImage[(y * iPitch * 2) + x * 2];
+        for (i = 0; i < 4; i++) {
+            for (j = 0; j < 4; j++) {
+                usDest[j] = usGrayTo565[(pSrc[0] + pSrc[1] + pSrc[8] + pSrc[9] + 2) >> 2];
+                pSrc += 2;
+            }
+            pSrc += 8;  // skip extra line
+            usDest += iPitch;
+        }
+        return;
+    }
     // For odd-sized JPEGs, don't draw past the edge of the image bounds
     xcount = ycount = 8;
+    if (pJPEG->iOptions & JPEG_SCALE_QUARTER) {
+        xcount = ycount = 2;
+    } else if (pJPEG->iOptions & JPEG_SCALE_EIGHTH) {
+        xcount = ycount = 1;
+    }
     if (x + 8 > pJPEG->iWidth) {
         xcount = pJPEG->iWidth & 7;
     }
@@ -1565,7 +1594,7 @@ static void JPEGPutMCUGray(JPEGIMAGE *pJPEG, int x, int y) {
         }
     } else {
         // must be RGB565 output
-        const int iPitch = pJPEG->iWidth;
+        const int iPitch = pJPEG->iPitch;
         uint16_t *usDest = (uint16_t *) &pJPEG->pImage[(y * iPitch * 2) + x * 2];
 
         for (i = 0; i < ycount; i++) {
@@ -1573,7 +1602,7 @@ static void JPEGPutMCUGray(JPEGIMAGE *pJPEG, int x, int y) {
             for (j = 0; j < xcount; j++) {
                 *usDest++ = usGrayTo565[*pSrc++];
             }
-            pSrc += (8 - xcount);
+            pSrc += (((pJPEG->iOptions & JPEG_SCALE_QUARTER) ? 2 : 8) - xcount); // 1/4 IDCT output is 2x2
             usDest -= xcount;
             usDest += iPitch; // next line
         }
@@ -1582,7 +1611,7 @@ static void JPEGPutMCUGray(JPEGIMAGE *pJPEG, int x, int y) {
 
 static void JPEGPutMCU8BitGray(JPEGIMAGE *pJPEG, int x, int y) {
     int i, j, xcount, ycount;
-    const int iPitch = pJPEG->iWidth;
+    const int iPitch = pJPEG->iPitch;
     uint8_t *pDest, *pSrc = (uint8_t *) &pJPEG->sMCUs[0];
     pDest = (uint8_t *) &pJPEG->pImage[(y * iPitch) + x];
     if (pJPEG->ucSubSample <= 0x11) {
@@ -1618,7 +1647,7 @@ static void JPEGPutMCU8BitGray(JPEGIMAGE *pJPEG, int x, int y) {
             for (j = 0; j < xcount; j++) {
                 *pDest++ = *pSrc++;
             }
-            pSrc += (8 - xcount);
+            pSrc += (((pJPEG->iOptions & JPEG_SCALE_QUARTER) ? 2 : 8) - xcount); // 1/4 IDCT output is 2x2
             pDest -= xcount;
             pDest += iPitch; // next line
         }
@@ -2045,7 +2074,7 @@ static void JPEGPutMCU11(JPEGIMAGE *pJPEG, int x, int y) {
     int iCr, iCb;
     signed int Y;
     int iCol, iRow, cx, cy;
-    const int iPitch = pJPEG->iWidth;
+    const int iPitch = pJPEG->iPitch;
     uint8_t *pY, *pCr, *pCb;
     uint16_t *pOutput = (uint16_t *) &pJPEG->pImage[(y * iPitch * 2) + x * 2];
 
@@ -2128,7 +2157,7 @@ static void JPEGPutMCU22(JPEGIMAGE *pJPEG, int x, int y) {
     signed int Y1, Y2, Y3, Y4;
     int iRow, iRowLimit, iCol, iXCount1, iXCount2;
     unsigned char *pY, *pCr, *pCb;
-    const int iPitch = pJPEG->iWidth;
+    const int iPitch = pJPEG->iPitch;
     int bUseOdd1, bUseOdd2; // special case where 24bpp odd sized image can clobber first column
     uint16_t *pOutput = (uint16_t *) &pJPEG->pImage[(y * iPitch * 2) + x * 2];
 
@@ -2370,7 +2399,7 @@ static void JPEGPutMCU12(JPEGIMAGE *pJPEG, int x, int y) {
     signed int Y1, Y2;
     int iRow, iCol, iXCount, iYCount;
     uint8_t *pY, *pCr, *pCb;
-    const int iPitch = pJPEG->iWidth;
+    const int iPitch = pJPEG->iPitch;
     uint16_t *pOutput = (uint16_t *) &pJPEG->pImage[(y * iPitch * 2) + x * 2];
 
     pY = (uint8_t *) &pJPEG->sMCUs[0 * DCTSIZE];
@@ -2477,7 +2506,7 @@ static void JPEGPutMCU21(JPEGIMAGE *pJPEG, int x, int y) {
     int iCol;
     int iRow, iXCount, iYCount;
     uint8_t *pY, *pCr, *pCb;
-    const int iPitch = pJPEG->iWidth;
+    const int iPitch = pJPEG->iPitch;
     uint16_t *pOutput = (uint16_t *) &pJPEG->pImage[(y * iPitch * 2) + x * 2];
 
     pY = (uint8_t *) &pJPEG->sMCUs[0 * DCTSIZE];
@@ -2581,6 +2610,43 @@ static void JPEGPutMCU21(JPEGIMAGE *pJPEG, int x, int y) {
     } // for row
 }
 
+// Copies the part of a staged MCU that overlaps the output window into the destination image.
+// x/y are the MCU coordinates and cx/cy the MCU size, all in scaled pixels.
+static void JPEGCopyMCU(JPEGIMAGE *pJPEG, int x, int y, int cx, int cy) {
+    image_t *dst = (image_t *) pJPEG->pUser;
+    int x_start = IM_MAX(x, pJPEG->iCropX);
+    int x_end = IM_MIN(x + cx, pJPEG->iCropX + pJPEG->iCropCX);
+    int y_start = IM_MAX(y, pJPEG->iCropY);
+    int y_end = IM_MIN(y + cy, pJPEG->iCropY + pJPEG->iCropCY);
+
+    for (int j = y_start; j < y_end; j++) {
+        int dst_y = j - pJPEG->iCropY;
+        int dst_x = x_start - pJPEG->iCropX;
+        int offset = ((j - y) * cx) + (x_start - x);
+
+        switch (dst->pixfmt) {
+            case PIXFORMAT_BINARY: {
+                uint8_t *src_row_ptr = ((uint8_t *) pJPEG->usPixels) + offset;
+                uint32_t *dst_row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(dst, dst_y);
+                for (int i = 0, ii = x_end - x_start; i < ii; i++) {
+                    IMAGE_PUT_BINARY_PIXEL_FAST(dst_row_ptr, dst_x + i, src_row_ptr[i] > 127);
+                }
+                break;
+            }
+            case PIXFORMAT_GRAYSCALE: {
+                uint8_t *dst_row_ptr = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(dst, dst_y);
+                memcpy(dst_row_ptr + dst_x, ((uint8_t *) pJPEG->usPixels) + offset, x_end - x_start);
+                break;
+            }
+            case PIXFORMAT_RGB565: {
+                uint16_t *dst_row_ptr = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(dst, dst_y);
+                memcpy(dst_row_ptr + dst_x, pJPEG->usPixels + offset, (x_end - x_start) * sizeof(uint16_t));
+                break;
+            }
+        }
+    }
+}
+
 // Decode the image
 // returns 0 for error, 1 for success
 static int DecodeJPEG(JPEGIMAGE *pJPEG) {
@@ -2676,6 +2742,20 @@ static int DecodeJPEG(JPEGIMAGE *pJPEG) {
     mcuCX >>= iScaleShift;
     mcuCY >>= iScaleShift;
 
+    // MCU window that has to be reconstructed (inclusive).
+    int iMCUX0 = 0, iMCUY0 = 0, iMCUX1 = cx - 1, iMCUY1 = cy - 1;
+    if (pJPEG->iCropCX) {
+        // Windowed decode: MCUs are written to a staging buffer and copied out clipped to the
+        // window. MCUs outside of the window are only entropy decoded to keep the DC predictors
+        // and bitstream position in sync, and decoding stops after the last row of the window.
+        iMCUX0 = pJPEG->iCropX / mcuCX;
+        iMCUY0 = pJPEG->iCropY / mcuCY;
+        iMCUX1 = IM_MIN((pJPEG->iCropX + pJPEG->iCropCX - 1) / mcuCX, cx - 1);
+        iMCUY1 = IM_MIN((pJPEG->iCropY + pJPEG->iCropCY - 1) / mcuCY, cy - 1);
+        pJPEG->pImage = (uint8_t *) pJPEG->usPixels;
+        pJPEG->iPitch = mcuCX;
+    }
+
     iQuant1 = pJPEG->sQuantTable[pJPEG->JPCI[0].quant_tbl_no * DCTSIZE];   // DC quant values
     iQuant2 = pJPEG->sQuantTable[pJPEG->JPCI[1].quant_tbl_no * DCTSIZE];
     iQuant3 = pJPEG->sQuantTable[pJPEG->JPCI[2].quant_tbl_no * DCTSIZE];
@@ -2702,8 +2782,9 @@ static int DecodeJPEG(JPEGIMAGE *pJPEG) {
         // dithered, override the max MCU count
         iMCUCount = cx; // do the whole row
     }
-    for (y = 0; y < cy && bContinue; y++) {
+    for (y = 0; y <= iMCUY1 && bContinue; y++) {
         for (x = 0; x < cx && bContinue && iErr == 0; x++) {
+            pJPEG->bSkipMCU = (y < iMCUY0) || (x < iMCUX0) || (x > iMCUX1);
             pJPEG->ucACTable = cACTable0;
             pJPEG->ucDCTable = cDCTable0;
             // do the first luminance component
@@ -2811,28 +2892,36 @@ static int DecodeJPEG(JPEGIMAGE *pJPEG) {
                     JPEGIDCT(pJPEG, iCb, pJPEG->JPCI[2].quant_tbl_no, (pJPEG->ucMaxACCol | (pJPEG->ucMaxACRow << 8)));
                 }
             } // if color components present
-            if (pJPEG->ucPixelType == EIGHT_BIT_GRAYSCALE) {
-                JPEGPutMCU8BitGray(pJPEG, x * mcuCX, y * mcuCY);
-            } else if (pJPEG->ucPixelType == ONE_BIT_GRAYSCALE) {
-                JPEGPutMCU1BitGray(pJPEG, x * mcuCX, y * mcuCY);
-            } else {
-                switch (pJPEG->ucSubSample) {
-                    case 0x00: // grayscale
-                        JPEGPutMCUGray(pJPEG, x * mcuCX, y * mcuCY);
-                        break; // not used
-                    case 0x11:
-                        JPEGPutMCU11(pJPEG, x * mcuCX, y * mcuCY);
-                        break;
-                    case 0x12:
-                        JPEGPutMCU12(pJPEG, x * mcuCX, y * mcuCY);
-                        break;
-                    case 0x21:
-                        JPEGPutMCU21(pJPEG, x * mcuCX, y * mcuCY);
-                        break;
-                    case 0x22:
-                        JPEGPutMCU22(pJPEG, x * mcuCX, y * mcuCY);
-                        break;
-                } // switch on color option
+            if (!pJPEG->bSkipMCU) {
+                // staged MCUs are always written at the origin of the staging buffer
+                int iOutX = pJPEG->iCropCX ? 0 : (x * mcuCX);
+                int iOutY = pJPEG->iCropCX ? 0 : (y * mcuCY);
+                if (pJPEG->ucPixelType == EIGHT_BIT_GRAYSCALE) {
+                    JPEGPutMCU8BitGray(pJPEG, iOutX, iOutY);
+                } else if (pJPEG->ucPixelType == ONE_BIT_GRAYSCALE) {
+                    JPEGPutMCU1BitGray(pJPEG, iOutX, iOutY);
+                } else {
+                    switch (pJPEG->ucSubSample) {
+                        case 0x00: // grayscale
+                            JPEGPutMCUGray(pJPEG, iOutX, iOutY);
+                            break; // not used
+                        case 0x11:
+                            JPEGPutMCU11(pJPEG, iOutX, iOutY);
+                            break;
+                        case 0x12:
+                            JPEGPutMCU12(pJPEG, iOutX, iOutY);
+                            break;
+                        case 0x21:
+                            JPEGPutMCU21(pJPEG, iOutX, iOutY);
+                            break;
+                        case 0x22:
+                            JPEGPutMCU22(pJPEG, iOutX, iOutY);
+                            break;
+                    } // switch on color option
+                }
+                if (pJPEG->iCropCX) {
+                    JPEGCopyMCU(pJPEG, x * mcuCX, y * mcuCY, mcuCX, mcuCY);
+                }
             }
             if (pJPEG->iResInterval) {
                 if (--pJPEG->iResCount == 0) {
@@ -2857,6 +2946,7 @@ static int DecodeJPEG(JPEGIMAGE *pJPEG) {
     return (iErr == 0);
 }
 
+#if (OMV_JPEG_CODEC_ENABLE == 0)
 void jpeg_decompress(image_t *dst, image_t *src) {
     OMV_PROFILE_START();
     JPEGIMAGE jpg;
@@ -2901,4 +2991,67 @@ void jpeg_decompress(image_t *dst, image_t *src) {
 
     OMV_PROFILE_PRINT();
 }
-#endif
+#endif // OMV_JPEG_CODEC_ENABLE == 0
+
+// Decodes the roi of the source image scaled down by 1, 2, 4 or 8 in the DCT domain. The roi is
+// in source pixels and the destination image must be roi->w / scale by roi->h / scale pixels.
+// Only the MCUs overlapping the roi go through the IDCT, the others are just entropy decoded.
+void jpeg_decompress_roi(image_t *dst, image_t *src, rectangle_t *roi, int scale) {
+    OMV_PROFILE_START();
+    JPEGIMAGE jpg;
+    int options = 0;
+
+    switch (scale) {
+        case 1:
+            break;
+        case 2:
+            options = JPEG_SCALE_HALF;
+            break;
+        case 4:
+            options = JPEG_SCALE_QUARTER;
+            break;
+        case 8:
+            options = JPEG_SCALE_EIGHTH;
+            break;
+        default:
+            mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("JPEG scale must be 1, 2, 4 or 8."));
+    }
+
+    // Supports decoding baseline JPEGs only.
+    if (!jpeg_is_valid(src)) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("Non-Baseline JPEGs are not supported."));
+    }
+
+    if (JPEG_openRAM(&jpg, src->data, src->size, dst->data) == 0) {
+        // failed to parse the header
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("JPEG decoder failed."));
+    }
+
+    switch (dst->pixfmt) {
+        case PIXFORMAT_BINARY:
+        case PIXFORMAT_GRAYSCALE:
+            // Binary output is thresholded when the staged MCUs are copied out.
+            jpg.ucPixelType = EIGHT_BIT_GRAYSCALE;
+            break;
+        case PIXFORMAT_RGB565:
+            // Force output to be RGB565
+            jpg.ucPixelType = RGB565_LITTLE_ENDIAN;
+            break;
+        default:
+            mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("Unsupported format."));
+    }
+
+    // Set up dest image params and the output window in scaled pixels.
+    jpg.pUser = (void *) dst;
+    jpg.iCropX = roi->x / scale;
+    jpg.iCropY = roi->y / scale;
+    jpg.iCropCX = dst->w;
+    jpg.iCropCY = dst->h;
+
+    // Start decoding.
+    if (JPEG_decode(&jpg, 0, 0, options) == 0) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("JPEG decoder failed."));
+    }
+
+    OMV_PROFILE_PRINT();
+}
@@ -0,0 +1,314 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *
+ * Sparse pyramidal Lucas-Kanade (KLT) feature tracker.
+ *
+ * Points are tracked from the top of the image pyramid down, refining the flow at each
+ * level with Gauss-Newton iterations over a bilinear interpolated window. Everything is
+ * fixed-point: positions and flow are Q8, window pixels are Q5 and gradients are Q4.
+ */
+#include "imlib.h"
+#include "xalloc.h"
+#include "fb_alloc.h"
+
+#ifdef IMLIB_ENABLE_FIND_KEYPOINTS
+
+#define KLT_PATCH_SIZE      (KLT_MAX_WINDOW + 2)
+#define KLT_BORDER          ((KLT_MAX_WINDOW / 2) + 1)  // Detection keeps away from the image edges.
+#define KLT_MIN_EIGEN       (4)         // Minimum mean squared gradient (gray levels per pixel).
+#define KLT_EPSILON         (8)         // Stop iterating when the update is under 8/256 pixels.
+#define KLT_MAX_STEP        (1 << 14)   // Largest update in pixels.
+
+// Samples an n x n window centered on (x, y) (Q8) with bilinear interpolation. Outputs Q5.
+static void klt_sample(image_t *img, int32_t x, int32_t y, int n, int16_t *out) {
+    int fx = x & 0xFF, fy = y & 0xFF;
+    int x0 = (x >> 8) - (n / 2), y0 = (y >> 8) - (n / 2);
+    int w00 = (256 - fx) * (256 - fy), w01 = fx * (256 - fy);
+    int w10 = (256 - fx) * fy, w11 = fx * fy;
+
+    if ((x0 >= 0) && (y0 >= 0) && ((x0 + n) < img->w) && ((y0 + n) < img->h)) {
+        for (int j = 0; j < n; j++, out += n) {
+            const uint8_t *row0 = img->pixels + ((y0 + j) * img->w) + x0;
+            const uint8_t *row1 = row0 + img->w;
+            for (int i = 0; i < n; i++) {
+                out[i] = ((row0[i] * w00) + (row0[i + 1] * w01) +
+                          (row1[i] * w10) + (row1[i + 1] * w11) + (1 << 10)) >> 11;
+            }
+        }
+    } else {
+        // Replicate the edge pixels.
+        for (int j = 0; j < n; j++, out += n) {
+            int ya = IM_CLAMP(y0 + j, 0, img->h - 1);
+            int yb = IM_CLAMP(y0 + j + 1, 0, img->h - 1);
+            const uint8_t *row0 = img->pixels + (ya * img->w);
+            const uint8_t *row1 = img->pixels + (yb * img->w);
+            for (int i = 0; i < n; i++) {
+                int xa = IM_CLAMP(x0 + i, 0, img->w - 1);
+                int xb = IM_CLAMP(x0 + i + 1, 0, img->w - 1);
+                out[i] = ((row0[xa] * w00) + (row0[xb] * w01) +
+                          (row1[xa] * w10) + (row1[xb] * w11) + (1 << 10)) >> 11;
+            }
+        }
+    }
+}
+
+static uint32_t klt_isqrt(uint64_t x) {
+    uint64_t r = 0;
+
+    for (uint64_t bit = 1ULL << 62; bit; bit >>= 2) {
+        if (x >= (r + bit)) {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+    }
+
+    return r;
+}
+
+// Returns num / den in Q8. The integer part is clamped to KLT_MAX_STEP.
+static int32_t klt_div_q8(int64_t num, int64_t den) {
+    int64_t q = num / den;
+    int64_t r = num - (q * den);
+
+    if ((q > KLT_MAX_STEP) || (q < -KLT_MAX_STEP)) {
+        return (q > 0) ? (KLT_MAX_STEP * 256) : (-KLT_MAX_STEP * 256);
+    }
+
+    return (q * 256) + ((r * 256) / den);
+}
+
+// Refines the flow (gx, gy) of the point (px, py) between two images of the same level.
+// Returns false if the window has too little texture to track.
+static bool klt_track_level(image_t *prev, image_t *curr, int32_t px, int32_t py,
+                            int32_t *gx, int32_t *gy, int window, int iterations) {
+    int16_t patch[KLT_PATCH_SIZE * KLT_PATCH_SIZE];
+    int16_t ii[KLT_MAX_WINDOW * KLT_MAX_WINDOW];
+    int16_t ix[KLT_MAX_WINDOW * KLT_MAX_WINDOW];
+    int16_t iy[KLT_MAX_WINDOW * KLT_MAX_WINDOW];
+    int16_t jj[KLT_MAX_WINDOW * KLT_MAX_WINDOW];
+    int n = window, pn = window + 2, area = window * window;
+    int64_t gxx = 0, gxy = 0, gyy = 0;
+
+    // Previous window, with a one pixel border for the central difference gradients.
+    klt_sample(prev, px, py, pn, patch);
+
+    for (int j = 0, k = 0; j < n; j++) {
+        const int16_t *row = patch + ((j + 1) * pn) + 1;
+        for (int i = 0; i < n; i++, k++) {
+            ii[k] = row[i];
+            ix[k] = (row[i + 1] - row[i - 1]) >> 2;
+            iy[k] = (row[i + pn] - row[i - pn]) >> 2;
+            gxx += ix[k] * ix[k];
+            gxy += ix[k] * iy[k];
+            gyy += iy[k] * iy[k];
+        }
+    }
+
+    // Scale the gradient matrix so its determinant fits in 54 bits.
+    int64_t gmax = IM_MAX(gxx, gyy);
+    int shift = 0;
+    for (; (gmax >> shift) >= (1LL << 27); shift++) {
+    }
+
+    gxx >>= shift;
+    gxy >>= shift;
+    gyy >>= shift;
+
+    int64_t det = (gxx * gyy) - (gxy * gxy);
+    int64_t diff = gxx - gyy;
+    int64_t min_eigen = ((gxx + gyy) - klt_isqrt((diff * diff) + (4 * gxy * gxy))) / 2;
+
+    if ((det <= 0) || (min_eigen < (((int64_t) KLT_MIN_EIGEN * 256 * area) >> shift))) {
+        return false;
+    }
+
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        int64_t bx = 0, by = 0;
+
+        klt_sample(curr, px + *gx, py + *gy, n, jj);
+
+        for (int k = 0; k < area; k++) {
+            int d = (ii[k] - jj[k]) >> 1;
+            bx += d * ix[k];
+            by += d * iy[k];
+        }
+
+        bx >>= shift;
+        by >>= shift;
+
+        int32_t dx = klt_div_q8((gyy * bx) - (gxy * by), det);
+        int32_t dy = klt_div_q8((gxx * by) - (gxy * bx), det);
+        *gx += dx;
+        *gy += dy;
+
+        if ((abs(dx) < KLT_EPSILON) && (abs(dy) < KLT_EPSILON)) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// Returns the mean absolute difference in gray levels between the windows at p and p + g.
+static int klt_error(image_t *prev, image_t *curr, klt_point_t *p, int32_t gx, int32_t gy, int window) {
+    int16_t ii[KLT_MAX_WINDOW * KLT_MAX_WINDOW];
+    int16_t jj[KLT_MAX_WINDOW * KLT_MAX_WINDOW];
+    int area = window * window;
+    int error = 0;
+
+    klt_sample(prev, p->x, p->y, window, ii);
+    klt_sample(curr, p->x + gx, p->y + gy, window, jj);
+
+    for (int k = 0; k < area; k++) {
+        error += abs(ii[k] - jj[k]);
+    }
+
+    return error / (area * 32);
+}
+
+int imlib_klt_track(image_pyramid_t *prev, image_pyramid_t *curr, klt_point_t *points, int n,
+                    int window, int iterations, int max_error) {
+    int levels = IM_MIN(prev->levels, curr->levels);
+    image_t *prev_img = &prev->images[0];
+    image_t *curr_img = &curr->images[0];
+    int margin = window / 2;
+    int tracked = 0;
+
+    for (int i = 0; i < n; i++) {
+        klt_point_t *p = &points[i];
+        int32_t gx = 0, gy = 0;
+        bool lost = false;
+
+        for (int level = levels - 1; level >= 0; level--) {
+            // Levels above 0 only provide an initial guess, a flat window there isn't fatal.
+            if (!klt_track_level(&prev->images[level], &curr->images[level], p->x >> level, p->y >> level,
+                                 &gx, &gy, window, iterations) && (!level)) {
+                lost = true;
+            }
+
+            if (level) {
+                gx *= 2;
+                gy *= 2;
+            }
+        }
+
+        int32_t x = p->x + gx;
+        int32_t y = p->y + gy;
+
+        if (lost ||
+            (x < (margin << 8)) || (x >= ((curr_img->w - margin) << 8)) ||
+            (y < (margin << 8)) || (y >= ((curr_img->h - margin) << 8)) ||
+            (klt_error(prev_img, curr_img, p, gx, gy, window) > max_error)) {
+            continue;
+        }
+
+        points[tracked] = *p;
+        points[tracked].x = x;
+        points[tracked].y = y;
+        points[tracked].age += 1;
+        tracked += 1;
+    }
+
+    return tracked;
+}
+
+// Index of the detection grid cell of (x, y), the grid starts at the roi corner.
+static inline int klt_cell(const rectangle_t *roi, int cell_size, int cells_w, int x, int y) {
+    return (((y - roi->y) / cell_size) * cells_w) + ((x - roi->x) / cell_size);
+}
+
+int imlib_klt_detect(image_t *img, klt_point_t *points, int n, int max_points,
+                     int threshold, int cell_size, uint16_t *next_id) {
+    rectangle_t roi = { KLT_BORDER, KLT_BORDER, img->w - (KLT_BORDER * 2), img->h - (KLT_BORDER * 2) };
+
+    if ((n >= max_points) || (roi.w <= 0) || (roi.h <= 0)) {
+        return n;
+    }
+
+    // Same grid as fast_detect_corners(), which starts at the roi corner.
+    int cells_w = (roi.w + cell_size - 1) / cell_size;
+    int cells_h = (roi.h + cell_size - 1) / cell_size;
+    int cells = cells_w * cells_h;
+
+    // Strongest corner of each cell, the score is 0 if the cell is empty or already has a point.
+    corner_t *best = fb_alloc0(cells * sizeof(corner_t), FB_ALLOC_NO_HINT);
+
+    #if defined(IMLIB_ENABLE_FAST)
+    corner_t *corners = fb_alloc(cells * sizeof(corner_t), FB_ALLOC_NO_HINT);
+    int num_corners = fast_detect_corners(img, corners, cells, threshold, &roi, cell_size, 1);
+
+    for (int i = 0; i < num_corners; i++) {
+        corner_t *c = &best[klt_cell(&roi, cell_size, cells_w, corners[i].x, corners[i].y)];
+        if (corners[i].score >= c->score) {
+            *c = (corner_t) { corners[i].x, corners[i].y, corners[i].score + 1 };
+        }
+    }
+
+    fb_free(); // corners
+    #else
+    array_t *kpts;
+    array_alloc(&kpts, xfree);
+    agast_detect(img, kpts, threshold, &roi);
+
+    for (int i = 0; i < array_length(kpts); i++) {
+        kp_t *kpt = array_at(kpts, i);
+        corner_t *c = &best[klt_cell(&roi, cell_size, cells_w, kpt->x, kpt->y)];
+        if (kpt->score >= c->score) {
+            *c = (corner_t) { kpt->x, kpt->y, kpt->score + 1 };
+        }
+    }
+
+    array_free(kpts);
+    #endif
+
+    for (int i = 0; i < n; i++) {
+        int x = IM_CLAMP(points[i].x >> 8, roi.x, roi.x + roi.w - 1);
+        int y = IM_CLAMP(points[i].y >> 8, roi.y, roi.y + roi.h - 1);
+        best[klt_cell(&roi, cell_size, cells_w, x, y)].score = 0;
+    }
+
+    // Add the strongest corners first.
+    while (n < max_points) {
+        corner_t *c = NULL;
+
+        for (int i = 0; i < cells; i++) {
+            if (best[i].score && ((!c) || (best[i].score > c->score))) {
+                c = &best[i];
+            }
+        }
+
+        if (!c) {
+            break;
+        }
+
+        points[n++] = (klt_point_t) { .x = c->x << 8, .y = c->y << 8, .id = (*next_id)++, .age = 0 };
+        c->score = 0;
+    }
+
+    fb_free(); // best
+    return n;
+}
+#endif // IMLIB_ENABLE_FIND_KEYPOINTS
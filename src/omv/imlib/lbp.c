@@ -30,14 +30,11 @@
 #include <stdlib.h>
 
 #include "imlib.h"
-#include "xalloc.h"
+#include "simd.h"
+#include "fb_alloc.h"
 #include "file_utils.h"
 #ifdef IMLIB_ENABLE_FIND_LBP
 
-#define LBP_HIST_SIZE      (59) //58 uniform hist + 1
-#define LBP_NUM_REGIONS    (7)  //7x7 regions
-#define LBP_DESC_SIZE      (LBP_NUM_REGIONS * LBP_NUM_REGIONS * LBP_HIST_SIZE)
-
 const static int8_t lbp_weights[49] = {
     2, 1, 1, 1, 1, 1, 2,
     2, 4, 4, 1, 4, 4, 2,
@@ -67,64 +64,134 @@ const static uint8_t uniform_tbl[256] = {
     47, 48, 58, 49, 58, 58, 58, 50, 51, 52, 58, 53, 54, 55, 56, 57
 };
 
-uint8_t *imlib_lbp_desc(image_t *image, rectangle_t *roi) {
-    int s = image->w; //stride
-    int RX = roi->w / LBP_NUM_REGIONS;
-    int RY = roi->h / LBP_NUM_REGIONS;
-    uint8_t *data = image->data;
-    uint8_t *desc = xalloc0(LBP_DESC_SIZE);
-
-    for (int y = roi->y; y < (roi->y + roi->h) - 3; y++) {
-        int y_idx = ((y - roi->y) / RY) * LBP_NUM_REGIONS;
-        for (int x = roi->x; x < (roi->x + roi->w) - 3; x++) {
-            uint8_t lbp = 0;
-            uint8_t p = data[(y + 1) * s + x + 1];
-            int hist_idx = y_idx + (x - roi->x) / RX;
-
-            lbp |= (data[(y + 0) * s + x + 0] >= p) << 0;
-            lbp |= (data[(y + 0) * s + x + 1] >= p) << 1;
-            lbp |= (data[(y + 0) * s + x + 2] >= p) << 2;
-            lbp |= (data[(y + 1) * s + x + 2] >= p) << 3;
-            lbp |= (data[(y + 2) * s + x + 2] >= p) << 4;
-            lbp |= (data[(y + 2) * s + x + 1] >= p) << 5;
-            lbp |= (data[(y + 2) * s + x + 0] >= p) << 6;
-            lbp |= (data[(y + 1) * s + x + 0] >= p) << 7;
-
-            desc[hist_idx * LBP_HIST_SIZE + uniform_tbl[lbp]]++;
+// Splits size pixels into LBP_NUM_REGIONS regions, the last region takes the remainder.
+static void lbp_region_bounds(int size, int n, int *end) {
+    for (int i = 0; i < (LBP_NUM_REGIONS - 1); i++) {
+        end[i] = IM_MIN((i + 1) * (size / LBP_NUM_REGIONS), n);
+    }
+
+    end[LBP_NUM_REGIONS - 1] = n;
+}
+
+void imlib_lbp_desc(image_t *image, rectangle_t *roi, uint8_t *desc) {
+    int w = roi->w - 3;
+    int h = roi->h - 3;
+    int x_end[LBP_NUM_REGIONS];
+    int y_end[LBP_NUM_REGIONS];
+
+    memset(desc, 0, LBP_DESC_SIZE);
+
+    if ((w <= 0) || (h <= 0)) {
+        return;
+    }
+
+    lbp_region_bounds(roi->w, w, x_end);
+    lbp_region_bounds(roi->h, h, y_end);
+
+    uint8_t *codes = fb_alloc(w, FB_ALLOC_NO_HINT);
+
+    for (int y = 0, ry = 0; y < h; y++) {
+        uint8_t *r0 = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(image, roi->y + y) + roi->x;
+        uint8_t *r1 = r0 + image->w;
+        uint8_t *r2 = r1 + image->w;
+
+        // Compare the 8 neighbours against the center for a vector of pixels at a time.
+        for (int x = 0; x < w; x += UINT8_VECTOR_SIZE) {
+            v128_predicate_t pred = vpredicate_8(w - x);
+            v128_t p = vldr_u8_pred(r1 + x + 1, pred);
+            v128_t code = vcmpcs_u8_bit(vldr_u8_pred(r0 + x + 0, pred), p, 0);
+            code = vorr_u32(code, vcmpcs_u8_bit(vldr_u8_pred(r0 + x + 1, pred), p, 1));
+            code = vorr_u32(code, vcmpcs_u8_bit(vldr_u8_pred(r0 + x + 2, pred), p, 2));
+            code = vorr_u32(code, vcmpcs_u8_bit(vldr_u8_pred(r1 + x + 2, pred), p, 3));
+            code = vorr_u32(code, vcmpcs_u8_bit(vldr_u8_pred(r2 + x + 2, pred), p, 4));
+            code = vorr_u32(code, vcmpcs_u8_bit(vldr_u8_pred(r2 + x + 1, pred), p, 5));
+            code = vorr_u32(code, vcmpcs_u8_bit(vldr_u8_pred(r2 + x + 0, pred), p, 6));
+            code = vorr_u32(code, vcmpcs_u8_bit(vldr_u8_pred(r1 + x + 0, pred), p, 7));
+            vstr_u8_pred(codes + x, code, pred);
+        }
+
+        while (y >= y_end[ry]) {
+            ry++;
+        }
+
+        uint8_t *hist = desc + (ry * LBP_NUM_REGIONS * LBP_HIST_SIZE);
+
+        for (int rx = 0, x = 0; rx < LBP_NUM_REGIONS; rx++, hist += LBP_HIST_SIZE) {
+            for (; x < x_end[rx]; x++) {
+                hist[uniform_tbl[codes[x]]]++;
+            }
         }
     }
-    return desc;
+
+    fb_free(); // codes
 }
 
 int imlib_lbp_desc_distance(uint8_t *d0, uint8_t *d1) {
     uint32_t sum = 0;
-    for (int i = 0; i < LBP_DESC_SIZE; i++) {
-        int w = lbp_weights[i / LBP_HIST_SIZE];
-        sum += w * ((((d0[i] - d1[i]) * (d0[i] - d1[i])) / IM_MAX((d0[i] + d1[i]), 1)));
+
+    for (int r = 0; r < (LBP_NUM_REGIONS * LBP_NUM_REGIONS); r++, d0 += LBP_HIST_SIZE, d1 += LBP_HIST_SIZE) {
+        if (!lbp_weights[r]) {
+            continue;
+        }
+
+        uint32_t region = 0;
+
+        for (int i = 0; i < LBP_HIST_SIZE; i += UINT8_VECTOR_SIZE) {
+            v128_predicate_t pred = vpredicate_8(LBP_HIST_SIZE - i);
+
+            // Equal bins add nothing to the chi-square distance.
+            if (!vsada_u8(vldr_u8_pred(d0 + i, pred), vldr_u8_pred(d1 + i, pred), 0)) {
+                continue;
+            }
+
+            for (int j = i, k = IM_MIN(i + (int) UINT8_VECTOR_SIZE, LBP_HIST_SIZE); j < k; j++) {
+                int diff = d0[j] - d1[j];
+                region += (diff * diff) / IM_MAX(d0[j] + d1[j], 1);
+            }
+        }
+
+        sum += lbp_weights[r] * region;
     }
+
     return sum;
 }
 
+// Histogram intersection distance. The difference between the sum of the bins and the
+// intersection of two histograms is half of their L1 distance, which is a SAD.
+int imlib_lbp_desc_intersection(uint8_t *d0, uint8_t *d1) {
+    uint32_t sum = 0;
+
+    for (int r = 0; r < (LBP_NUM_REGIONS * LBP_NUM_REGIONS); r++, d0 += LBP_HIST_SIZE, d1 += LBP_HIST_SIZE) {
+        if (!lbp_weights[r]) {
+            continue;
+        }
+
+        uint32_t region = 0;
+
+        for (int i = 0; i < LBP_HIST_SIZE; i += UINT8_VECTOR_SIZE) {
+            v128_predicate_t pred = vpredicate_8(LBP_HIST_SIZE - i);
+            region = vsada_u8(vldr_u8_pred(d0 + i, pred), vldr_u8_pred(d1 + i, pred), region);
+        }
+
+        sum += lbp_weights[r] * region;
+    }
+
+    return sum / 2;
+}
+
 int imlib_lbp_desc_save(FIL *fp, uint8_t *desc) {
     UINT bytes;
     // Write descriptor
     return file_ll_write(fp, desc, LBP_DESC_SIZE, &bytes);
 }
 
-int imlib_lbp_desc_load(FIL *fp, uint8_t **desc) {
+int imlib_lbp_desc_load(FIL *fp, uint8_t *desc) {
     UINT bytes;
-    FRESULT res = FR_OK;
-
-    *desc = NULL;
-    uint8_t *hist = xalloc(LBP_DESC_SIZE);
-
     // Read descriptor
-    res = file_ll_read(fp, hist, LBP_DESC_SIZE, &bytes);
-    if (res != FR_OK || bytes != LBP_DESC_SIZE) {
-        *desc = NULL;
-        xfree(hist);
-    } else {
-        *desc = hist;
+    FRESULT res = file_ll_read(fp, desc, LBP_DESC_SIZE, &bytes);
+
+    if ((res == FR_OK) && (bytes != LBP_DESC_SIZE)) {
+        res = FR_DISK_ERR;
     }
 
     return res;
@@ -2133,7 +2133,7 @@ static void region_grow(int x, int y, image_int angles, struct lsd_point *reg,
         }
         if (ty < 0) {
             ty = 0; dy--;
-        } else if (ty + dy >= used->ysize) {
+        } else if (ty + dy >= (int) used->ysize) {
             dy--;
         }
         for (xx = tx; xx < tx + dx; xx++) {
@@ -2460,6 +2460,7 @@ float *LineSegmentDetection(int *n_out,
                             float ang_th, float log_eps, float density_th,
                             int n_bins,
                             int **reg_img, int *reg_x, int *reg_y) {
+    (void) reg_img, (void) reg_x, (void) reg_y;
     image_char image;
     ntuple_list out = new_ntuple_list(7);
     float *return_value;
@@ -2687,6 +2688,715 @@ float *lsd(int *n_out, unsigned char *img, int X, int Y) {
     return lsd_scale(n_out, img, X, Y, scale);
 }
 
+/*----------------------------------------------------------------------------*/
+/*------------------------ Fixed-Point Line Segment Detector -----------------*/
+/*----------------------------------------------------------------------------*/
+
+/* Integer port of LineSegmentDetection() for the parameters used by
+   find_line_segments(): quant = 2, ang_th = 22.5, log_eps = 0 and
+   density_th = 0.7, without scaling. LineSegmentDetection() is kept as the
+   float reference this code is checked against (see tools/lsd_test).
+
+   - Angles are in 1/16384 turn units. Gradient angles are read from an atan
+     table indexed by the Q8 slope of the octant reduced gradient.
+   - Gradient magnitudes are 16-bit (4x the reference norm) and pixels are
+     pseudo-ordered by a counting sort on that value.
+   - Coordinates and widths are Q8, directions are Q14.
+   - NFA values are Q24 log10 values computed from log-factorials (a table
+     for small n, Stirling's series above) and a short Q16 summation of the
+     binomial tail, so no log-gamma or floating-point math is needed.
+
+   Memory: everything is fb_alloc'd. For a W x H ROI with N pixels above the
+   gradient threshold (N < W * H) the peak is W * H bytes for the grayscale
+   copy, 4 * W * H bytes for the angle and magnitude maps, 8 * N bytes for
+   the pseudo-ordered list and the region, and 5.8 KB for the counting sort
+   bins: at most 13 * W * H + 5.8 KB, about 1 MB for a QVGA ROI in the worst
+   case but usually much less since N is typically a fraction of W * H.
+ */
+
+#define LSD_ANGLE_BITS          (14)
+#define LSD_ANGLE_MASK          ((1 << LSD_ANGLE_BITS) - 1)
+#define LSD_ANGLE_PI            (1 << (LSD_ANGLE_BITS - 1))
+#define LSD_ANGLE_PI_2          (1 << (LSD_ANGLE_BITS - 2))
+#define LSD_ANGLE_NOTDEF        (0x4000)
+#define LSD_ANGLE_USED          (0x8000)
+#define LSD_GRAD_THRESHOLD      (109) // (2 * quant / sin(ang_th))^2
+#define LSD_MAG_BINS            (1448) // sqrt(4 * 2 * 510^2) < 1448
+#define LSD_P_LOG2              (3) // p = ang_th / 180 = 2^-3
+#define LSD_Q24_LOG10_2         (5050445)
+#define LSD_Q24_LOG10_E         (7286252)
+#define LSD_Q24_LOG10_2PI_2     (6695618) // log10(2 * pi) / 2
+#define LSD_Q24_LOG10_E_12      (607188) // log10(e) / 12
+
+// sin(i * pi / 512) in Q14, a quarter turn.
+static const int16_t lsd_sin_table[257] = {
+    0, 101, 201, 302, 402, 503, 603, 704, 804, 904, 1005, 1105,
+    1205, 1306, 1406, 1506, 1606, 1706, 1806, 1906, 2006, 2105, 2205, 2305,
+    2404, 2503, 2603, 2702, 2801, 2900, 2999, 3098, 3196, 3295, 3393, 3492,
+    3590, 3688, 3786, 3883, 3981, 4078, 4176, 4273, 4370, 4467, 4563, 4660,
+    4756, 4852, 4948, 5044, 5139, 5235, 5330, 5425, 5520, 5614, 5708, 5803,
+    5897, 5990, 6084, 6177, 6270, 6363, 6455, 6547, 6639, 6731, 6823, 6914,
+    7005, 7096, 7186, 7276, 7366, 7456, 7545, 7635, 7723, 7812, 7900, 7988,
+    8076, 8163, 8250, 8337, 8423, 8509, 8595, 8680, 8765, 8850, 8935, 9019,
+    9102, 9186, 9269, 9352, 9434, 9516, 9598, 9679, 9760, 9841, 9921, 10001,
+    10080, 10159, 10238, 10316, 10394, 10471, 10549, 10625, 10702, 10778, 10853, 10928,
+    11003, 11077, 11151, 11224, 11297, 11370, 11442, 11514, 11585, 11656, 11727, 11797,
+    11866, 11935, 12004, 12072, 12140, 12207, 12274, 12340, 12406, 12472, 12537, 12601,
+    12665, 12729, 12792, 12854, 12916, 12978, 13039, 13100, 13160, 13219, 13279, 13337,
+    13395, 13453, 13510, 13567, 13623, 13678, 13733, 13788, 13842, 13896, 13949, 14001,
+    14053, 14104, 14155, 14206, 14256, 14305, 14354, 14402, 14449, 14497, 14543, 14589,
+    14635, 14680, 14724, 14768, 14811, 14854, 14896, 14937, 14978, 15019, 15059, 15098,
+    15137, 15175, 15213, 15250, 15286, 15322, 15357, 15392, 15426, 15460, 15493, 15525,
+    15557, 15588, 15619, 15649, 15679, 15707, 15736, 15763, 15791, 15817, 15843, 15868,
+    15893, 15917, 15941, 15964, 15986, 16008, 16029, 16049, 16069, 16088, 16107, 16125,
+    16143, 16160, 16176, 16192, 16207, 16221, 16235, 16248, 16261, 16273, 16284, 16295,
+    16305, 16315, 16324, 16332, 16340, 16347, 16353, 16359, 16364, 16369, 16373, 16376,
+    16379, 16381, 16383, 16384, 16384
+};
+
+// atan(i / 256) in 1/16384 turn units.
+static const uint16_t lsd_atan_table[257] = {
+    0, 10, 20, 31, 41, 51, 61, 71, 81, 92, 102, 112, 122, 132, 142, 153,
+    163, 173, 183, 193, 203, 213, 224, 234, 244, 254, 264, 274, 284, 294, 304, 314,
+    324, 334, 344, 354, 364, 374, 384, 394, 404, 414, 424, 434, 444, 454, 464, 473,
+    483, 493, 503, 513, 523, 532, 542, 552, 562, 571, 581, 591, 600, 610, 620, 629,
+    639, 648, 658, 667, 677, 687, 696, 705, 715, 724, 734, 743, 753, 762, 771, 781,
+    790, 799, 808, 818, 827, 836, 845, 854, 863, 872, 882, 891, 900, 909, 918, 927,
+    936, 944, 953, 962, 971, 980, 989, 997, 1006, 1015, 1024, 1032, 1041, 1050, 1058, 1067,
+    1075, 1084, 1092, 1101, 1109, 1118, 1126, 1135, 1143, 1151, 1160, 1168, 1176, 1184, 1193, 1201,
+    1209, 1217, 1225, 1233, 1241, 1249, 1257, 1265, 1273, 1281, 1289, 1297, 1305, 1313, 1321, 1328,
+    1336, 1344, 1352, 1359, 1367, 1374, 1382, 1390, 1397, 1405, 1412, 1420, 1427, 1435, 1442, 1449,
+    1457, 1464, 1471, 1478, 1486, 1493, 1500, 1507, 1514, 1521, 1529, 1536, 1543, 1550, 1557, 1564,
+    1571, 1577, 1584, 1591, 1598, 1605, 1612, 1618, 1625, 1632, 1638, 1645, 1652, 1658, 1665, 1671,
+    1678, 1684, 1691, 1697, 1704, 1710, 1717, 1723, 1729, 1736, 1742, 1748, 1754, 1761, 1767, 1773,
+    1779, 1785, 1791, 1798, 1804, 1810, 1816, 1822, 1828, 1833, 1839, 1845, 1851, 1857, 1863, 1869,
+    1874, 1880, 1886, 1892, 1897, 1903, 1909, 1914, 1920, 1925, 1931, 1937, 1942, 1948, 1953, 1958,
+    1964, 1969, 1975, 1980, 1985, 1991, 1996, 2001, 2007, 2012, 2017, 2022, 2027, 2033, 2038, 2043,
+    2048
+};
+
+// log10(n!) in Q24.
+static const int32_t lsd_log10_fact_table[16] = {
+    0, 0, 5050445, 13055212,
+    23156102, 34882873, 47938084, 62116477,
+    77267813, 93277345, 110054561, 127526231,
+    145631888, 164320756, 183549594, 203281131
+};
+
+typedef struct lsdi_rect {
+    int32_t x1, y1, x2, y2; // Q8 end points
+    int32_t width; // Q8
+    int32_t theta, prec; // 1/16384 turn units
+    int32_t dx, dy; // Q14 direction
+    int p_log2; // p = 2^-p_log2
+} lsdi_rect_t;
+
+typedef struct lsdi {
+    int w, h;
+    uint16_t *angles; // angle, LSD_ANGLE_NOTDEF and LSD_ANGLE_USED
+    uint16_t *mags;
+    struct lsd_point *reg;
+    int reg_size;
+    int reg_angle;
+    int64_t logNT;
+} lsdi_t;
+
+static int lsdi_sin(int a) {
+    int q = (a >> (LSD_ANGLE_BITS - 2)) & 3;
+    int i = a & (LSD_ANGLE_PI_2 - 1);
+
+    if (q & 1) {
+        i = LSD_ANGLE_PI_2 - i;
+    }
+
+    int j = i >> (LSD_ANGLE_BITS - 10), f = i & ((1 << (LSD_ANGLE_BITS - 10)) - 1), s = lsd_sin_table[j];
+
+    if (f) {
+        s += ((lsd_sin_table[j + 1] - s) * f) >> (LSD_ANGLE_BITS - 10);
+    }
+
+    return (q & 2) ? -s : s;
+}
+
+static inline int lsdi_cos(int a) {
+    return lsdi_sin(a + LSD_ANGLE_PI_2);
+}
+
+// Returns the angle of (x, y) in [0, 16384).
+static int lsdi_atan2(int32_t y, int32_t x) {
+    uint32_t ax = (x < 0) ? -x : x;
+    uint32_t ay = (y < 0) ? -y : y;
+    int swap = ay > ax;
+    uint32_t num = swap ? ax : ay;
+    uint32_t den = swap ? ay : ax;
+
+    if (!den) {
+        return 0;
+    }
+
+    int s = 17 - __builtin_clz(den);
+    if (s > 0) {
+        num >>= s;
+        den >>= s;
+    }
+
+    uint32_t t = (num << 16) / den; // Q16 slope
+    int i = t >> 8, f = t & 0xFF, a = lsd_atan_table[i];
+
+    if (f) {
+        a += ((lsd_atan_table[i + 1] - a) * f) >> 8;
+    }
+
+    if (swap) {
+        a = LSD_ANGLE_PI_2 - a;
+    }
+
+    if (x < 0) {
+        a = LSD_ANGLE_PI - a;
+    }
+
+    if (y < 0) {
+        a = -a;
+    }
+
+    return a & LSD_ANGLE_MASK;
+}
+
+static inline int lsdi_angle_diff(int a, int b) {
+    int d = (a - b) & LSD_ANGLE_MASK;
+    return (d > LSD_ANGLE_PI) ? ((1 << LSD_ANGLE_BITS) - d) : d;
+}
+
+static inline int lsdi_angle_diff_signed(int a, int b) {
+    return ((a - b + LSD_ANGLE_PI) & LSD_ANGLE_MASK) - LSD_ANGLE_PI;
+}
+
+static inline int lsdi_isaligned(uint16_t a, int theta, int prec) {
+    return (!(a & LSD_ANGLE_NOTDEF)) && (lsdi_angle_diff(a & LSD_ANGLE_MASK, theta) <= prec);
+}
+
+static uint32_t lsdi_isqrt(uint32_t x) {
+    uint32_t r = 0;
+
+    for (uint32_t b = 1UL << 30; b; b >>= 2) {
+        if (x >= (r + b)) {
+            x -= r + b;
+            r = (r >> 1) + b;
+        } else {
+            r >>= 1;
+        }
+    }
+
+    return r;
+}
+
+static uint32_t lsdi_isqrt64(uint64_t x) {
+    uint64_t r = 0;
+
+    for (uint64_t b = 1ULL << 62; b; b >>= 2) {
+        if (x >= (r + b)) {
+            x -= r + b;
+            r = (r >> 1) + b;
+        } else {
+            r >>= 1;
+        }
+    }
+
+    return r;
+}
+
+// Returns log10(x) in Q24 for x >= 1.
+static int32_t lsdi_log10(uint32_t x) {
+    int e = 31 - __builtin_clz(x);
+    uint32_t m = x << (31 - e); // Q31 in [1, 2)
+    int32_t r = e << 24;
+
+    for (int i = 23; i >= 0; i--) {
+        uint64_t mm = (((uint64_t) m) * m) >> 31;
+        if (mm >> 32) {
+            mm >>= 1;
+            r |= 1 << i;
+        }
+        m = mm;
+    }
+
+    return (((int64_t) r) * 323228497) >> 30; // log10(2) in Q30
+}
+
+// Returns log10(n!) in Q24.
+static int64_t lsdi_log10_fact(uint32_t n) {
+    if (n < 16) {
+        return lsd_log10_fact_table[n];
+    }
+
+    return ((((int64_t) ((2 * n) + 1)) * lsdi_log10(n)) >> 1)
+           - (((int64_t) n) * LSD_Q24_LOG10_E) + LSD_Q24_LOG10_2PI_2 + (LSD_Q24_LOG10_E_12 / n);
+}
+
+// Returns -log10(NFA) in Q24 for k aligned points out of n at p = 2^-p_log2.
+static int64_t lsdi_nfa(uint32_t n, uint32_t k, int p_log2, int64_t logNT) {
+    if ((!n) || (!k)) {
+        return -logNT;
+    }
+
+    if (n == k) {
+        return (((int64_t) n) * p_log2 * LSD_Q24_LOG10_2) - logNT;
+    }
+
+    // The binomial tail is close to 1 when k <= n * p.
+    if ((((uint64_t) k) << p_log2) <= n) {
+        return -logNT;
+    }
+
+    int64_t log_p = -p_log2 * LSD_Q24_LOG10_2;
+    int64_t log_q = lsdi_log10((1 << p_log2) - 1) + log_p;
+    int64_t term = lsdi_log10_fact(n) - lsdi_log10_fact(k) - lsdi_log10_fact(n - k)
+                   + (k * log_p) + ((n - k) * log_q);
+
+    // Sum the tail terms relative to the first one (Q16) until the remainder, bounded
+    // by a geometric series of the last term ratio, is below 1%.
+    uint32_t q = (1 << p_log2) - 1;
+    uint64_t t = 1 << 16, sum = 1 << 16;
+
+    for (uint32_t i = k + 1; (i <= n) && t; i++) {
+        uint64_t num = n - i + 1, den = ((uint64_t) i) * q;
+        t = (t * num) / den;
+        sum += t;
+
+        if (((i - k) >= 32) || ((t * num) <= ((den - num) * (sum >> 7)))) {
+            sum += (t * num) / (den - num);
+            break;
+        }
+    }
+
+    int32_t sum_log2 = 16;
+    for (; sum >> 32; sum >>= 1, sum_log2--) {
+    }
+
+    return -(term + lsdi_log10(sum) - (sum_log2 * LSD_Q24_LOG10_2)) - logNT;
+}
+
+static int lsdi_density_ok(lsdi_t *lsd, lsdi_rect_t *rec) {
+    int64_t dx = rec->x2 - rec->x1, dy = rec->y2 - rec->y1;
+    int64_t len = lsdi_isqrt64((dx * dx) + (dy * dy));
+    // density_th = 0.7
+    return (((int64_t) lsd->reg_size) * (10 << 16)) >= (7 * len * rec->width);
+}
+
+static int lsdi_get_theta(int64_t ixx, int64_t iyy, int64_t ixy, int reg_angle, int prec) {
+    uint64_t m = IM_MAX(IM_MAX(llabs(ixx), llabs(iyy)), llabs(ixy));
+
+    if (!m) {
+        return reg_angle;
+    }
+
+    // Scale the inertia matrix so that the eigenvalue fits in 64 bits.
+    for (; m >= (1 << 28); m >>= 1) {
+        ixx /= 2;
+        iyy /= 2;
+        ixy /= 2;
+    }
+
+    int64_t d = ixx - iyy;
+    int64_t lambda = (ixx + iyy - lsdi_isqrt64((d * d) + (4 * ixy * ixy))) / 2;
+    int theta = (llabs(ixx) > llabs(iyy)) ? lsdi_atan2(lambda - ixx, ixy) : lsdi_atan2(ixy, lambda - iyy);
+
+    if (lsdi_angle_diff(theta, reg_angle) > prec) {
+        theta = (theta + LSD_ANGLE_PI) & LSD_ANGLE_MASK;
+    }
+
+    return theta;
+}
+
+static void lsdi_region2rect(lsdi_t *lsd, int prec, int p_log2, lsdi_rect_t *rec) {
+    struct lsd_point *reg = lsd->reg;
+    int64_t sx = 0, sy = 0, sum = 0;
+
+    for (int i = 0; i < lsd->reg_size; i++) {
+        int w = lsd->mags[(reg[i].y * lsd->w) + reg[i].x];
+        sx += reg[i].x * w;
+        sy += reg[i].y * w;
+        sum += w;
+    }
+
+    int32_t cx = (sx << 8) / sum;
+    int32_t cy = (sy << 8) / sum;
+    int64_t ixx = 0, iyy = 0, ixy = 0;
+
+    for (int i = 0; i < lsd->reg_size; i++) {
+        int w = lsd->mags[(reg[i].y * lsd->w) + reg[i].x];
+        int32_t dx = ((reg[i].x << 8) - cx) >> 4; // Q4
+        int32_t dy = ((reg[i].y << 8) - cy) >> 4;
+        ixx += ((int64_t) (dy * dy)) * w;
+        iyy += ((int64_t) (dx * dx)) * w;
+        ixy -= ((int64_t) (dx * dy)) * w;
+    }
+
+    int theta = lsdi_get_theta(ixx, iyy, ixy, lsd->reg_angle, prec);
+    int32_t dx = lsdi_cos(theta), dy = lsdi_sin(theta);
+    int32_t l_min = 0, l_max = 0, w_min = 0, w_max = 0;
+
+    for (int i = 0; i < lsd->reg_size; i++) {
+        int64_t px = (reg[i].x << 8) - cx;
+        int64_t py = (reg[i].y << 8) - cy;
+        int32_t l = ((px * dx) + (py * dy) + (1 << 13)) >> 14;
+        int32_t w = ((py * dx) - (px * dy) + (1 << 13)) >> 14;
+        l_min = IM_MIN(l_min, l);
+        l_max = IM_MAX(l_max, l);
+        w_min = IM_MIN(w_min, w);
+        w_max = IM_MAX(w_max, w);
+    }
+
+    rec->x1 = cx + (((l_min * ((int64_t) dx)) + (1 << 13)) >> 14);
+    rec->y1 = cy + (((l_min * ((int64_t) dy)) + (1 << 13)) >> 14);
+    rec->x2 = cx + (((l_max * ((int64_t) dx)) + (1 << 13)) >> 14);
+    rec->y2 = cy + (((l_max * ((int64_t) dy)) + (1 << 13)) >> 14);
+    rec->width = IM_MAX(w_max - w_min, 256); // minimal width of one pixel
+    rec->theta = theta;
+    rec->dx = dx;
+    rec->dy = dy;
+    rec->prec = prec;
+    rec->p_log2 = p_log2;
+}
+
+static void lsdi_region_grow(lsdi_t *lsd, int x, int y, int prec) {
+    uint16_t *angles = lsd->angles;
+    struct lsd_point *reg = lsd->reg;
+    int w = lsd->w, h = lsd->h, size = 1;
+    int angle = angles[(y * w) + x] & LSD_ANGLE_MASK;
+    int32_t sumdx = lsdi_cos(angle), sumdy = lsdi_sin(angle);
+
+    reg[0].x = x;
+    reg[0].y = y;
+    angles[(y * w) + x] |= LSD_ANGLE_USED;
+
+    for (int i = 0; i < size; i++) {
+        int x_start = IM_MAX(reg[i].x - 1, 0), x_end = IM_MIN(reg[i].x + 1, w - 1);
+        int y_start = IM_MAX(reg[i].y - 1, 0), y_end = IM_MIN(reg[i].y + 1, h - 1);
+
+        for (int xx = x_start; xx <= x_end; xx++) {
+            for (int yy = y_start; yy <= y_end; yy++) {
+                uint16_t a = angles[(yy * w) + xx];
+
+                if ((!(a & LSD_ANGLE_USED)) && lsdi_isaligned(a, angle, prec)) {
+                    angles[(yy * w) + xx] = a | LSD_ANGLE_USED;
+                    reg[size].x = xx;
+                    reg[size].y = yy;
+                    size += 1;
+
+                    sumdx += lsdi_cos(a);
+                    sumdy += lsdi_sin(a);
+
+                    // Halving both sums keeps the direction.
+                    if ((abs(sumdx) | abs(sumdy)) >= (1 << 30)) {
+                        sumdx /= 2;
+                        sumdy /= 2;
+                    }
+
+                    angle = lsdi_atan2(sumdy, sumdx);
+                }
+            }
+        }
+    }
+
+    lsd->reg_size = size;
+    lsd->reg_angle = angle;
+}
+
+static int64_t lsdi_rect_nfa(lsdi_t *lsd, lsdi_rect_t *rec) {
+    int32_t ox = ((((int64_t) rec->dy) * rec->width) + (1 << 14)) >> 15;
+    int32_t oy = ((((int64_t) rec->dx) * rec->width) + (1 << 14)) >> 15;
+    int32_t cx[4] = {rec->x1 - ox, rec->x2 - ox, rec->x2 + ox, rec->x1 + ox};
+    int32_t cy[4] = {rec->y1 + oy, rec->y2 + oy, rec->y2 - oy, rec->y1 - oy};
+    int32_t vx[4], vy[4];
+    int offset;
+
+    // Rotate the corners so that the first one has the smallest x.
+    if ((rec->x1 < rec->x2) && (rec->y1 <= rec->y2)) {
+        offset = 0;
+    } else if ((rec->x1 >= rec->x2) && (rec->y1 < rec->y2)) {
+        offset = 1;
+    } else if ((rec->x1 > rec->x2) && (rec->y1 >= rec->y2)) {
+        offset = 2;
+    } else {
+        offset = 3;
+    }
+
+    for (int n = 0; n < 4; n++) {
+        vx[n] = cx[(n + offset) & 3];
+        vy[n] = cy[(n + offset) & 3];
+    }
+
+    uint32_t pts = 0, alg = 0;
+    int x_start = IM_MAX((vx[0] + 255) >> 8, 0);
+    int x_end = IM_MIN(vx[2] >> 8, lsd->w - 1);
+
+    for (int x = x_start; x <= x_end; x++) {
+        int32_t xq = x << 8, ys, ye;
+        int a = (xq < vx[3]) ? 0 : 3, b = (xq < vx[3]) ? 3 : 2;
+        int c = (xq < vx[1]) ? 0 : 1, d = (xq < vx[1]) ? 1 : 2;
+
+        // Lower and upper sides of the rectangle at this column.
+        if (vx[a] == vx[b]) {
+            ys = IM_MIN(vy[a], vy[b]);
+        } else {
+            ys = vy[a] + (((int64_t) (xq - vx[a])) * (vy[b] - vy[a])) / (vx[b] - vx[a]);
+        }
+
+        if (vx[c] == vx[d]) {
+            ye = IM_MAX(vy[c], vy[d]);
+        } else {
+            ye = vy[c] + (((int64_t) (xq - vx[c])) * (vy[d] - vy[c])) / (vx[d] - vx[c]);
+        }
+
+        int y_start = IM_MAX((ys + 255) >> 8, 0);
+        int y_end = IM_MIN(ye >> 8, lsd->h - 1);
+        uint16_t *col = lsd->angles + x;
+
+        for (int y = y_start; y <= y_end; y++) {
+            alg += lsdi_isaligned(col[y * lsd->w], rec->theta, rec->prec);
+        }
+
+        pts += IM_MAX(y_end - y_start + 1, 0);
+    }
+
+    return lsdi_nfa(pts, alg, rec->p_log2, lsd->logNT);
+}
+
+static int64_t lsdi_rect_improve(lsdi_t *lsd, lsdi_rect_t *rec) {
+    const int32_t delta = 128, delta_2 = 64; // 0.5 and 0.25 in Q8
+    int64_t log_nfa = lsdi_rect_nfa(lsd, rec), log_nfa_new;
+    lsdi_rect_t r;
+
+    if (log_nfa > 0) {
+        return log_nfa;
+    }
+
+    // Try finer precisions.
+    r = *rec;
+    for (int n = 0; n < 5; n++) {
+        r.p_log2 += 1;
+        r.prec = LSD_ANGLE_PI >> r.p_log2;
+        if ((log_nfa_new = lsdi_rect_nfa(lsd, &r)) > log_nfa) {
+            log_nfa = log_nfa_new;
+            *rec = r;
+        }
+    }
+
+    if (log_nfa > 0) {
+        return log_nfa;
+    }
+
+    // Try to reduce the width, then one side and then the other side.
+    for (int side = 0; side < 3; side++) {
+        int32_t sx = (side == 0) ? 0 : (side == 1) ? -delta_2 : delta_2;
+        r = *rec;
+        for (int n = 0; n < 5; n++) {
+            if ((r.width - delta) >= 128) {
+                int32_t ox = (r.dy * sx) >> 14, oy = (r.dx * sx) >> 14;
+                r.x1 += ox;
+                r.y1 -= oy;
+                r.x2 += ox;
+                r.y2 -= oy;
+                r.width -= delta;
+                if ((log_nfa_new = lsdi_rect_nfa(lsd, &r)) > log_nfa) {
+                    log_nfa = log_nfa_new;
+                    *rec = r;
+                }
+            }
+        }
+
+        if (log_nfa > 0) {
+            return log_nfa;
+        }
+    }
+
+    // Try even finer precisions.
+    r = *rec;
+    for (int n = 0; n < 5; n++) {
+        r.p_log2 += 1;
+        r.prec = LSD_ANGLE_PI >> r.p_log2;
+        if ((log_nfa_new = lsdi_rect_nfa(lsd, &r)) > log_nfa) {
+            log_nfa = log_nfa_new;
+            *rec = r;
+        }
+    }
+
+    return log_nfa;
+}
+
+static int lsdi_reduce_region_radius(lsdi_t *lsd, int prec, int p_log2, lsdi_rect_t *rec) {
+    struct lsd_point *reg = lsd->reg;
+    int32_t xc = reg[0].x << 8, yc = reg[0].y << 8;
+    int64_t dx1 = rec->x1 - xc, dy1 = rec->y1 - yc;
+    int64_t dx2 = rec->x2 - xc, dy2 = rec->y2 - yc;
+    int64_t rad = IM_MAX((dx1 * dx1) + (dy1 * dy1), (dx2 * dx2) + (dy2 * dy2)); // Q16 squared
+
+    while (!lsdi_density_ok(lsd, rec)) {
+        rad = (rad * 9) / 16; // 75% of the radius
+
+        for (int i = 0; i < lsd->reg_size; i++) {
+            int64_t dx = (reg[i].x << 8) - xc, dy = (reg[i].y << 8) - yc;
+
+            if (((dx * dx) + (dy * dy)) > rad) {
+                lsd->angles[(reg[i].y * lsd->w) + reg[i].x] &= ~LSD_ANGLE_USED;
+                reg[i] = reg[--lsd->reg_size];
+                i -= 1;
+            }
+        }
+
+        if (lsd->reg_size < 2) {
+            return FALSE;
+        }
+
+        lsdi_region2rect(lsd, prec, p_log2, rec);
+    }
+
+    return TRUE;
+}
+
+static int lsdi_refine(lsdi_t *lsd, int prec, int p_log2, lsdi_rect_t *rec) {
+    struct lsd_point *reg = lsd->reg;
+
+    if (lsdi_density_ok(lsd, rec)) {
+        return TRUE;
+    }
+
+    // First try: reduce the angle tolerance to twice the angle standard
+    // deviation near the seed.
+    int xc = reg[0].x, yc = reg[0].y;
+    int ang_c = lsd->angles[(yc * lsd->w) + xc] & LSD_ANGLE_MASK;
+    int64_t width2 = ((int64_t) rec->width) * rec->width;
+    int64_t sum = 0, s_sum = 0;
+    int n = 0;
+
+    for (int i = 0; i < lsd->reg_size; i++) {
+        uint16_t *a = lsd->angles + (reg[i].y * lsd->w) + reg[i].x;
+        int dx = reg[i].x - xc, dy = reg[i].y - yc;
+        *a &= ~LSD_ANGLE_USED;
+
+        if ((((int64_t) ((dx * dx) + (dy * dy))) << 16) < width2) {
+            int ang_d = lsdi_angle_diff_signed(*a & LSD_ANGLE_MASK, ang_c);
+            sum += ang_d;
+            s_sum += ang_d * ang_d;
+            n += 1;
+        }
+    }
+
+    int tau = ((2 * lsdi_isqrt64((n * s_sum) - (sum * sum))) + (n / 2)) / n;
+
+    lsdi_region_grow(lsd, xc, yc, tau);
+
+    if (lsd->reg_size < 2) {
+        return FALSE;
+    }
+
+    lsdi_region2rect(lsd, prec, p_log2, rec);
+
+    // Second try: reduce the region radius.
+    return lsdi_reduce_region_radius(lsd, prec, p_log2, rec);
+}
+
+// Computes the level-line angle and the gradient magnitude of each pixel and returns
+// the number of pixels above the gradient threshold.
+static int lsdi_ll_angle(lsdi_t *lsd, uint8_t *img) {
+    int w = lsd->w, h = lsd->h, n = 0;
+
+    for (int y = 0; y < (h - 1); y++) {
+        uint8_t *row = img + (y * w), *row_next = row + w;
+        uint16_t *angles = lsd->angles + (y * w);
+        uint16_t *mags = lsd->mags + (y * w);
+
+        for (int x = 0; x < (w - 1); x++) {
+            // 2x2 mask: com1 = D - A, com2 = B - C.
+            int com1 = row_next[x + 1] - row[x];
+            int com2 = row[x + 1] - row_next[x];
+            int gx = com1 + com2, gy = com1 - com2;
+            uint32_t norm2 = (gx * gx) + (gy * gy);
+
+            if (norm2 <= LSD_GRAD_THRESHOLD) {
+                angles[x] = LSD_ANGLE_NOTDEF;
+                mags[x] = 0;
+            } else {
+                angles[x] = lsdi_atan2(gx, -gy);
+                mags[x] = lsdi_isqrt(norm2 << 2);
+                n += 1;
+            }
+        }
+
+        angles[w - 1] = LSD_ANGLE_NOTDEF;
+        mags[w - 1] = 0;
+    }
+
+    for (int x = 0; x < w; x++) {
+        lsd->angles[((h - 1) * w) + x] = LSD_ANGLE_NOTDEF;
+        lsd->mags[((h - 1) * w) + x] = 0;
+    }
+
+    return n;
+}
+
+// Bucket sorts the defined pixels by decreasing magnitude. Pixels with the same
+// magnitude keep the column-major order of the reference implementation.
+static void lsdi_pseudo_order(lsdi_t *lsd, uint32_t *list) {
+    int w = lsd->w, h = lsd->h;
+    uint32_t *bins = fb_alloc0(LSD_MAG_BINS * sizeof(uint32_t), FB_ALLOC_NO_HINT);
+
+    for (int i = 0, j = w * h; i < j; i++) {
+        if (!(lsd->angles[i] & LSD_ANGLE_NOTDEF)) {
+            bins[lsd->mags[i]] += 1;
+        }
+    }
+
+    for (int i = LSD_MAG_BINS - 1, start = 0; i >= 0; i--) {
+        int count = bins[i];
+        bins[i] = start;
+        start += count;
+    }
+
+    for (int x = 0; x < w; x++) {
+        for (int y = 0, i = x; y < h; y++, i += w) {
+            if (!(lsd->angles[i] & LSD_ANGLE_NOTDEF)) {
+                list[bins[lsd->mags[i]]++] = i;
+            }
+        }
+    }
+
+    fb_free(); // bins
+}
+
+static void lsdi_add_segment(list_t *out, rectangle_t *roi, lsdi_rect_t *rec, int64_t log_nfa) {
+    find_lines_list_lnk_data_t lnk_line;
+
+    // The gradient was computed with a 2x2 mask, its value corresponds to points with an
+    // offset of (0.5, 0.5) which is added here while rounding.
+    lnk_line.line.x1 = (rec->x1 + 256) >> 8;
+    lnk_line.line.y1 = (rec->y1 + 256) >> 8;
+    lnk_line.line.x2 = (rec->x2 + 256) >> 8;
+    lnk_line.line.y2 = (rec->y2 + 256) >> 8;
+
+    if (lb_clip_line(&lnk_line.line, 0, 0, roi->w, roi->h)) {
+        lnk_line.line.x1 += roi->x;
+        lnk_line.line.y1 += roi->y;
+        lnk_line.line.x2 += roi->x;
+        lnk_line.line.y2 += roi->y;
+
+        int dx = lnk_line.line.x2 - lnk_line.line.x1, mdx = lnk_line.line.x1 + (dx / 2);
+        int dy = lnk_line.line.y2 - lnk_line.line.y1, mdy = lnk_line.line.y1 + (dy / 2);
+        float rotation = (dx ? fast_atan2f(dy, dx) : 1.570796f) + 1.570796f; // PI/2
+
+        lnk_line.theta = fast_roundf(rotation * 57.295780) % 180; // * (180 / PI)
+        if (lnk_line.theta < 0) {
+            lnk_line.theta += 180;
+        }
+        lnk_line.rho = fast_roundf((mdx * cos_table[lnk_line.theta]) + (mdy * sin_table[lnk_line.theta]));
+
+        lnk_line.magnitude = (log_nfa + (1 << 23)) >> 24;
+
+        list_push_back(out, &lnk_line);
+    }
+}
+
 void imlib_lsd_find_line_segments(list_t *out,
                                   image_t *ptr,
                                   rectangle_t *roi,
@@ -2701,52 +3411,48 @@ void imlib_lsd_find_line_segments(list_t *out,
     img.data = grayscale_image;
     imlib_draw_image(&img, ptr, 0, 0, 1.f, 1.f, roi, -1, 256, NULL, NULL, 0, NULL, NULL, NULL);
 
-    umm_init_x(fb_avail());
-
-    int n_ls;
-    float *ls = LineSegmentDetection(&n_ls,
-                                     grayscale_image,
-                                     roi->w,
-                                     roi->h,
-                                     0.8,
-                                     0.6,
-                                     2.0,
-                                     22.5,
-                                     0.0,
-                                     0.7,
-                                     1024,
-                                     NULL,
-                                     NULL,
-                                     NULL);
+    lsdi_t lsd;
+    lsd.w = roi->w;
+    lsd.h = roi->h;
+    lsd.angles = fb_alloc(lsd.w * lsd.h * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+    lsd.mags = fb_alloc(lsd.w * lsd.h * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+
+    int n = lsdi_ll_angle(&lsd, grayscale_image);
+    uint32_t *list = fb_alloc(IM_MAX(n, 1) * sizeof(uint32_t), FB_ALLOC_NO_HINT);
+    lsd.reg = fb_alloc(IM_MAX(n, 1) * sizeof(struct lsd_point), FB_ALLOC_NO_HINT);
+    lsdi_pseudo_order(&lsd, list);
+
+    // Number of tests: 11 * (W * H)^(5/2).
+    lsd.logNT = ((5 * (((int64_t) lsdi_log10(lsd.w)) + lsdi_log10(lsd.h))) / 2) + lsdi_log10(11);
+    int min_reg_size = lsd.logNT / (LSD_P_LOG2 * LSD_Q24_LOG10_2);
+    int prec = LSD_ANGLE_PI >> LSD_P_LOG2;
+
     list_init(out, sizeof(find_lines_list_lnk_data_t));
 
-    for (int i = 0, j = n_ls; i < j; i++) {
-        find_lines_list_lnk_data_t lnk_line;
+    for (int i = 0; i < n; i++) {
+        int x = list[i] % lsd.w, y = list[i] / lsd.w;
 
-        lnk_line.line.x1 = fast_roundf(ls[(7 * i) + 0]);
-        lnk_line.line.y1 = fast_roundf(ls[(7 * i) + 1]);
-        lnk_line.line.x2 = fast_roundf(ls[(7 * i) + 2]);
-        lnk_line.line.y2 = fast_roundf(ls[(7 * i) + 3]);
+        if (lsd.angles[list[i]] & LSD_ANGLE_USED) {
+            continue;
+        }
 
-        if (lb_clip_line(&lnk_line.line, 0, 0, roi->w, roi->h)) {
-            lnk_line.line.x1 += roi->x;
-            lnk_line.line.y1 += roi->y;
-            lnk_line.line.x2 += roi->x;
-            lnk_line.line.y2 += roi->y;
+        lsdi_region_grow(&lsd, x, y, prec);
 
-            int dx = lnk_line.line.x2 - lnk_line.line.x1, mdx = lnk_line.line.x1 + (dx / 2);
-            int dy = lnk_line.line.y2 - lnk_line.line.y1, mdy = lnk_line.line.y1 + (dy / 2);
-            float rotation = (dx ? fast_atan2f(dy, dx) : 1.570796f) + 1.570796f; // PI/2
+        if (lsd.reg_size < min_reg_size) {
+            continue;
+        }
 
-            lnk_line.theta = fast_roundf(rotation * 57.295780) % 180; // * (180 / PI)
-            if (lnk_line.theta < 0) {
-                lnk_line.theta += 180;
-            }
-            lnk_line.rho = fast_roundf((mdx * cos_table[lnk_line.theta]) + (mdy * sin_table[lnk_line.theta]));
+        lsdi_rect_t rec;
+        lsdi_region2rect(&lsd, prec, LSD_P_LOG2, &rec);
+
+        if (!lsdi_refine(&lsd, prec, LSD_P_LOG2, &rec)) {
+            continue;
+        }
 
-            lnk_line.magnitude = fast_roundf(ls[(7 * i) + 6]);
+        int64_t log_nfa = lsdi_rect_improve(&lsd, &rec);
 
-            list_push_back(out, &lnk_line);
+        if (log_nfa > 0) {
+            lsdi_add_segment(out, roi, &rec, log_nfa);
         }
     }
 
@@ -2754,7 +3460,10 @@ void imlib_lsd_find_line_segments(list_t *out,
         merge_alot(out, merge_distance, max_theta_diff);
     }
 
-    fb_free(); // umm_init_x();
+    fb_free(); // lsd.reg
+    fb_free(); // list
+    fb_free(); // lsd.mags
+    fb_free(); // lsd.angles
     fb_free(); // grayscale_image;
 }
 
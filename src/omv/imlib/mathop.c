@@ -26,6 +26,65 @@
 #include "imlib.h"
 
 #ifdef IMLIB_ENABLE_MATH_OPS
+#if defined(ARM_MATH_DSP)
+// Returns the n (at most 4) mask pixels starting at x as a bit field.
+static inline uint32_t mathop_get_mask_bits(image_t *mask, int x, int y, int n) {
+    uint32_t bits = 0;
+
+    if ((0 <= x) && ((x + n) <= mask->w) && (0 <= y) && (y < mask->h)) {
+        switch (mask->pixfmt) {
+            case PIXFORMAT_BINARY: {
+                uint32_t *row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(mask, y);
+                int shift = x & UINT32_T_MASK;
+                bits = row_ptr[x >> UINT32_T_SHIFT] >> shift;
+
+                if ((shift + n) > 32) {
+                    bits |= row_ptr[(x >> UINT32_T_SHIFT) + 1] << (32 - shift);
+                }
+
+                return bits & ((1 << n) - 1);
+            }
+            case PIXFORMAT_GRAYSCALE: {
+                uint8_t *row_ptr = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(mask, y);
+                for (int i = 0; i < n; i++) {
+                    bits |= COLOR_GRAYSCALE_TO_BINARY(IMAGE_GET_GRAYSCALE_PIXEL_FAST(row_ptr, x + i)) << i;
+                }
+                return bits;
+            }
+            case PIXFORMAT_RGB565: {
+                uint16_t *row_ptr = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(mask, y);
+                for (int i = 0; i < n; i++) {
+                    bits |= COLOR_RGB565_TO_BINARY(IMAGE_GET_RGB565_PIXEL_FAST(row_ptr, x + i)) << i;
+                }
+                return bits;
+            }
+            default: {
+                return 0;
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        bits |= image_get_mask_pixel(mask, x + i, y) << i;
+    }
+
+    return bits;
+}
+
+// Selects the bytes of p for the pixels set in bits and the bytes of p0 for the others.
+static inline uint32_t mathop_blend_u8(uint32_t bits, uint32_t p, uint32_t p0) {
+    // Spread bits 0-3 to bit 0 of each byte, the usub8 sets GE for the bytes equal to 1.
+    __USUB8((bits * 0x00204081) & 0x01010101, 0x01010101);
+    return __SEL(p, p0);
+}
+
+// Selects the halfwords of p for the pixels set in bits and the halfwords of p0 for the others.
+static inline uint32_t mathop_blend_u16(uint32_t bits, uint32_t p, uint32_t p0) {
+    __USUB16((bits * 0x8001) & 0x10001, 0x10001);
+    return __SEL(p, p0);
+}
+#endif
+
 void imlib_add_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data) {
     image_t *mask = (image_t *) data->callback_arg;
 
@@ -54,6 +113,19 @@ void imlib_add_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data)
                     IMAGE_PUT_GRAYSCALE_PIXEL_FAST(row0, x, p);
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 4; x += 4) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 4);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        uint32_t p = __UQADD8(p0, p1);
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u8(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_GRAYSCALE_PIXEL_FAST(row0, x);
@@ -90,6 +162,22 @@ void imlib_add_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data)
                     IMAGE_PUT_RGB565_PIXEL_FAST(row0, x, COLOR_R5_G6_B5_TO_RGB565(r, g, b));
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 2; x += 2) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 2);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        uint32_t r = __USAT16(((p0 >> 11) & 0x1f001f) + ((p1 >> 11) & 0x1f001f), 5);
+                        uint32_t g = __USAT16(((p0 >> 5) & 0x3f003f) + ((p1 >> 5) & 0x3f003f), 6);
+                        uint32_t b = __USAT16((p0 & 0x1f001f) + (p1 & 0x1f001f), 5);
+                        uint32_t p = COLOR_R5_G6_B5_TO_RGB565(r, g, b);
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u16(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_RGB565_PIXEL_FAST(row0, x);
@@ -172,6 +260,19 @@ void imlib_sub_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data)
                     IMAGE_PUT_GRAYSCALE_PIXEL_FAST(row0, x, p);
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 4; x += 4) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 4);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        uint32_t p = __UQSUB8(p0, p1);
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u8(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_GRAYSCALE_PIXEL_FAST(row0, x);
@@ -208,6 +309,22 @@ void imlib_sub_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data)
                     IMAGE_PUT_RGB565_PIXEL_FAST(row0, x, COLOR_R5_G6_B5_TO_RGB565(r, g, b));
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 2; x += 2) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 2);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        uint32_t r = __USAT16(__SSUB16((p0 >> 11) & 0x1f001f, (p1 >> 11) & 0x1f001f), 5);
+                        uint32_t g = __USAT16(__SSUB16((p0 >> 5) & 0x3f003f, (p1 >> 5) & 0x3f003f), 6);
+                        uint32_t b = __USAT16(__SSUB16(p0 & 0x1f001f, p1 & 0x1f001f), 5);
+                        uint32_t p = COLOR_R5_G6_B5_TO_RGB565(r, g, b);
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u16(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_RGB565_PIXEL_FAST(row0, x);
@@ -290,6 +407,19 @@ void imlib_rsub_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data
                     IMAGE_PUT_GRAYSCALE_PIXEL_FAST(row0, x, p);
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 4; x += 4) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 4);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        uint32_t p = __UQSUB8(p1, p0);
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u8(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_GRAYSCALE_PIXEL_FAST(row0, x);
@@ -326,6 +456,22 @@ void imlib_rsub_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data
                     IMAGE_PUT_RGB565_PIXEL_FAST(row0, x, COLOR_R5_G6_B5_TO_RGB565(r, g, b));
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 2; x += 2) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 2);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        uint32_t r = __USAT16(__SSUB16((p1 >> 11) & 0x1f001f, (p0 >> 11) & 0x1f001f), 5);
+                        uint32_t g = __USAT16(__SSUB16((p1 >> 5) & 0x3f003f, (p0 >> 5) & 0x3f003f), 6);
+                        uint32_t b = __USAT16(__SSUB16(p1 & 0x1f001f, p0 & 0x1f001f), 5);
+                        uint32_t p = COLOR_R5_G6_B5_TO_RGB565(r, g, b);
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u16(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_RGB565_PIXEL_FAST(row0, x);
@@ -373,6 +519,20 @@ void imlib_min_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data)
                     IMAGE_PUT_GRAYSCALE_PIXEL_FAST(row0, x, p);
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 4; x += 4) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 4);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        __USUB8(p0, p1);
+                        uint32_t p = __SEL(p1, p0);
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u8(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_GRAYSCALE_PIXEL_FAST(row0, x);
@@ -412,6 +572,25 @@ void imlib_min_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data)
                     IMAGE_PUT_RGB565_PIXEL_FAST(row0, x, COLOR_R5_G6_B5_TO_RGB565(r, g, b));
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 2; x += 2) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 2);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        uint32_t p0_rb = p0 & 0xf81ff81f, p1_rb = p1 & 0xf81ff81f;
+                        __USUB8(p0_rb, p1_rb);
+                        uint32_t rb = __SEL(p1_rb, p0_rb);
+                        uint32_t p0_g = p0 & 0x07e007e0, p1_g = p1 & 0x07e007e0;
+                        __USUB16(p0_g, p1_g);
+                        uint32_t g = __SEL(p1_g, p0_g);
+                        uint32_t p = rb | g;
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u16(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_RGB565_PIXEL_FAST(row0, x);
@@ -460,6 +639,20 @@ void imlib_max_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data)
                     IMAGE_PUT_GRAYSCALE_PIXEL_FAST(row0, x, p);
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 4; x += 4) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 4);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        __USUB8(p0, p1);
+                        uint32_t p = __SEL(p0, p1);
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u8(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_GRAYSCALE_PIXEL_FAST(row0, x);
@@ -499,6 +692,25 @@ void imlib_max_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t *data)
                     IMAGE_PUT_RGB565_PIXEL_FAST(row0, x, COLOR_R5_G6_B5_TO_RGB565(r, g, b));
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 2; x += 2) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 2);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        uint32_t p0_rb = p0 & 0xf81ff81f, p1_rb = p1 & 0xf81ff81f;
+                        __USUB8(p0_rb, p1_rb);
+                        uint32_t rb = __SEL(p0_rb, p1_rb);
+                        uint32_t p0_g = p0 & 0x07e007e0, p1_g = p1 & 0x07e007e0;
+                        __USUB16(p0_g, p1_g);
+                        uint32_t g = __SEL(p0_g, p1_g);
+                        uint32_t p = rb | g;
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u16(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_RGB565_PIXEL_FAST(row0, x);
@@ -548,6 +760,21 @@ void imlib_difference_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t
                     IMAGE_PUT_GRAYSCALE_PIXEL_FAST(row0, x, p);
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 4; x += 4) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 4);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        uint32_t sub0 = __USUB8(p0, p1);
+                        uint32_t sub1 = __USUB8(p1, p0);
+                        uint32_t p = __SEL(sub1, sub0);
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u8(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_GRAYSCALE_PIXEL_FAST(row0, x);
@@ -589,6 +816,27 @@ void imlib_difference_line_op(int x, int x_end, int y_row, imlib_draw_row_data_t
                     IMAGE_PUT_RGB565_PIXEL_FAST(row0, x, COLOR_R5_G6_B5_TO_RGB565(r, g, b));
                 }
             } else {
+                #if defined(ARM_MATH_DSP)
+                for (; (x_end - x) >= 2; x += 2) {
+                    uint32_t bits = mathop_get_mask_bits(mask, x, y_row, 2);
+
+                    if (bits) {
+                        uint32_t p0 = *((uint32_t *) (row0 + x));
+                        uint32_t p1 = *((uint32_t *) (row1 + x));
+                        uint32_t p0_rb = p0 & 0xf81ff81f, p1_rb = p1 & 0xf81ff81f;
+                        uint32_t sub0 = __USUB8(p0_rb, p1_rb);
+                        uint32_t sub1 = __USUB8(p1_rb, p0_rb);
+                        uint32_t rb = __SEL(sub1, sub0);
+                        uint32_t p0_g = p0 & 0x07e007e0, p1_g = p1 & 0x07e007e0;
+                        sub0 = __USUB16(p0_g, p1_g);
+                        sub1 = __USUB16(p1_g, p0_g);
+                        uint32_t g = __SEL(sub1, sub0);
+                        uint32_t p = rb | g;
+                        *((uint32_t *) (row0 + x)) = mathop_blend_u16(bits, p, p0);
+                    }
+                }
+                #endif
+
                 for (; x < x_end; x++) {
                     if (image_get_mask_pixel(mask, x, y_row)) {
                         uint32_t p0 = IMAGE_GET_RGB565_PIXEL_FAST(row0, x);
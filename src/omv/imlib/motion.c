@@ -0,0 +1,170 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *
+ * Block-matching motion estimation.
+ *
+ * Each block of the current image is matched against the previous image by SAD (sum of
+ * absolute differences). The search starts from the best of the zero vector and the
+ * vectors of the neighboring blocks, then refines it with a large and a small diamond
+ * pattern. Positions already tested are skipped.
+ */
+#include "imlib.h"
+#ifdef IMLIB_ENABLE_FIND_MOTION_VECTORS
+#include "simd.h"
+
+typedef struct motion_search {
+    const uint8_t *block;   // Current block.
+    image_t *prev;
+    int x, y;               // Block position.
+    int size;
+    int range;
+    uint32_t visited[(MOTION_MAX_RANGE * 2) + 1];
+    int best_x, best_y;
+    uint32_t best_sad;
+} motion_search_t;
+
+// Returns the SAD of two blocks, stopping early once it reaches limit.
+static uint32_t motion_sad(const uint8_t *a, const uint8_t *b, int stride, int size, uint32_t limit) {
+    uint32_t sad = 0;
+
+    for (int y = 0; y < size; y++, a += stride, b += stride) {
+        for (int x = 0; x < size; x += UINT8_VECTOR_SIZE) {
+            v128_predicate_t pred = vpredicate_8(size - x);
+            sad = vsada_u8(vldr_u8_pred(a + x, pred), vldr_u8_pred(b + x, pred), sad);
+        }
+
+        if (sad >= limit) {
+            break;
+        }
+    }
+
+    return sad;
+}
+
+static bool motion_try(motion_search_t *s, int dx, int dy) {
+    int px = s->x - dx;
+    int py = s->y - dy;
+
+    if ((abs(dx) > s->range) || (abs(dy) > s->range) ||
+        (px < 0) || (py < 0) || ((px + s->size) > s->prev->w) || ((py + s->size) > s->prev->h)) {
+        return false;
+    }
+
+    uint32_t bit = 1U << (dx + s->range);
+    uint32_t *row = &s->visited[dy + s->range];
+
+    if ((*row) & bit) {
+        return false;
+    }
+
+    *row |= bit;
+
+    const uint8_t *p = s->prev->pixels + (py * s->prev->w) + px;
+    uint32_t sad = motion_sad(s->block, p, s->prev->w, s->size, s->best_sad);
+
+    if (sad < s->best_sad) {
+        s->best_x = dx;
+        s->best_y = dy;
+        s->best_sad = sad;
+        return true;
+    }
+
+    return false;
+}
+
+static int motion_median(int a, int b, int c) {
+    return IM_MAX(IM_MIN(a, b), IM_MIN(IM_MAX(a, b), c));
+}
+
+void imlib_find_motion_vectors(image_t *img, image_t *prev, rectangle_t *roi,
+                               int block_size, int range, motion_vector_t *vectors) {
+    static const int8_t large_diamond[8][2] = {
+        { 0, -2 }, { 1, -1 }, { 2, 0 }, { 1, 1 }, { 0, 2 }, { -1, 1 }, { -2, 0 }, { -1, -1 }
+    };
+    static const int8_t small_diamond[4][2] = {
+        { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 }
+    };
+
+    int cols = roi->w / block_size;
+    int rows = roi->h / block_size;
+    // A mean absolute difference under 1 is as good as it gets.
+    uint32_t good_sad = block_size * block_size;
+    motion_search_t s = { .prev = prev, .size = block_size, .range = IM_MIN(range, MOTION_MAX_RANGE) };
+
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            motion_vector_t *mv = &vectors[(row * cols) + col];
+            s.x = roi->x + (col * block_size);
+            s.y = roi->y + (row * block_size);
+            s.block = img->pixels + (s.y * img->w) + s.x;
+            s.best_x = 0;
+            s.best_y = 0;
+            s.best_sad = UINT32_MAX;
+            memset(s.visited, 0, sizeof(s.visited));
+
+            // Predictors: zero, left, top, top-right and their median.
+            motion_try(&s, 0, 0);
+
+            if (row || col) {
+                motion_vector_t *l = col ? (mv - 1) : NULL;
+                motion_vector_t *t = row ? (mv - cols) : NULL;
+                motion_vector_t *tr = (row && (col < (cols - 1))) ? (mv - cols + 1) : t;
+
+                if (l) {
+                    motion_try(&s, l->x, l->y);
+                }
+
+                if (t) {
+                    motion_try(&s, t->x, t->y);
+                    motion_try(&s, tr->x, tr->y);
+                }
+
+                if (l && t) {
+                    motion_try(&s, motion_median(l->x, t->x, tr->x), motion_median(l->y, t->y, tr->y));
+                }
+            }
+
+            // Large diamond until the center is the best, then one small diamond.
+            if (s.best_sad > good_sad) {
+                for (bool moved = true; moved;) {
+                    int cx = s.best_x, cy = s.best_y;
+                    moved = false;
+                    for (int i = 0; i < 8; i++) {
+                        moved |= motion_try(&s, cx + large_diamond[i][0], cy + large_diamond[i][1]);
+                    }
+                }
+
+                int cx = s.best_x, cy = s.best_y;
+                for (int i = 0; i < 4; i++) {
+                    motion_try(&s, cx + small_diamond[i][0], cy + small_diamond[i][1]);
+                }
+            }
+
+            mv->x = s.best_x;
+            mv->y = s.best_y;
+            mv->sad = s.best_sad;
+        }
+    }
+}
+#endif // IMLIB_ENABLE_FIND_MOTION_VECTORS
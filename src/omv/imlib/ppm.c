@@ -88,6 +88,7 @@ void ppm_read_geometry(FIL *fp, image_t *img, const char *path, ppm_read_setting
 
     read_int(fp, (uint32_t *) &img->w, rs);
     read_int(fp, (uint32_t *) &img->h, rs);
+    rs->ppm_w = img->w;
 
     if ((img->w == 0) || (img->h == 0)) {
         file_raise_corrupted(fp);
@@ -100,52 +101,119 @@ void ppm_read_geometry(FIL *fp, image_t *img, const char *path, ppm_read_setting
     }
 }
 
-// This function reads the pixel values of an image.
-void ppm_read_pixels(FIL *fp, image_t *img, int n_lines, ppm_read_settings_t *rs) {
-    if (rs->ppm_fmt == '2') {
-        for (int i = 0; i < n_lines; i++) {
-            for (int j = 0; j < img->w; j++) {
-                uint32_t pixel;
-                read_int(fp, &pixel, rs);
-                IM_SET_GS_PIXEL(img, j, i, pixel);
-            }
-        }
-    } else if (rs->ppm_fmt == '3') {
-        for (int i = 0; i < n_lines; i++) {
-            for (int j = 0; j < img->w; j++) {
-                uint32_t r, g, b;
-                read_int(fp, &r, rs);
-                read_int(fp, &g, rs);
-                read_int(fp, &b, rs);
-                IM_SET_RGB565_PIXEL(img, j, i, COLOR_R8_G8_B8_TO_RGB565(r, g, b));
+// Converts a row of RGB565 pixels to RGB888 two pixels at a time.
+static void ppm_rgb565_to_rgb888(uint8_t *dst, const uint16_t *src, int w) {
+    int x = 0;
+
+    for (; x < (w - 1); x += 2, dst += 6) {
+        uint32_t pixels;
+        memcpy(&pixels, src + x, sizeof(uint32_t));
+        uint32_t r = (pixels >> 8) & 0x00F800F8;
+        uint32_t g = (pixels >> 3) & 0x00FC00FC;
+        uint32_t b = (pixels << 3) & 0x00F800F8;
+        r |= r >> 5;
+        g |= g >> 6;
+        b |= b >> 5;
+        dst[0] = r;
+        dst[1] = g;
+        dst[2] = b;
+        dst[3] = r >> 16;
+        dst[4] = g >> 16;
+        dst[5] = b >> 16;
+    }
+
+    if (x < w) {
+        uint16_t pixel = src[x];
+        dst[0] = COLOR_RGB565_TO_R8(pixel);
+        dst[1] = COLOR_RGB565_TO_G8(pixel);
+        dst[2] = COLOR_RGB565_TO_B8(pixel);
+    }
+}
+
+// This function reads the pixel values of the r sub-image of a PPM/PGM file into img. Binary
+// files are read a chunk of rows at a time into a line buffer and rows outside of r are not read.
+// ASCII files are parsed through the file buffer.
+void ppm_read_pixels(FIL *fp, image_t *img, rectangle_t *r, ppm_read_settings_t *rs) {
+    int w = r->x + r->w, h = r->y + r->h; // file width is only needed for ASCII files
+
+    if ((rs->ppm_fmt == '2') || (rs->ppm_fmt == '3')) {
+        // ASCII files have variable length rows so rows above r have to be parsed.
+        file_buffer_on(fp);
+        for (int i = 0; i < h; i++) {
+            for (int j = 0, jj = rs->ppm_w; j < jj; j++) {
+                uint32_t r8, g8 = 0, b8 = 0;
+                read_int(fp, &r8, rs);
+                if (rs->ppm_fmt == '3') {
+                    read_int(fp, &g8, rs);
+                    read_int(fp, &b8, rs);
+                }
+                if ((i >= r->y) && (j >= r->x) && (j < w)) {
+                    if (rs->ppm_fmt == '2') {
+                        IM_SET_GS_PIXEL(img, j - r->x, i - r->y, r8);
+                    } else {
+                        IM_SET_RGB565_PIXEL(img, j - r->x, i - r->y, COLOR_R8_G8_B8_TO_RGB565(r8, g8, b8));
+                    }
+                }
             }
         }
-    } else if (rs->ppm_fmt == '5') {
-        file_read(fp, img->pixels, n_lines * img->w);
-    } else if (rs->ppm_fmt == '6') {
-        for (int i = 0; i < n_lines; i++) {
-            for (int j = 0; j < img->w; j++) {
-                uint8_t r, g, b;
-                file_read(fp, &r, 1);
-                file_read(fp, &g, 1);
-                file_read(fp, &b, 1);
-                IM_SET_RGB565_PIXEL(img, j, i, COLOR_R8_G8_B8_TO_RGB565(r, g, b));
+        file_buffer_off(fp);
+        return;
+    }
+
+    int bytes_per_pixel = (rs->ppm_fmt == '5') ? 1 : 3;
+    int row_bytes = rs->ppm_w * bytes_per_pixel;
+
+    uint32_t size;
+    uint8_t *buffer = fb_alloc_all(&size, FB_ALLOC_PREFER_SIZE | FB_ALLOC_CACHE_ALIGN);
+    int chunk_rows = IM_MIN(size / row_bytes, r->h);
+
+    if (!chunk_rows) {
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Out of Memory!"));
+    }
+
+    file_seek(fp, file_tell(fp) + (r->y * row_bytes));
+
+    for (int i = 0; i < r->h; i += chunk_rows) {
+        int n = IM_MIN(chunk_rows, r->h - i);
+        file_read(fp, buffer, n * row_bytes);
+
+        for (int j = 0; j < n; j++) {
+            uint8_t *src = buffer + (j * row_bytes) + (r->x * bytes_per_pixel);
+
+            if (rs->ppm_fmt == '5') {
+                memcpy(IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, i + j), src, r->w);
+            } else {
+                uint16_t *dst = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, i + j);
+                for (int x = 0; x < r->w; x++, src += 3) {
+                    dst[x] = COLOR_R8_G8_B8_TO_RGB565(src[0], src[1], src[2]);
+                }
             }
         }
     }
+
+    fb_free();
 }
 
-void ppm_read(image_t *img, const char *path) {
+void ppm_read(image_t *img, const char *path, rectangle_t *roi) {
     FIL fp;
     ppm_read_settings_t rs;
 
-    file_open(&fp, path, true, FA_READ | FA_OPEN_EXISTING);
+    file_open(&fp, path, false, FA_READ | FA_OPEN_EXISTING);
     ppm_read_geometry(&fp, img, path, &rs);
 
+    rectangle_t r = {0, 0, img->w, img->h};
+    if (roi) {
+        if (!rectangle_subimg(img, roi, &r)) {
+            mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("No intersection!"));
+        }
+        img->w = r.w;
+        img->h = r.h;
+    }
+
     if (!img->pixels) {
         img->pixels = xalloc(img->w * img->h * img->bpp);
     }
-    ppm_read_pixels(&fp, img, img->h, &rs);
+    ppm_read_pixels(&fp, img, &r, &rs);
     file_close(&fp);
 }
 
@@ -156,7 +224,7 @@ void ppm_write_subimg(image_t *img, const char *path, rectangle_t *r) {
     }
 
     FIL fp;
-    file_open(&fp, path, true, FA_WRITE | FA_CREATE_ALWAYS);
+    file_open(&fp, path, false, FA_WRITE | FA_CREATE_ALWAYS);
 
     if (IM_IS_GS(img)) {
         char buffer[20]; // exactly big enough for 5-digit w/h
@@ -173,16 +241,28 @@ void ppm_write_subimg(image_t *img, const char *path, rectangle_t *r) {
         char buffer[20]; // exactly big enough for 5-digit w/h
         int len = snprintf(buffer, 20, "P6\n%d %d\n255\n", rect.w, rect.h);
         file_write(&fp, buffer, len);
-        for (int i = 0; i < rect.h; i++) {
-            for (int j = 0; j < rect.w; j++) {
-                int pixel = IM_GET_RGB565_PIXEL(img, (rect.x + j), (rect.y + i));
-                char buff[3];
-                buff[0] = COLOR_RGB565_TO_R8(pixel);
-                buff[1] = COLOR_RGB565_TO_G8(pixel);
-                buff[2] = COLOR_RGB565_TO_B8(pixel);
-                file_write(&fp, buff, 3);
+
+        // Convert a chunk of rows at a time into a line buffer and write it out at once.
+        uint32_t size, row_bytes = rect.w * 3;
+        uint8_t *line = fb_alloc_all(&size, FB_ALLOC_PREFER_SIZE | FB_ALLOC_CACHE_ALIGN);
+        int chunk_rows = IM_MIN(size / row_bytes, rect.h);
+
+        if (!chunk_rows) {
+            mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Out of Memory!"));
+        }
+
+        for (int i = 0; i < rect.h; i += chunk_rows) {
+            int n = IM_MIN(chunk_rows, rect.h - i);
+
+            for (int j = 0; j < n; j++) {
+                uint16_t *src = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, rect.y + i + j) + rect.x;
+                ppm_rgb565_to_rgb888(line + (j * row_bytes), src, rect.w);
             }
+
+            file_write(&fp, line, n * row_bytes);
         }
+
+        fb_free();
     }
     file_close(&fp);
 }
@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *
+ * Image pyramid.
+ *
+ * Each level is half the size of the level below it, with every pixel set to the average
+ * of a 2x2 block. Level 0 is the source image itself and isn't copied.
+ */
+#include "imlib.h"
+#include "fb_alloc.h"
+
+void imlib_pyramid_build(image_pyramid_t *pyramid, image_t *img, int levels) {
+    pyramid->levels = 1;
+    pyramid->images[0] = *img;
+
+    for (int i = 1; i < IM_MIN(levels, IMAGE_PYRAMID_MAX_LEVELS); i++) {
+        image_t *src = &pyramid->images[i - 1];
+        image_t *dst = &pyramid->images[i];
+
+        if (((src->w / 2) < IMAGE_PYRAMID_MIN_SIZE) || ((src->h / 2) < IMAGE_PYRAMID_MIN_SIZE)) {
+            break;
+        }
+
+        *dst = *src;
+        dst->w = src->w / 2;
+        dst->h = src->h / 2;
+        dst->pixels = fb_alloc(dst->w * dst->h, FB_ALLOC_NO_HINT);
+
+        for (int y = 0; y < dst->h; y++) {
+            const uint8_t *row0 = src->pixels + (y * 2 * src->w);
+            const uint8_t *row1 = row0 + src->w;
+            uint8_t *row = dst->pixels + (y * dst->w);
+
+            for (int x = 0; x < dst->w; x++, row0 += 2, row1 += 2) {
+                row[x] = (row0[0] + row0[1] + row1[0] + row1[1] + 2) >> 2;
+            }
+        }
+
+        pyramid->levels += 1;
+    }
+}
+
+void imlib_pyramid_free(image_pyramid_t *pyramid) {
+    for (; pyramid->levels > 1; pyramid->levels--) {
+        fb_free();
+    }
+}
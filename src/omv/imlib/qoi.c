@@ -0,0 +1,401 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * QOI style lossless CODEC.
+ *
+ * A single pass run/diff/index coder in the spirit of the "Quite OK Image" format, adapted
+ * to the native RGB565 and GRAYSCALE pixels so that frames can be buffered losslessly in RAM.
+ * The stream starts with a 4 byte header ("QOI" + bytes per pixel) followed by the ops below.
+ * Pixels are coded in raster order with the previous pixel carried over between rows. Images
+ * that do not compress (e.g. noise) are stored raw instead, flagged in the bytes per pixel.
+ *
+ * RGB565 ops (channel differences wrap around their 5/6/5 bit ranges):
+ *   00iiiiii            - INDEX: pixel from the 64 entry hash of previously seen pixels.
+ *   01rrggbb            - DIFF:  dr, dg, db in [-2, 1].
+ *   10gggggg rrrrbbbb   - LUMA:  dg in [-32, 31], dr - dg / 2 and db - dg / 2 in [-8, 7].
+ *   11rrrrrr            - RUN:   1 to 62 repeats of the previous pixel.
+ *   11111110 hhhhhhhh llllllll - RAW pixel.
+ *
+ * GRAYSCALE ops:
+ *   00dddddd            - DIFF:  d in [-32, 30].
+ *   00111111 vvvvvvvv   - RAW pixel.
+ *   01rrrrrr            - RUN:   1 to 64 repeats of the previous pixel.
+ *   1aaabbbb            - PAIR:  two pixels, da in [-4, 3] and db in [-8, 7].
+ */
+#include "imlib.h"
+#include "py/runtime.h"
+
+#define QOI_HEADER_STORED       (0x80)
+
+#define QOI_OP_INDEX            (0x00)
+#define QOI_OP_DIFF             (0x40)
+#define QOI_OP_LUMA             (0x80)
+#define QOI_OP_RUN              (0xC0)
+#define QOI_OP_RAW              (0xFE)
+#define QOI_OP_MASK             (0xC0)
+#define QOI_RUN_MAX             (62)
+
+#define QOI_GS_OP_DIFF          (0x00)
+#define QOI_GS_OP_RAW           (0x3F)
+#define QOI_GS_OP_RUN           (0x40)
+#define QOI_GS_OP_PAIR          (0x80)
+#define QOI_GS_RUN_MAX          (64)
+
+#define QOI_RGB565_HASH(r, g, b)    ((((r) * 3) + ((g) * 5) + ((b) * 7)) & 63)
+
+// Each encoder returns the number of bytes written to out, or 0 if out_end was reached.
+static size_t qoi_encode_rgb565(image_t *src, uint8_t *out, uint8_t *out_end) {
+    uint16_t index[64] = {};
+    uint16_t *pixels = (uint16_t *) src->data;
+    size_t n = src->w * src->h;
+    uint8_t *p = out;
+    int prev = 0, run = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        int pixel = pixels[i];
+
+        // A flushed run plus a raw pixel is the most a pixel can write.
+        if ((out_end - p) < 4) {
+            return 0;
+        }
+
+        if (pixel == prev) {
+            if (++run == QOI_RUN_MAX) {
+                *p++ = QOI_OP_RUN | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+
+        if (run) {
+            *p++ = QOI_OP_RUN | (run - 1);
+            run = 0;
+        }
+
+        int r = COLOR_RGB565_TO_R5(pixel);
+        int g = COLOR_RGB565_TO_G6(pixel);
+        int b = COLOR_RGB565_TO_B5(pixel);
+        int hash = QOI_RGB565_HASH(r, g, b);
+
+        if (index[hash] == pixel) {
+            *p++ = QOI_OP_INDEX | hash;
+        } else {
+            index[hash] = pixel;
+
+            int dr = ((r - COLOR_RGB565_TO_R5(prev) + 16) & 31) - 16;
+            int dg = ((g - COLOR_RGB565_TO_G6(prev) + 32) & 63) - 32;
+            int db = ((b - COLOR_RGB565_TO_B5(prev) + 16) & 31) - 16;
+            int dr_dg = dr - (dg >> 1);
+            int db_dg = db - (dg >> 1);
+
+            if ((-2 <= dr) && (dr <= 1) && (-2 <= dg) && (dg <= 1) && (-2 <= db) && (db <= 1)) {
+                *p++ = QOI_OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2);
+            } else if ((-8 <= dr_dg) && (dr_dg <= 7) && (-8 <= db_dg) && (db_dg <= 7)) {
+                *p++ = QOI_OP_LUMA | (dg + 32);
+                *p++ = ((dr_dg + 8) << 4) | (db_dg + 8);
+            } else {
+                *p++ = QOI_OP_RAW;
+                *p++ = pixel >> 8;
+                *p++ = pixel;
+            }
+        }
+
+        prev = pixel;
+    }
+
+    if (run) {
+        if (p == out_end) {
+            return 0;
+        }
+        *p++ = QOI_OP_RUN | (run - 1);
+    }
+
+    return p - out;
+}
+
+static size_t qoi_encode_grayscale(image_t *src, uint8_t *out, uint8_t *out_end) {
+    uint8_t *pixels = src->data;
+    size_t n = src->w * src->h;
+    uint8_t *p = out;
+    int prev = 0, run = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        int pixel = pixels[i];
+
+        // A flushed run plus a raw pixel is the most a pixel can write.
+        if ((out_end - p) < 3) {
+            return 0;
+        }
+
+        if (pixel == prev) {
+            if (++run == QOI_GS_RUN_MAX) {
+                *p++ = QOI_GS_OP_RUN | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+
+        if (run) {
+            *p++ = QOI_GS_OP_RUN | (run - 1);
+            run = 0;
+        }
+
+        int da = pixel - prev;
+
+        // Try to pack the next pixel in with this one.
+        if ((-4 <= da) && (da <= 3) && ((i + 1) < n)) {
+            int db = pixels[i + 1] - pixel;
+            if ((-8 <= db) && (db <= 7)) {
+                *p++ = QOI_GS_OP_PAIR | ((da + 4) << 4) | (db + 8);
+                prev = pixels[++i];
+                continue;
+            }
+        }
+
+        if ((-32 <= da) && (da <= 30)) {
+            *p++ = QOI_GS_OP_DIFF | (da + 32);
+        } else {
+            *p++ = QOI_GS_OP_RAW;
+            *p++ = pixel;
+        }
+
+        prev = pixel;
+    }
+
+    if (run) {
+        if (p == out_end) {
+            return 0;
+        }
+        *p++ = QOI_GS_OP_RUN | (run - 1);
+    }
+
+    return p - out;
+}
+
+bool qoi_compress(image_t *src, image_t *dst) {
+    OMV_PROFILE_START();
+
+    if (src->is_compressed) {
+        return true;
+    }
+
+    if ((src->pixfmt != PIXFORMAT_GRAYSCALE) && (src->pixfmt != PIXFORMAT_RGB565)) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Input format is not supported"));
+    }
+
+    if (!dst->data) {
+        uint32_t size = 0;
+        dst->data = fb_alloc_all(&size, FB_ALLOC_PREFER_SIZE);
+        dst->size = IMLIB_IMAGE_MAX_SIZE(size);
+    }
+
+    if (dst->size <= QOI_HEADER_SIZE) {
+        return true; // overflow
+    }
+
+    dst->data[0] = 'Q';
+    dst->data[1] = 'O';
+    dst->data[2] = 'I';
+    dst->data[3] = src->bpp;
+
+    // Encoding stops once it would be larger than the raw image.
+    size_t raw_size = image_size(src);
+    uint8_t *out = dst->data + QOI_HEADER_SIZE;
+    uint8_t *out_end = out + IM_MIN(dst->size - QOI_HEADER_SIZE, raw_size);
+    size_t out_size = (src->pixfmt == PIXFORMAT_RGB565)
+                      ? qoi_encode_rgb565(src, out, out_end)
+                      : qoi_encode_grayscale(src, out, out_end);
+
+    if (!out_size) {
+        if ((dst->size - QOI_HEADER_SIZE) < raw_size) {
+            return true; // overflow
+        }
+
+        dst->data[3] |= QOI_HEADER_STORED;
+        memcpy(out, src->data, raw_size);
+        out_size = raw_size;
+    }
+
+    dst->size = QOI_HEADER_SIZE + out_size;
+
+    OMV_PROFILE_PRINT();
+    return false;
+}
+
+// Converts a decoded row to the destination pixel format.
+static void qoi_convert_row(image_t *dst, int y, uint8_t *row, int bpp) {
+    switch (dst->pixfmt) {
+        case PIXFORMAT_BINARY: {
+            uint32_t *dst_row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(dst, y);
+            for (int x = 0; x < dst->w; x++) {
+                int pixel = (bpp == 2) ? COLOR_RGB565_TO_GRAYSCALE(((uint16_t *) row)[x]) : row[x];
+                IMAGE_PUT_BINARY_PIXEL_FAST(dst_row, x, COLOR_GRAYSCALE_TO_BINARY(pixel));
+            }
+            break;
+        }
+        case PIXFORMAT_GRAYSCALE: {
+            uint8_t *dst_row = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(dst, y);
+            for (int x = 0; x < dst->w; x++) {
+                dst_row[x] = COLOR_RGB565_TO_GRAYSCALE(((uint16_t *) row)[x]);
+            }
+            break;
+        }
+        case PIXFORMAT_RGB565: {
+            uint16_t *dst_row = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(dst, y);
+            for (int x = 0; x < dst->w; x++) {
+                dst_row[x] = COLOR_GRAYSCALE_TO_RGB565(row[x]);
+            }
+            break;
+        }
+    }
+}
+
+void qoi_decompress(image_t *dst, image_t *src) {
+    OMV_PROFILE_START();
+
+    if ((src->size < QOI_HEADER_SIZE)
+        || (src->data[0] != 'Q') || (src->data[1] != 'O') || (src->data[2] != 'I')
+        || (((src->data[3] & ~QOI_HEADER_STORED) != PIXFORMAT_BPP_GRAY8)
+            && ((src->data[3] & ~QOI_HEADER_STORED) != PIXFORMAT_BPP_RGB565))) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Invalid QOI image"));
+    }
+
+    if ((dst->pixfmt != PIXFORMAT_BINARY)
+        && (dst->pixfmt != PIXFORMAT_GRAYSCALE)
+        && (dst->pixfmt != PIXFORMAT_RGB565)) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Output format is not supported"));
+    }
+
+    int bpp = src->data[3] & ~QOI_HEADER_STORED;
+    const uint8_t *p = src->data + QOI_HEADER_SIZE;
+    const uint8_t *end = src->data + src->size;
+    size_t row_size = dst->w * bpp;
+
+    // Rows are decoded in place when the destination matches the stream, else via a row buffer.
+    bool native = ((bpp == PIXFORMAT_BPP_RGB565) && (dst->pixfmt == PIXFORMAT_RGB565))
+                  || ((bpp == PIXFORMAT_BPP_GRAY8) && (dst->pixfmt == PIXFORMAT_GRAYSCALE));
+
+    if (src->data[3] & QOI_HEADER_STORED) {
+        if ((end - p) < (row_size * dst->h)) {
+            mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Invalid QOI image"));
+        }
+
+        for (int y = 0; y < dst->h; y++, p += row_size) {
+            if (native) {
+                memcpy(dst->data + (y * row_size), p, row_size);
+            } else {
+                qoi_convert_row(dst, y, (uint8_t *) p, bpp);
+            }
+        }
+
+        OMV_PROFILE_PRINT();
+        return;
+    }
+
+    uint8_t *row_buffer = native ? NULL : fb_alloc(row_size, FB_ALLOC_NO_HINT);
+
+    uint16_t index[64] = {};
+    int prev = 0, run = 0, pair = -1;
+
+    for (int y = 0; y < dst->h; y++) {
+        uint8_t *row = native ? (dst->data + (y * row_size)) : row_buffer;
+
+        for (int x = 0; x < dst->w; x++) {
+            if (run) {
+                run--;
+            } else if (pair >= 0) {
+                prev = pair;
+                pair = -1;
+            } else if (p >= end) {
+                // Truncated stream, repeat the last pixel.
+            } else if (bpp == PIXFORMAT_BPP_RGB565) {
+                int op = *p++;
+                if (op == QOI_OP_RAW) {
+                    if ((end - p) < 2) {
+                        // Truncated operand, repeat the last pixel.
+                        p = end;
+                    } else {
+                        prev = (p[0] << 8) | p[1];
+                        p += 2;
+                    }
+                } else if ((op & QOI_OP_MASK) == QOI_OP_RUN) {
+                    run = op & 0x3F;
+                } else if ((op & QOI_OP_MASK) == QOI_OP_INDEX) {
+                    prev = index[op];
+                } else {
+                    int r = COLOR_RGB565_TO_R5(prev);
+                    int g = COLOR_RGB565_TO_G6(prev);
+                    int b = COLOR_RGB565_TO_B5(prev);
+                    if ((op & QOI_OP_MASK) == QOI_OP_DIFF) {
+                        r += ((op >> 4) & 3) - 2;
+                        g += ((op >> 2) & 3) - 2;
+                        b += (op & 3) - 2;
+                    } else if (p < end) { // A truncated LUMA operand repeats the last pixel.
+                        int dg = (op & 0x3F) - 32;
+                        int dr_db = *p++;
+                        r += (dg >> 1) + (dr_db >> 4) - 8;
+                        g += dg;
+                        b += (dg >> 1) + (dr_db & 0xF) - 8;
+                    }
+                    prev = COLOR_R5_G6_B5_TO_RGB565(r & 31, g & 63, b & 31);
+                }
+
+                if ((op == QOI_OP_RAW) || ((op & QOI_OP_MASK) != QOI_OP_RUN)) {
+                    index[QOI_RGB565_HASH(COLOR_RGB565_TO_R5(prev),
+                                          COLOR_RGB565_TO_G6(prev),
+                                          COLOR_RGB565_TO_B5(prev))] = prev;
+                }
+            } else {
+                int op = *p++;
+                if (op == QOI_GS_OP_RAW) {
+                    // A truncated operand repeats the last pixel.
+                    prev = (p < end) ? *p++ : prev;
+                } else if (op & QOI_GS_OP_PAIR) {
+                    prev += (op >> 4) - 8 - 4; // op >> 4 includes the PAIR tag bit.
+                    pair = prev + (op & 0xF) - 8;
+                } else if (op & QOI_GS_OP_RUN) {
+                    run = op & 0x3F;
+                } else {
+                    prev += op - 32;
+                }
+                prev &= 0xFF;
+            }
+
+            if (bpp == PIXFORMAT_BPP_RGB565) {
+                ((uint16_t *) row)[x] = prev;
+            } else {
+                row[x] = prev;
+            }
+        }
+
+        if (!native) {
+            qoi_convert_row(dst, y, row, bpp);
+        }
+    }
+
+    if (row_buffer) {
+        fb_free();
+    }
+
+    OMV_PROFILE_PRINT();
+}
@@ -969,65 +969,19 @@ static void flood_fill_seed(struct quirc *q, int x, int y, int from, int to,
 
 static void threshold(struct quirc *q)
 {
-    int x, y;
-    int avg_w = 0;
-    int avg_u = 0;
-    int threshold_s = q->w / THRESHOLD_S_DEN;
-    int fracmul, fracmul2;
-    quirc_pixel_t *row = q->pixels;
-    int width = q->w;
-
-    /*
-     * Ensure a sane, non-zero value for threshold_s.
-     *
-     * threshold_s can be zero if the image width is small. We need to avoid
-     * SIGFPE as it will be used as divisor.
-     */
-    if (threshold_s < THRESHOLD_S_MIN)
-        threshold_s = THRESHOLD_S_MIN;
-
-    fracmul = (32768 * (threshold_s - 1)) / threshold_s; // to use multiply instead of divide (not too many bits or we'll overflow)
-    // to get the effect used below (a fraction of threshold_s-1/threshold_s
-    // The second constant is to reduce the averaged values to compare with the current pixel
-    fracmul2 = (0x100000 * (100 - THRESHOLD_T)) / (200 * threshold_s); // use as many bits as possible without overflowing
-
-    for (y = 0; y < q->h; y++) {
-        int row_average[q->w];
-
-        memset(row_average, 0, sizeof(row_average));
-
-        for (x = 0; x < width; x++) {
-            int w, u;
-
-            if (y & 1) {
-                w = x;
-                u = width - 1 - x;
-            } else {
-                w = width - 1 - x;
-                u = x;
-            }
-
-//            avg_w = (avg_w * (threshold_s - 1)) / threshold_s + row[w];
-//            avg_u = (avg_u * (threshold_s - 1)) / threshold_s + row[u];
-            // The original mul/div operation sought to reduce the average value by a small fraction (e.g. 1/79)
-            // This mul/shift approximation achieves the same goal with only a small percentage difference
-            avg_w = ((avg_w * fracmul) >> 15) + row[w];
-            avg_u = ((avg_u * fracmul) >> 15) + row[u];
-
-            row_average[w] += avg_w;
-            row_average[u] += avg_u;
-        }
+    image_t img;
+    img.w = q->w;
+    img.h = q->h;
+    img.pixfmt = PIXFORMAT_GRAYSCALE;
+    img.data = q->pixels;
 
-        for (x = 0; x < width; x++) {
-            //            if (row[x] < row_average[x] * (100 - THRESHOLD_T) / (200 * threshold_s))
-            if (row[x] < ((row_average[x] * fracmul2) >> 20))
-                row[x] = QUIRC_PIXEL_BLACK;
-            else
-                row[x] = QUIRC_PIXEL_WHITE;
-        }
+    /* Bradley thresholding over a square window 1/THRESHOLD_S_DEN of the
+     * image width wide, dark pixels become 0xFF. */
+    int ksize = IM_MIN(IM_MAX(q->w / (THRESHOLD_S_DEN * 2), THRESHOLD_S_MIN), 128);
+    imlib_adaptive_threshold(&img, &img, ADAPTIVE_THRESHOLD_BRADLEY, ksize, THRESHOLD_T, 0, true);
 
-        row += width;
-    }
+    for (int i = 0, ii = q->w * q->h; i < ii; i++)
+        q->pixels[i] &= QUIRC_PIXEL_BLACK;
 } /* threshold() */
 
 static void area_count(void *user_data, int y, int left, int right)
@@ -180,7 +180,7 @@ int rectangle_nms_get_bounding_boxes(list_t *bounding_boxes, float threshold, fl
         memcpy(&lnk_data, max_it->data, bounding_boxes->data_len);
         list_move_back(&nms_bounding_boxes, bounding_boxes, max_it);
 
-        float max_score = 0.0f;
+        float max_score = -FLT_MAX;
         for (list_lnk_t *it = bounding_boxes->head; it; ) {
             bounding_box_lnk_data_t *lnk_data2 = list_get_data(it);
 
@@ -191,7 +191,8 @@ int rectangle_nms_get_bounding_boxes(list_t *bounding_boxes, float threshold, fl
             float iou = rectangle_iou(&lnk_data.rect, &lnk_data2->rect);
             // Do not use fast_expf() as it does not output 1 when it's input is 0.
             // This will cause the scores of non-overlapping bounding boxes to decay.
-            lnk_data2->score *= expf(sigma_scale * iou * iou);
+            // The penalty is applied to the magnitude so that negative scores decrease too.
+            lnk_data2->score -= fabsf(lnk_data2->score) * (1.0f - expf(sigma_scale * iou * iou));
 
             if (lnk_data2->score < threshold) {
                 list_remove(bounding_boxes, old_it, NULL);
@@ -0,0 +1,597 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *
+ * Rectangle detection.
+ *
+ * The image is binarized on the fly against per tile thresholds (the midpoint of the
+ * min and max of the 3x3 surrounding tiles, dark pixels are foreground). Borders of the
+ * foreground are followed as in Suzuki-Abe with a visited bitmap and every closed border
+ * short enough to be a rectangle in the ROI is fitted with a quad: two opposite corners
+ * from farthest points, the other two from the farthest points to that diagonal. Each
+ * side must be straight, the corners are then refined by intersecting least squares lines
+ * fitted to the sides. Overlapping quads, like both borders of a thick frame, are reduced
+ * to the one with the largest edge magnitude.
+ *
+ * Memory usage is w*h/8 bytes for the visited bitmap, 3 bytes per 16x16 tile and 4 bytes
+ * per contour point for a contour of at most 4*(w+h) points. Formats other than binary,
+ * grayscale and RGB565 are first converted to a w*h grayscale copy.
+ */
+#include "imlib.h"
+
+#ifdef IMLIB_ENABLE_FIND_RECTS
+#define RECTS_TILE_SHIFT        (4)
+#define RECTS_TILE_SIZE         (1 << RECTS_TILE_SHIFT)
+#define RECTS_MIN_CONTRAST      (20)
+#define RECTS_MIN_SIDE          (8)
+
+typedef struct rects {
+    image_t *img;
+    int x_offset, y_offset; // Of the ROI in img.
+    int x_origin, y_origin; // Of the ROI in the source image.
+    int w, h;
+    int tiles_w, tiles_h;
+    uint8_t *thresholds; // Per tile, 0 if the whole ROI is low contrast.
+    uint32_t *visited;
+    point_t *contour;
+    int contour_max;
+} rects_t;
+
+// Neighbors in counter-clockwise order (y down).
+static const int8_t rects_dx[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+static const int8_t rects_dy[8] = { 0, -1, -1, -1, 0, 1, 1, 1 };
+
+static inline int rects_get_pixel(image_t *img, int x, int y) {
+    switch (img->pixfmt) {
+        case PIXFORMAT_BINARY:
+            return COLOR_BINARY_TO_GRAYSCALE(IMAGE_GET_BINARY_PIXEL(img, x, y));
+        case PIXFORMAT_GRAYSCALE:
+            return IMAGE_GET_GRAYSCALE_PIXEL(img, x, y);
+        default:
+            return COLOR_RGB565_TO_Y(IMAGE_GET_RGB565_PIXEL(img, x, y));
+    }
+}
+
+static inline bool rects_is_fg(rects_t *r, int x, int y) {
+    if ((((unsigned) x) >= r->w) || (((unsigned) y) >= r->h)) {
+        return false;
+    }
+
+    int t = r->thresholds[((y >> RECTS_TILE_SHIFT) * r->tiles_w) + (x >> RECTS_TILE_SHIFT)];
+    return rects_get_pixel(r->img, r->x_offset + x, r->y_offset + y) < t;
+}
+
+static inline bool rects_is_visited(rects_t *r, int x, int y) {
+    int i = (y * r->w) + x;
+    return (r->visited[i >> UINT32_T_SHIFT] >> (i & UINT32_T_MASK)) & 1;
+}
+
+static inline void rects_set_visited(rects_t *r, int x, int y) {
+    int i = (y * r->w) + x;
+    r->visited[i >> UINT32_T_SHIFT] |= 1U << (i & UINT32_T_MASK);
+}
+
+static void rects_compute_thresholds(rects_t *r) {
+    int n = r->tiles_w * r->tiles_h;
+    uint8_t *t_min = fb_alloc(n, FB_ALLOC_NO_HINT);
+    uint8_t *t_max = fb_alloc(n, FB_ALLOC_NO_HINT);
+    memset(t_min, 255, n);
+    memset(t_max, 0, n);
+
+    for (int y = 0; y < r->h; y++) {
+        uint8_t *row_min = t_min + ((y >> RECTS_TILE_SHIFT) * r->tiles_w);
+        uint8_t *row_max = t_max + ((y >> RECTS_TILE_SHIFT) * r->tiles_w);
+
+        for (int x = 0; x < r->w; x++) {
+            int pixel = rects_get_pixel(r->img, r->x_offset + x, r->y_offset + y);
+            int t = x >> RECTS_TILE_SHIFT;
+            row_min[t] = IM_MIN(row_min[t], pixel);
+            row_max[t] = IM_MAX(row_max[t], pixel);
+        }
+    }
+
+    for (int ty = 0; ty < r->tiles_h; ty++) {
+        for (int tx = 0; tx < r->tiles_w; tx++) {
+            int lo = 255, hi = 0;
+
+            for (int j = IM_MAX(ty - 1, 0), jj = IM_MIN(ty + 1, r->tiles_h - 1); j <= jj; j++) {
+                for (int i = IM_MAX(tx - 1, 0), ii = IM_MIN(tx + 1, r->tiles_w - 1); i <= ii; i++) {
+                    lo = IM_MIN(lo, t_min[(j * r->tiles_w) + i]);
+                    hi = IM_MAX(hi, t_max[(j * r->tiles_w) + i]);
+                }
+            }
+
+            r->thresholds[(ty * r->tiles_w) + tx] = ((hi - lo) < RECTS_MIN_CONTRAST) ? 0 : ((lo + hi + 1) / 2);
+        }
+    }
+
+    // Low contrast tiles take the threshold of a neighbor so that flat areas inside shapes
+    // are not split from their borders (a forward then a backward pass reaches every tile).
+    uint8_t *t = r->thresholds;
+
+    for (int i = 0; i < n; i++) {
+        if (!t[i]) {
+            if ((i % r->tiles_w) && t[i - 1]) {
+                t[i] = t[i - 1];
+            } else if ((i >= r->tiles_w) && t[i - r->tiles_w]) {
+                t[i] = t[i - r->tiles_w];
+            }
+        }
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+        if (!t[i]) {
+            if (((i + 1) % r->tiles_w) && t[i + 1]) {
+                t[i] = t[i + 1];
+            } else if (((i + r->tiles_w) < n) && t[i + r->tiles_w]) {
+                t[i] = t[i + r->tiles_w];
+            }
+        }
+    }
+
+    fb_free(); // t_max
+    fb_free(); // t_min
+}
+
+// Follows the border starting at (x, y) with the background neighbor in direction dir.
+// Returns the number of points stored, or -1 if the border touches the ROI edge or is
+// too long to be a rectangle (the whole border is still marked as visited).
+static int rects_trace(rects_t *r, int x, int y, int dir) {
+    int n = 0;
+    bool valid = true;
+
+    // Find the first foreground neighbor clockwise from the background one.
+    int first = -1;
+    for (int k = 0; k < 8; k++) {
+        int d = (dir - k) & 7;
+        if (rects_is_fg(r, x + rects_dx[d], y + rects_dy[d])) {
+            first = d;
+            break;
+        }
+    }
+
+    if (first < 0) {
+        rects_set_visited(r, x, y);
+        return -1;
+    }
+
+    int x1 = x + rects_dx[first], y1 = y + rects_dy[first];
+    int cx = x, cy = y, back = first;
+
+    for (;;) {
+        // Next foreground neighbor counter-clockwise from the previous point.
+        int d = back;
+        for (int k = 1; k <= 8; k++) {
+            d = (back + k) & 7;
+            if (rects_is_fg(r, cx + rects_dx[d], cy + rects_dy[d])) {
+                break;
+            }
+        }
+
+        rects_set_visited(r, cx, cy);
+
+        if ((!cx) || (!cy) || (cx == (r->w - 1)) || (cy == (r->h - 1)) || (n == r->contour_max)) {
+            valid = false;
+        }
+
+        if (valid) {
+            r->contour[n++] = (point_t) { .x = cx, .y = cy };
+        }
+
+        int nx = cx + rects_dx[d], ny = cy + rects_dy[d];
+
+        if ((nx == x) && (ny == y) && (cx == x1) && (cy == y1)) {
+            break;
+        }
+
+        back = (d + 4) & 7;
+        cx = nx;
+        cy = ny;
+    }
+
+    return valid ? n : -1;
+}
+
+static inline int rects_dist2(point_t *a, point_t *b) {
+    return ((a->x - b->x) * (a->x - b->x)) + ((a->y - b->y) * (a->y - b->y));
+}
+
+// Returns the index of the point between s and e (circular) farthest from the line
+// through c[a] and c[b], and its distance times |c[b] - c[a]| in dist.
+static int rects_farthest_from_line(point_t *c, int n, int s, int e, int a, int b, int *dist) {
+    int lx = c[b].x - c[a].x, ly = c[b].y - c[a].y;
+    int best = s;
+    *dist = -1;
+
+    for (int i = s; ; i = (i + 1) % n) {
+        int d = abs((lx * (c[i].y - c[a].y)) - (ly * (c[i].x - c[a].x)));
+
+        if (d > *dist) {
+            *dist = d;
+            best = i;
+        }
+
+        if (i == e) {
+            break;
+        }
+    }
+
+    return best;
+}
+
+// Fits a line to the contour between s and e (circular), skipping the points near the ends.
+static void rects_fit_line(point_t *c, int n, int s, int e, float *px, float *py, float *dx, float *dy) {
+    int m = ((e - s + n) % n) + 1;
+    int trim = m / 8;
+    float sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+
+    m -= trim * 2;
+    for (int k = 0, i = (s + trim) % n; k < m; k++, i = (i + 1) % n) {
+        sx += c[i].x;
+        sy += c[i].y;
+        sxx += c[i].x * c[i].x;
+        syy += c[i].y * c[i].y;
+        sxy += c[i].x * c[i].y;
+    }
+
+    *px = sx / m;
+    *py = sy / m;
+
+    float a = (sxx / m) - ((*px) * (*px));
+    float b = (sxy / m) - ((*px) * (*py));
+    float d = (syy / m) - ((*py) * (*py));
+    float l = ((a + d) / 2) + fast_sqrtf((((a - d) / 2) * ((a - d) / 2)) + (b * b));
+
+    // Eigenvector of the largest eigenvalue, picking the better conditioned form.
+    if (fabsf(l - d) > fabsf(l - a)) {
+        *dx = l - d;
+        *dy = b;
+    } else {
+        *dx = b;
+        *dy = l - a;
+    }
+
+    float len = fast_sqrtf(((*dx) * (*dx)) + ((*dy) * (*dy)));
+
+    if (len > 0) {
+        *dx /= len;
+        *dy /= len;
+    } else {
+        *dx = c[e].x - c[s].x;
+        *dy = c[e].y - c[s].y;
+    }
+}
+
+// Fits a quad to a closed contour, hole is true if the foreground is outside of the contour.
+// Returns false if the contour is not a quad.
+static bool rects_fit_quad(point_t *c, int n, bool hole, float corners[4][2]) {
+    int idx[4], dist;
+
+    // Two opposite corners.
+    int a = 0;
+    for (int k = 0; k < 2; k++) {
+        int best = -1, far = a;
+        for (int i = 0; i < n; i++) {
+            int d = rects_dist2(c + a, c + i);
+            if (d > best) {
+                best = d;
+                far = i;
+            }
+        }
+        idx[k * 2] = a = far;
+    }
+
+    if (idx[0] == idx[2]) {
+        return false;
+    }
+
+    if (rects_dist2(c + idx[0], c + idx[2]) < (2 * RECTS_MIN_SIDE * RECTS_MIN_SIDE)) {
+        return false;
+    }
+
+    // The two other corners are the farthest points from the diagonal on each side.
+    idx[1] = rects_farthest_from_line(c, n, idx[0], idx[2], idx[0], idx[2], &dist);
+    idx[3] = rects_farthest_from_line(c, n, idx[2], idx[0], idx[0], idx[2], &dist);
+
+    // Each side must be straight.
+    for (int k = 0; k < 4; k++) {
+        int s = idx[k], e = idx[(k + 1) & 3];
+        int len2 = rects_dist2(c + s, c + e);
+
+        if ((len2 < (RECTS_MIN_SIDE * RECTS_MIN_SIDE)) || (((e - s + n) % n) < 2)) {
+            return false;
+        }
+
+        rects_farthest_from_line(c, n, s, e, s, e, &dist);
+
+        // Allowed deviation is 1.5 + len / 16: dist / len <= 1.5 + (len / 16).
+        float len = fast_sqrtf(len2);
+        if (dist > (len * (1.5f + (len / 16)))) {
+            return false;
+        }
+    }
+
+    // Refine the corners by intersecting the lines fitted to the sides.
+    float px[4], py[4], dx[4], dy[4];
+    for (int k = 0; k < 4; k++) {
+        rects_fit_line(c, n, idx[k], idx[(k + 1) & 3], px + k, py + k, dx + k, dy + k);
+    }
+
+    // The contour runs on foreground pixels, move the sides half a pixel to the background.
+    float cx = (c[idx[0]].x + c[idx[1]].x + c[idx[2]].x + c[idx[3]].x) / 4.f;
+    float cy = (c[idx[0]].y + c[idx[1]].y + c[idx[2]].y + c[idx[3]].y) / 4.f;
+
+    for (int k = 0; k < 4; k++) {
+        float offset = ((((px[k] - cx) * -dy[k]) + ((py[k] - cy) * dx[k])) < 0) ? -0.5f : 0.5f;
+        offset = hole ? -offset : offset;
+        px[k] -= dy[k] * offset;
+        py[k] += dx[k] * offset;
+    }
+
+    for (int k = 0; k < 4; k++) {
+        int p = (k + 3) & 3; // The side ending at corner k.
+        float det = (dx[p] * dy[k]) - (dy[p] * dx[k]);
+        float x = c[idx[k]].x, y = c[idx[k]].y;
+
+        if (fabsf(det) > 0.1f) {
+            float t = (((px[k] - px[p]) * dy[k]) - ((py[k] - py[p]) * dx[k])) / det;
+            float ix = px[p] + (t * dx[p]), iy = py[p] + (t * dy[p]);
+
+            // Keep the contour corner if the sides do not meet close to it.
+            if ((((ix - x) * (ix - x)) + ((iy - y) * (iy - y))) <= (RECTS_MIN_SIDE * RECTS_MIN_SIDE)) {
+                x = ix;
+                y = iy;
+            }
+        }
+
+        corners[k][0] = x;
+        corners[k][1] = y;
+    }
+
+    // The quad must be convex.
+    float sign = 0;
+    for (int k = 0; k < 4; k++) {
+        float *p0 = corners[k], *p1 = corners[(k + 1) & 3], *p2 = corners[(k + 2) & 3];
+        float cross = ((p1[0] - p0[0]) * (p2[1] - p1[1])) - ((p1[1] - p0[1]) * (p2[0] - p1[0]));
+
+        if ((cross * sign) < 0) {
+            return false;
+        }
+
+        sign = cross;
+    }
+
+    return true;
+}
+
+// Returns true if segments p0-p1 and q0-q1 intersect or touch.
+static bool rects_segments_intersect(point_t *p0, point_t *p1, point_t *q0, point_t *q1) {
+    int d0 = ((p1->x - p0->x) * (q0->y - p0->y)) - ((p1->y - p0->y) * (q0->x - p0->x));
+    int d1 = ((p1->x - p0->x) * (q1->y - p0->y)) - ((p1->y - p0->y) * (q1->x - p0->x));
+    int d2 = ((q1->x - q0->x) * (p0->y - q0->y)) - ((q1->y - q0->y) * (p0->x - q0->x));
+    int d3 = ((q1->x - q0->x) * (p1->y - q0->y)) - ((q1->y - q0->y) * (p1->x - q0->x));
+
+    if ((((d0 > 0) && (d1 > 0)) || ((d0 < 0) && (d1 < 0))) ||
+        (((d2 > 0) && (d3 > 0)) || ((d2 < 0) && (d3 < 0)))) {
+        return false;
+    }
+
+    // Collinear segments must also overlap on both axes.
+    return (IM_MAX(IM_MIN(p0->x, p1->x), IM_MIN(q0->x, q1->x)) <= IM_MIN(IM_MAX(p0->x, p1->x), IM_MAX(q0->x, q1->x))) &&
+           (IM_MAX(IM_MIN(p0->y, p1->y), IM_MIN(q0->y, q1->y)) <= IM_MIN(IM_MAX(p0->y, p1->y), IM_MAX(q0->y, q1->y)));
+}
+
+// Returns true if p is inside the convex quad q (corners in clockwise order).
+static bool rects_quad_contains(point_t *q, point_t *p) {
+    for (int k = 0; k < 4; k++) {
+        point_t *q0 = q + k, *q1 = q + ((k + 1) & 3);
+        if ((((q1->x - q0->x) * (p->y - q0->y)) - ((q1->y - q0->y) * (p->x - q0->x))) < 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool rects_quads_overlap(point_t *q0, point_t *q1) {
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            if (rects_segments_intersect(q0 + i, q0 + ((i + 1) & 3), q1 + j, q1 + ((j + 1) & 3))) {
+                return true;
+            }
+        }
+    }
+
+    return rects_quad_contains(q0, q1) || rects_quad_contains(q1, q0);
+}
+
+// Overlapping quads, like the outer and inner borders of a thick frame, are the same
+// rectangle found more than once. Only the one with the largest magnitude is kept.
+static void rects_reconcile(list_t *out) {
+    for (list_lnk_t *i = out->head; i; ) {
+        find_rects_list_lnk_data_t *data0 = list_get_data(i);
+        list_lnk_t *next = i->next;
+
+        for (list_lnk_t *j = i->next; j; ) {
+            find_rects_list_lnk_data_t *data1 = list_get_data(j);
+            list_lnk_t *old_j = j;
+            j = j->next;
+
+            if (!rects_quads_overlap(data0->corners, data1->corners)) {
+                continue;
+            }
+
+            if (data1->magnitude > data0->magnitude) {
+                list_remove(out, i, NULL);
+                break;
+            }
+
+            if (old_j == next) {
+                next = j;
+            }
+
+            list_remove(out, old_j, NULL);
+        }
+
+        i = next;
+    }
+}
+
+static void rects_add(list_t *out, image_t *ptr, rects_t *r, float corners[4][2], uint32_t threshold,
+                      int *theta_buffer, uint32_t *mag_buffer, point_t *point_buffer) {
+    point_t p[4];
+
+    for (int k = 0; k < 4; k++) {
+        p[k].x = fast_floorf(corners[k][0] + 0.5f) + r->x_origin;
+        p[k].y = fast_floorf(corners[k][1] + 0.5f) + r->y_origin;
+    }
+
+    uint32_t magnitude = 0;
+
+    for (int k = 0; k < 4; k++) {
+        line_t line = { p[k].x, p[k].y, p[(k + 1) & 3].x, p[(k + 1) & 3].y };
+
+        if (!lb_clip_line(&line, 0, 0, ptr->w, ptr->h)) {
+            continue;
+        }
+
+        size_t index = trace_line(ptr, &line, theta_buffer, mag_buffer, point_buffer);
+
+        for (size_t i = 0; i < index; i++) {
+            magnitude += mag_buffer[i];
+        }
+    }
+
+    if (magnitude < threshold) {
+        return;
+    }
+
+    // Corners are returned clockwise starting from the top-left one.
+    int area = 0, first = 0;
+
+    for (int k = 0; k < 4; k++) {
+        area += (p[k].x * p[(k + 1) & 3].y) - (p[(k + 1) & 3].x * p[k].y);
+    }
+
+    if (area < 0) {
+        point_t tmp = p[1];
+        p[1] = p[3];
+        p[3] = tmp;
+    }
+
+    for (int k = 1; k < 4; k++) {
+        if ((p[k].x + p[k].y) < (p[first].x + p[first].y)) {
+            first = k;
+        }
+    }
+
+    find_rects_list_lnk_data_t lnk_data;
+    rectangle_init(&(lnk_data.rect), p[0].x, p[0].y, 0, 0);
+
+    for (int k = 0; k < 4; k++) {
+        rectangle_t temp;
+        rectangle_init(&temp, p[k].x, p[k].y, 0, 0);
+        rectangle_united(&(lnk_data.rect), &temp);
+        lnk_data.corners[k] = p[(first + k) & 3];
+    }
+
+    lnk_data.magnitude = magnitude;
+    list_push_back(out, &lnk_data);
+}
+
+void imlib_find_rects(list_t *out, image_t *ptr, rectangle_t *roi, uint32_t threshold) {
+    rects_t r;
+    image_t img;
+
+    r.img = ptr;
+    r.x_offset = r.x_origin = roi->x;
+    r.y_offset = r.y_origin = roi->y;
+    r.w = roi->w;
+    r.h = roi->h;
+
+    if ((ptr->pixfmt != PIXFORMAT_BINARY) && (ptr->pixfmt != PIXFORMAT_GRAYSCALE) && (ptr->pixfmt != PIXFORMAT_RGB565)) {
+        img.w = roi->w;
+        img.h = roi->h;
+        img.pixfmt = PIXFORMAT_GRAYSCALE;
+        img.data = fb_alloc(image_size(&img), FB_ALLOC_NO_HINT);
+        imlib_draw_image(&img, ptr, 0, 0, 1.f, 1.f, roi, -1, 256, NULL, NULL, 0, NULL, NULL, NULL);
+        r.img = &img;
+        r.x_offset = 0;
+        r.y_offset = 0;
+    }
+
+    r.tiles_w = (r.w + RECTS_TILE_SIZE - 1) >> RECTS_TILE_SHIFT;
+    r.tiles_h = (r.h + RECTS_TILE_SIZE - 1) >> RECTS_TILE_SHIFT;
+    r.thresholds = fb_alloc(r.tiles_w * r.tiles_h, FB_ALLOC_NO_HINT);
+    r.visited = fb_alloc0(((r.w * r.h) + UINT32_T_MASK) >> UINT32_T_SHIFT << 2, FB_ALLOC_NO_HINT);
+    r.contour_max = 4 * (r.w + r.h);
+    r.contour = fb_alloc(r.contour_max * sizeof(point_t), FB_ALLOC_NO_HINT);
+
+    const int r_diag_len = fast_roundf(fast_sqrtf((roi->w * roi->w) + (roi->h * roi->h))) * 2;
+    int *theta_buffer = fb_alloc(sizeof(int) * r_diag_len, FB_ALLOC_NO_HINT);
+    uint32_t *mag_buffer = fb_alloc(sizeof(uint32_t) * r_diag_len, FB_ALLOC_NO_HINT);
+    point_t *point_buffer = fb_alloc(sizeof(point_t) * r_diag_len, FB_ALLOC_NO_HINT);
+
+    rects_compute_thresholds(&r);
+    list_init(out, sizeof(find_rects_list_lnk_data_t));
+
+    for (int y = 0; y < r.h; y++) {
+        bool fg = rects_is_fg(&r, 0, y), fg_prev = false;
+
+        for (int x = 0; x < r.w; x++) {
+            bool fg_next = rects_is_fg(&r, x + 1, y);
+
+            if (fg && (!rects_is_visited(&r, x, y))) {
+                // Outer border if the left neighbor is background, else hole border if the
+                // right neighbor is background.
+                int dir = (!fg_prev) ? 4 : ((!fg_next) ? 0 : -1);
+
+                if (dir >= 0) {
+                    int n = rects_trace(&r, x, y, dir);
+                    float corners[4][2];
+
+                    if ((n >= (4 * RECTS_MIN_SIDE)) && rects_fit_quad(r.contour, n, dir == 0, corners)) {
+                        rects_add(out, ptr, &r, corners, threshold, theta_buffer, mag_buffer, point_buffer);
+                    }
+                }
+            }
+
+            fg_prev = fg;
+            fg = fg_next;
+        }
+    }
+
+    rects_reconcile(out);
+
+    fb_free(); // point_buffer
+    fb_free(); // mag_buffer
+    fb_free(); // theta_buffer
+    fb_free(); // contour
+    fb_free(); // visited
+    fb_free(); // thresholds
+
+    if (r.img != ptr) {
+        fb_free(); // img.data
+    }
+}
+#endif // IMLIB_ENABLE_FIND_RECTS
@@ -918,6 +918,68 @@ static inline v128_t vsub_s16(v128_t v0, v128_t v1) {
     #endif
 }
 
+static inline v128_t vqadd_u8(v128_t v0, v128_t v1) {
+    #if (__ARM_ARCH >= 8)
+    return (v128_t) vqaddq(v0.u8, v1.u8);
+    #elif (__ARM_ARCH >= 7)
+    return (v128_t) {
+        .u32 = { __UQADD8(v0.u32[0], v1.u32[0]) }
+    };
+    #else
+    v128_u8_t sum = v0.u8 + v1.u8;
+    return (v128_t) {
+        .u8 = sum | (v128_u8_t) (sum < v0.u8)
+    };
+    #endif
+}
+
+static inline v128_t vqsub_u8(v128_t v0, v128_t v1) {
+    #if (__ARM_ARCH >= 8)
+    return (v128_t) vqsubq(v0.u8, v1.u8);
+    #elif (__ARM_ARCH >= 7)
+    return (v128_t) {
+        .u32 = { __UQSUB8(v0.u32[0], v1.u32[0]) }
+    };
+    #else
+    return (v128_t) {
+        .u8 = (v0.u8 - v1.u8) & (v128_u8_t) (v0.u8 >= v1.u8)
+    };
+    #endif
+}
+
+// Compares v0 > v1 per 8-bit lane and returns the result as a bit mask with one bit per lane.
+static inline uint32_t vcmphi_u8_get_mask(v128_t v0, v128_t v1) {
+    #if (__ARM_ARCH >= 8)
+    return vcmphiq(v0.u8, v1.u8);
+    #elif (__ARM_ARCH >= 7)
+    // GE bits are set where v1 >= v0, so select 1 in the other lanes and gather the lanes.
+    __USUB8(v1.u32[0], v0.u32[0]);
+    return (__SEL(0, 0x01010101) * 0x01020408) >> 24;
+    #else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < UINT8_VECTOR_SIZE; i++) {
+        mask |= (v0.u8[i] > v1.u8[i]) << i;
+    }
+    return mask;
+    #endif
+}
+
+// Compares v0 >= v1 per 8-bit lane and returns (1 << n) in the lanes where it's true and 0 otherwise.
+static inline v128_t vcmpcs_u8_bit(v128_t v0, v128_t v1, uint32_t n) {
+    #if (__ARM_ARCH >= 8)
+    return (v128_t) vpselq(vdupq_n_u8(1 << n), vdupq_n_u8(0), vcmpcsq(v0.u8, v1.u8));
+    #elif (__ARM_ARCH >= 7)
+    __USUB8(v0.u32[0], v1.u32[0]);
+    return (v128_t) {
+        .u32 = { __SEL(0x01010101 << n, 0) }
+    };
+    #else
+    return (v128_t) {
+        .u8 = (v128_u8_t) (v0.u8 >= v1.u8) & (uint8_t) (1 << n)
+    };
+    #endif
+}
+
 #if (__ARM_ARCH >= 8)
 #define vsli_u8(v0, v1, n) ((v128_t) vsliq_n_u8(v0.u8, v1.u8, n))
 #else
@@ -1300,6 +1362,20 @@ static inline int32_t vmladava_s16(v128_t v0, v128_t v1, int32_t acc) {
     #endif
 }
 
+// Adds the sum of absolute differences of the 8-bit lanes to acc.
+static inline uint32_t vsada_u8(v128_t v0, v128_t v1, uint32_t acc) {
+    #if (__ARM_ARCH >= 8)
+    return vabavq(acc, v0.u8, v1.u8);
+    #elif (__ARM_ARCH >= 7)
+    return __USADA8(v0.u32[0], v1.u32[0], acc);
+    #else
+    for (uint32_t i = 0; i < UINT8_VECTOR_SIZE; i++) {
+        acc += (v0.u8[i] > v1.u8[i]) ? (v0.u8[i] - v1.u8[i]) : (v1.u8[i] - v0.u8[i]);
+    }
+    return acc;
+    #endif
+}
+
 static inline v128_t vldr_u8(const uint8_t *p) {
     #if (__ARM_ARCH >= 8)
     return (v128_t) vldrbq_u8(p);
@@ -0,0 +1,292 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * Adaptive thresholding.
+ *
+ * The box methods (mean, Bradley and Sauvola) keep per-column sums of a sliding window of
+ * rows and a running sum across each row, so the cost per pixel doesn't depend on the
+ * window size. The source rows inside the window are copied to a ring buffer as they are
+ * consumed which allows the output to be written in place over the source image.
+ */
+#include "imlib.h"
+
+#define SAUVOLA_R   (128.0f)    // Dynamic range of the standard deviation.
+
+// Converts a source row to 8-bit luma.
+static void adaptive_threshold_load_row(image_t *img, int y, uint8_t *row) {
+    switch (img->pixfmt) {
+        case PIXFORMAT_BINARY: {
+            uint32_t *row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(img, y);
+            for (int x = 0; x < img->w; x++) {
+                row[x] = COLOR_BINARY_TO_GRAYSCALE(IMAGE_GET_BINARY_PIXEL_FAST(row_ptr, x));
+            }
+            break;
+        }
+        case PIXFORMAT_GRAYSCALE: {
+            memcpy(row, IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y), img->w);
+            break;
+        }
+        case PIXFORMAT_RGB565: {
+            uint16_t *row_ptr = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
+            for (int x = 0; x < img->w; x++) {
+                row[x] = COLOR_RGB565_TO_Y(IMAGE_GET_RGB565_PIXEL_FAST(row_ptr, x));
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+static void adaptive_threshold_put_pixel(image_t *out, void *row_ptr, int x, bool fg) {
+    switch (out->pixfmt) {
+        case PIXFORMAT_BINARY: {
+            IMAGE_PUT_BINARY_PIXEL_FAST((uint32_t *) row_ptr, x, fg);
+            break;
+        }
+        case PIXFORMAT_GRAYSCALE: {
+            IMAGE_PUT_GRAYSCALE_PIXEL_FAST((uint8_t *) row_ptr, x,
+                                           fg ? COLOR_GRAYSCALE_BINARY_MAX : COLOR_GRAYSCALE_BINARY_MIN);
+            break;
+        }
+        case PIXFORMAT_RGB565: {
+            IMAGE_PUT_RGB565_PIXEL_FAST((uint16_t *) row_ptr, x,
+                                        fg ? COLOR_RGB565_BINARY_MAX : COLOR_RGB565_BINARY_MIN);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+// Adds a row to the column sums, two columns at a time when the DSP extension is available.
+static void adaptive_threshold_add_row(uint16_t *colsum, uint32_t *colsq, uint8_t *row, int w) {
+    int x = 0;
+
+    #if defined(ARM_MATH_DSP)
+    for (; x < (w - 1); x += 2) {
+        uint32_t pixels = *((uint16_t *) (row + x));
+        uint32_t *sum = (uint32_t *) (colsum + x);
+        *sum = __UADD16(*sum, __UXTB16(pixels | (pixels << 8)));
+    }
+    #endif
+
+    for (; x < w; x++) {
+        colsum[x] += row[x];
+    }
+
+    if (colsq) {
+        for (x = 0; x < w; x++) {
+            colsq[x] += row[x] * row[x];
+        }
+    }
+}
+
+static void adaptive_threshold_sub_row(uint16_t *colsum, uint32_t *colsq, uint8_t *row, int w) {
+    int x = 0;
+
+    #if defined(ARM_MATH_DSP)
+    for (; x < (w - 1); x += 2) {
+        uint32_t pixels = *((uint16_t *) (row + x));
+        uint32_t *sum = (uint32_t *) (colsum + x);
+        *sum = __USUB16(*sum, __UXTB16(pixels | (pixels << 8)));
+    }
+    #endif
+
+    for (; x < w; x++) {
+        colsum[x] -= row[x];
+    }
+
+    if (colsq) {
+        for (x = 0; x < w; x++) {
+            colsq[x] -= row[x] * row[x];
+        }
+    }
+}
+
+static void adaptive_threshold_box(image_t *out, image_t *img, adaptive_threshold_method_t method,
+                                   int ksize, int offset, float k, bool invert) {
+    int w = img->w, h = img->h;
+    int n = IM_MIN((ksize * 2) + 1, h);
+    bool sauvola = method == ADAPTIVE_THRESHOLD_SAUVOLA;
+
+    uint8_t *ring = fb_alloc(w * n, FB_ALLOC_NO_HINT);
+    uint16_t *colsum = fb_alloc0(w * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+    uint32_t *colsq = sauvola ? fb_alloc0(w * sizeof(uint32_t), FB_ALLOC_NO_HINT) : NULL;
+
+    // Prime the window with rows [0, ksize].
+    for (int y = 0, yy = IM_MIN(ksize + 1, h); y < yy; y++) {
+        uint8_t *row = ring + ((y % n) * w);
+        adaptive_threshold_load_row(img, y, row);
+        adaptive_threshold_add_row(colsum, colsq, row, w);
+    }
+
+    for (int y = 0; y < h; y++) {
+        if (y) {
+            int y_add = y + ksize, y_sub = y - ksize - 1;
+
+            // The row leaving the window shares its ring slot with the row entering it.
+            if (y_sub >= 0) {
+                adaptive_threshold_sub_row(colsum, colsq, ring + ((y_sub % n) * w), w);
+            }
+
+            if (y_add < h) {
+                uint8_t *row = ring + ((y_add % n) * w);
+                adaptive_threshold_load_row(img, y_add, row);
+                adaptive_threshold_add_row(colsum, colsq, row, w);
+            }
+        }
+
+        uint8_t *row = ring + ((y % n) * w);
+        void *out_row_ptr = out->data + (y * image_line_size(out));
+        int cnt_y = IM_MIN(y + ksize, h - 1) - IM_MAX(y - ksize, 0) + 1;
+        uint32_t acc = 0, acc_sq = 0;
+
+        for (int x = 0, xx = IM_MIN(ksize + 1, w); x < xx; x++) {
+            acc += colsum[x];
+            acc_sq += sauvola ? colsq[x] : 0;
+        }
+
+        for (int x = 0; x < w; x++) {
+            uint32_t area = (IM_MIN(x + ksize, w - 1) - IM_MAX(x - ksize, 0) + 1) * cnt_y;
+            int pixel = row[x];
+            bool fg;
+
+            switch (method) {
+                case ADAPTIVE_THRESHOLD_MEAN: {
+                    // pixel > (mean - offset)
+                    fg = ((pixel + offset) * (int32_t) area) > (int32_t) acc;
+                    break;
+                }
+                case ADAPTIVE_THRESHOLD_BRADLEY: {
+                    // pixel > (mean * (100 - offset) / 100), offset is in [0, 100] so this fits in 32-bits.
+                    fg = (pixel * 100 * (int32_t) area) > ((int32_t) acc * (100 - offset));
+                    break;
+                }
+                case ADAPTIVE_THRESHOLD_SAUVOLA: {
+                    // pixel > (mean * (1 + k * ((stdev / R) - 1)))
+                    float mean = acc / (float) area;
+                    float var = (acc_sq / (float) area) - (mean * mean);
+                    float stdev = (var > 0) ? fast_sqrtf(var) : 0;
+                    fg = pixel > (mean * (1 + (k * ((stdev / SAUVOLA_R) - 1))));
+                    break;
+                }
+                default: {
+                    fg = false;
+                    break;
+                }
+            }
+
+            adaptive_threshold_put_pixel(out, out_row_ptr, x, fg ^ invert);
+
+            if ((x + ksize + 1) < w) {
+                acc += colsum[x + ksize + 1];
+                acc_sq += sauvola ? colsq[x + ksize + 1] : 0;
+            }
+
+            if ((x - ksize) >= 0) {
+                acc -= colsum[x - ksize];
+                acc_sq -= sauvola ? colsq[x - ksize] : 0;
+            }
+        }
+    }
+
+    if (sauvola) {
+        fb_free(); // colsq
+    }
+
+    fb_free(); // colsum
+    fb_free(); // ring
+}
+
+// Tile min/max thresholding. Each pixel is compared against the midpoint of the min and max
+// of its tile and the 8 neighboring tiles. Pixels in tiles whose contrast is less than offset
+// are always background.
+static void adaptive_threshold_minmax(image_t *out, image_t *img, int ksize, int offset, bool invert) {
+    int w = img->w, h = img->h;
+    int tsize = (ksize * 2) + 1;
+    int tw = (w + tsize - 1) / tsize;
+    int th = (h + tsize - 1) / tsize;
+
+    uint8_t *row = fb_alloc(w, FB_ALLOC_NO_HINT);
+    uint8_t *tmin = fb_alloc(tw * th, FB_ALLOC_NO_HINT);
+    uint8_t *tmax = fb_alloc(tw * th, FB_ALLOC_NO_HINT);
+    int16_t *tthresh = fb_alloc(tw * th * sizeof(int16_t), FB_ALLOC_NO_HINT);
+
+    memset(tmin, COLOR_GRAYSCALE_MAX, tw * th);
+    memset(tmax, COLOR_GRAYSCALE_MIN, tw * th);
+
+    for (int y = 0; y < h; y++) {
+        uint8_t *min_row = tmin + ((y / tsize) * tw);
+        uint8_t *max_row = tmax + ((y / tsize) * tw);
+        adaptive_threshold_load_row(img, y, row);
+
+        for (int x = 0; x < w; x++) {
+            int t = x / tsize;
+            min_row[t] = IM_MIN(min_row[t], row[x]);
+            max_row[t] = IM_MAX(max_row[t], row[x]);
+        }
+    }
+
+    for (int ty = 0; ty < th; ty++) {
+        for (int tx = 0; tx < tw; tx++) {
+            int t_min = COLOR_GRAYSCALE_MAX, t_max = COLOR_GRAYSCALE_MIN;
+
+            for (int j = IM_MAX(ty - 1, 0), jj = IM_MIN(ty + 1, th - 1); j <= jj; j++) {
+                for (int i = IM_MAX(tx - 1, 0), ii = IM_MIN(tx + 1, tw - 1); i <= ii; i++) {
+                    t_min = IM_MIN(t_min, tmin[(j * tw) + i]);
+                    t_max = IM_MAX(t_max, tmax[(j * tw) + i]);
+                }
+            }
+
+            tthresh[(ty * tw) + tx] = ((t_max - t_min) < offset) ? -1 : ((t_min + t_max) / 2);
+        }
+    }
+
+    for (int y = 0; y < h; y++) {
+        int16_t *thresh_row = tthresh + ((y / tsize) * tw);
+        void *out_row_ptr = out->data + (y * image_line_size(out));
+        adaptive_threshold_load_row(img, y, row);
+
+        for (int x = 0; x < w; x++) {
+            int thresh = thresh_row[x / tsize];
+            adaptive_threshold_put_pixel(out, out_row_ptr, x, (thresh >= 0) && ((row[x] > thresh) ^ invert));
+        }
+    }
+
+    fb_free(); // tthresh
+    fb_free(); // tmax
+    fb_free(); // tmin
+    fb_free(); // row
+}
+
+void imlib_adaptive_threshold(image_t *out, image_t *img, adaptive_threshold_method_t method,
+                              int ksize, int offset, float k, bool invert) {
+    if (method == ADAPTIVE_THRESHOLD_MINMAX) {
+        adaptive_threshold_minmax(out, img, ksize, offset, invert);
+    } else {
+        adaptive_threshold_box(out, img, method, ksize, offset, k, invert);
+    }
+}
@@ -139,7 +139,7 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(py_display_backlight_obj, 1, 2, py_di
 static mp_obj_t py_display_write(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     enum {
         ARG_image, ARG_x, ARG_y, ARG_x_scale, ARG_y_scale, ARG_roi,
-        ARG_channel, ARG_alpha, ARG_color_palette, ARG_alpha_palette, ARG_hint
+        ARG_channel, ARG_alpha, ARG_color_palette, ARG_alpha_palette, ARG_hint, ARG_dirty
     };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_image, MP_ARG_OBJ | MP_ARG_REQUIRED, {.u_rom_obj = MP_ROM_NONE} },
@@ -153,6 +153,7 @@ static mp_obj_t py_display_write(uint n_args, const mp_obj_t *pos_args, mp_map_t
         { MP_QSTR_color_palette, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
         { MP_QSTR_alpha_palette, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
         { MP_QSTR_hint, MP_ARG_INT | MP_ARG_KW_ONLY,  {.u_int = 0 } },
+        { MP_QSTR_dirty, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
     };
 
     // Parse args.
@@ -160,6 +161,19 @@ static mp_obj_t py_display_write(uint n_args, const mp_obj_t *pos_args, mp_map_t
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
     mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
+    // Partial updates are only supported by single buffered SPI displays, the other displays
+    // continuously scan out whole framebuffers.
+    if (args[ARG_dirty].u_obj != mp_const_none) {
+        #if defined(OMV_SPI_DISPLAY_CONTROLLER)
+        bool partial = (self->base.type == &py_spi_display_type) && (!self->triple_buffer);
+        #else
+        bool partial = false;
+        #endif
+        if (!partial) {
+            mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Dirty regions require a single buffered SPI display"));
+        }
+    }
+
     fb_alloc_mark();
     image_t *image = py_helper_arg_to_image(args[ARG_image].u_obj, ARG_IMAGE_ANY | ARG_IMAGE_ALLOC);
     rectangle_t roi = py_helper_arg_to_roi(args[ARG_roi].u_obj, image);
@@ -183,9 +197,19 @@ static mp_obj_t py_display_write(uint n_args, const mp_obj_t *pos_args, mp_map_t
     const uint16_t *color_palette = py_helper_arg_to_palette(args[ARG_color_palette].u_obj, PIXFORMAT_RGB565);
     const uint8_t *alpha_palette = py_helper_arg_to_palette(args[ARG_alpha_palette].u_obj, PIXFORMAT_GRAYSCALE);
 
+    // Only the dirty regions are sent.
+    self->dirty_rects = NULL;
+    self->dirty_count = 0;
+    if (args[ARG_dirty].u_obj != mp_const_none) {
+        self->dirty_count = py_helper_arg_to_dirty_rects(args[ARG_dirty].u_obj, self->width,
+                                                         self->height, &self->dirty_rects);
+    }
+
     py_display_p_t *display_p = (py_display_p_t *) MP_OBJ_TYPE_GET_SLOT(self->base.type, protocol);
     display_p->write(self, image, args[ARG_x].u_int, args[ARG_y].u_int, x_scale, y_scale, &roi,
                      args[ARG_channel].u_int, args[ARG_alpha].u_int, color_palette, alpha_palette, args[ARG_hint].u_int);
+    self->dirty_rects = NULL;
+    self->dirty_count = 0;
     fb_alloc_free_till_mark();
 
     return mp_const_none;
@@ -73,6 +73,9 @@ typedef struct _py_display_obj_t {
     bool spi_tx_running;
     uint32_t spi_baudrate;
     #endif
+    // Display regions to refresh on the next write, or NULL for the whole display.
+    rectangle_t *dirty_rects;
+    size_t dirty_count;
     bool triple_buffer;
     uint32_t framebuffer_tail;
     volatile uint32_t framebuffer_head;
@@ -51,7 +51,7 @@ image_t *py_helper_arg_to_image(const mp_obj_t arg, uint32_t flags) {
         imlib_read_geometry(&fp, image, path, &rs);
         file_close(&fp);
         image->data = fb_alloc(image_size(image), FB_ALLOC_CACHE_ALIGN);
-        imlib_load_image(image, path);
+        imlib_load_image(image, path, NULL);
         #else
         mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("Image I/O is not supported"));
         #endif // IMLIB_ENABLE_IMAGE_FILE_IO
@@ -118,6 +118,43 @@ rectangle_t py_helper_arg_to_roi(const mp_obj_t arg, const image_t *img) {
     return roi;
 }
 
+size_t py_helper_arg_to_dirty_rects(const mp_obj_t arg, int w, int h, rectangle_t **rects) {
+    mp_obj_t single = arg;
+    mp_obj_t *items;
+    size_t len;
+    mp_obj_get_array(arg, &len, &items);
+
+    // Accept a single (x, y, w, h) tuple or a list of them.
+    if ((len == 4) && mp_obj_is_int(items[0])) {
+        items = &single;
+        len = 1;
+    }
+
+    *rects = fb_alloc((len ? len : 1) * sizeof(rectangle_t), FB_ALLOC_NO_HINT);
+
+    size_t count = 0;
+    rectangle_t bounds = {0, 0, w, h};
+    for (size_t i = 0; i < len; i++) {
+        mp_obj_t *arg_rect;
+        mp_obj_get_array_fixed_n(items[i], 4, &arg_rect);
+        rectangle_t rect;
+        rect.x = mp_obj_get_int(arg_rect[0]);
+        rect.y = mp_obj_get_int(arg_rect[1]);
+        rect.w = mp_obj_get_int(arg_rect[2]);
+        rect.h = mp_obj_get_int(arg_rect[3]);
+
+        PY_ASSERT_TRUE_MSG((rect.w >= 1) && (rect.h >= 1), "Invalid dirty rectangle dimensions!");
+
+        // Rectangles outside of the display have nothing to refresh.
+        if (rectangle_overlap(&rect, &bounds)) {
+            rectangle_intersected(&rect, &bounds);
+            (*rects)[count++] = rect;
+        }
+    }
+
+    return count;
+}
+
 void py_helper_arg_to_scale(const mp_obj_t arg_x_scale, const mp_obj_t arg_y_scale,
                             float *x_scale, float *y_scale) {
     if (arg_x_scale != mp_const_none) {
@@ -39,6 +39,7 @@ extern const mp_obj_fun_builtin_var_t py_func_unavailable_obj;
 image_t *py_helper_arg_to_image(const mp_obj_t arg, uint32_t flags);
 const void *py_helper_arg_to_palette(const mp_obj_t arg, uint32_t pixfmt);
 rectangle_t py_helper_arg_to_roi(const mp_obj_t arg, const image_t *img);
+size_t py_helper_arg_to_dirty_rects(const mp_obj_t arg, int w, int h, rectangle_t **rects);
 void py_helper_arg_to_scale(const mp_obj_t arg_x_scale, const mp_obj_t arg_y_scale,
                             float *x_scale, float *y_scale);
 void py_helper_arg_to_minmax(const mp_obj_t minmax, float *min, float *max,
@@ -157,7 +157,7 @@ py_kp_obj_t *py_kpts_obj(mp_obj_t kpts_obj) {
 
 typedef struct _py_lbp_obj_t {
     mp_obj_base_t base;
-    uint8_t *hist;
+    uint8_t hist[LBP_DESC_SIZE];
 } py_lbp_obj_t;
 
 static void py_lbp_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
@@ -424,7 +424,8 @@ static void py_image_print(const mp_print_t *print, mp_obj_t self, mp_print_kind
                   (image->pixfmt == PIXFORMAT_YUV422)     ? "yuv422" :
                   (image->pixfmt == PIXFORMAT_YVU422)     ? "yvu422" :
                   (image->pixfmt == PIXFORMAT_JPEG)       ? "jpeg" :
-                  (image->pixfmt == PIXFORMAT_PNG)        ? "png" : "unknown",
+                  (image->pixfmt == PIXFORMAT_PNG)        ? "png" :
+                  (image->pixfmt == PIXFORMAT_QOI)        ? "qoi" : "unknown",
                   image_size(image));
     }
 }
@@ -506,7 +507,8 @@ static mp_obj_t py_image_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value
                 }
             }
             case PIXFORMAT_JPEG:
-            case PIXFORMAT_PNG: {
+            case PIXFORMAT_PNG:
+            case PIXFORMAT_QOI: {
                 if (MP_OBJ_IS_TYPE(index, &mp_type_slice)) {
                     mp_bound_slice_t slice;
                     if (!mp_seq_get_fast_slice_indexes(image->size, index, &slice)) {
@@ -643,7 +645,8 @@ static mp_obj_t py_image_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value
                 return mp_const_none;
             }
             case PIXFORMAT_JPEG:
-            case PIXFORMAT_PNG: {
+            case PIXFORMAT_PNG:
+            case PIXFORMAT_QOI: {
                 if (MP_OBJ_IS_TYPE(index, &mp_type_slice)) {
                     mp_bound_slice_t slice;
                     if (!mp_seq_get_fast_slice_indexes(image->size, index, &slice)) {
@@ -723,6 +726,8 @@ static mp_obj_t py_image_format(mp_obj_t img_obj) {
             return mp_obj_new_int(PIXFORMAT_JPEG);
         case PIXFORMAT_PNG:
             return mp_obj_new_int(PIXFORMAT_PNG);
+        case PIXFORMAT_QOI:
+            return mp_obj_new_int(PIXFORMAT_QOI);
         default:
             return mp_obj_new_int(PIXFORMAT_INVALID);
     }
@@ -1129,7 +1134,8 @@ static mp_obj_t py_image_to(pixformat_t pixfmt, mp_rom_obj_t default_color_palet
 
             if (((dst_img.pixfmt == PIXFORMAT_JPEG) &&
                  jpeg_compress(&temp, &dst_img_tmp, args[ARG_quality].u_int, false, args[ARG_subsampling].u_int))
-                || ((dst_img.pixfmt == PIXFORMAT_PNG) && png_compress(&temp, &dst_img_tmp))) {
+                || ((dst_img.pixfmt == PIXFORMAT_PNG) && png_compress(&temp, &dst_img_tmp))
+                || ((dst_img.pixfmt == PIXFORMAT_QOI) && qoi_compress(&temp, &dst_img_tmp))) {
                 mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("Compression Failed!"));
             }
         } else if (args[ARG_encode_for_ide].u_bool) {
@@ -1232,6 +1238,37 @@ static mp_obj_t py_image_to_png(uint n_args, const mp_obj_t *args, mp_map_t *kw_
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_to_png_obj, 1, py_image_to_png);
 
+static mp_obj_t py_image_to_qoi(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
+    return py_image_to(PIXFORMAT_QOI, MP_ROM_NONE, false, n_args, args, kw_args);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_to_qoi_obj, 1, py_image_to_qoi);
+
+static mp_obj_t py_image_compress(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
+    pixformat_t pixfmt = PIXFORMAT_JPEG;
+
+    // Pick the codec from the format keyword and pass everything else on.
+    mp_map_t to_kw_args;
+    mp_map_init(&to_kw_args, kw_args->used);
+    for (size_t i = 0; i < kw_args->alloc; i++) {
+        if (!mp_map_slot_is_filled(kw_args, i)) {
+            continue;
+        }
+        if (kw_args->table[i].key == MP_OBJ_NEW_QSTR(MP_QSTR_format)) {
+            pixfmt = mp_obj_get_int(kw_args->table[i].value);
+        } else {
+            mp_map_lookup(&to_kw_args, kw_args->table[i].key,
+                          MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = kw_args->table[i].value;
+        }
+    }
+
+    if ((pixfmt != PIXFORMAT_JPEG) && (pixfmt != PIXFORMAT_PNG) && (pixfmt != PIXFORMAT_QOI)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Format must be JPEG, PNG or QOI"));
+    }
+
+    return py_image_to(pixfmt, MP_ROM_NONE, false, n_args, args, &to_kw_args);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_compress_obj, 1, py_image_compress);
+
 static mp_obj_t py_image_copy(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
     return py_image_to(PIXFORMAT_INVALID, MP_ROM_NONE, true, n_args, args, kw_args);
 }
@@ -1405,15 +1442,93 @@ static mp_obj_t py_image_draw_string(uint n_args, const mp_obj_t *args, mp_map_t
         py_helper_keyword_int(n_args, args, offset + 9, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_string_hmirror), false);
     int arg_string_vflip =
         py_helper_keyword_int(n_args, args, offset + 10, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_string_vflip), false);
+    bool arg_antialias =
+        py_helper_keyword_int(n_args, args, offset + 11, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_antialias), false);
 
     imlib_draw_string(arg_img, arg_x_off, arg_y_off, arg_str,
                       arg_c, arg_scale, arg_x_spacing, arg_y_spacing, arg_mono_space,
                       arg_char_rotation, arg_char_hmirror, arg_char_vflip,
-                      arg_string_rotation, arg_string_hmirror, arg_string_vflip);
+                      arg_string_rotation, arg_string_hmirror, arg_string_vflip, arg_antialias);
     return args[0];
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_draw_string_obj, 2, py_image_draw_string);
 
+static mp_obj_t py_image_draw_strings(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
+    image_t *arg_img = py_helper_arg_to_image(args[0], ARG_IMAGE_MUTABLE);
+
+    size_t len;
+    mp_obj_t *items;
+    mp_obj_get_array(args[1], &len, &items);
+
+    int arg_c =
+        py_helper_keyword_color(arg_img, n_args, args, 2, kw_args, -1); // White.
+    float arg_scale =
+        py_helper_keyword_float(n_args, args, 3, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_scale), 1.0);
+    PY_ASSERT_TRUE_MSG(0 < arg_scale, "Error: 0 < scale!");
+    int arg_x_spacing =
+        py_helper_keyword_int(n_args, args, 4, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_x_spacing), 0);
+    int arg_y_spacing =
+        py_helper_keyword_int(n_args, args, 5, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_y_spacing), 0);
+    bool arg_mono_space =
+        py_helper_keyword_int(n_args, args, 6, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_mono_space), true);
+    int arg_char_rotation =
+        py_helper_keyword_int(n_args, args, 7, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_char_rotation), 0);
+    int arg_char_hmirror =
+        py_helper_keyword_int(n_args, args, 8, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_char_hmirror), false);
+    int arg_char_vflip =
+        py_helper_keyword_int(n_args, args, 9, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_char_vflip), false);
+    int arg_string_rotation =
+        py_helper_keyword_int(n_args, args, 10, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_string_rotation), 0);
+    int arg_string_hmirror =
+        py_helper_keyword_int(n_args, args, 11, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_string_hmirror), false);
+    int arg_string_vflip =
+        py_helper_keyword_int(n_args, args, 12, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_string_vflip), false);
+    bool arg_antialias =
+        py_helper_keyword_int(n_args, args, 13, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_antialias), false);
+
+    // Check all items first, nothing may raise once the glyph cache has marked fb_alloc.
+    for (size_t i = 0; i < len; i++) {
+        size_t item_len;
+        mp_obj_t *item;
+        mp_obj_get_array(items[i], &item_len, &item);
+
+        if ((item_len != 3) && (item_len != 4)) {
+            mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Expected (x, y, text) or (x, y, text, color)"));
+        }
+
+        mp_obj_get_int(item[0]);
+        mp_obj_get_int(item[1]);
+        mp_obj_str_get_str(item[2]);
+
+        if (item_len == 4) {
+            py_helper_keyword_color(arg_img, 1, &item[3], 0, NULL, arg_c);
+        }
+    }
+
+    // All strings share one glyph cache so each glyph is only rendered once.
+    glyph_cache_t cache;
+    imlib_glyph_cache_init(&cache, arg_scale, arg_char_rotation, arg_char_hmirror, arg_char_vflip,
+                           arg_string_rotation, arg_antialias);
+
+    for (size_t i = 0; i < len; i++) {
+        size_t item_len;
+        mp_obj_t *item;
+        mp_obj_get_array(items[i], &item_len, &item);
+
+        int x_off = mp_obj_get_int(item[0]);
+        int y_off = mp_obj_get_int(item[1]);
+        const char *str = mp_obj_str_get_str(item[2]);
+        int c = (item_len == 4) ? py_helper_keyword_color(arg_img, 1, &item[3], 0, NULL, arg_c) : arg_c;
+
+        imlib_draw_string_cached(arg_img, &cache, x_off, y_off, str, c, arg_x_spacing, arg_y_spacing,
+                                 arg_mono_space, arg_string_hmirror, arg_string_vflip);
+    }
+
+    imlib_glyph_cache_free(&cache);
+    return args[0];
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_draw_strings_obj, 2, py_image_draw_strings);
+
 static mp_obj_t py_image_draw_cross(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
     image_t *arg_img = py_helper_arg_to_image(args[0], ARG_IMAGE_MUTABLE);
 
@@ -1567,6 +1682,158 @@ static mp_obj_t py_image_draw_keypoints(uint n_args, const mp_obj_t *args, mp_ma
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_draw_keypoints_obj, 2, py_image_draw_keypoints);
 
+// Returns the array of a draw_batch() item, which has n values plus an optional color.
+static mp_obj_t *py_image_draw_batch_item(image_t *img, mp_obj_t obj, size_t n, int *c) {
+    size_t len;
+    mp_obj_t *item;
+    mp_obj_get_array(obj, &len, &item);
+
+    if ((len != n) && (len != (n + 1))) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Unexpected number of values!"));
+    }
+
+    if (len > n) {
+        *c = py_helper_keyword_color(img, 1, &item[n], 0, NULL, *c);
+    }
+
+    return item;
+}
+
+// Checks every draw_batch() item up front so nothing raises once the draw list is allocated.
+static void py_image_draw_batch_check(image_t *img, mp_obj_t *items, size_t len, size_t n) {
+    for (size_t i = 0; i < len; i++) {
+        int c = 0;
+        mp_obj_t *item = py_image_draw_batch_item(img, items[i], n, &c);
+        for (size_t j = 0; j < n; j++) {
+            mp_obj_get_int(item[j]);
+        }
+    }
+}
+
+static mp_obj_t py_image_draw_batch(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_rectangles, ARG_circles, ARG_lines, ARG_keypoints, ARG_color, ARG_thickness, ARG_fill, ARG_size };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_rectangles, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_circles, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_lines, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_keypoints, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_color, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_thickness, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 1} },
+        { MP_QSTR_fill, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false} },
+        { MP_QSTR_size, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 10} },
+    };
+
+    // Parse args.
+    image_t *image = py_helper_arg_to_image(pos_args[0], ARG_IMAGE_MUTABLE);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    int color = (args[ARG_color].u_obj == mp_const_none) ? -1 : // White.
+                py_helper_keyword_color(image, 1, &args[ARG_color].u_obj, 0, NULL, -1);
+    int thickness = args[ARG_thickness].u_int;
+    bool fill = args[ARG_fill].u_bool;
+    int size = args[ARG_size].u_int;
+
+    size_t rects_len = 0, circles_len = 0, lines_len = 0, kpts_len = 0;
+    mp_obj_t *rects = NULL, *circles = NULL, *lines = NULL, *kpts = NULL;
+    #ifdef IMLIB_ENABLE_FIND_KEYPOINTS
+    py_kp_obj_t *kpts_obj = NULL;
+    #endif
+
+    if (args[ARG_rectangles].u_obj != mp_const_none) {
+        mp_obj_get_array(args[ARG_rectangles].u_obj, &rects_len, &rects);
+    }
+
+    if (args[ARG_circles].u_obj != mp_const_none) {
+        mp_obj_get_array(args[ARG_circles].u_obj, &circles_len, &circles);
+    }
+
+    if (args[ARG_lines].u_obj != mp_const_none) {
+        mp_obj_get_array(args[ARG_lines].u_obj, &lines_len, &lines);
+    }
+
+    if (args[ARG_keypoints].u_obj != mp_const_none) {
+        if (MP_OBJ_IS_TYPE(args[ARG_keypoints].u_obj, &mp_type_tuple) ||
+            MP_OBJ_IS_TYPE(args[ARG_keypoints].u_obj, &mp_type_list)) {
+            mp_obj_get_array(args[ARG_keypoints].u_obj, &kpts_len, &kpts);
+        } else {
+            #ifdef IMLIB_ENABLE_FIND_KEYPOINTS
+            kpts_obj = py_kpts_obj(args[ARG_keypoints].u_obj);
+            kpts_len = array_length(kpts_obj->kpts);
+            #else
+            mp_raise_msg(&mp_type_TypeError, MP_ERROR_TEXT("Expected a list of tuples!"));
+            #endif
+        }
+    }
+
+    // Each keypoint is a circle and a line.
+    size_t count = rects_len + circles_len + lines_len + (kpts_len * 2);
+
+    if (count > UINT16_MAX) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Too many primitives!"));
+    }
+
+    py_image_draw_batch_check(image, rects, rects_len, 4);
+    py_image_draw_batch_check(image, circles, circles_len, 3);
+    py_image_draw_batch_check(image, lines, lines_len, 4);
+    py_image_draw_batch_check(image, kpts, kpts ? kpts_len : 0, 3);
+
+    fb_alloc_mark();
+    draw_list_t list;
+    imlib_draw_list_init(&list, count);
+
+    for (size_t i = 0; i < rects_len; i++) {
+        int c = color;
+        mp_obj_t *item = py_image_draw_batch_item(image, rects[i], 4, &c);
+        imlib_draw_list_add_rectangle(&list, mp_obj_get_int(item[0]), mp_obj_get_int(item[1]),
+                                      mp_obj_get_int(item[2]), mp_obj_get_int(item[3]), c, thickness, fill);
+    }
+
+    for (size_t i = 0; i < circles_len; i++) {
+        int c = color;
+        mp_obj_t *item = py_image_draw_batch_item(image, circles[i], 3, &c);
+        imlib_draw_list_add_circle(&list, mp_obj_get_int(item[0]), mp_obj_get_int(item[1]),
+                                   mp_obj_get_int(item[2]), c, thickness, fill);
+    }
+
+    for (size_t i = 0; i < lines_len; i++) {
+        int c = color;
+        mp_obj_t *item = py_image_draw_batch_item(image, lines[i], 4, &c);
+        imlib_draw_list_add_line(&list, mp_obj_get_int(item[0]), mp_obj_get_int(item[1]),
+                                 mp_obj_get_int(item[2]), mp_obj_get_int(item[3]), c, thickness);
+    }
+
+    for (size_t i = 0; i < kpts_len; i++) {
+        int c = color, cx = 0, cy = 0, angle = 0;
+        if (kpts) {
+            mp_obj_t *item = py_image_draw_batch_item(image, kpts[i], 3, &c);
+            cx = mp_obj_get_int(item[0]);
+            cy = mp_obj_get_int(item[1]);
+            angle = mp_obj_get_int(item[2]) % 360;
+        } else {
+            #ifdef IMLIB_ENABLE_FIND_KEYPOINTS
+            kp_t *kp = array_at(kpts_obj->kpts, i);
+            cx = kp->x;
+            cy = kp->y;
+            angle = kp->angle % 360;
+            #endif
+        }
+        if (angle < 0) {
+            angle += 360;
+        }
+        // Same layout as draw_keypoints().
+        int si = (int) (sin_table[angle] * size);
+        int co = (int) (cos_table[angle] * size);
+        imlib_draw_list_add_line(&list, cx, cy, cx + co, cy + si, c, thickness);
+        imlib_draw_list_add_circle(&list, cx, cy, (size - 2) / 2, c, thickness, fill);
+    }
+
+    imlib_draw_list_render(image, &list);
+    fb_alloc_free_till_mark();
+    return pos_args[0];
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_draw_batch_obj, 1, py_image_draw_batch);
+
 static mp_obj_t py_image_mask_rectangle(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
     image_t *arg_img = py_helper_arg_to_image(args[0], ARG_IMAGE_MUTABLE);
     int arg_rx;
@@ -1999,6 +2266,83 @@ static mp_obj_t py_image_binary(uint n_args, const mp_obj_t *pos_args, mp_map_t
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_binary_obj, 1, py_image_binary);
 
+static mp_obj_t py_image_adaptive_threshold(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_ksize, ARG_method, ARG_offset, ARG_k, ARG_invert, ARG_to_bitmap, ARG_copy };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_ksize, MP_ARG_INT | MP_ARG_REQUIRED, },
+        { MP_QSTR_method, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = ADAPTIVE_THRESHOLD_MEAN} },
+        { MP_QSTR_offset, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 0} },
+        { MP_QSTR_k, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_invert, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false} },
+        { MP_QSTR_to_bitmap, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false} },
+        { MP_QSTR_copy, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false} },
+    };
+
+    // Parse args.
+    image_t *image = py_helper_arg_to_image(pos_args[0], ARG_IMAGE_MUTABLE);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    int ksize = args[ARG_ksize].u_int;
+    float k = (args[ARG_k].u_obj == mp_const_none) ? 0.34f : mp_obj_get_float(args[ARG_k].u_obj);
+
+    if ((image->pixfmt != PIXFORMAT_BINARY) && (image->pixfmt != PIXFORMAT_GRAYSCALE) &&
+        (image->pixfmt != PIXFORMAT_RGB565)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("Unsupported pixformat"));
+    }
+
+    if ((ksize < 0) || (ksize > 128)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("0 <= ksize <= 128!"));
+    }
+
+    if ((args[ARG_method].u_int < ADAPTIVE_THRESHOLD_MEAN) || (args[ARG_method].u_int > ADAPTIVE_THRESHOLD_MINMAX)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid method!"));
+    }
+
+    // The offset is a pixel value for mean, a percentage for bradley and a contrast for minmax.
+    int offset = args[ARG_offset].u_int;
+    int offset_min = (args[ARG_method].u_int == ADAPTIVE_THRESHOLD_MEAN) ? -255 : 0;
+    int offset_max = (args[ARG_method].u_int == ADAPTIVE_THRESHOLD_BRADLEY) ? 100 : 255;
+
+    if ((offset < offset_min) || (offset > offset_max)) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("%d <= offset <= %d!"), offset_min, offset_max);
+    }
+
+    if (args[ARG_to_bitmap].u_int && (!args[ARG_copy].u_int)) {
+        switch (image->pixfmt) {
+            case PIXFORMAT_GRAYSCALE: {
+                PY_ASSERT_TRUE_MSG((image->w >= 4), "Can't convert to bitmap in place!");
+                break;
+            }
+            case PIXFORMAT_RGB565: {
+                PY_ASSERT_TRUE_MSG((image->w >= 2), "Can't convert to bitmap in place!");
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+
+    image_t out;
+    out.w = image->w;
+    out.h = image->h;
+    out.pixfmt = args[ARG_to_bitmap].u_int ? PIXFORMAT_BINARY : image->pixfmt;
+    out.data = args[ARG_copy].u_int ? xalloc(image_size(&out)) : image->pixels;
+
+    fb_alloc_mark();
+    imlib_adaptive_threshold(&out, image, args[ARG_method].u_int, ksize, offset, k, args[ARG_invert].u_int);
+    fb_alloc_free_till_mark();
+
+    if (args[ARG_to_bitmap].u_int && (!args[ARG_copy].u_int)) {
+        image->pixfmt = PIXFORMAT_BINARY;
+        py_helper_update_framebuffer(&out);
+    }
+
+    return py_image_from_struct(&out);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_adaptive_threshold_obj, 1, py_image_adaptive_threshold);
+
 static mp_obj_t py_image_invert(mp_obj_t img_obj) {
     imlib_invert(py_helper_arg_to_image(img_obj, ARG_IMAGE_MUTABLE));
     return img_obj;
@@ -5034,6 +5378,36 @@ static MP_DEFINE_CONST_OBJ_TYPE(
     locals_dict, &py_qrcode_locals_dict
     );
 
+static mp_obj_t py_qrcode_from_lnk_data(find_qrcodes_list_lnk_data_t *lnk_data) {
+    py_qrcode_obj_t *o = m_new_obj(py_qrcode_obj_t);
+    o->base.type = &py_qrcode_type;
+    o->corners = mp_obj_new_tuple(4, (mp_obj_t [])
+                                  {mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[0].x),
+                                                                   mp_obj_new_int(lnk_data->corners[0].y)}),
+                                   mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[1].x),
+                                                                   mp_obj_new_int(lnk_data->corners[1].y)}),
+                                   mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[2].x),
+                                                                   mp_obj_new_int(lnk_data->corners[2].y)}),
+                                   mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[3].x),
+                                                                   mp_obj_new_int(lnk_data->corners[3].y)})});
+    o->x = mp_obj_new_int(lnk_data->rect.x);
+    o->y = mp_obj_new_int(lnk_data->rect.y);
+    o->w = mp_obj_new_int(lnk_data->rect.w);
+    o->h = mp_obj_new_int(lnk_data->rect.h);
+    o->payload = mp_obj_new_str(lnk_data->payload, lnk_data->payload_len);
+    o->version = mp_obj_new_int(lnk_data->version);
+    o->ecc_level = mp_obj_new_int(lnk_data->ecc_level);
+    o->mask = mp_obj_new_int(lnk_data->mask);
+    o->data_type = mp_obj_new_int(lnk_data->data_type);
+    o->eci = mp_obj_new_int(lnk_data->eci);
+
+    return o;
+}
+
 static mp_obj_t py_image_find_qrcodes(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
     image_t *arg_img = py_image_cobj(args[0]);
 
@@ -5050,33 +5424,7 @@ static mp_obj_t py_image_find_qrcodes(uint n_args, const mp_obj_t *args, mp_map_
         find_qrcodes_list_lnk_data_t lnk_data;
         list_pop_front(&out, &lnk_data);
 
-        py_qrcode_obj_t *o = m_new_obj(py_qrcode_obj_t);
-        o->base.type = &py_qrcode_type;
-        o->corners = mp_obj_new_tuple(4, (mp_obj_t [])
-                                      {mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[0].x),
-                                                                       mp_obj_new_int(lnk_data.corners[0].y)}),
-                                       mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[1].x),
-                                                                       mp_obj_new_int(lnk_data.corners[1].y)}),
-                                       mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[2].x),
-                                                                       mp_obj_new_int(lnk_data.corners[2].y)}),
-                                       mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[3].x),
-                                                                       mp_obj_new_int(lnk_data.corners[3].y)})});
-        o->x = mp_obj_new_int(lnk_data.rect.x);
-        o->y = mp_obj_new_int(lnk_data.rect.y);
-        o->w = mp_obj_new_int(lnk_data.rect.w);
-        o->h = mp_obj_new_int(lnk_data.rect.h);
-        o->payload = mp_obj_new_str(lnk_data.payload, lnk_data.payload_len);
-        o->version = mp_obj_new_int(lnk_data.version);
-        o->ecc_level = mp_obj_new_int(lnk_data.ecc_level);
-        o->mask = mp_obj_new_int(lnk_data.mask);
-        o->data_type = mp_obj_new_int(lnk_data.data_type);
-        o->eci = mp_obj_new_int(lnk_data.eci);
-
-        objects_list->items[i] = o;
+        objects_list->items[i] = py_qrcode_from_lnk_data(&lnk_data);
         xfree(lnk_data.payload);
     }
 
@@ -5465,6 +5813,36 @@ static MP_DEFINE_CONST_OBJ_TYPE(
     locals_dict, &py_datamatrix_locals_dict
     );
 
+static mp_obj_t py_datamatrix_from_lnk_data(find_datamatrices_list_lnk_data_t *lnk_data) {
+    py_datamatrix_obj_t *o = m_new_obj(py_datamatrix_obj_t);
+    o->base.type = &py_datamatrix_type;
+    o->corners = mp_obj_new_tuple(4, (mp_obj_t [])
+                                  {mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[0].x),
+                                                                   mp_obj_new_int(lnk_data->corners[0].y)}),
+                                   mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[1].x),
+                                                                   mp_obj_new_int(lnk_data->corners[1].y)}),
+                                   mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[2].x),
+                                                                   mp_obj_new_int(lnk_data->corners[2].y)}),
+                                   mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[3].x),
+                                                                   mp_obj_new_int(lnk_data->corners[3].y)})});
+    o->x = mp_obj_new_int(lnk_data->rect.x);
+    o->y = mp_obj_new_int(lnk_data->rect.y);
+    o->w = mp_obj_new_int(lnk_data->rect.w);
+    o->h = mp_obj_new_int(lnk_data->rect.h);
+    o->payload = mp_obj_new_str(lnk_data->payload, lnk_data->payload_len);
+    o->rotation = mp_obj_new_float(IM_DEG2RAD(lnk_data->rotation));
+    o->rows = mp_obj_new_int(lnk_data->rows);
+    o->columns = mp_obj_new_int(lnk_data->columns);
+    o->capacity = mp_obj_new_int(lnk_data->capacity);
+    o->padding = mp_obj_new_int(lnk_data->padding);
+
+    return o;
+}
+
 static mp_obj_t py_image_find_datamatrices(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
     image_t *arg_img = py_image_cobj(args[0]);
 
@@ -5483,33 +5861,7 @@ static mp_obj_t py_image_find_datamatrices(uint n_args, const mp_obj_t *args, mp
         find_datamatrices_list_lnk_data_t lnk_data;
         list_pop_front(&out, &lnk_data);
 
-        py_datamatrix_obj_t *o = m_new_obj(py_datamatrix_obj_t);
-        o->base.type = &py_datamatrix_type;
-        o->corners = mp_obj_new_tuple(4, (mp_obj_t [])
-                                      {mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[0].x),
-                                                                       mp_obj_new_int(lnk_data.corners[0].y)}),
-                                       mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[1].x),
-                                                                       mp_obj_new_int(lnk_data.corners[1].y)}),
-                                       mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[2].x),
-                                                                       mp_obj_new_int(lnk_data.corners[2].y)}),
-                                       mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[3].x),
-                                                                       mp_obj_new_int(lnk_data.corners[3].y)})});
-        o->x = mp_obj_new_int(lnk_data.rect.x);
-        o->y = mp_obj_new_int(lnk_data.rect.y);
-        o->w = mp_obj_new_int(lnk_data.rect.w);
-        o->h = mp_obj_new_int(lnk_data.rect.h);
-        o->payload = mp_obj_new_str(lnk_data.payload, lnk_data.payload_len);
-        o->rotation = mp_obj_new_float(IM_DEG2RAD(lnk_data.rotation));
-        o->rows = mp_obj_new_int(lnk_data.rows);
-        o->columns = mp_obj_new_int(lnk_data.columns);
-        o->capacity = mp_obj_new_int(lnk_data.capacity);
-        o->padding = mp_obj_new_int(lnk_data.padding);
-
-        objects_list->items[i] = o;
+        objects_list->items[i] = py_datamatrix_from_lnk_data(&lnk_data);
         xfree(lnk_data.payload);
     }
 
@@ -5646,6 +5998,34 @@ static MP_DEFINE_CONST_OBJ_TYPE(
     locals_dict, &py_barcode_locals_dict
     );
 
+static mp_obj_t py_barcode_from_lnk_data(find_barcodes_list_lnk_data_t *lnk_data) {
+    py_barcode_obj_t *o = m_new_obj(py_barcode_obj_t);
+    o->base.type = &py_barcode_type;
+    o->corners = mp_obj_new_tuple(4, (mp_obj_t [])
+                                  {mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[0].x),
+                                                                   mp_obj_new_int(lnk_data->corners[0].y)}),
+                                   mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[1].x),
+                                                                   mp_obj_new_int(lnk_data->corners[1].y)}),
+                                   mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[2].x),
+                                                                   mp_obj_new_int(lnk_data->corners[2].y)}),
+                                   mp_obj_new_tuple(2,
+                                                    (mp_obj_t []) {mp_obj_new_int(lnk_data->corners[3].x),
+                                                                   mp_obj_new_int(lnk_data->corners[3].y)})});
+    o->x = mp_obj_new_int(lnk_data->rect.x);
+    o->y = mp_obj_new_int(lnk_data->rect.y);
+    o->w = mp_obj_new_int(lnk_data->rect.w);
+    o->h = mp_obj_new_int(lnk_data->rect.h);
+    o->payload = mp_obj_new_str(lnk_data->payload, lnk_data->payload_len);
+    o->type = mp_obj_new_int(lnk_data->type);
+    o->rotation = mp_obj_new_float(IM_DEG2RAD(lnk_data->rotation));
+    o->quality = mp_obj_new_int(lnk_data->quality);
+
+    return o;
+}
+
 static mp_obj_t py_image_find_barcodes(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
     image_t *arg_img = py_image_cobj(args[0]);
 
@@ -5662,31 +6042,7 @@ static mp_obj_t py_image_find_barcodes(uint n_args, const mp_obj_t *args, mp_map
         find_barcodes_list_lnk_data_t lnk_data;
         list_pop_front(&out, &lnk_data);
 
-        py_barcode_obj_t *o = m_new_obj(py_barcode_obj_t);
-        o->base.type = &py_barcode_type;
-        o->corners = mp_obj_new_tuple(4, (mp_obj_t [])
-                                      {mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[0].x),
-                                                                       mp_obj_new_int(lnk_data.corners[0].y)}),
-                                       mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[1].x),
-                                                                       mp_obj_new_int(lnk_data.corners[1].y)}),
-                                       mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[2].x),
-                                                                       mp_obj_new_int(lnk_data.corners[2].y)}),
-                                       mp_obj_new_tuple(2,
-                                                        (mp_obj_t []) {mp_obj_new_int(lnk_data.corners[3].x),
-                                                                       mp_obj_new_int(lnk_data.corners[3].y)})});
-        o->x = mp_obj_new_int(lnk_data.rect.x);
-        o->y = mp_obj_new_int(lnk_data.rect.y);
-        o->w = mp_obj_new_int(lnk_data.rect.w);
-        o->h = mp_obj_new_int(lnk_data.rect.h);
-        o->payload = mp_obj_new_str(lnk_data.payload, lnk_data.payload_len);
-        o->type = mp_obj_new_int(lnk_data.type);
-        o->rotation = mp_obj_new_float(IM_DEG2RAD(lnk_data.rotation));
-        o->quality = mp_obj_new_int(lnk_data.quality);
-
-        objects_list->items[i] = o;
+        objects_list->items[i] = py_barcode_from_lnk_data(&lnk_data);
         xfree(lnk_data.payload);
     }
 
@@ -5695,6 +6051,67 @@ static mp_obj_t py_image_find_barcodes(uint n_args, const mp_obj_t *args, mp_map
 static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_barcodes_obj, 1, py_image_find_barcodes);
 #endif // IMLIB_ENABLE_BARCODES
 
+#if defined(IMLIB_ENABLE_QRCODES) || defined(IMLIB_ENABLE_DATAMATRICES) || \
+    (defined(IMLIB_ENABLE_BARCODES) && (!defined(OMV_NO_GPL)))
+static mp_obj_t py_image_find_codes(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
+    image_t *arg_img = py_image_cobj(args[0]);
+
+    rectangle_t roi;
+    py_helper_keyword_rectangle_roi(arg_img, n_args, args, 1, kw_args, &roi);
+
+    int codes = py_helper_keyword_int(n_args, args, 2, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_codes),
+                                      CODE_QRCODE | CODE_DATAMATRIX | CODE_BARCODE);
+    int effort = py_helper_keyword_int(n_args, args, 3, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_effort), 200);
+
+    list_t qrcodes, datamatrices, barcodes;
+    list_init(&qrcodes, sizeof(find_qrcodes_list_lnk_data_t));
+    list_init(&datamatrices, sizeof(find_datamatrices_list_lnk_data_t));
+    list_init(&barcodes, sizeof(find_barcodes_list_lnk_data_t));
+
+    fb_alloc_mark();
+    imlib_find_codes((codes & CODE_QRCODE) ? &qrcodes : NULL,
+                     (codes & CODE_DATAMATRIX) ? &datamatrices : NULL,
+                     (codes & CODE_BARCODE) ? &barcodes : NULL,
+                     arg_img, &roi, effort);
+    fb_alloc_free_till_mark();
+
+    mp_obj_list_t *objects_list = mp_obj_new_list(list_size(&qrcodes) +
+                                                  list_size(&datamatrices) +
+                                                  list_size(&barcodes), NULL);
+    size_t i = 0;
+
+    #if defined(IMLIB_ENABLE_QRCODES)
+    while (list_size(&qrcodes)) {
+        find_qrcodes_list_lnk_data_t lnk_data;
+        list_pop_front(&qrcodes, &lnk_data);
+        objects_list->items[i++] = py_qrcode_from_lnk_data(&lnk_data);
+        xfree(lnk_data.payload);
+    }
+    #endif
+
+    #if defined(IMLIB_ENABLE_DATAMATRICES)
+    while (list_size(&datamatrices)) {
+        find_datamatrices_list_lnk_data_t lnk_data;
+        list_pop_front(&datamatrices, &lnk_data);
+        objects_list->items[i++] = py_datamatrix_from_lnk_data(&lnk_data);
+        xfree(lnk_data.payload);
+    }
+    #endif
+
+    #if defined(IMLIB_ENABLE_BARCODES) && (!defined(OMV_NO_GPL))
+    while (list_size(&barcodes)) {
+        find_barcodes_list_lnk_data_t lnk_data;
+        list_pop_front(&barcodes, &lnk_data);
+        objects_list->items[i++] = py_barcode_from_lnk_data(&lnk_data);
+        xfree(lnk_data.payload);
+    }
+    #endif
+
+    return objects_list;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_codes_obj, 1, py_image_find_codes);
+#endif // IMLIB_ENABLE_QRCODES || IMLIB_ENABLE_DATAMATRICES || IMLIB_ENABLE_BARCODES
+
 #ifdef IMLIB_ENABLE_FIND_DISPLACEMENT
 // Displacement Object //
 #define py_displacement_obj_size    5
@@ -5818,6 +6235,64 @@ static mp_obj_t py_image_find_displacement(uint n_args, const mp_obj_t *args, mp
 static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_displacement_obj, 2, py_image_find_displacement);
 #endif // IMLIB_ENABLE_FIND_DISPLACEMENT
 
+#ifdef IMLIB_ENABLE_FIND_MOTION_VECTORS
+static mp_obj_t py_image_find_motion_vectors(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_prev, ARG_roi, ARG_block_size, ARG_search_range };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_prev, MP_ARG_OBJ | MP_ARG_REQUIRED, },
+        { MP_QSTR_roi, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_block_size, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 16} },
+        { MP_QSTR_search_range, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 7} },
+    };
+
+    // Parse args.
+    image_t *image = py_helper_arg_to_image(pos_args[0], ARG_IMAGE_GRAYSCALE);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    image_t *prev = py_helper_arg_to_image(args[ARG_prev].u_obj, ARG_IMAGE_GRAYSCALE);
+    rectangle_t roi = py_helper_arg_to_roi(args[ARG_roi].u_obj, image);
+    int block_size = args[ARG_block_size].u_int;
+
+    PY_ASSERT_TRUE_MSG((prev->w == image->w) && (prev->h == image->h), "Images must be the same size!");
+
+    if ((block_size != 8) && (block_size != 16)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("block_size must be 8 or 16!"));
+    }
+
+    if ((args[ARG_search_range].u_int < 1) || (args[ARG_search_range].u_int > MOTION_MAX_RANGE)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("1 <= search_range <= 15!"));
+    }
+
+    int cols = roi.w / block_size;
+    int rows = roi.h / block_size;
+
+    fb_alloc_mark();
+    motion_vector_t *vectors = fb_alloc(IM_MAX(cols * rows, 1) * sizeof(motion_vector_t), FB_ALLOC_NO_HINT);
+    imlib_find_motion_vectors(image, prev, &roi, block_size, args[ARG_search_range].u_int, vectors);
+
+    // One list per row of (x, y, sad) tuples.
+    mp_obj_t field = mp_obj_new_list(0, NULL);
+
+    for (int y = 0; y < rows; y++) {
+        mp_obj_t row = mp_obj_new_list(0, NULL);
+        for (int x = 0; x < cols; x++) {
+            motion_vector_t *mv = &vectors[(y * cols) + x];
+            mp_obj_list_append(row, mp_obj_new_tuple(3, (mp_obj_t []) {
+                mp_obj_new_int(mv->x),
+                mp_obj_new_int(mv->y),
+                mp_obj_new_int(mv->sad)
+            }));
+        }
+        mp_obj_list_append(field, row);
+    }
+
+    fb_alloc_free_till_mark();
+    return field;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_motion_vectors_obj, 1, py_image_find_motion_vectors);
+#endif // IMLIB_ENABLE_FIND_MOTION_VECTORS
+
 #ifdef IMLIB_FIND_TEMPLATE
 static mp_obj_t py_image_find_template(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
     image_t *arg_img = py_helper_arg_to_image(args[0], ARG_IMAGE_GRAYSCALE);
@@ -5927,7 +6402,10 @@ static mp_obj_t py_image_find_lbp(uint n_args, const mp_obj_t *args, mp_map_t *k
 
     py_lbp_obj_t *lbp_obj = m_new_obj(py_lbp_obj_t);
     lbp_obj->base.type = &py_lbp_type;
-    lbp_obj->hist = imlib_lbp_desc(arg_img, &roi);
+
+    fb_alloc_mark();
+    imlib_lbp_desc(arg_img, &roi, lbp_obj->hist);
+    fb_alloc_free_till_mark();
     return lbp_obj;
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_lbp_obj, 2, py_image_find_lbp);
@@ -5972,6 +6450,109 @@ static mp_obj_t py_image_find_keypoints(uint n_args, const mp_obj_t *args, mp_ma
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_keypoints_obj, 1, py_image_find_keypoints);
+
+static mp_obj_t py_image_track_features(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_prev, ARG_points, ARG_window, ARG_levels, ARG_iterations, ARG_max_error, ARG_features,
+           ARG_threshold, ARG_cell_size };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_prev, MP_ARG_OBJ | MP_ARG_REQUIRED, },
+        { MP_QSTR_points, MP_ARG_OBJ | MP_ARG_REQUIRED, },
+        { MP_QSTR_window, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 9} },
+        { MP_QSTR_levels, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 3} },
+        { MP_QSTR_iterations, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 10} },
+        { MP_QSTR_max_error, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 16} },
+        { MP_QSTR_features, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 0} },
+        { MP_QSTR_threshold, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 20} },
+        { MP_QSTR_cell_size, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 32} },
+    };
+
+    // Parse args.
+    image_t *image = py_helper_arg_to_image(pos_args[0], ARG_IMAGE_GRAYSCALE);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    image_t *prev = py_helper_arg_to_image(args[ARG_prev].u_obj, ARG_IMAGE_GRAYSCALE);
+    int window = args[ARG_window].u_int;
+    int features = args[ARG_features].u_int;
+
+    PY_ASSERT_TRUE_MSG((prev->w == image->w) && (prev->h == image->h), "Images must be the same size!");
+
+    if ((window < 3) || (window > KLT_MAX_WINDOW) || (!(window & 1))) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("window must be odd and 3 <= window <= 15!"));
+    }
+
+    if ((args[ARG_levels].u_int < 1) || (args[ARG_levels].u_int > IMAGE_PYRAMID_MAX_LEVELS)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("1 <= levels <= 4!"));
+    }
+
+    if ((args[ARG_iterations].u_int < 1) || (features < 0) || (args[ARG_cell_size].u_int < 8)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid argument!"));
+    }
+
+    size_t n;
+    mp_obj_t *items;
+    mp_obj_get_array(args[ARG_points].u_obj, &n, &items);
+
+    fb_alloc_mark();
+    klt_point_t *points = fb_alloc(IM_MAX((int) n, features) * sizeof(klt_point_t), FB_ALLOC_NO_HINT);
+    uint16_t next_id = 0;
+
+    // Points are (x, y) for new points or (x, y, id, age) as returned from a previous call.
+    for (size_t i = 0; i < n; i++) {
+        size_t len;
+        mp_obj_t *point;
+        mp_obj_get_array(items[i], &len, &point);
+
+        if ((len != 2) && (len != 4)) {
+            mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Expected (x, y) or (x, y, id, age)!"));
+        }
+
+        points[i].x = fast_roundf(mp_obj_get_float(point[0]) * 256.0f);
+        points[i].y = fast_roundf(mp_obj_get_float(point[1]) * 256.0f);
+        points[i].id = (len == 4) ? mp_obj_get_int(point[2]) : 0;
+        points[i].age = (len == 4) ? mp_obj_get_int(point[3]) : 0;
+
+        if (len == 4) {
+            next_id = IM_MAX(next_id, points[i].id + 1);
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        mp_obj_t *point;
+        size_t len;
+        mp_obj_get_array(items[i], &len, &point);
+        if (len == 2) {
+            points[i].id = next_id++;
+        }
+    }
+
+    image_pyramid_t prev_pyramid, pyramid;
+    imlib_pyramid_build(&prev_pyramid, prev, args[ARG_levels].u_int);
+    imlib_pyramid_build(&pyramid, image, args[ARG_levels].u_int);
+
+    n = imlib_klt_track(&prev_pyramid, &pyramid, points, n, window,
+                        args[ARG_iterations].u_int, args[ARG_max_error].u_int);
+
+    if (features) {
+        n = imlib_klt_detect(image, points, n, features, args[ARG_threshold].u_int,
+                             args[ARG_cell_size].u_int, &next_id);
+    }
+
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+
+    for (size_t i = 0; i < n; i++) {
+        mp_obj_list_append(list, mp_obj_new_tuple(4, (mp_obj_t []) {
+            mp_obj_new_float(points[i].x / 256.0f),
+            mp_obj_new_float(points[i].y / 256.0f),
+            mp_obj_new_int(points[i].id),
+            mp_obj_new_int(points[i].age)
+        }));
+    }
+
+    fb_alloc_free_till_mark();
+    return list;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_track_features_obj, 1, py_image_track_features);
 #endif // IMLIB_ENABLE_FIND_KEYPOINTS
 
 #ifdef IMLIB_ENABLE_BINARY_OPS
@@ -6029,6 +6610,154 @@ static mp_obj_t py_image_find_hog(uint n_args, const mp_obj_t *args, mp_map_t *k
     return args[0];
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_hog_obj, 1, py_image_find_hog);
+
+static mp_obj_t py_image_get_hog(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_roi, ARG_cell_size };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_roi, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_cell_size, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 8} },
+    };
+
+    // Parse args.
+    image_t *image = py_helper_arg_to_image(pos_args[0], ARG_IMAGE_GRAYSCALE);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    rectangle_t roi = py_helper_arg_to_roi(args[ARG_roi].u_obj, image);
+    int cell_size = args[ARG_cell_size].u_int;
+
+    if ((cell_size < 4) || (cell_size > 32)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("4 <= cell_size <= 32!"));
+    }
+
+    int cells_w = roi.w / cell_size;
+    int cells_h = roi.h / cell_size;
+    PY_ASSERT_TRUE_MSG((cells_w >= 2) && (cells_h >= 2), "ROI must be at least 2x2 cells!");
+
+    vstr_t vstr;
+    vstr_init_len(&vstr, imlib_hog_descriptor_size(cells_w, cells_h));
+
+    fb_alloc_mark();
+    hog_t hog;
+    imlib_hog_compute(&hog, image, &roi, cell_size);
+    imlib_hog_get_descriptor(&hog, 0, 0, cells_w, cells_h, (uint8_t *) vstr.buf);
+    fb_alloc_free_till_mark();
+
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_get_hog_obj, 1, py_image_get_hog);
+
+static mp_obj_t py_image_find_hog_objects(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_weights, ARG_bias, ARG_window, ARG_cell_size, ARG_step, ARG_threshold, ARG_sigma, ARG_roi };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_weights, MP_ARG_OBJ | MP_ARG_REQUIRED, },
+        { MP_QSTR_bias, MP_ARG_OBJ, {.u_rom_obj = MP_ROM_INT(0)} },
+        { MP_QSTR_window, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_cell_size, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 8} },
+        { MP_QSTR_step, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 1} },
+        { MP_QSTR_threshold, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_INT(0)} },
+        { MP_QSTR_sigma, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_roi, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+    };
+
+    // Parse args.
+    image_t *image = py_helper_arg_to_image(pos_args[0], ARG_IMAGE_GRAYSCALE);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    rectangle_t roi = py_helper_arg_to_roi(args[ARG_roi].u_obj, image);
+    int cell_size = args[ARG_cell_size].u_int;
+    int window_w = 64, window_h = 128;
+
+    if (args[ARG_window].u_obj != mp_const_none) {
+        mp_obj_t *window;
+        mp_obj_get_array_fixed_n(args[ARG_window].u_obj, 2, &window);
+        window_w = mp_obj_get_int(window[0]);
+        window_h = mp_obj_get_int(window[1]);
+    }
+
+    if ((cell_size < 4) || (cell_size > 32)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("4 <= cell_size <= 32!"));
+    }
+
+    if ((window_w % cell_size) || (window_h % cell_size) || (window_w < (cell_size * 2)) || (window_h < (cell_size * 2))) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("window must be a multiple of cell_size and at least 2x2 cells!"));
+    }
+
+    if (args[ARG_step].u_int < 1) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("step must be > 0!"));
+    }
+
+    int cells_w = window_w / cell_size;
+    int cells_h = window_h / cell_size;
+    int size = imlib_hog_descriptor_size(cells_w, cells_h);
+
+    // Weights are a list of floats or an array('f').
+    mp_buffer_info_t bufinfo;
+    float *weights_f = NULL;
+    mp_obj_t *weights_o = NULL;
+    size_t weights_len;
+
+    if (mp_get_buffer(args[ARG_weights].u_obj, &bufinfo, MP_BUFFER_READ) && (bufinfo.typecode == 'f')) {
+        weights_f = bufinfo.buf;
+        weights_len = bufinfo.len / sizeof(float);
+    } else {
+        mp_obj_get_array(args[ARG_weights].u_obj, &weights_len, &weights_o);
+    }
+
+    if (((int) weights_len) != size) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("Expected %d weights!"), size);
+    }
+
+    // Weights are all converted here, so that no exception can be raised once fb_alloc is marked.
+    float max = 0.0f;
+
+    for (int i = 0; i < size; i++) {
+        float w = weights_f ? weights_f[i] : mp_obj_get_float(weights_o[i]);
+        max = IM_MAX(max, fast_fabsf(w));
+    }
+
+    float bias = mp_obj_get_float(args[ARG_bias].u_obj);
+    float threshold = mp_obj_get_float(args[ARG_threshold].u_obj);
+    // Soft non-max suppress overlapping windows, sigma=0 disables it.
+    float sigma = (args[ARG_sigma].u_obj != mp_const_none) ? mp_obj_get_float(args[ARG_sigma].u_obj) : 0.1f;
+
+    // Quantize the weights to 16-bits. Descriptor values are in Q8 (255 == 1.0).
+    float weight_scale = (max > 0.0f) ? (32767.0f / max) : 1.0f;
+
+    fb_alloc_mark();
+    int16_t *weights = fb_alloc(size * sizeof(int16_t), FB_ALLOC_NO_HINT);
+
+    for (int i = 0; i < size; i++) {
+        float w = weights_f ? weights_f[i] : mp_obj_get_float(weights_o[i]);
+        weights[i] = fast_roundf(w * weight_scale);
+    }
+
+    list_t out;
+    hog_t hog;
+    imlib_hog_compute(&hog, image, &roi, cell_size);
+    imlib_hog_detect(&out, &hog, cells_w, cells_h, args[ARG_step].u_int, weights,
+                     1.0f / (255.0f * weight_scale), bias, threshold);
+    fb_alloc_free_till_mark();
+
+    rectangle_nms_get_bounding_boxes(&out, threshold, sigma);
+
+    mp_obj_list_t *objects_list = mp_obj_new_list(list_size(&out), NULL);
+    for (size_t i = 0; list_size(&out); i++) {
+        bounding_box_lnk_data_t lnk_data;
+        list_pop_front(&out, &lnk_data);
+        objects_list->items[i] = mp_obj_new_tuple(5, (mp_obj_t []) {
+            mp_obj_new_int(lnk_data.rect.x),
+            mp_obj_new_int(lnk_data.rect.y),
+            mp_obj_new_int(lnk_data.rect.w),
+            mp_obj_new_int(lnk_data.rect.h),
+            mp_obj_new_float(lnk_data.score)
+        });
+    }
+
+    return objects_list;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_hog_objects_obj, 2, py_image_find_hog_objects);
 #endif // IMLIB_ENABLE_HOG
 
 #ifdef IMLIB_ENABLE_SELECTIVE_SEARCH
@@ -6090,13 +6819,14 @@ static MP_DEFINE_CONST_FUN_OBJ_KW(py_image_stereo_disparity_obj, 1, py_image_ste
 #endif // IMLIB_ENABLE_STEREO_DISPARITY
 
 mp_obj_t py_image_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
-    enum { ARG_arg, ARG_height, ARG_pixformat, ARG_buffer, ARG_copy_to_fb, ARG_shape, ARG_strides, ARG_scale};
+    enum { ARG_arg, ARG_height, ARG_pixformat, ARG_buffer, ARG_copy_to_fb, ARG_roi, ARG_shape, ARG_strides, ARG_scale};
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_arg,          MP_ARG_REQUIRED | MP_ARG_OBJ },
         { MP_QSTR_height,       MP_ARG_INT, {.u_int = -1} },
         { MP_QSTR_pixformat,    MP_ARG_INT, {.u_int = -1} },
         { MP_QSTR_buffer,       MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
         { MP_QSTR_copy_to_fb,   MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false} },
+        { MP_QSTR_roi,          MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
     };
 
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
@@ -6114,13 +6844,18 @@ mp_obj_t py_image_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw
         imlib_read_geometry(&fp, &image, path, &rs);
         file_close(&fp);
 
+        // Only the rows and columns inside of the roi are loaded.
+        rectangle_t roi = py_helper_arg_to_roi(args[ARG_roi].u_obj, &image);
+        image.w = roi.w;
+        image.h = roi.h;
+
         if (args[ARG_copy_to_fb].u_bool) {
             py_helper_set_to_framebuffer(&image);
         } else {
             image.data = xalloc(image_size(&image));
         }
 
-        imlib_load_image(&image, path);
+        imlib_load_image(&image, path, (args[ARG_roi].u_obj != mp_const_none) ? &roi : NULL);
         fb_alloc_free_till_mark();
         #else
         mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("Image I/O is not supported"));
@@ -6251,7 +6986,8 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
     #endif // OMV_GENX320_ENABLE == 1
     {MP_ROM_QSTR(MP_QSTR_to_jpeg),             MP_ROM_PTR(&py_image_to_jpeg_obj)},
     {MP_ROM_QSTR(MP_QSTR_to_png),              MP_ROM_PTR(&py_image_to_png_obj)},
-    {MP_ROM_QSTR(MP_QSTR_compress),            MP_ROM_PTR(&py_image_to_jpeg_obj)},
+    {MP_ROM_QSTR(MP_QSTR_to_qoi),              MP_ROM_PTR(&py_image_to_qoi_obj)},
+    {MP_ROM_QSTR(MP_QSTR_compress),            MP_ROM_PTR(&py_image_compress_obj)},
     {MP_ROM_QSTR(MP_QSTR_copy),                MP_ROM_PTR(&py_image_copy_obj)},
     {MP_ROM_QSTR(MP_QSTR_crop),                MP_ROM_PTR(&py_image_crop_obj)},
     {MP_ROM_QSTR(MP_QSTR_scale),               MP_ROM_PTR(&py_image_crop_obj)},
@@ -6268,6 +7004,7 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
     {MP_ROM_QSTR(MP_QSTR_draw_circle),         MP_ROM_PTR(&py_image_draw_circle_obj)},
     {MP_ROM_QSTR(MP_QSTR_draw_ellipse),        MP_ROM_PTR(&py_image_draw_ellipse_obj)},
     {MP_ROM_QSTR(MP_QSTR_draw_string),         MP_ROM_PTR(&py_image_draw_string_obj)},
+    {MP_ROM_QSTR(MP_QSTR_draw_strings),        MP_ROM_PTR(&py_image_draw_strings_obj)},
     {MP_ROM_QSTR(MP_QSTR_draw_cross),          MP_ROM_PTR(&py_image_draw_cross_obj)},
     {MP_ROM_QSTR(MP_QSTR_draw_arrow),          MP_ROM_PTR(&py_image_draw_arrow_obj)},
     {MP_ROM_QSTR(MP_QSTR_draw_edges),          MP_ROM_PTR(&py_image_draw_edges_obj)},
@@ -6278,6 +7015,7 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
     {MP_ROM_QSTR(MP_QSTR_flood_fill),          MP_ROM_PTR(&py_func_unavailable_obj)},
     #endif
     {MP_ROM_QSTR(MP_QSTR_draw_keypoints),      MP_ROM_PTR(&py_image_draw_keypoints_obj)},
+    {MP_ROM_QSTR(MP_QSTR_draw_batch),          MP_ROM_PTR(&py_image_draw_batch_obj)},
     {MP_ROM_QSTR(MP_QSTR_mask_rectangle),      MP_ROM_PTR(&py_image_mask_rectangle_obj)},
     {MP_ROM_QSTR(MP_QSTR_mask_circle),         MP_ROM_PTR(&py_image_mask_circle_obj)},
     {MP_ROM_QSTR(MP_QSTR_mask_ellipse),        MP_ROM_PTR(&py_image_mask_ellipse_obj)},
@@ -6296,6 +7034,7 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
     /* Binary Methods */
     #ifdef IMLIB_ENABLE_BINARY_OPS
     {MP_ROM_QSTR(MP_QSTR_binary),              MP_ROM_PTR(&py_image_binary_obj)},
+    {MP_ROM_QSTR(MP_QSTR_adaptive_threshold),  MP_ROM_PTR(&py_image_adaptive_threshold_obj)},
     {MP_ROM_QSTR(MP_QSTR_invert),              MP_ROM_PTR(&py_image_invert_obj)},
     {MP_ROM_QSTR(MP_QSTR_and),                 MP_ROM_PTR(&py_image_b_and_obj)},
     {MP_ROM_QSTR(MP_QSTR_b_and),               MP_ROM_PTR(&py_image_b_and_obj)},
@@ -6315,6 +7054,7 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
     {MP_ROM_QSTR(MP_QSTR_close),               MP_ROM_PTR(&py_image_close_obj)},
     #else
     {MP_ROM_QSTR(MP_QSTR_binary),              MP_ROM_PTR(&py_func_unavailable_obj)},
+    {MP_ROM_QSTR(MP_QSTR_adaptive_threshold),  MP_ROM_PTR(&py_func_unavailable_obj)},
     {MP_ROM_QSTR(MP_QSTR_invert),              MP_ROM_PTR(&py_func_unavailable_obj)},
     {MP_ROM_QSTR(MP_QSTR_and),                 MP_ROM_PTR(&py_func_unavailable_obj)},
     {MP_ROM_QSTR(MP_QSTR_b_and),               MP_ROM_PTR(&py_func_unavailable_obj)},
@@ -6487,11 +7227,22 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
     #else
     {MP_ROM_QSTR(MP_QSTR_find_barcodes),       MP_ROM_PTR(&py_func_unavailable_obj)},
     #endif
+    #if defined(IMLIB_ENABLE_QRCODES) || defined(IMLIB_ENABLE_DATAMATRICES) || \
+    (defined(IMLIB_ENABLE_BARCODES) && (!defined(OMV_NO_GPL)))
+    {MP_ROM_QSTR(MP_QSTR_find_codes),          MP_ROM_PTR(&py_image_find_codes_obj)},
+    #else
+    {MP_ROM_QSTR(MP_QSTR_find_codes),          MP_ROM_PTR(&py_func_unavailable_obj)},
+    #endif
     #ifdef IMLIB_ENABLE_FIND_DISPLACEMENT
     {MP_ROM_QSTR(MP_QSTR_find_displacement),   MP_ROM_PTR(&py_image_find_displacement_obj)},
     #else
     {MP_ROM_QSTR(MP_QSTR_find_displacement),   MP_ROM_PTR(&py_func_unavailable_obj)},
     #endif
+    #ifdef IMLIB_ENABLE_FIND_MOTION_VECTORS
+    {MP_ROM_QSTR(MP_QSTR_find_motion_vectors), MP_ROM_PTR(&py_image_find_motion_vectors_obj)},
+    #else
+    {MP_ROM_QSTR(MP_QSTR_find_motion_vectors), MP_ROM_PTR(&py_func_unavailable_obj)},
+    #endif
     #ifdef IMLIB_FIND_TEMPLATE
     {MP_ROM_QSTR(MP_QSTR_find_template),       MP_ROM_PTR(&py_image_find_template_obj)},
     #else
@@ -6510,8 +7261,10 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
     #endif
     #ifdef IMLIB_ENABLE_FIND_KEYPOINTS
     {MP_ROM_QSTR(MP_QSTR_find_keypoints),      MP_ROM_PTR(&py_image_find_keypoints_obj)},
+    {MP_ROM_QSTR(MP_QSTR_track_features),      MP_ROM_PTR(&py_image_track_features_obj)},
     #else
     {MP_ROM_QSTR(MP_QSTR_find_keypoints),      MP_ROM_PTR(&py_func_unavailable_obj)},
+    {MP_ROM_QSTR(MP_QSTR_track_features),      MP_ROM_PTR(&py_func_unavailable_obj)},
     #endif
     #ifdef IMLIB_ENABLE_BINARY_OPS
     {MP_ROM_QSTR(MP_QSTR_find_edges),          MP_ROM_PTR(&py_image_find_edges_obj)},
@@ -6520,8 +7273,12 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
     #endif
     #ifdef IMLIB_ENABLE_HOG
     {MP_ROM_QSTR(MP_QSTR_find_hog),            MP_ROM_PTR(&py_image_find_hog_obj)},
+    {MP_ROM_QSTR(MP_QSTR_get_hog),             MP_ROM_PTR(&py_image_get_hog_obj)},
+    {MP_ROM_QSTR(MP_QSTR_find_hog_objects),    MP_ROM_PTR(&py_image_find_hog_objects_obj)},
     #else
     {MP_ROM_QSTR(MP_QSTR_find_hog),            MP_ROM_PTR(&py_func_unavailable_obj)},
+    {MP_ROM_QSTR(MP_QSTR_get_hog),             MP_ROM_PTR(&py_func_unavailable_obj)},
+    {MP_ROM_QSTR(MP_QSTR_find_hog_objects),    MP_ROM_PTR(&py_func_unavailable_obj)},
     #endif
     #ifdef IMLIB_ENABLE_SELECTIVE_SEARCH
     {MP_ROM_QSTR(MP_QSTR_selective_search),    MP_ROM_PTR(&py_image_selective_search_obj)},
@@ -6845,7 +7602,7 @@ mp_obj_t py_image_load_descriptor(uint n_args, const mp_obj_t *args, mp_map_t *k
             py_lbp_obj_t *lbp = m_new_obj(py_lbp_obj_t);
             lbp->base.type = &py_lbp_type;
 
-            res = imlib_lbp_desc_load(&fp, &lbp->hist);
+            res = imlib_lbp_desc_load(&fp, lbp->hist);
             if (res == FR_OK) {
                 desc = lbp;
             }
@@ -6961,8 +7718,14 @@ static mp_obj_t py_image_match_descriptor(uint n_args, const mp_obj_t *args, mp_
         PY_ASSERT_TYPE(lbp1, &py_lbp_type);
         PY_ASSERT_TYPE(lbp2, &py_lbp_type);
 
+        int intersection = py_helper_keyword_int(n_args, args, 4, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_intersection), false);
+
         // Match descriptors
-        match_obj = mp_obj_new_int(imlib_lbp_desc_distance(lbp1->hist, lbp2->hist));
+        if (intersection) {
+            match_obj = mp_obj_new_int(imlib_lbp_desc_intersection(lbp1->hist, lbp2->hist));
+        } else {
+            match_obj = mp_obj_new_int(imlib_lbp_desc_distance(lbp1->hist, lbp2->hist));
+        }
     #endif //IMLIB_ENABLE_FIND_LBP
     #if defined(IMLIB_ENABLE_FIND_KEYPOINTS)
     } else if (desc1_type == &py_kp_type) {
@@ -7056,6 +7819,7 @@ static const mp_rom_map_elem_t globals_dict_table[] = {
     {MP_ROM_QSTR(MP_QSTR_YUV422),              MP_ROM_INT(PIXFORMAT_YUV422)},   /* 2BPP/YUV422*/
     {MP_ROM_QSTR(MP_QSTR_JPEG),                MP_ROM_INT(PIXFORMAT_JPEG)},     /* JPEG/COMPRESSED*/
     {MP_ROM_QSTR(MP_QSTR_PNG),                 MP_ROM_INT(PIXFORMAT_PNG)},      /* PNG/COMPRESSED*/
+    {MP_ROM_QSTR(MP_QSTR_QOI),                 MP_ROM_INT(PIXFORMAT_QOI)},      /* QOI/COMPRESSED*/
     {MP_ROM_QSTR(MP_QSTR_PALETTE_RAINBOW),     MP_ROM_INT(COLOR_PALETTE_RAINBOW)},
     {MP_ROM_QSTR(MP_QSTR_PALETTE_IRONBOW),     MP_ROM_INT(COLOR_PALETTE_IRONBOW)},
     #if (OMV_GENX320_ENABLE == 1)
@@ -7090,6 +7854,10 @@ static const mp_rom_map_elem_t globals_dict_table[] = {
     {MP_ROM_QSTR(MP_QSTR_EDGE_SIMPLE),         MP_ROM_INT(EDGE_SIMPLE)},
     {MP_ROM_QSTR(MP_QSTR_CORNER_FAST),         MP_ROM_INT(CORNER_FAST)},
     {MP_ROM_QSTR(MP_QSTR_CORNER_AGAST),        MP_ROM_INT(CORNER_AGAST)},
+    {MP_ROM_QSTR(MP_QSTR_ADAPTIVE_MEAN),       MP_ROM_INT(ADAPTIVE_THRESHOLD_MEAN)},
+    {MP_ROM_QSTR(MP_QSTR_ADAPTIVE_BRADLEY),    MP_ROM_INT(ADAPTIVE_THRESHOLD_BRADLEY)},
+    {MP_ROM_QSTR(MP_QSTR_ADAPTIVE_SAUVOLA),    MP_ROM_INT(ADAPTIVE_THRESHOLD_SAUVOLA)},
+    {MP_ROM_QSTR(MP_QSTR_ADAPTIVE_MINMAX),     MP_ROM_INT(ADAPTIVE_THRESHOLD_MINMAX)},
     #ifdef IMLIB_ENABLE_APRILTAGS
     #ifdef IMLIB_ENABLE_APRILTAGS_TAG16H5
     {MP_ROM_QSTR(MP_QSTR_TAG16H5),             MP_ROM_INT(TAG16H5)},
@@ -7110,6 +7878,9 @@ static const mp_rom_map_elem_t globals_dict_table[] = {
     {MP_ROM_QSTR(MP_QSTR_ARTOOLKIT),           MP_ROM_INT(ARTOOLKIT)},
     #endif
     #endif
+    {MP_ROM_QSTR(MP_QSTR_QRCODE),              MP_ROM_INT(CODE_QRCODE)},
+    {MP_ROM_QSTR(MP_QSTR_DATAMATRIX),          MP_ROM_INT(CODE_DATAMATRIX)},
+    {MP_ROM_QSTR(MP_QSTR_BARCODE),             MP_ROM_INT(CODE_BARCODE)},
     #ifdef IMLIB_ENABLE_BARCODES
     {MP_ROM_QSTR(MP_QSTR_EAN2),                MP_ROM_INT(BARCODE_EAN2)},
     {MP_ROM_QSTR(MP_QSTR_EAN5),                MP_ROM_INT(BARCODE_EAN5)},
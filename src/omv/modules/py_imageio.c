@@ -66,15 +66,35 @@
                                   / (IMAGE_ALIGNMENT))                                        \
                                  * (IMAGE_ALIGNMENT))
 
+#define RING_FRAME_T_SIZE_ALIGNED (((sizeof(image_io_ring_frame_t) + (IMAGE_ALIGNMENT) -1) \
+                                    / (IMAGE_ALIGNMENT))                                 \
+                                   * (IMAGE_ALIGNMENT))
+
+static size_t size_aligned(size_t size) {
+    return ((size + (IMAGE_ALIGNMENT) -1) / (IMAGE_ALIGNMENT)) * (IMAGE_ALIGNMENT);
+}
+
 static size_t image_size_aligned(image_t *image) {
-    return ((image_size(image) + (IMAGE_ALIGNMENT) -1) / (IMAGE_ALIGNMENT)) * (IMAGE_ALIGNMENT);
+    return size_aligned(image_size(image));
 }
 
 typedef enum image_io_stream_type {
     IMAGE_IO_FILE_STREAM,
     IMAGE_IO_MEMORY_STREAM,
+    IMAGE_IO_RING_STREAM,
 } image_io_stream_type_t;
 
+// Ring streams pack variable size frames back to back in the buffer. A frame never straddles the
+// end of the buffer, when one does not fit the writer restarts at the beginning of the buffer and
+// the end of the last frame before the jump is kept in wrap. Frames are dropped oldest first to
+// make room for new ones.
+typedef struct image_io_ring_frame {
+    uint32_t size;          // Frame size in bytes including this header and padding.
+    uint32_t ms;            // Time the frame was written.
+    uint32_t elapsed_ms;    // Time since the previous frame.
+    image_t image;
+} image_io_ring_frame_t;
+
 typedef struct py_imageio_obj {
     mp_obj_base_t base;
     image_io_stream_type_t type;
@@ -92,6 +112,20 @@ typedef struct py_imageio_obj {
         struct {
             uint32_t size;
             uint8_t *buffer;
+            // Ring stream state, the buffer is size bytes long.
+            uint32_t head;      // Offset of the oldest frame.
+            uint32_t tail;      // Offset past the newest frame.
+            uint32_t wrap;      // End of the frames before the writer wrapped around.
+            uint32_t used;      // Bytes used by frames.
+            uint32_t cursor;    // Offset of the frame at the read offset.
+            uint32_t seq;       // Sequence number of the oldest frame.
+            #if defined(IMLIB_ENABLE_IMAGE_FILE_IO)
+            FIL dump_fp;
+            bool dumping;
+            uint32_t dump_pos;  // Offset of the next frame to dump.
+            uint32_t dump_seq;  // Sequence number of the next frame to dump.
+            uint32_t dump_end;  // Sequence number past the last frame to dump.
+            #endif
         };
     };
 } py_imageio_obj_t;
@@ -110,7 +144,8 @@ static void py_imageio_print(const mp_print_t *print, mp_obj_t self, mp_print_ki
     py_imageio_obj_t *stream = MP_OBJ_TO_PTR(self);
     mp_printf(print, "{\"type\":%s, \"closed\":%s, \"count\":%u, \"offset\":%u, "
               "\"version\":%u, \"buffer_size\":%u, \"size\":%u}",
-              (stream->type == IMAGE_IO_FILE_STREAM) ? "\"file stream\"" : "\"memory stream\"",
+              (stream->type == IMAGE_IO_FILE_STREAM) ? "\"file stream\"" :
+              (stream->type == IMAGE_IO_RING_STREAM) ? "\"ring stream\"" : "\"memory stream\"",
               stream->closed ? "\"true\"" : "\"false\"",
               stream->count,
               stream->offset,
@@ -121,10 +156,9 @@ static void py_imageio_print(const mp_print_t *print, mp_obj_t self, mp_print_ki
               #endif
               (stream->type == IMAGE_IO_FILE_STREAM) ? 0 : stream->size,
               #if defined(IMLIB_ENABLE_IMAGE_FILE_IO)
-              (stream->type == IMAGE_IO_FILE_STREAM) ? f_size(&stream->fp) : (stream->count * stream->size));
-              #else
-              stream->count * stream->size);
+              (stream->type == IMAGE_IO_FILE_STREAM) ? f_size(&stream->fp) :
               #endif
+              (stream->type == IMAGE_IO_RING_STREAM) ? stream->used : (stream->count * stream->size));
 }
 
 static mp_obj_t py_imageio_get_type(mp_obj_t self) {
@@ -168,6 +202,10 @@ static mp_obj_t py_imageio_buffer_size(mp_obj_t self) {
     }
     #endif
 
+    if (stream->type == IMAGE_IO_RING_STREAM) {
+        return mp_obj_new_int(stream->size);
+    }
+
     return mp_obj_new_int(stream->size - IMAGE_T_SIZE_ALIGNED);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(py_imageio_buffer_size_obj, py_imageio_buffer_size);
@@ -181,10 +219,161 @@ static mp_obj_t py_imageio_size(mp_obj_t self) {
     }
     #endif
 
+    if (stream->type == IMAGE_IO_RING_STREAM) {
+        return mp_obj_new_int(stream->used);
+    }
+
     return mp_obj_new_int(stream->count * stream->size);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(py_imageio_size_obj, py_imageio_size);
 
+static image_io_ring_frame_t *int_py_imageio_ring_frame(py_imageio_obj_t *stream, uint32_t pos) {
+    return (image_io_ring_frame_t *) (stream->buffer + pos);
+}
+
+static uint32_t int_py_imageio_ring_next(py_imageio_obj_t *stream, uint32_t pos) {
+    pos += int_py_imageio_ring_frame(stream, pos)->size;
+    return (pos == stream->wrap) ? 0 : pos;
+}
+
+#if defined(IMLIB_ENABLE_IMAGE_FILE_IO)
+static void int_py_imageio_write_chunk(FIL *fp, int version, image_t *image, uint32_t elapsed_ms) {
+    file_write_long(fp, elapsed_ms);
+    file_write_long(fp, image->w);
+    file_write_long(fp, image->h);
+
+    char padding[ALIGN_SIZE] = {};
+
+    if (version < NEW_PIXFORMAT_VER) {
+        if (image->pixfmt == PIXFORMAT_BINARY) {
+            file_write_long(fp, OLD_BINARY_BPP);
+        } else if (image->pixfmt == PIXFORMAT_GRAYSCALE) {
+            file_write_long(fp, OLD_GRAYSCALE_BPP);
+        } else if (image->pixfmt == PIXFORMAT_RGB565) {
+            file_write_long(fp, OLD_RGB565_BPP);
+        } else if (image->pixfmt == PIXFORMAT_BAYER) {
+            file_write_long(fp, OLD_BAYER_BPP);
+        } else if (image->pixfmt == PIXFORMAT_JPEG) {
+            file_write_long(fp, image->size);
+        } else {
+            mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid image stream bpp"));
+        }
+    } else {
+        file_write_long(fp, image->pixfmt);
+        file_write_long(fp, image->size);
+        file_write(fp, padding, AFTER_SIZE_PADDING);
+    }
+
+    uint32_t size = image_size(image);
+    file_write(fp, image->data, size);
+
+    if (size % ALIGN_SIZE) {
+        file_write(fp, padding, ALIGN_SIZE - (size % ALIGN_SIZE));
+    }
+}
+
+// Writes the next pending frame of a ring stream dump to the dump file.
+static void int_py_imageio_dump_frame(py_imageio_obj_t *stream) {
+    image_io_ring_frame_t *frame = (image_io_ring_frame_t *) (stream->buffer + stream->dump_pos);
+    image_t image = frame->image;
+    image.data = ((uint8_t *) frame) + RING_FRAME_T_SIZE_ALIGNED;
+
+    // The first frame of a dump has nothing to wait for on playback.
+    uint32_t elapsed_ms = (f_tell(&stream->dump_fp) == MAGIC_SIZE) ? 0 : frame->elapsed_ms;
+    int_py_imageio_write_chunk(&stream->dump_fp, NEW_PIXFORMAT_VER, &image, elapsed_ms);
+
+    stream->dump_pos = int_py_imageio_ring_next(stream, stream->dump_pos);
+    stream->dump_seq += 1;
+
+    if (stream->dump_seq == stream->dump_end) {
+        file_close(&stream->dump_fp);
+        stream->dumping = false;
+    }
+}
+#endif
+
+// Drops the oldest frame of a ring stream.
+static void int_py_imageio_ring_pop(py_imageio_obj_t *stream) {
+    #if defined(IMLIB_ENABLE_IMAGE_FILE_IO)
+    // Frames still waiting to be dumped are flushed before they are overwritten.
+    if (stream->dumping && (stream->dump_seq == stream->seq)) {
+        int_py_imageio_dump_frame(stream);
+    }
+    #endif
+
+    uint32_t next = int_py_imageio_ring_next(stream, stream->head);
+    stream->used -= int_py_imageio_ring_frame(stream, stream->head)->size;
+
+    // No frames are left past the wrap point once the head moves back to the start.
+    if (next < stream->head) {
+        stream->wrap = stream->size;
+    }
+
+    stream->head = next;
+    stream->count -= 1;
+    stream->seq += 1;
+
+    // Keep the read offset on the same frame.
+    if (stream->offset) {
+        stream->offset -= 1;
+    } else {
+        stream->cursor = stream->head;
+    }
+
+    if (!stream->count) {
+        stream->head = stream->tail = stream->cursor = 0;
+        stream->wrap = stream->size;
+    }
+}
+
+static void int_py_imageio_ring_write(py_imageio_obj_t *stream, image_t *image, uint32_t ms, uint32_t elapsed_ms) {
+    uint32_t size = image_size(image);
+    uint32_t frame_size = RING_FRAME_T_SIZE_ALIGNED + image_size_aligned(image);
+
+    if (stream->size < frame_size) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid frame size"));
+    }
+
+    uint32_t pos = stream->tail;
+
+    if ((pos + frame_size) > stream->size) {
+        // Drop the frames between the tail and the end of the buffer and wrap around.
+        while (stream->count && (stream->head >= pos)) {
+            int_py_imageio_ring_pop(stream);
+        }
+
+        if (stream->count) {
+            stream->wrap = pos;
+        }
+
+        pos = 0;
+    }
+
+    // Drop the oldest frames until the new frame fits.
+    while (stream->count && (stream->head >= pos) && (stream->head < (pos + frame_size))) {
+        int_py_imageio_ring_pop(stream);
+    }
+
+    if (!stream->count) {
+        stream->head = pos;
+    }
+
+    if (stream->offset == stream->count) {
+        stream->cursor = pos;
+    }
+
+    image_io_ring_frame_t *frame = int_py_imageio_ring_frame(stream, pos);
+    frame->size = frame_size;
+    frame->ms = ms;
+    frame->elapsed_ms = elapsed_ms;
+    frame->image = *image;
+    memcpy(((uint8_t *) frame) + RING_FRAME_T_SIZE_ALIGNED, image->data, size);
+
+    stream->tail = pos + frame_size;
+    stream->used += frame_size;
+    stream->count += 1;
+}
+
 static mp_obj_t py_imageio_write(mp_obj_t self, mp_obj_t img_obj) {
     py_imageio_obj_t *stream = py_imageio_obj(self);
     image_t *image = py_image_cobj(img_obj);
@@ -196,39 +385,7 @@ static mp_obj_t py_imageio_write(mp_obj_t self, mp_obj_t img_obj) {
     #if defined(IMLIB_ENABLE_IMAGE_FILE_IO)
     } else if (stream->type == IMAGE_IO_FILE_STREAM) {
         FIL *fp = &stream->fp;
-
-        file_write_long(fp, elapsed_ms);
-        file_write_long(fp, image->w);
-        file_write_long(fp, image->h);
-
-        char padding[ALIGN_SIZE] = {};
-
-        if (stream->version < NEW_PIXFORMAT_VER) {
-            if (image->pixfmt == PIXFORMAT_BINARY) {
-                file_write_long(fp, OLD_BINARY_BPP);
-            } else if (image->pixfmt == PIXFORMAT_GRAYSCALE) {
-                file_write_long(fp, OLD_GRAYSCALE_BPP);
-            } else if (image->pixfmt == PIXFORMAT_RGB565) {
-                file_write_long(fp, OLD_RGB565_BPP);
-            } else if (image->pixfmt == PIXFORMAT_BAYER) {
-                file_write_long(fp, OLD_BAYER_BPP);
-            } else if (image->pixfmt == PIXFORMAT_JPEG) {
-                file_write_long(fp, image->size);
-            } else {
-                mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid image stream bpp"));
-            }
-        } else {
-            file_write_long(fp, image->pixfmt);
-            file_write_long(fp, image->size);
-            file_write(fp, padding, AFTER_SIZE_PADDING);
-        }
-
-        uint32_t size = image_size(image);
-        file_write(fp, image->data, size);
-
-        if (size % ALIGN_SIZE) {
-            file_write(fp, padding, ALIGN_SIZE - (size % ALIGN_SIZE));
-        }
+        int_py_imageio_write_chunk(fp, stream->version, image, elapsed_ms);
 
         // Seeking to the middle of a file and writing data corrupts the remainder of the file. So,
         // truncate the rest of the file when this happens to prevent crashing because of this.
@@ -252,6 +409,18 @@ static mp_obj_t py_imageio_write(mp_obj_t self, mp_obj_t img_obj) {
         *((uint32_t *) (stream->buffer + (stream->offset * stream->size))) = elapsed_ms;
         memcpy(stream->buffer + (stream->offset * stream->size) + sizeof(uint32_t), image, sizeof(image_t));
         memcpy(stream->buffer + (stream->offset * stream->size) + IMAGE_T_SIZE_ALIGNED, image->data, size);
+    } else if (stream->type == IMAGE_IO_RING_STREAM) {
+        int_py_imageio_ring_write(stream, image, ms, elapsed_ms);
+
+        #if defined(IMLIB_ENABLE_IMAGE_FILE_IO)
+        // A pending dump advances by one frame per frame written so it never falls behind.
+        if (stream->dumping) {
+            int_py_imageio_dump_frame(stream);
+        }
+        #endif
+
+        // Writing appends to a ring stream and does not move the read offset.
+        return self;
     }
 
     stream->offset += 1;
@@ -270,6 +439,8 @@ static void int_py_imageio_pause(py_imageio_obj_t *stream, bool pause) {
     #endif
     } else if (stream->type == IMAGE_IO_MEMORY_STREAM) {
         elapsed_ms = *((uint32_t *) (stream->buffer + (stream->offset * stream->size)));
+    } else if (stream->type == IMAGE_IO_RING_STREAM) {
+        elapsed_ms = int_py_imageio_ring_frame(stream, stream->cursor)->elapsed_ms;
     }
 
     while (pause && ((mp_hal_ticks_ms() - stream->ms) < elapsed_ms)) {
@@ -367,6 +538,13 @@ static mp_obj_t py_imageio_read(uint n_args, const mp_obj_t *pos_args, mp_map_t
 
         int_py_imageio_pause(stream, args[ARG_pause].u_bool);
         memcpy(&image, stream->buffer + (stream->offset * stream->size) + sizeof(uint32_t), sizeof(image_t));
+    } else if (stream->type == IMAGE_IO_RING_STREAM) {
+        if (stream->offset == stream->count) {
+            mp_raise_msg(&mp_type_EOFError, MP_ERROR_TEXT("End of stream"));
+        }
+
+        int_py_imageio_pause(stream, args[ARG_pause].u_bool);
+        image = int_py_imageio_ring_frame(stream, stream->cursor)->image;
     }
 
     uint32_t size = image_size(&image);
@@ -408,6 +586,9 @@ static mp_obj_t py_imageio_read(uint n_args, const mp_obj_t *pos_args, mp_map_t
     #endif
     } else if (stream->type == IMAGE_IO_MEMORY_STREAM) {
         memcpy(image.data, stream->buffer + (stream->offset * stream->size) + IMAGE_T_SIZE_ALIGNED, size);
+    } else if (stream->type == IMAGE_IO_RING_STREAM) {
+        memcpy(image.data, stream->buffer + stream->cursor + RING_FRAME_T_SIZE_ALIGNED, size);
+        stream->cursor = int_py_imageio_ring_next(stream, stream->cursor);
     }
 
     stream->offset += 1;
@@ -425,7 +606,7 @@ static mp_obj_t py_imageio_seek(mp_obj_t self, mp_obj_t offs) {
     py_imageio_obj_t *stream = py_imageio_obj(self);
     int offset = mp_obj_get_int(offs);
 
-    if ((offset < 0) || ((stream->type == IMAGE_IO_MEMORY_STREAM) && (stream->count <= offset))) {
+    if ((offset < 0) || ((stream->type != IMAGE_IO_FILE_STREAM) && (stream->count <= offset))) {
         mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid stream offset"));
     }
 
@@ -452,6 +633,14 @@ static mp_obj_t py_imageio_seek(mp_obj_t self, mp_obj_t offs) {
     }
     #endif
 
+    if (stream->type == IMAGE_IO_RING_STREAM) {
+        stream->cursor = stream->head;
+
+        for (int i = 0; i < offset; i++) {
+            stream->cursor = int_py_imageio_ring_next(stream, stream->cursor);
+        }
+    }
+
     stream->offset = offset;
 
     return self;
@@ -464,6 +653,10 @@ static mp_obj_t py_imageio_sync(mp_obj_t self) {
 
     if (stream->type == IMAGE_IO_FILE_STREAM) {
         file_sync(&stream->fp);
+    } else if (stream->type == IMAGE_IO_RING_STREAM) {
+        while (stream->dumping) {
+            int_py_imageio_dump_frame(stream);
+        }
     }
     #endif
 
@@ -471,6 +664,78 @@ static mp_obj_t py_imageio_sync(mp_obj_t self) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(py_imageio_sync_obj, py_imageio_sync);
 
+#if defined(IMLIB_ENABLE_IMAGE_FILE_IO)
+static mp_obj_t py_imageio_dump(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_path, ARG_time, ARG_block };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_path, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_time, MP_ARG_INT, {.u_int = -1 } },
+        { MP_QSTR_block, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false } },
+    };
+
+    // Parse args.
+    py_imageio_obj_t *stream = py_imageio_obj(pos_args[0]);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    if (stream->type != IMAGE_IO_RING_STREAM) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("Expected a ring stream"));
+    }
+
+    // Finish the previous dump first.
+    py_imageio_sync(pos_args[0]);
+
+    // Skip frames older than the requested window. Only the frame headers are visited.
+    uint32_t pos = stream->head, seq = stream->seq, end = stream->seq + stream->count;
+
+    if (args[ARG_time].u_int >= 0) {
+        uint32_t ms = mp_hal_ticks_ms(), time_ms = args[ARG_time].u_int;
+
+        for (; seq != end; seq++) {
+            if ((ms - int_py_imageio_ring_frame(stream, pos)->ms) <= time_ms) {
+                break;
+            }
+
+            pos = int_py_imageio_ring_next(stream, pos);
+        }
+    }
+
+    FIL *fp = &stream->dump_fp;
+    const char string[] = "OMV IMG STR V2.0";
+    file_open(fp, mp_obj_str_get_str(args[ARG_path].u_obj), false, FA_WRITE | FA_CREATE_ALWAYS);
+    file_write(fp, string, sizeof(string) - 1); // exclude null terminator
+
+    if (seq == end) {
+        file_close(fp);
+        return mp_obj_new_int(0);
+    }
+
+    stream->dumping = true;
+    stream->dump_pos = pos;
+    stream->dump_seq = seq;
+    stream->dump_end = end;
+
+    // Otherwise the frames are written out as new frames arrive, on eviction, or on sync().
+    if (args[ARG_block].u_bool) {
+        py_imageio_sync(pos_args[0]);
+    }
+
+    return mp_obj_new_int(end - seq);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_imageio_dump_obj, 2, py_imageio_dump);
+
+static mp_obj_t py_imageio_dump_pending(mp_obj_t self) {
+    py_imageio_obj_t *stream = py_imageio_obj(self);
+
+    if ((stream->type != IMAGE_IO_RING_STREAM) || (!stream->dumping)) {
+        return mp_obj_new_int(0);
+    }
+
+    return mp_obj_new_int(stream->dump_end - stream->dump_seq);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(py_imageio_dump_pending_obj, py_imageio_dump_pending);
+#endif
+
 static mp_obj_t py_imageio_close(mp_obj_t self) {
     py_imageio_obj_t *stream = py_imageio_obj(self);
 
@@ -479,6 +744,11 @@ static mp_obj_t py_imageio_close(mp_obj_t self) {
     } else if (stream->type == IMAGE_IO_FILE_STREAM) {
         file_close(&stream->fp);
     #endif
+    } else if (stream->type == IMAGE_IO_RING_STREAM) {
+        #if defined(IMLIB_ENABLE_IMAGE_FILE_IO)
+        py_imageio_sync(self);
+        #endif
+        fb_alloc_free_till_mark_past_mark_permanent();
     } else if (stream->type == IMAGE_IO_MEMORY_STREAM) {
         fb_alloc_free_till_mark_past_mark_permanent();
     }
@@ -489,8 +759,19 @@ static mp_obj_t py_imageio_close(mp_obj_t self) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(py_imageio_close_obj, py_imageio_close);
 
-static mp_obj_t py_imageio_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
-    mp_arg_check_num(n_args, n_kw, 2, 2, false);
+static mp_obj_t py_imageio_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_stream, ARG_mode, ARG_ring };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_stream, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_mode, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_ring, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false } },
+    };
+
+    // Parse args.
+    mp_arg_val_t parsed_args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, parsed_args);
+    mp_obj_t args[2] = { parsed_args[ARG_stream].u_obj, parsed_args[ARG_mode].u_obj };
+
     py_imageio_obj_t *stream = mp_obj_malloc_with_finaliser(py_imageio_obj_t, &py_imageio_type);
     stream->closed = false;
 
@@ -571,6 +852,14 @@ static mp_obj_t py_imageio_make_new(const mp_obj_type_t *type, size_t n_args, si
         }
 
         image_t image = {.w = w, .h = h, .pixfmt = pixfmt};
+        size_t header_size = 0;
+
+        // QOI stores the pixels when they don't compress, so a frame may be as large as
+        // an RGB565 image plus the QOI header.
+        if (image.pixfmt == PIXFORMAT_QOI) {
+            image.pixfmt = PIXFORMAT_RGB565;
+            header_size = QOI_HEADER_SIZE;
+        }
 
         // Estimate that the compressed image will fit in less than 2 bits per pixel.
         if (image.is_compressed) {
@@ -579,11 +868,28 @@ static mp_obj_t py_imageio_make_new(const mp_obj_type_t *type, size_t n_args, si
         }
 
         stream->count = mp_obj_get_int(args[1]);
-        stream->size = IMAGE_T_SIZE_ALIGNED + image_size_aligned(&image);
+        stream->size = IMAGE_T_SIZE_ALIGNED + size_aligned(image_size(&image) + header_size);
+        uint32_t buffer_size = stream->count * stream->size;
+
+        if (parsed_args[ARG_ring].u_bool) {
+            // Ring streams size the buffer for count estimated frames but hold as many as fit.
+            stream->type = IMAGE_IO_RING_STREAM;
+            stream->size = buffer_size = stream->count * (RING_FRAME_T_SIZE_ALIGNED +
+                                                          size_aligned(image_size(&image) + header_size));
+        }
 
         fb_alloc_mark();
-        stream->buffer = fb_alloc(stream->count * stream->size, FB_ALLOC_PREFER_SIZE | FB_ALLOC_CACHE_ALIGN);
+        stream->buffer = fb_alloc(buffer_size, FB_ALLOC_PREFER_SIZE | FB_ALLOC_CACHE_ALIGN);
         fb_alloc_mark_permanent();
+
+        if (stream->type == IMAGE_IO_RING_STREAM) {
+            stream->count = 0;
+            stream->head = stream->tail = stream->used = stream->cursor = stream->seq = 0;
+            stream->wrap = stream->size;
+            #if defined(IMLIB_ENABLE_IMAGE_FILE_IO)
+            stream->dumping = false;
+            #endif
+        }
     } else {
         mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid stream type"));
     }
@@ -599,6 +905,7 @@ static const mp_rom_map_elem_t py_imageio_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR___del__),         MP_ROM_PTR(&py_imageio_close_obj)       },
     { MP_ROM_QSTR(MP_QSTR_FILE_STREAM),     MP_ROM_INT(IMAGE_IO_FILE_STREAM)        },
     { MP_ROM_QSTR(MP_QSTR_MEMORY_STREAM),   MP_ROM_INT(IMAGE_IO_MEMORY_STREAM)      },
+    { MP_ROM_QSTR(MP_QSTR_RING_STREAM),     MP_ROM_INT(IMAGE_IO_RING_STREAM)        },
     { MP_ROM_QSTR(MP_QSTR_type),            MP_ROM_PTR(&py_imageio_get_type_obj)    },
     { MP_ROM_QSTR(MP_QSTR_is_closed),       MP_ROM_PTR(&py_imageio_is_closed_obj)   },
     { MP_ROM_QSTR(MP_QSTR_count),           MP_ROM_PTR(&py_imageio_count_obj)       },
@@ -614,6 +921,13 @@ static const mp_rom_map_elem_t py_imageio_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_read),            MP_ROM_PTR(&py_imageio_read_obj)        },
     { MP_ROM_QSTR(MP_QSTR_seek),            MP_ROM_PTR(&py_imageio_seek_obj)        },
     { MP_ROM_QSTR(MP_QSTR_sync),            MP_ROM_PTR(&py_imageio_sync_obj)        },
+    #if defined(IMLIB_ENABLE_IMAGE_FILE_IO)
+    { MP_ROM_QSTR(MP_QSTR_dump),            MP_ROM_PTR(&py_imageio_dump_obj)        },
+    { MP_ROM_QSTR(MP_QSTR_dump_pending),    MP_ROM_PTR(&py_imageio_dump_pending_obj) },
+    #else
+    { MP_ROM_QSTR(MP_QSTR_dump),            MP_ROM_PTR(&py_func_unavailable_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_dump_pending),    MP_ROM_PTR(&py_func_unavailable_obj)    },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_close),           MP_ROM_PTR(&py_imageio_close_obj)       }
 };
 
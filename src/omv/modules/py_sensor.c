@@ -147,6 +147,30 @@ static mp_obj_t py_sensor_snapshot(uint n_args, const mp_obj_t *args, mp_map_t *
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(py_sensor_snapshot_obj, 0, py_sensor_snapshot);
 
+static mp_obj_t py_sensor_snapshot_rois() {
+    image_t image;
+
+    if (!sensor.roi_list.count) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Multi-ROI capture is not enabled"));
+    }
+
+    int error = sensor.snapshot(&sensor, &image, 0);
+    if (error != 0) {
+        sensor_raise_error(error);
+    }
+
+    // The ROI images are packed in the frame buffer after the first one.
+    sensor_roi_list_t *list = &sensor.roi_list;
+    mp_obj_list_t *rois = mp_obj_new_list(list->count, NULL);
+    for (int i = 0; i < list->count; i++) {
+        rois->items[i] = py_image(list->rois[i].w / list->decimation,
+                                  list->rois[i].h / list->decimation,
+                                  image.pixfmt, 0, image.data + list->rois[i].offset);
+    }
+    return rois;
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_snapshot_rois_obj, py_sensor_snapshot_rois);
+
 static mp_obj_t py_sensor_skip_frames(uint n_args, const mp_obj_t *args, mp_map_t *kw_args) {
     mp_map_elem_t *kw_arg = mp_map_lookup(kw_args, MP_ROM_QSTR(MP_QSTR_time), MP_MAP_LOOKUP);
     mp_int_t time = 300; // OV Recommended.
@@ -286,6 +310,79 @@ static mp_obj_t py_sensor_get_framerate() {
 }
 static MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_framerate_obj, py_sensor_get_framerate);
 
+static mp_obj_t py_sensor_define_mode(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_id, ARG_pixformat, ARG_framesize, ARG_window, ARG_framerate };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_id, MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_pixformat, MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_framesize, MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_window, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_framerate, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 0} },
+    };
+
+    // Parse args.
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    int framesize = args[ARG_framesize].u_int;
+    if ((framesize <= FRAMESIZE_INVALID) || (framesize > FRAMESIZE_WQXGA2)) {
+        sensor_raise_error(SENSOR_ERROR_INVALID_FRAMESIZE);
+    }
+
+    // A zero width/height selects the full frame.
+    rectangle_t r = { 0, 0, 0, 0 };
+
+    if (args[ARG_window].u_obj != mp_const_none) {
+        mp_obj_t *array;
+        size_t array_len;
+        mp_obj_get_array(args[ARG_window].u_obj, &array_len, &array);
+
+        if (array_len == 2) {
+            r.w = mp_obj_get_int(array[0]);
+            r.h = mp_obj_get_int(array[1]);
+            r.x = (resolution[framesize][0] / 2) - (r.w / 2);
+            r.y = (resolution[framesize][1] / 2) - (r.h / 2);
+        } else if (array_len == 4) {
+            r.x = mp_obj_get_int(array[0]);
+            r.y = mp_obj_get_int(array[1]);
+            r.w = mp_obj_get_int(array[2]);
+            r.h = mp_obj_get_int(array[3]);
+        } else {
+            mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("The tuple/list must either be (x, y, w, h) or (w, h)"));
+        }
+
+        if ((r.w < 1) || (r.h < 1)) {
+            mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid ROI dimensions!"));
+        }
+    }
+
+    int error = sensor_define_mode(args[ARG_id].u_int, args[ARG_pixformat].u_int, framesize,
+                                   r.x, r.y, r.w, r.h, args[ARG_framerate].u_int);
+    if (error != 0) {
+        sensor_raise_error(error);
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_sensor_define_mode_obj, 3, py_sensor_define_mode);
+
+static mp_obj_t py_sensor_set_mode(mp_obj_t id) {
+    int error = sensor_set_mode(mp_obj_get_int(id));
+    if (error != 0) {
+        sensor_raise_error(error);
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_set_mode_obj, py_sensor_set_mode);
+
+static mp_obj_t py_sensor_get_mode() {
+    int mode = sensor_get_mode();
+    if (mode < 0) {
+        return mp_const_none;
+    }
+    return mp_obj_new_int(mode);
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_mode_obj, py_sensor_get_mode);
+
 static mp_obj_t py_sensor_set_windowing(uint n_args, const mp_obj_t *args) {
     if (sensor.framesize == FRAMESIZE_INVALID) {
         sensor_raise_error(SENSOR_ERROR_INVALID_FRAMESIZE);
@@ -339,6 +436,118 @@ static mp_obj_t py_sensor_set_windowing(uint n_args, const mp_obj_t *args) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(py_sensor_set_windowing_obj, 1, 4, py_sensor_set_windowing);
 
+static mp_obj_t py_sensor_set_rois(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_rois, ARG_decimation };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_rois, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_decimation, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 1} },
+    };
+
+    // Parse args.
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    rectangle_t rois[SENSOR_ROI_MAX];
+    size_t count = 0;
+
+    if (args[ARG_rois].u_obj != mp_const_none) {
+        mp_obj_t *items;
+        mp_obj_get_array(args[ARG_rois].u_obj, &count, &items);
+
+        if (count > SENSOR_ROI_MAX) {
+            mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("Expected at most %d ROIs"), SENSOR_ROI_MAX);
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            mp_obj_t *roi;
+            mp_obj_get_array_fixed_n(items[i], 4, &roi);
+            rois[i].x = mp_obj_get_int(roi[0]);
+            rois[i].y = mp_obj_get_int(roi[1]);
+            rois[i].w = mp_obj_get_int(roi[2]);
+            rois[i].h = mp_obj_get_int(roi[3]);
+        }
+    }
+
+    int error = sensor_set_rois(rois, count, args[ARG_decimation].u_int);
+    if (error != 0) {
+        sensor_raise_error(error);
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_sensor_set_rois_obj, 1, py_sensor_set_rois);
+
+static mp_obj_t py_sensor_get_rois() {
+    sensor_roi_list_t *list = &sensor.roi_list;
+
+    if (!list->count) {
+        return mp_const_none;
+    }
+
+    mp_obj_list_t *rois = mp_obj_new_list(list->count, NULL);
+    for (int i = 0; i < list->count; i++) {
+        rois->items[i] = mp_obj_new_tuple(4, (mp_obj_t []) {
+            mp_obj_new_int(MAIN_FB()->x + list->rois[i].x),
+            mp_obj_new_int(MAIN_FB()->y + list->rois[i].y),
+            mp_obj_new_int(list->rois[i].w),
+            mp_obj_new_int(list->rois[i].h)
+        });
+    }
+    return rois;
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_rois_obj, py_sensor_get_rois);
+
+static mp_obj_t py_sensor_set_isp(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_pixformat, ARG_threshold, ARG_invert, ARG_histogram };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_pixformat, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_threshold, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_invert, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false} },
+        { MP_QSTR_histogram, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false} },
+    };
+
+    // Parse args.
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    pixformat_t pixformat = PIXFORMAT_INVALID;
+    if (args[ARG_pixformat].u_obj != mp_const_none) {
+        pixformat = mp_obj_get_int(args[ARG_pixformat].u_obj);
+    }
+
+    // Binary output keeps the pixels with a luma in [lo, hi].
+    int lo = 128, hi = 255;
+    if (args[ARG_threshold].u_obj != mp_const_none) {
+        mp_obj_t *threshold;
+        mp_obj_get_array_fixed_n(args[ARG_threshold].u_obj, 2, &threshold);
+        lo = mp_obj_get_int(threshold[0]);
+        hi = mp_obj_get_int(threshold[1]);
+        if ((lo < 0) || (hi < 0)) {
+            sensor_raise_error(SENSOR_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
+    int error = sensor_set_isp(pixformat, lo, hi, args[ARG_invert].u_bool, args[ARG_histogram].u_bool);
+    if (error != 0) {
+        sensor_raise_error(error);
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(py_sensor_set_isp_obj, 1, py_sensor_set_isp);
+
+static mp_obj_t py_sensor_get_isp_histogram() {
+    if (!sensor.isp.histogram) {
+        return mp_const_none;
+    }
+
+    const uint32_t *bins = sensor_isp_get_histogram(&sensor.isp);
+    mp_obj_list_t *list = mp_obj_new_list(SENSOR_ISP_HISTOGRAM_BINS, NULL);
+    for (int i = 0; i < SENSOR_ISP_HISTOGRAM_BINS; i++) {
+        list->items[i] = mp_obj_new_int(bins[i]);
+    }
+    return list;
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_isp_histogram_obj, py_sensor_get_isp_histogram);
+
 static mp_obj_t py_sensor_get_windowing() {
     if (sensor.framesize == FRAMESIZE_INVALID) {
         sensor_raise_error(SENSOR_ERROR_INVALID_FRAMESIZE);
@@ -1204,6 +1413,7 @@ static const mp_rom_map_elem_t globals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_shutdown),            MP_ROM_PTR(&py_sensor_shutdown_obj) },
     { MP_ROM_QSTR(MP_QSTR_flush),               MP_ROM_PTR(&py_sensor_flush_obj) },
     { MP_ROM_QSTR(MP_QSTR_snapshot),            MP_ROM_PTR(&py_sensor_snapshot_obj) },
+    { MP_ROM_QSTR(MP_QSTR_snapshot_rois),       MP_ROM_PTR(&py_sensor_snapshot_rois_obj) },
     { MP_ROM_QSTR(MP_QSTR_skip_frames),         MP_ROM_PTR(&py_sensor_skip_frames_obj) },
     { MP_ROM_QSTR(MP_QSTR_width),               MP_ROM_PTR(&py_sensor_width_obj) },
     { MP_ROM_QSTR(MP_QSTR_height),              MP_ROM_PTR(&py_sensor_height_obj) },
@@ -1218,8 +1428,15 @@ static const mp_rom_map_elem_t globals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_get_framesize),       MP_ROM_PTR(&py_sensor_get_framesize_obj) },
     { MP_ROM_QSTR(MP_QSTR_set_framerate),       MP_ROM_PTR(&py_sensor_set_framerate_obj) },
     { MP_ROM_QSTR(MP_QSTR_get_framerate),       MP_ROM_PTR(&py_sensor_get_framerate_obj) },
+    { MP_ROM_QSTR(MP_QSTR_define_mode),         MP_ROM_PTR(&py_sensor_define_mode_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_mode),            MP_ROM_PTR(&py_sensor_set_mode_obj) },
+    { MP_ROM_QSTR(MP_QSTR_get_mode),            MP_ROM_PTR(&py_sensor_get_mode_obj) },
     { MP_ROM_QSTR(MP_QSTR_set_windowing),       MP_ROM_PTR(&py_sensor_set_windowing_obj) },
     { MP_ROM_QSTR(MP_QSTR_get_windowing),       MP_ROM_PTR(&py_sensor_get_windowing_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_rois),            MP_ROM_PTR(&py_sensor_set_rois_obj) },
+    { MP_ROM_QSTR(MP_QSTR_get_rois),            MP_ROM_PTR(&py_sensor_get_rois_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_isp),             MP_ROM_PTR(&py_sensor_set_isp_obj) },
+    { MP_ROM_QSTR(MP_QSTR_get_isp_histogram),   MP_ROM_PTR(&py_sensor_get_isp_histogram_obj) },
     { MP_ROM_QSTR(MP_QSTR_set_gainceiling),     MP_ROM_PTR(&py_sensor_set_gainceiling_obj) },
     { MP_ROM_QSTR(MP_QSTR_set_contrast),        MP_ROM_PTR(&py_sensor_set_contrast_obj) },
     { MP_ROM_QSTR(MP_QSTR_set_brightness),      MP_ROM_PTR(&py_sensor_set_brightness_obj) },
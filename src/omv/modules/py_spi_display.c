@@ -41,6 +41,8 @@
 #define LCD_COMMAND_DISPON          (0x29)
 #define LCD_COMMAND_RAMWR           (0x2C)
 #define LCD_COMMAND_SLPOUT          (0x11)
+#define LCD_COMMAND_CASET           (0x2A)
+#define LCD_COMMAND_RASET           (0x2B)
 #define LCD_COMMAND_MADCTL          (0x36)
 #define LCD_COMMAND_COLMOD          (0x3A)
 
@@ -179,60 +181,116 @@ static void spi_display_kick(py_display_obj_t *self) {
 
 static void spi_display_draw_image_cb(int x_start, int x_end, int y_row, imlib_draw_row_data_t *data) {
     py_display_obj_t *lcd_self = (py_display_obj_t *) data->callback_arg;
-    spi_transmit_16(lcd_self, data->dst_row_override, lcd_self->width);
+    spi_transmit_16(lcd_self, data->dst_row_override, data->dst_img->w);
 }
 
-static void spi_display_write(py_display_obj_t *self, image_t *src_img, int dst_x_start, int dst_y_start,
-                              float x_scale, float y_scale, rectangle_t *roi, int rgb_channel, int alpha,
-                              const uint16_t *color_palette, const uint8_t *alpha_palette, image_hint_t hint) {
+static void spi_display_set_window(py_display_obj_t *self, rectangle_t *window) {
+    int x_end = window->x + window->w - 1;
+    int y_end = window->y + window->h - 1;
+    spi_write(self, LCD_COMMAND_CASET, (uint8_t []) { window->x >> 8, window->x, x_end >> 8, x_end }, 4, false);
+    spi_write(self, LCD_COMMAND_RASET, (uint8_t []) { window->y >> 8, window->y, y_end >> 8, y_end }, 4, false);
+}
+
+// Draws the image into a window of the display and streams it out one line at a time.
+static void spi_display_write_window(py_display_obj_t *self, image_t *src_img, int dst_x_start, int dst_y_start,
+                                     float x_scale, float y_scale, rectangle_t *roi, int rgb_channel, int alpha,
+                                     const uint16_t *color_palette, const uint8_t *alpha_palette,
+                                     image_hint_t hint, rectangle_t *window, uint16_t *line) {
     image_t dst_img;
-    dst_img.w = self->width;
-    dst_img.h = self->height;
+    dst_img.w = window->w;
+    dst_img.h = window->h;
     dst_img.pixfmt = PIXFORMAT_RGB565;
+    dst_img.data = (uint8_t *) line;
+
+    // Drawing into the window is the same as drawing into the display with the origin moved.
+    dst_x_start -= window->x;
+    dst_y_start -= window->y;
 
     point_t p0, p1;
     imlib_draw_image_get_bounds(&dst_img, src_img, dst_x_start, dst_y_start, x_scale,
                                 y_scale, roi, alpha, alpha_palette, hint, &p0, &p1);
     bool black = p0.x == -1;
 
-    if (!self->triple_buffer) {
-        dst_img.data = fb_alloc0(self->width * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+    memset(line, 0, window->w * sizeof(uint16_t));
 
-        spi_display_command(self, LCD_COMMAND_RAMWR, 0);
-        spi_switch_mode(self, (!self->byte_swap) ? 16 : 8, true);
-        omv_gpio_write(OMV_SPI_DISPLAY_SSEL_PIN, 0);
+    spi_display_command(self, LCD_COMMAND_RAMWR, 0);
+    spi_switch_mode(self, (!self->byte_swap) ? 16 : 8, true);
+    omv_gpio_write(OMV_SPI_DISPLAY_SSEL_PIN, 0);
 
-        if (black) {
-            // zero the whole image
-            for (int i = 0; i < self->height; i++) {
-                spi_transmit_16(self, dst_img.data, self->width);
-            }
-        } else {
-            // Zero the top rows
-            for (int i = 0; i < p0.y; i++) {
-                spi_transmit_16(self, dst_img.data, self->width);
-            }
+    if (black) {
+        // zero the whole window
+        for (int i = 0; i < window->h; i++) {
+            spi_transmit_16(self, dst_img.data, window->w);
+        }
+    } else {
+        // Zero the top rows
+        for (int i = 0; i < p0.y; i++) {
+            spi_transmit_16(self, dst_img.data, window->w);
+        }
 
-            // Transmits left/right parts already zeroed...
-            imlib_draw_image(&dst_img, src_img, dst_x_start, dst_y_start,
-                             x_scale, y_scale, roi, rgb_channel, alpha, color_palette, alpha_palette,
-                             hint | IMAGE_HINT_BLACK_BACKGROUND, spi_display_draw_image_cb, self, dst_img.data);
+        // Transmits left/right parts already zeroed...
+        imlib_draw_image(&dst_img, src_img, dst_x_start, dst_y_start,
+                         x_scale, y_scale, roi, rgb_channel, alpha, color_palette, alpha_palette,
+                         hint | IMAGE_HINT_BLACK_BACKGROUND, spi_display_draw_image_cb, self, dst_img.data);
 
-            // Zero the bottom rows
-            if (p1.y < self->height) {
-                memset(dst_img.data, 0, self->width * sizeof(uint16_t));
+        // Zero the bottom rows
+        if (p1.y < window->h) {
+            memset(dst_img.data, 0, window->w * sizeof(uint16_t));
+        }
+
+        for (int i = p1.y; i < window->h; i++) {
+            spi_transmit_16(self, dst_img.data, window->w);
+        }
+    }
+
+    spi_switch_mode(self, 8, false);
+    omv_gpio_write(OMV_SPI_DISPLAY_SSEL_PIN, 1);
+}
+
+static void spi_display_write(py_display_obj_t *self, image_t *src_img, int dst_x_start, int dst_y_start,
+                              float x_scale, float y_scale, rectangle_t *roi, int rgb_channel, int alpha,
+                              const uint16_t *color_palette, const uint8_t *alpha_palette, image_hint_t hint) {
+    if (!self->triple_buffer) {
+        rectangle_t display = {0, 0, self->width, self->height};
+        uint16_t *line = fb_alloc(self->width * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+
+        if (self->dirty_rects == NULL) {
+            spi_display_write_window(self, src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi,
+                                     rgb_channel, alpha, color_palette, alpha_palette, hint, &display, line);
+        } else if (self->dirty_count) {
+            // Scale and center against the whole display so that every window shows its part of
+            // the same image, the windows then only translate the destination origin.
+            if (src_img) {
+                image_t dst_img = {.w = self->width, .h = self->height, .pixfmt = PIXFORMAT_RGB565};
+                imlib_draw_image_resolve_hints(&dst_img, src_img, roi, &dst_x_start, &dst_y_start,
+                                               &x_scale, &y_scale, &hint);
             }
 
-            for (int i = p1.y; i < self->height; i++) {
-                spi_transmit_16(self, dst_img.data, self->width);
+            // Only the dirty windows are sent, each one using the controller's column/row address
+            // window. The full address window is restored afterwards for the next full update.
+            for (size_t i = 0; i < self->dirty_count; i++) {
+                spi_display_set_window(self, &self->dirty_rects[i]);
+                spi_display_write_window(self, src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi,
+                                         rgb_channel, alpha, color_palette, alpha_palette, hint,
+                                         &self->dirty_rects[i], line);
             }
+
+            spi_display_set_window(self, &display);
         }
 
-        spi_switch_mode(self, 8, false);
-        omv_gpio_write(OMV_SPI_DISPLAY_SSEL_PIN, 1);
         spi_display_command(self, LCD_COMMAND_DISPON, 0);
         fb_free();
     } else {
+        image_t dst_img;
+        dst_img.w = self->width;
+        dst_img.h = self->height;
+        dst_img.pixfmt = PIXFORMAT_RGB565;
+
+        point_t p0, p1;
+        imlib_draw_image_get_bounds(&dst_img, src_img, dst_x_start, dst_y_start, x_scale,
+                                    y_scale, roi, alpha, alpha_palette, hint, &p0, &p1);
+        bool black = p0.x == -1;
+
         // For triple buffering we are never drawing where tail or head
         // (which may instantly update to to be equal to tail) is.
         int new_framebuffer_tail = (self->framebuffer_tail + 1) % FRAMEBUFFER_COUNT;
@@ -300,6 +358,8 @@ static void spi_display_clear(py_display_obj_t *self, bool display_off) {
         }
     } else {
         spi_display_command(self, LCD_COMMAND_DISPOFF, 0);
+        self->dirty_rects = NULL;
+        self->dirty_count = 0;
         fb_alloc_mark();
         spi_display_write(self, NULL, 0, 0, 1.f, 1.f, NULL, 0, 0, NULL, NULL, 0);
         fb_alloc_free_till_mark();
@@ -367,6 +427,8 @@ mp_obj_t spi_display_make_new(const mp_obj_type_t *type, size_t n_args, size_t n
     self->bgr = args[ARG_bgr].u_bool;
     self->byte_swap = args[ARG_byte_swap].u_bool;
     self->controller = args[ARG_controller].u_obj;
+    self->dirty_rects = NULL;
+    self->dirty_count = 0;
     self->bl_controller = args[ARG_backlight].u_obj;
 
     omv_spi_config_t spi_config;
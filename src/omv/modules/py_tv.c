@@ -598,57 +598,105 @@ static void spi_tv_draw_image_cb_rgb565(int x_start, int x_end, int y_row, imlib
     SpiTransmitReceivePacket(data->dst_row_override, NULL, PICLINE_LENGTH_BYTES, false);
 }
 
-static void spi_tv_display(image_t *src_img, int dst_x_start, int dst_y_start, float x_scale, float y_scale,
-                           rectangle_t *roi, int rgb_channel, int alpha,
-                           const uint16_t *color_palette, const uint8_t *alpha_palette,
-                           image_hint_t hint) {
-    bool rgb565 = ((rgb_channel == -1) && src_img->is_color) || color_palette;
+// Draws the image into the display lines [y_start, y_start + lines) and streams them to the SPI RAM.
+static void spi_tv_display_lines(image_t *src_img, int dst_x_start, int dst_y_start, float x_scale, float y_scale,
+                                 rectangle_t *roi, int rgb_channel, int alpha,
+                                 const uint16_t *color_palette, const uint8_t *alpha_palette,
+                                 image_hint_t hint, bool rgb565, int y_start, int lines, uint8_t *line) {
     imlib_draw_row_callback_t cb = rgb565 ? spi_tv_draw_image_cb_rgb565 : spi_tv_draw_image_cb_grayscale;
 
+    // Drawing into the lines is the same as drawing into the display with the origin moved.
     image_t dst_img;
     dst_img.w = TV_WIDTH;
-    dst_img.h = TV_HEIGHT;
+    dst_img.h = lines;
     dst_img.pixfmt = rgb565 ? PIXFORMAT_RGB565 : PIXFORMAT_GRAYSCALE;
+    dst_img.data = line;
+    dst_y_start -= y_start;
 
     point_t p0, p1;
     imlib_draw_image_get_bounds(&dst_img, src_img, dst_x_start, dst_y_start, x_scale, y_scale,
                                 roi, alpha, alpha_palette, hint, &p0, &p1);
     bool black = p0.x == -1;
 
-    if (!tv_triple_buffer) {
-        dst_img.data = fb_alloc0(TV_WIDTH_RGB565, FB_ALLOC_NO_HINT);
+    memset(line, 0, TV_WIDTH_RGB565);
 
-        SpiTransmitReceivePacket((uint8_t *) write_sram, NULL, sizeof(write_sram), false);
+    uint8_t packet[4] = {
+        WRITE_SRAM,
+        (uint8_t) (PICLINE_BYTE_ADDRESS(y_start) >> 16),
+        (uint8_t) (PICLINE_BYTE_ADDRESS(y_start) >> 8),
+        (uint8_t) (PICLINE_BYTE_ADDRESS(y_start) >> 0)
+    };
+    SpiTransmitReceivePacket(packet, NULL, sizeof(packet), false);
 
-        if (black) {
-            // zero the whole image
-            for (int i = 0; i < TV_HEIGHT; i++) {
-                SpiTransmitReceivePacket(dst_img.data, NULL, PICLINE_LENGTH_BYTES, false);
-            }
-        } else {
-            // Zero the top rows
-            for (int i = 0; i < p0.y; i++) {
-                SpiTransmitReceivePacket(dst_img.data, NULL, PICLINE_LENGTH_BYTES, false);
-            }
+    if (black) {
+        // zero the whole image
+        for (int i = 0; i < lines; i++) {
+            SpiTransmitReceivePacket(dst_img.data, NULL, PICLINE_LENGTH_BYTES, false);
+        }
+    } else {
+        // Zero the top rows
+        for (int i = 0; i < p0.y; i++) {
+            SpiTransmitReceivePacket(dst_img.data, NULL, PICLINE_LENGTH_BYTES, false);
+        }
 
-            // Transmits left/right parts already zeroed...
-            imlib_draw_image(&dst_img, src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi,
-                             rgb_channel, alpha, color_palette, alpha_palette, hint | IMAGE_HINT_BLACK_BACKGROUND,
-                             cb, NULL, dst_img.data);
+        // Transmits left/right parts already zeroed...
+        imlib_draw_image(&dst_img, src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi,
+                         rgb_channel, alpha, color_palette, alpha_palette, hint | IMAGE_HINT_BLACK_BACKGROUND,
+                         cb, NULL, dst_img.data);
 
-            // Zero the bottom rows
-            if (p1.y < TV_HEIGHT) {
-                memset(dst_img.data, 0, TV_WIDTH_RGB565);
-            }
+        // Zero the bottom rows
+        if (p1.y < lines) {
+            memset(dst_img.data, 0, TV_WIDTH_RGB565);
+        }
+
+        for (int i = p1.y; i < lines; i++) {
+            SpiTransmitReceivePacket(dst_img.data, NULL, PICLINE_LENGTH_BYTES, false);
+        }
+    }
+
+    omv_gpio_write(OMV_SPI_DISPLAY_SSEL_PIN, 1);
+}
+
+static void spi_tv_display(image_t *src_img, int dst_x_start, int dst_y_start, float x_scale, float y_scale,
+                           rectangle_t *roi, int rgb_channel, int alpha,
+                           const uint16_t *color_palette, const uint8_t *alpha_palette,
+                           image_hint_t hint, rectangle_t *dirty_rects, size_t dirty_count) {
+    bool rgb565 = ((rgb_channel == -1) && src_img->is_color) || color_palette;
 
-            for (int i = p1.y; i < TV_HEIGHT; i++) {
-                SpiTransmitReceivePacket(dst_img.data, NULL, PICLINE_LENGTH_BYTES, false);
+    if (!tv_triple_buffer) {
+        uint8_t *line = fb_alloc(TV_WIDTH_RGB565, FB_ALLOC_NO_HINT);
+
+        if (dirty_rects == NULL) {
+            spi_tv_display_lines(src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi, rgb_channel, alpha,
+                                 color_palette, alpha_palette, hint, rgb565, 0, TV_HEIGHT, line);
+        } else {
+            // Scale and center against the whole display so that every band of lines shows its
+            // part of the same image, the bands then only translate the destination origin.
+            image_t dst_img = {.w = TV_WIDTH, .h = TV_HEIGHT, .pixfmt = PIXFORMAT_GRAYSCALE};
+            imlib_draw_image_resolve_hints(&dst_img, src_img, roi, &dst_x_start, &dst_y_start,
+                                           &x_scale, &y_scale, &hint);
+
+            // Lines are packed in the SPI RAM so only whole lines covered by the dirty rectangles
+            // are rewritten, starting at the address of the first line of each rectangle.
+            for (size_t i = 0; i < dirty_count; i++) {
+                spi_tv_display_lines(src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi, rgb_channel,
+                                     alpha, color_palette, alpha_palette, hint, rgb565,
+                                     dirty_rects[i].y, dirty_rects[i].h, line);
             }
         }
 
-        omv_gpio_write(OMV_SPI_DISPLAY_SSEL_PIN, 1);
         fb_free();
     } else {
+        image_t dst_img;
+        dst_img.w = TV_WIDTH;
+        dst_img.h = TV_HEIGHT;
+        dst_img.pixfmt = rgb565 ? PIXFORMAT_RGB565 : PIXFORMAT_GRAYSCALE;
+
+        point_t p0, p1;
+        imlib_draw_image_get_bounds(&dst_img, src_img, dst_x_start, dst_y_start, x_scale, y_scale,
+                                    roi, alpha, alpha_palette, hint, &p0, &p1);
+        bool black = p0.x == -1;
+
         // For triple buffering we are never drawing where head or tail (which may instantly update to
         // to be equal to head) is.
         int new_framebuffer_head = (framebuffer_head + 1) % FRAMEBUFFER_COUNT;
@@ -886,7 +934,7 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(py_tv_channel_obj, 0, 1, py_tv_channe
 static mp_obj_t py_tv_display(uint n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     enum {
         ARG_x, ARG_y, ARG_x_scale, ARG_y_scale, ARG_roi, ARG_channel, ARG_alpha,
-        ARG_color_palette, ARG_alpha_palette, ARG_hint
+        ARG_color_palette, ARG_alpha_palette, ARG_hint, ARG_dirty
     };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_x, MP_ARG_INT | MP_ARG_KW_ONLY,  {.u_int = 0 } },
@@ -899,6 +947,7 @@ static mp_obj_t py_tv_display(uint n_args, const mp_obj_t *pos_args, mp_map_t *k
         { MP_QSTR_color_palette, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
         { MP_QSTR_alpha_palette, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
         { MP_QSTR_hint, MP_ARG_INT | MP_ARG_KW_ONLY,  {.u_int = 0 } },
+        { MP_QSTR_dirty, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_rom_obj = MP_ROM_NONE} },
     };
 
     // Parse args.
@@ -926,10 +975,21 @@ static mp_obj_t py_tv_display(uint n_args, const mp_obj_t *pos_args, mp_map_t *k
     switch (tv_type) {
         #ifdef OMV_SPI_DISPLAY_CONTROLLER
         case TV_SHIELD: {
+            // The SPI RAM is continuously rewritten from the framebuffers with triple buffering,
+            // so there is nothing to gain from partial updates.
+            if ((args[ARG_dirty].u_obj != mp_const_none) && tv_triple_buffer) {
+                mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Dirty regions require single buffering"));
+            }
+
             fb_alloc_mark();
+            rectangle_t *dirty_rects = NULL;
+            size_t dirty_count = 0;
+            if (args[ARG_dirty].u_obj != mp_const_none) {
+                dirty_count = py_helper_arg_to_dirty_rects(args[ARG_dirty].u_obj, TV_WIDTH, TV_HEIGHT, &dirty_rects);
+            }
             spi_tv_display(image, args[ARG_x].u_int, args[ARG_y].u_int, x_scale, y_scale, &roi,
                            args[ARG_channel].u_int, args[ARG_alpha].u_int, color_palette, alpha_palette,
-                           args[ARG_hint].u_int);
+                           args[ARG_hint].u_int, dirty_rects, dirty_count);
             fb_alloc_free_till_mark();
             break;
         }
@@ -948,7 +1008,7 @@ static mp_obj_t py_tv_clear() {
         case TV_SHIELD: {
             fb_alloc_mark();
             spi_tv_display(NULL, 0, 0, 1.f, 1.f, NULL,
-                           0, 0, NULL, NULL, 0);
+                           0, 0, NULL, NULL, 0, NULL, 0);
             fb_alloc_free_till_mark();
             break;
         }
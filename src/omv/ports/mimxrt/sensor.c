@@ -328,7 +328,17 @@ void sensor_line_callback(uint32_t addr) {
         return;
     }
 
-    if ((MAIN_FB()->y <= buffer->offset) && (buffer->offset < (MAIN_FB()->y + MAIN_FB()->v))) {
+    if (sensor.roi_list.count) {
+        // Multi-ROI capture copies each line to all the ROIs that contain it.
+        uint8_t *src = ((uint8_t *) addr) + (MAIN_FB()->x * sensor_get_src_bpp());
+        sensor_roi_copy_line(&sensor.roi_list, buffer->offset - MAIN_FB()->y, src, buffer->data);
+    } else if (sensor.line_callback) {
+        // The line callback processes each line of the window into the frame buffer.
+        if ((MAIN_FB()->y <= buffer->offset) && (buffer->offset < (MAIN_FB()->y + MAIN_FB()->v))) {
+            uint8_t *src = ((uint8_t *) addr) + (MAIN_FB()->x * sensor_get_src_bpp());
+            sensor.line_callback(buffer->offset - MAIN_FB()->y, src, buffer->data);
+        }
+    } else if ((MAIN_FB()->y <= buffer->offset) && (buffer->offset < (MAIN_FB()->y + MAIN_FB()->v))) {
         // Copy from DMA buffer to framebuffer.
         uint32_t bytes_per_pixel = sensor_get_src_bpp();
         uint8_t *src = ((uint8_t *) addr) + (MAIN_FB()->x * bytes_per_pixel);
@@ -489,7 +499,8 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags) {
 
     #if defined(OMV_CSI_DMA)
     // dest_inc_size will be less than MIN_EDMA_DST_INC if the EDMA is not initialized or unusable.
-    if (dest_inc_size >= MIN_EDMA_DST_INC) {
+    // Multi-ROI capture and line callback lines are written by the CPU, so they must not be invalidated.
+    if ((dest_inc_size >= MIN_EDMA_DST_INC) && !sensor->roi_list.count && !sensor->line_callback) {
         fb_flags = FB_INVALIDATE;
     }
     #endif
@@ -524,7 +535,11 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags) {
         return SENSOR_ERROR_JPEG_OVERFLOW;
     }
 
-    if (!sensor->transpose) {
+    if (sensor->roi_list.count) {
+        // The frame buffer image is the first ROI.
+        MAIN_FB()->w = sensor->roi_list.rois[0].w / sensor->roi_list.decimation;
+        MAIN_FB()->h = sensor->roi_list.rois[0].h / sensor->roi_list.decimation;
+    } else if (!sensor->transpose) {
         MAIN_FB()->w = w;
         MAIN_FB()->h = h;
     } else {
@@ -569,6 +584,11 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags) {
             break;
     }
 
+    // The line callback output format replaces the captured format.
+    if (sensor->line_callback) {
+        MAIN_FB()->pixfmt = sensor->line_pixfmt;
+    }
+
     // Set the user image.
     framebuffer_init_image(image);
     return 0;
@@ -176,6 +176,14 @@ int sensor_set_windowing(int x, int y, int w, int h) {
     return SENSOR_ERROR_CTL_UNSUPPORTED;
 }
 
+int sensor_set_rois(const rectangle_t *rois, uint32_t count, uint32_t decimation) {
+    return SENSOR_ERROR_CTL_UNSUPPORTED;
+}
+
+int sensor_set_line_callback(line_cb_t line_cb, pixformat_t pixfmt) {
+    return SENSOR_ERROR_CTL_UNSUPPORTED;
+}
+
 // This is the default snapshot function, which can be replaced in sensor_init functions.
 int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags) {
     // Compress the framebuffer for the IDE preview, only if it's not the first frame,
@@ -133,6 +133,9 @@ target_sources(${MICROPY_TARGET} PRIVATE
     ${TOP_DIR}/${OMV_DIR}/common/file_utils.c
     ${TOP_DIR}/${OMV_DIR}/common/mp_utils.c
     ${TOP_DIR}/${OMV_DIR}/common/sensor_utils.c
+    ${TOP_DIR}/${OMV_DIR}/common/sensor_roi.c
+    ${TOP_DIR}/${OMV_DIR}/common/sensor_isp.c
+    ${TOP_DIR}/${OMV_DIR}/common/omv_i2c_regseq.c
 
     ${TOP_DIR}/${OMV_DIR}/sensors/ov2640.c
     ${TOP_DIR}/${OMV_DIR}/sensors/ov5640.c
@@ -153,6 +156,7 @@ target_sources(${MICROPY_TARGET} PRIVATE
     ${TOP_DIR}/${OMV_DIR}/imlib/blob.c
     ${TOP_DIR}/${OMV_DIR}/imlib/bmp.c
     ${TOP_DIR}/${OMV_DIR}/imlib/clahe.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/codes.c
     ${TOP_DIR}/${OMV_DIR}/imlib/collections.c
     ${TOP_DIR}/${OMV_DIR}/imlib/dmtx.c
     ${TOP_DIR}/${OMV_DIR}/imlib/draw.c
@@ -177,6 +181,7 @@ target_sources(${MICROPY_TARGET} PRIVATE
     ${TOP_DIR}/${OMV_DIR}/imlib/jpege.c
     ${TOP_DIR}/${OMV_DIR}/imlib/lodepng.c
     ${TOP_DIR}/${OMV_DIR}/imlib/png.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/klt.c
     ${TOP_DIR}/${OMV_DIR}/imlib/kmeans.c
     ${TOP_DIR}/${OMV_DIR}/imlib/lab_tab.c
     ${TOP_DIR}/${OMV_DIR}/imlib/lbp.c
@@ -184,19 +189,24 @@ target_sources(${MICROPY_TARGET} PRIVATE
     ${TOP_DIR}/${OMV_DIR}/imlib/lsd.c
     ${TOP_DIR}/${OMV_DIR}/imlib/mathop.c
     ${TOP_DIR}/${OMV_DIR}/imlib/mjpeg.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/motion.c
     ${TOP_DIR}/${OMV_DIR}/imlib/orb.c
     ${TOP_DIR}/${OMV_DIR}/imlib/phasecorrelation.c
     ${TOP_DIR}/${OMV_DIR}/imlib/point.c
     ${TOP_DIR}/${OMV_DIR}/imlib/ppm.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/pyramid.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/qoi.c
     ${TOP_DIR}/${OMV_DIR}/imlib/qrcode.c
     ${TOP_DIR}/${OMV_DIR}/imlib/qsort.c
     ${TOP_DIR}/${OMV_DIR}/imlib/rainbow_tab.c
     ${TOP_DIR}/${OMV_DIR}/imlib/rectangle.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/rects.c
     ${TOP_DIR}/${OMV_DIR}/imlib/selective_search.c
     ${TOP_DIR}/${OMV_DIR}/imlib/sincos_tab.c
     ${TOP_DIR}/${OMV_DIR}/imlib/stats.c
     ${TOP_DIR}/${OMV_DIR}/imlib/stereo.c
     ${TOP_DIR}/${OMV_DIR}/imlib/template.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/threshold.c
     ${TOP_DIR}/${OMV_DIR}/imlib/xyz_tab.c
     ${TOP_DIR}/${OMV_DIR}/imlib/yuv.c
     ${TOP_DIR}/${OMV_DIR}/imlib/zbar.c
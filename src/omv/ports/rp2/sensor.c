@@ -196,6 +196,14 @@ int sensor_set_windowing(int x, int y, int w, int h) {
     return SENSOR_ERROR_CTL_UNSUPPORTED;
 }
 
+int sensor_set_rois(const rectangle_t *rois, uint32_t count, uint32_t decimation) {
+    return SENSOR_ERROR_CTL_UNSUPPORTED;
+}
+
+int sensor_set_line_callback(line_cb_t line_cb, pixformat_t pixfmt) {
+    return SENSOR_ERROR_CTL_UNSUPPORTED;
+}
+
 static void dma_irq_handler() {
     if (dma_irqn_get_channel_status(OMV_CSI_DMA, OMV_CSI_DMA_CHANNEL)) {
         // Clear the interrupt request.
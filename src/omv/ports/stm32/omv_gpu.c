@@ -229,4 +229,56 @@ int omv_gpu_draw_image(image_t *src_img,
     OMV_PROFILE_PRINT();
     return 0;
 }
+
+int omv_gpu_fill_rect(image_t *dst_img, rectangle_t *dst_rect, int color) {
+    OMV_PROFILE_START();
+
+    // DMA2D can only draw on RGB565 buffers and the destination buffer must be accessible by DMA.
+    if ((dst_img->pixfmt != PIXFORMAT_RGB565) || (!DMA_BUFFER(dst_img->data))) {
+        return -1;
+    }
+
+    DMA2D_HandleTypeDef dma2d = {};
+
+    dma2d.Instance = DMA2D;
+    dma2d.Init.Mode = DMA2D_R2M;
+    dma2d.Init.ColorMode = DMA2D_OUTPUT_RGB565;
+    dma2d.Init.OutputOffset = dst_img->w - dst_rect->w;
+
+    HAL_DMA2D_Init(&dma2d);
+
+    uint16_t *dst16 = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(dst_img, dst_rect->y) + dst_rect->x;
+
+    #if __DCACHE_PRESENT
+    // Ensures any cached writes to dst16 are flushed.
+    uint16_t *dst16_tmp = dst16;
+    for (int i = 0; i < dst_rect->h; i++) {
+        SCB_CleanInvalidateDCache_by_Addr(dst16_tmp, dst_rect->w * sizeof(uint16_t));
+        dst16_tmp += dst_img->w;
+    }
+    #endif
+
+    // The register to memory color is passed as ARGB8888 and converted by the HAL.
+    uint32_t argb = (0xff << 24) |
+                    (COLOR_RGB565_TO_R8(color) << 16) |
+                    (COLOR_RGB565_TO_G8(color) << 8) |
+                    COLOR_RGB565_TO_B8(color);
+
+    HAL_DMA2D_Start(&dma2d, argb, (uint32_t) dst16, dst_rect->w, dst_rect->h);
+    HAL_DMA2D_PollForTransfer(&dma2d, 1000);
+
+    #if __DCACHE_PRESENT
+    // Ensures any cached reads to dst16 are dropped.
+    dst16_tmp = dst16;
+    for (int i = 0; i < dst_rect->h; i++) {
+        SCB_InvalidateDCache_by_Addr(dst16_tmp, dst_rect->w * sizeof(uint16_t));
+        dst16_tmp += dst_img->w;
+    }
+    #endif
+
+    HAL_DMA2D_DeInit(&dma2d);
+
+    OMV_PROFILE_PRINT();
+    return 0;
+}
 #endif // (OMV_GPU_ENABLE == 1)
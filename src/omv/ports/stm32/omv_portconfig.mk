@@ -210,6 +210,9 @@ FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/common/, \
 	file_utils.o                \
 	mp_utils.o                  \
 	sensor_utils.o              \
+	sensor_roi.o                \
+	sensor_isp.o                \
+	omv_i2c_regseq.o            \
    )
 
 FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/sensors/,   \
@@ -616,6 +619,9 @@ UVC_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/common/, \
 	trace.o                                 \
 	mutex.o                                 \
 	sensor_utils.o                          \
+	sensor_roi.o                            \
+	sensor_isp.o                            \
+	omv_i2c_regseq.o                        \
 	vospi.o                                 \
 	)
 
@@ -53,6 +53,13 @@ static MDMA_HandleTypeDef DCMI_MDMA_Handle1;
 #endif
 
 extern uint8_t _line_buf;
+
+#if defined(OMV_MDMA_CHANNEL_DCMI_0)
+// Line transfers are completely offloaded to MDMA unless the CPU has to process each line,
+// which is the case when transposing the image, splitting the lines between several ROIs
+// or running the line callback.
+#define MDMA_FULL_OFFLOAD(s)     (!(s)->transpose && !(s)->roi_list.count && !(s)->line_callback)
+#endif
 extern uint32_t hal_get_exti_gpio(uint32_t line);
 
 void DCMI_IRQHandler(void) {
@@ -129,6 +136,34 @@ void sensor_init0() {
     sensor_set_frame_callback(NULL);
 }
 
+#if defined(OMV_CSI_PROBE_CACHE_BKP)
+// The probe cache is kept in the RTC backup registers starting at OMV_CSI_PROBE_CACHE_BKP.
+// The sensor is initialized before the filesystem is mounted, and the backup domain is
+// retained across resets and standby, and on VBAT.
+#define PROBE_CACHE_WORDS   (sizeof(sensor_probe_cache_t) / 4)
+
+int sensor_probe_cache_load(sensor_probe_cache_t *cache) {
+    uint32_t *words = (uint32_t *) cache;
+    volatile uint32_t *bkp = &RTC->BKP0R + OMV_CSI_PROBE_CACHE_BKP;
+
+    for (size_t i = 0; i < PROBE_CACHE_WORDS; i++) {
+        words[i] = bkp[i];
+    }
+    return 0;
+}
+
+int sensor_probe_cache_save(const sensor_probe_cache_t *cache) {
+    const uint32_t *words = (const uint32_t *) cache;
+    volatile uint32_t *bkp = &RTC->BKP0R + OMV_CSI_PROBE_CACHE_BKP;
+
+    HAL_PWR_EnableBkUpAccess();
+    for (size_t i = 0; i < PROBE_CACHE_WORDS; i++) {
+        bkp[i] = words[i];
+    }
+    return 0;
+}
+#endif // OMV_CSI_PROBE_CACHE_BKP
+
 int sensor_init() {
     int init_ret = 0;
 
@@ -469,7 +504,7 @@ void DCMI_DMAConvCpltUser(uint32_t addr) {
         // If we're dropping a frame in full offload mode it's safe to disable this interrupt saving
         // ourselves from having to service the DMA complete callback.
         #if defined(OMV_MDMA_CHANNEL_DCMI_0)
-        if (!sensor.transpose) {
+        if (MDMA_FULL_OFFLOAD(&sensor)) {
             HAL_NVIC_DisableIRQ(DMA2_Stream1_IRQn);
         }
         #endif
@@ -538,7 +573,7 @@ void DCMI_DMAConvCpltUser(uint32_t addr) {
     // DCMI_DMAXferCplt in the HAL DCMI driver always calls DCMI_DMAConvCpltUser with the other
     // MAR register. So, we have to fix the address in full MDMA offload mode...
     #if defined(OMV_MDMA_CHANNEL_DCMI_0)
-    if (!sensor.transpose) {
+    if (MDMA_FULL_OFFLOAD(&sensor)) {
         addr = (uint32_t) &_line_buf;
     }
     #endif
@@ -547,6 +582,18 @@ void DCMI_DMAConvCpltUser(uint32_t addr) {
     uint8_t *src = ((uint8_t *) addr) + (MAIN_FB()->x * bytes_per_pixel) - get_dcmi_hw_crop(bytes_per_pixel);
     uint8_t *dst = buffer->data;
 
+    // Multi-ROI capture copies each line to all the ROIs that contain it.
+    if (sensor.roi_list.count) {
+        sensor_roi_copy_line(&sensor.roi_list, buffer->offset++, src, dst);
+        return;
+    }
+
+    // The line callback processes each line into the frame buffer.
+    if (sensor.line_callback) {
+        sensor.line_callback(buffer->offset++, src, dst);
+        return;
+    }
+
     if (sensor.pixformat == PIXFORMAT_GRAYSCALE) {
         bytes_per_pixel = sizeof(uint8_t);
     }
@@ -554,7 +601,7 @@ void DCMI_DMAConvCpltUser(uint32_t addr) {
     // For all non-JPEG and non-transposed modes we can completely offload image capture to MDMA
     // and we do not need to receive any line interrupts for the rest of the frame until it ends.
     #if defined(OMV_MDMA_CHANNEL_DCMI_0)
-    if (!sensor.transpose) {
+    if (MDMA_FULL_OFFLOAD(&sensor)) {
         // NOTE: We're starting MDMA here because it gives the maximum amount of time before we
         // have to drop the frame if there's no space. If you use the FRAME/VSYNC callbacks then
         // you will have to drop the frame earlier than necessary if there's no space resulting
@@ -679,6 +726,11 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags) {
     // first to save space before being cropped until it fits.
     sensor_auto_crop_framebuffer();
 
+    // The line callback output can't be cropped, make sure it fits into the FB.
+    if (sensor->line_callback && (sensor_check_framebuffer_size() != 0)) {
+        return SENSOR_ERROR_FRAMEBUFFER_OVERFLOW;
+    }
+
     // The user may have changed the MAIN_FB width or height on the last image so we need
     // to restore that here. We don't have to restore bpp because that's taken care of
     // already in the code below. Note that we do the JPEG compression above first to save
@@ -747,7 +799,7 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags) {
             HAL_MDMA_Init(&DCMI_MDMA_Handle0);
 
             // If we are not transposing the image we can fully offload image capture from the CPU.
-            if (!sensor->transpose) {
+            if (MDMA_FULL_OFFLOAD(sensor)) {
                 // MDMA will trigger on each TC from DMA and transfer one line to the frame buffer.
                 DCMI_MDMA_Handle1.Init.Request = MDMA_REQUEST_DMA2_Stream1_TC;
                 DCMI_MDMA_Handle1.Init.TransferTriggerMode = MDMA_BLOCK_TRANSFER;
@@ -806,7 +858,7 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags) {
             }
         #if defined(OMV_MDMA_CHANNEL_DCMI_0)
             // Special transfer mode with MDMA that completely offloads the line capture load.
-        } else if ((sensor->pixformat != PIXFORMAT_JPEG) && (!sensor->transpose)) {
+        } else if ((sensor->pixformat != PIXFORMAT_JPEG) && MDMA_FULL_OFFLOAD(sensor)) {
             // DMA to circular mode writing the same line over and over again.
             ((DMA_Stream_TypeDef *) DMAHandle.Instance)->CR |= DMA_SxCR_CIRC;
             // DCMI will transfer to same line and MDMA will move to final location.
@@ -844,7 +896,8 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags) {
 
     #if defined(OMV_MDMA_CHANNEL_DCMI_0)
     // DCMI_MDMA_Handle0.State will be HAL_MDMA_STATE_RESET if the MDMA is not initialized.
-    if (DCMI_MDMA_Handle0.State != HAL_MDMA_STATE_RESET) {
+    // Multi-ROI capture and line callback lines are written by the CPU, so they must not be invalidated.
+    if ((DCMI_MDMA_Handle0.State != HAL_MDMA_STATE_RESET) && !sensor->roi_list.count && !sensor->line_callback) {
         fb_flags = FB_INVALIDATE;
     }
     #endif
@@ -890,7 +943,11 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags) {
 
     // Prepare the frame buffer w/h/bpp values given the image type.
 
-    if (!sensor->transpose) {
+    if (sensor->roi_list.count) {
+        // The frame buffer image is the first ROI.
+        MAIN_FB()->w = sensor->roi_list.rois[0].w / sensor->roi_list.decimation;
+        MAIN_FB()->h = sensor->roi_list.rois[0].h / sensor->roi_list.decimation;
+    } else if (!sensor->transpose) {
         MAIN_FB()->w = w;
         MAIN_FB()->h = h;
     } else {
@@ -942,6 +999,11 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags) {
             break;
     }
 
+    // The line callback output format replaces the captured format.
+    if (sensor->line_callback) {
+        MAIN_FB()->pixfmt = sensor->line_pixfmt;
+    }
+
     // Set the user image.
     framebuffer_init_image(image);
     return 0;
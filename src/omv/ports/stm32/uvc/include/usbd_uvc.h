@@ -80,14 +80,16 @@ enum _vs_fmt_indexes {
   VS_FMT_INDEX_GREY = 1,
   VS_FMT_INDEX_YUYV,
   VS_FMT_INDEX_RGB565,
+  VS_FMT_INDEX_MJPEG,
 };
 
-#define VS_NUM_FORMATS 3
+#define VS_NUM_FORMATS 4
 
 enum _vs_fmt_size {
   VS_FMT_SIZE_YUYV   = 16,
   VS_FMT_SIZE_GREY   =  8,
   VS_FMT_SIZE_RGB565 = 16,
+  VS_FMT_SIZE_MJPEG  = 16,  /* Worst case, used for bit rates and buffer sizes. */
 };
 
 #define VS_FMT_GUID_NONE \
@@ -320,6 +322,36 @@ struct uvc_input_terminal_desc {
   .dwFrameInterval = { INTERVAL },      /* 1,000,000 ns  *100ns -> 10 FPS */ \
 }
 
+#define UVC_FORMAT_MJPEG_DESCRIPTOR(NUM_FRAME_DESCS) { \
+  .bLength = UVC_DT_FORMAT_MJPEG_SIZE, \
+  .bDescriptorType = UVC_CS_INTERFACE,  /* CS_INTERFACE */ \
+  .bDescriptorSubType = UVC_VS_FORMAT_MJPEG, /* VS_FORMAT_MJPEG subtype */ \
+  .bFormatIndex = VS_FMT_INDEX(MJPEG),  /* */ \
+  .bNumFrameDescriptors = NUM_FRAME_DESCS, /* */ \
+  .bmFlags = 0x00,                      /* Variable size samples. */ \
+  .bDefaultFrameIndex = 0x01,           /* Default frame index is 1. */ \
+  .bAspectRatioX = 0x00,                /* Non-interlaced stream not required. */ \
+  .bAspectRatioY = 0x00,                /* Non-interlaced stream not required. */ \
+  .bmInterlaceFlags = 0x00,             /* Non-interlaced stream */ \
+  .bCopyProtect = 0x00,                 /* No restrictions imposed on the duplication of this video stream. */ \
+}
+
+#define UVC_FRAME_MJPEG(FRAME_INDEX, WIDTH, HEIGHT) { \
+  .bLength = UVC_DT_FRAME_UNCOMPRESSED_SIZE(1), \
+  .bDescriptorType = UVC_CS_INTERFACE,  /* CS_INTERFACE */ \
+  .bDescriptorSubType = UVC_VS_FRAME_MJPEG, /* VS_FRAME_MJPEG */ \
+  .bFrameIndex = FRAME_INDEX,           /* */ \
+  .bmCapabilities = 0x02,               /* D1: Fixed frame-rate. */ \
+  .wWidth = WIDTH,                      /* */ \
+  .wHeight = HEIGHT,                    /* */ \
+  .dwMinBitRate = MIN_BIT_RATE(WIDTH,HEIGHT,VS_FMT_SIZE(MJPEG)), /* Min bit rate in bits/s  */ \
+  .dwMaxBitRate = MAX_BIT_RATE(WIDTH,HEIGHT,VS_FMT_SIZE(MJPEG)), /* Max bit rate in bits/s  */ \
+  .dwMaxVideoFrameBufferSize = MAX_FRAME_SIZE(WIDTH,HEIGHT,VS_FMT_SIZE(MJPEG)), /* Upper bound of a compressed frame. */ \
+  .dwDefaultFrameInterval = INTERVAL,   /* */ \
+  .bFrameIntervalType = 0x01,           /* */ \
+  .dwFrameInterval = { INTERVAL },      /* */ \
+}
+
 #define UVC_COLOR_MATCHING_DESCRIPTOR() { \
   .bLength = UVC_DT_COLOR_MATCHING_SIZE, \
   .bDescriptorType = UVC_CS_INTERFACE,  /* CS_INTERFACE */ \
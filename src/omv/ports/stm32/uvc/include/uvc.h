@@ -508,6 +508,23 @@ struct UVC_FRAME_UNCOMPRESSED(n) {			\
 	uint32_t dwFrameInterval[n];			\
 } __attribute__ ((packed))
 
+/* MJPEG Payload - 3.1.1. Motion-JPEG Video Format Descriptor */
+struct uvc_format_mjpeg {
+	uint8_t  bLength;
+	uint8_t  bDescriptorType;
+	uint8_t  bDescriptorSubType;
+	uint8_t  bFormatIndex;
+	uint8_t  bNumFrameDescriptors;
+	uint8_t  bmFlags;
+	uint8_t  bDefaultFrameIndex;
+	uint8_t  bAspectRatioX;
+	uint8_t  bAspectRatioY;
+	uint8_t  bmInterlaceFlags;
+	uint8_t  bCopyProtect;
+} __attribute__((__packed__));
+
+#define UVC_DT_FORMAT_MJPEG_SIZE			11
+
 #define UVC_FRAMES_FORMAT_UNCOMPRESSED(n) \
 		uvc_vs_frame_format_desc_##n
 
@@ -518,5 +535,16 @@ struct UVC_FRAMES_FORMAT_UNCOMPRESSED(n) { \
 	struct uvc_color_matching_descriptor uvc_vs_color; \
 } __attribute__ ((packed));
 
+/* MJPEG Payload - 3.2.1. Motion-JPEG frame descriptors share the uncompressed layout. */
+#define UVC_FRAMES_FORMAT_MJPEG(n) \
+		uvc_vs_frame_format_mjpeg_desc_##n
+
+#define DECLARE_UVC_FRAMES_FORMAT_MJPEG(n) \
+struct UVC_FRAMES_FORMAT_MJPEG(n) { \
+	struct uvc_format_mjpeg uvc_vs_format; \
+	struct UVC_FRAME_UNCOMPRESSED(1) uvc_vs_frame[n]; \
+	struct uvc_color_matching_descriptor uvc_vs_color; \
+} __attribute__ ((packed));
+
 #endif /* __UVC_H */
 
@@ -22,11 +22,13 @@ DECLARE_UVC_EXTENSION_UNIT_DESCRIPTOR(1, 8);
 DECLARE_UVC_INPUT_HEADER_DESCRIPTOR(1, VS_NUM_FORMATS);
 DECLARE_UVC_FRAMES_FORMAT_UNCOMPRESSED(3);
 DECLARE_UVC_FRAMES_FORMAT_UNCOMPRESSED(4);
+DECLARE_UVC_FRAMES_FORMAT_MJPEG(4);
 
 struct uvc_vs_frames_formats_descriptor {
   struct UVC_FRAMES_FORMAT_UNCOMPRESSED(4) uvc_vs_frames_format_1;
   struct UVC_FRAMES_FORMAT_UNCOMPRESSED(3) uvc_vs_frames_format_2;
   struct UVC_FRAMES_FORMAT_UNCOMPRESSED(3) uvc_vs_frames_format_3;
+  struct UVC_FRAMES_FORMAT_MJPEG(4) uvc_vs_frames_format_4;
 };
 
 struct usbd_uvc_cfg {
@@ -10,6 +10,7 @@
  */
 #include STM32_HAL_H
 #include <stdbool.h>
+#include <string.h>
 #include "sdram.h"
 #include "usbd_core.h"
 #include "usbd_desc.h"
@@ -18,6 +19,7 @@
 #include "omv_i2c.h"
 #include "sensor.h"
 #include "framebuffer.h"
+#include "fb_alloc.h"
 #include "omv_boardconfig.h"
 #if OMV_ENABLE_BOOTLOADER
 #include "omv_bootconfig.h"
@@ -135,35 +137,74 @@ const void *mp_sys_stdout_print = NULL;
 
 static uint8_t frame_index = 0;
 static uint8_t format_index = 0;
+static int jpeg_quality = OMV_JPEG_QUALITY_LOW;
+// Frame buffer count to restore when leaving MJPEG, 0 if MJPEG is not active.
+static uint32_t mjpeg_saved_framebuffers = 0;
 
 static uint8_t uvc_header[2] = { 2, 0 };
-static uint8_t packet[VIDEO_PACKET_SIZE];
+// Ping-pong packet buffers, one is filled while the USB core is still sending the other one.
+static uint8_t packet_buffers[2][VIDEO_PACKET_SIZE] __attribute__((aligned(4)));
+static uint32_t packet_index = 0;
 uint32_t packet_size = VIDEO_PACKET_SIZE-2;
 
 bool process_frame(image_t *image)
 {
     uint32_t xfer_size = 0;
     uint32_t xfer_bytes = 0;
-    uint8_t *dst = packet + 2;
+    uint8_t *pixels = image->pixels;
+    bool mjpeg = (videoCommitControl.bFormatIndex == VS_FMT_INDEX(MJPEG));
+
+    if (mjpeg) {
+        // The payload is fb_alloc()'d by jpeg_compress() and freed once the frame has been queued.
+        image_t jpeg = { .w = image->w, .h = image->h, .pixfmt = PIXFORMAT_JPEG, .size = 0, .data = NULL };
+        fb_alloc_mark();
+
+        if (jpeg_compress(image, &jpeg, jpeg_quality, false, JPEG_SUBSAMPLING_AUTO)) {
+            // Overflow, drop this frame and lower the quality for the next one.
+            jpeg_quality = IM_MAX(1, jpeg_quality / 2);
+
+            // Send an empty frame with the error bit set so the host knows it was dropped.
+            uint8_t *packet = packet_buffers[packet_index];
+            packet[0] = uvc_header[0];
+            packet[1] = uvc_header[1] | 0x42; // End of frame and error.
+            uvc_header[1] ^= 1;
+
+            while (UVC_Transmit_FS(packet, 2) != USBD_OK) {
+                __WFI();
+            }
 
-    xfer_size = image->w * image->h * image->bpp;
+            packet_index ^= 1;
+            xfer_size = 0;
+        } else {
+            if (jpeg_quality < OMV_JPEG_QUALITY_LOW) {
+                jpeg_quality++;
+            }
+            pixels = jpeg.data;
+            xfer_size = jpeg.size;
+        }
+    } else {
+        xfer_size = image->w * image->h * image->bpp;
+    }
 
     while (xfer_bytes < xfer_size) {
+        uint8_t *packet = packet_buffers[packet_index];
+        uint8_t *dst = packet + 2;
+        uint32_t length = IM_MIN(packet_size, xfer_size - xfer_bytes);
+
         packet[0] = uvc_header[0];
         packet[1] = uvc_header[1];
 
         switch (videoCommitControl.bFormatIndex) {
-            case VS_FMT_INDEX(GREY): {
-                for (int i=0; i<packet_size; i++, xfer_bytes+=image->bpp) {
-                    dst[i+0] = image->pixels[xfer_bytes+0];
-                }
+            case VS_FMT_INDEX(GREY):
+            case VS_FMT_INDEX(MJPEG): {
+                memcpy(dst, pixels + xfer_bytes, length);
                 break;
             }
             case VS_FMT_INDEX(YUYV):
             case VS_FMT_INDEX(RGB565): {
-                for (int i=0; i<packet_size; i+=2, xfer_bytes+=2) {
-                    dst[i+0] = image->pixels[xfer_bytes+1];
-                    dst[i+1] = image->pixels[xfer_bytes+0];
+                for (int i=0; i<length; i+=2) {
+                    dst[i+0] = pixels[xfer_bytes+i+1];
+                    dst[i+1] = pixels[xfer_bytes+i+0];
                 }
                 break;
             }
@@ -171,14 +212,24 @@ bool process_frame(image_t *image)
                 break;
         }
 
+        xfer_bytes += length;
+
         if (xfer_bytes == xfer_size) {
             packet[1] |= 0x2;    // Flag end of frame
             uvc_header[1] ^= 1;  // Toggle bit 0 for next new frame
         }
 
-        while (UVC_Transmit_FS(packet, VIDEO_PACKET_SIZE) != USBD_OK) {
+        // This waits for the previous packet to go out only, the next packet
+        // is filled into the other buffer while this one is being sent.
+        while (UVC_Transmit_FS(packet, length + 2) != USBD_OK) {
             __WFI();
         }
+
+        packet_index ^= 1;
+    }
+
+    if (mjpeg) {
+        fb_alloc_free_till_mark();
     }
 
     if (g_uvc_stream_status != 2 ||
@@ -250,6 +301,12 @@ int main()
                     case VS_FMT_INDEX(RGB565):
                         sensor_set_pixformat(PIXFORMAT_RGB565);
                         break;
+                    case VS_FMT_INDEX(MJPEG):
+                        // Mono sensors fail to set RGB565 and are compressed as grayscale.
+                        if (sensor_set_pixformat(PIXFORMAT_RGB565) != 0) {
+                            sensor_set_pixformat(PIXFORMAT_GRAYSCALE);
+                        }
+                        break;
                     default:
                         break;
                 }
@@ -271,6 +328,19 @@ int main()
                         break;
                 }
 
+                // Capture frame N+1 in the background while frame N is streamed. MJPEG uses
+                // two buffers only to leave fb_alloc space for the compressed payload, the
+                // previous count is restored when switching to another format.
+                if (videoCommitControl.bFormatIndex == VS_FMT_INDEX(MJPEG)) {
+                    if (!mjpeg_saved_framebuffers) {
+                        mjpeg_saved_framebuffers = framebuffer->n_buffers;
+                    }
+                    sensor_set_framebuffers(2);
+                } else if (mjpeg_saved_framebuffers) {
+                    sensor_set_framebuffers(mjpeg_saved_framebuffers);
+                    mjpeg_saved_framebuffers = 0;
+                }
+
                 frame_index = videoCommitControl.bFrameIndex;
                 format_index = videoCommitControl.bFormatIndex;
             }
@@ -440,6 +440,7 @@ __ALIGN_BEGIN struct usbd_uvc_cfg USBD_UVC_CfgFSDesc __ALIGN_END = {
         { 0x00 },                                // bmaControls(0)           0 no VS specific controls
         { 0x00 },                                // bmaControls(1)           0 no VS specific controls
         { 0x00 },                                // bmaControls(2)           0 no VS specific controls
+        { 0x00 },                                // bmaControls(3)           0 no VS specific controls
       },
     },
 
@@ -495,6 +496,15 @@ static struct uvc_vs_frames_formats_descriptor uvc_vs_frames_formats_desc = {
                            UVC_FRAME_FORMAT(VS_FRAME_INDEX_3, RGB565, 320, 240)},
         .uvc_vs_color  = UVC_COLOR_MATCHING_DESCRIPTOR(),
       },
+    .uvc_vs_frames_format_4 =
+      {
+        .uvc_vs_format = UVC_FORMAT_MJPEG_DESCRIPTOR(4),
+        .uvc_vs_frame  = { UVC_FRAME_MJPEG(VS_FRAME_INDEX_1, 80, 60),
+                           UVC_FRAME_MJPEG(VS_FRAME_INDEX_2, 160, 120),
+                           UVC_FRAME_MJPEG(VS_FRAME_INDEX_3, 320, 240),
+                           UVC_FRAME_MJPEG(VS_FRAME_INDEX_4, 640, 480)},
+        .uvc_vs_color  = UVC_COLOR_MATCHING_DESCRIPTOR(),
+      },
 };
 
 static struct uvc_vs_frames_formats_descriptor uvc_vs_frames_formats_desc_gs = {
@@ -523,6 +533,15 @@ static struct uvc_vs_frames_formats_descriptor uvc_vs_frames_formats_desc_gs = {
                            UVC_FRAME_FORMAT(VS_FRAME_INDEX_3, GREY, 320, 240)},
         .uvc_vs_color  = UVC_COLOR_MATCHING_DESCRIPTOR(),
       },
+    .uvc_vs_frames_format_4 =
+      {
+        .uvc_vs_format = UVC_FORMAT_MJPEG_DESCRIPTOR(4),
+        .uvc_vs_frame  = { UVC_FRAME_MJPEG(VS_FRAME_INDEX_1, 80, 60),
+                           UVC_FRAME_MJPEG(VS_FRAME_INDEX_2, 160, 120),
+                           UVC_FRAME_MJPEG(VS_FRAME_INDEX_3, 320, 240),
+                           UVC_FRAME_MJPEG(VS_FRAME_INDEX_4, 640, 480)},
+        .uvc_vs_color  = UVC_COLOR_MATCHING_DESCRIPTOR(),
+      },
 };
 
 /**
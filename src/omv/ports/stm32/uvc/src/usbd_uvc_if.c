@@ -296,15 +296,18 @@ static int8_t UVC_VS_ControlGet(uint8_t cmd, uint8_t* pbuf, uint16_t length, uin
         frames_formats = &USBD_UVC_CfgFSDesc.uvc_vs_frames_formats_desc;
 
         switch (videoProbeControl.bFormatIndex) {
-        case VS_FMT_INDEX(YUYV):
+        case VS_FMT_INDEX(GREY):
           frame = frames_formats->uvc_vs_frames_format_1.uvc_vs_frame;
           break;
-        case VS_FMT_INDEX(GREY):
+        case VS_FMT_INDEX(YUYV):
           frame = frames_formats->uvc_vs_frames_format_2.uvc_vs_frame;
           break;
         case VS_FMT_INDEX(RGB565):
           frame = frames_formats->uvc_vs_frames_format_3.uvc_vs_frame;
           break;
+        case VS_FMT_INDEX(MJPEG):
+          frame = frames_formats->uvc_vs_frames_format_4.uvc_vs_frame;
+          break;
         default:
           return USBD_FAIL;
         }
@@ -62,6 +62,9 @@ static uint16_t readout_h = ACTIVE_SENSOR_HEIGHT;
 
 static uint16_t hts_target = 0;
 
+// Shadow of the registers written by reset(), the mode switch functions and write_reg().
+static omv_i2c_regseq_t regseq;
+
 static const uint8_t default_regs[][3] = {
 
 // https://github.com/ArduCAM/Arduino/blob/master/ArduCAM/ov5640_regs.h
@@ -674,7 +677,9 @@ static int reset(sensor_t *sensor) {
     // Delay 5 ms
     mp_hal_delay_ms(5);
 
-    // Write default registers
+    // Write default registers (consecutive registers are sent as one burst).
+    omv_i2c_regseq_init(&regseq, &sensor->i2c_bus, sensor->slv_addr, 2);
+
     for (int i = 0; default_regs[i][0]; i++) {
         int addr = (default_regs[i][0] << 8) | (default_regs[i][1] << 0);
         int data = default_regs[i][2];
@@ -693,11 +698,12 @@ static int reset(sensor_t *sensor) {
         }
         #endif
 
-        ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, addr, data);
+        ret |= omv_i2c_regseq_write_force(&regseq, addr, data);
     }
 
     #if (OMV_OV5640_AF_ENABLE == 1)
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, SYSTEM_RESET_00, 0x20); // force mcu reset
+    ret |= omv_i2c_regseq_write_force(&regseq, SYSTEM_RESET_00, 0x20); // force mcu reset
+    ret |= omv_i2c_regseq_flush(&regseq);
 
     // Write firmware
     uint16_t fw_addr = __REV16(MCU_FIRMWARE_BASE);
@@ -710,15 +716,16 @@ static int reset(sensor_t *sensor) {
 
     for (int i = 0; af_firmware_command_regs[i][0]; i++) {
         ret |=
-            omv_i2c_writeb2(&sensor->i2c_bus,
-                            sensor->slv_addr,
-                            (af_firmware_command_regs[i][0] << 8) | (af_firmware_command_regs[i][1] << 0),
-                            af_firmware_command_regs[i][2]);
+            omv_i2c_regseq_write_force(&regseq,
+                                       (af_firmware_command_regs[i][0] << 8) | (af_firmware_command_regs[i][1] << 0),
+                                       af_firmware_command_regs[i][2]);
     }
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, SYSTEM_RESET_00, 0x00); // release mcu reset
+    ret |= omv_i2c_regseq_write_force(&regseq, SYSTEM_RESET_00, 0x00); // release mcu reset
     #endif
 
+    ret |= omv_i2c_regseq_flush(&regseq);
+
     // Delay 300 ms
     if (!sensor->disable_delays) {
         mp_hal_delay_ms(300);
@@ -747,7 +754,8 @@ static int read_reg(sensor_t *sensor, uint16_t reg_addr) {
 }
 
 static int write_reg(sensor_t *sensor, uint16_t reg_addr, uint16_t reg_data) {
-    return omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, reg_addr, reg_data);
+    omv_i2c_regseq_write_force(&regseq, reg_addr, reg_data);
+    return omv_i2c_regseq_flush(&regseq);
 }
 
 // HTS (Horizontal Time) is the readout width plus the HSYNC_TIME time. However, if this value gets
@@ -756,11 +764,11 @@ static int write_reg(sensor_t *sensor, uint16_t reg_addr, uint16_t reg_data) {
 // increasing HTS so that DCMI_DMAConvCpltUser() can keep up with the data rate.
 //
 // WARNING! IF YOU CHANGE ANYTHING HERE RETEST WITH **ALL** RESOLUTIONS FOR THE AFFECTED MODE!
-static int calculate_hts(sensor_t *sensor, uint16_t width) {
+static int calculate_hts(sensor_t *sensor, pixformat_t pixformat, uint16_t width) {
     uint16_t hts = hts_target;
 
-    if ((sensor->pixformat == PIXFORMAT_GRAYSCALE) || (sensor->pixformat == PIXFORMAT_BAYER) ||
-        (sensor->pixformat == PIXFORMAT_JPEG)) {
+    if ((pixformat == PIXFORMAT_GRAYSCALE) || (pixformat == PIXFORMAT_BAYER) ||
+        (pixformat == PIXFORMAT_JPEG)) {
         if (width <= 1280) {
             hts = IM_MAX((width * 2) + 8, hts_target);
         }
@@ -785,12 +793,13 @@ static int calculate_vts(sensor_t *sensor, uint16_t readout_height) {
     return IM_MAX(readout_height + VYSNC_TIME, (SENSOR_HEIGHT + VYSNC_TIME) / 8); // Fix to prevent crashing.
 }
 
-static int set_pixformat(sensor_t *sensor, pixformat_t pixformat) {
-    uint8_t reg;
-    int ret = 0;
+// Returns 0 if the pixel format and frame size combination is supported.
+static int check_mode(pixformat_t pixformat, framesize_t framesize) {
+    uint16_t w = resolution[framesize][0];
+    uint16_t h = resolution[framesize][1];
 
     // Not a multiple of 8. The JPEG encoder on the OV5640 can't handle this.
-    if ((pixformat == PIXFORMAT_JPEG) && ((resolution[sensor->framesize][0] % 8) || (resolution[sensor->framesize][1] % 8))) {
+    if ((pixformat == PIXFORMAT_JPEG) && ((w % 8) || (h % 8))) {
         return -1;
     }
 
@@ -801,99 +810,77 @@ static int set_pixformat(sensor_t *sensor, pixformat_t pixformat) {
     // to even have time to start the line transfer. If it were possible to slow the line readout speed of the OV5640
     // this would enable these resolutions below. However, there's nothing in the datasheet that when modified does this.
     if (((pixformat == PIXFORMAT_GRAYSCALE) || (pixformat == PIXFORMAT_BAYER) || (pixformat == PIXFORMAT_JPEG))
-        && ((sensor->framesize == FRAMESIZE_QQCIF)
-            || (sensor->framesize == FRAMESIZE_QQSIF)
-            || (sensor->framesize == FRAMESIZE_HQQQVGA)
-            || (sensor->framesize == FRAMESIZE_HQQVGA))) {
+        && ((framesize == FRAMESIZE_QQCIF)
+            || (framesize == FRAMESIZE_QQSIF)
+            || (framesize == FRAMESIZE_HQQQVGA)
+            || (framesize == FRAMESIZE_HQQVGA))) {
         return -1;
     }
 
+    // Generally doesn't work for anything.
+    if (framesize == FRAMESIZE_QQQQVGA) {
+        return -1;
+    }
+
+    // Invalid resolution.
+    if ((w > ACTIVE_SENSOR_WIDTH) || (h > ACTIVE_SENSOR_HEIGHT)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+// Queues the pixel format registers, the caller flushes them.
+static int write_pixformat(sensor_t *sensor, pixformat_t pixformat, framesize_t framesize) {
+    int ret = 0;
+
     switch (pixformat) {
         case PIXFORMAT_GRAYSCALE:
-            ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, FORMAT_CONTROL, 0x10);
-            ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, FORMAT_CONTROL_MUX, 0x00);
+            ret |= omv_i2c_regseq_write(&regseq, FORMAT_CONTROL, 0x10);
+            ret |= omv_i2c_regseq_write(&regseq, FORMAT_CONTROL_MUX, 0x00);
             break;
         case PIXFORMAT_RGB565:
-            ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, FORMAT_CONTROL, 0x6F);
-            ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, FORMAT_CONTROL_MUX, 0x01);
+            ret |= omv_i2c_regseq_write(&regseq, FORMAT_CONTROL, 0x6F);
+            ret |= omv_i2c_regseq_write(&regseq, FORMAT_CONTROL_MUX, 0x01);
             break;
         case PIXFORMAT_YUV422:
-            ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, FORMAT_CONTROL, 0x30);
-            ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, FORMAT_CONTROL_MUX, 0x00);
+            ret |= omv_i2c_regseq_write(&regseq, FORMAT_CONTROL, 0x30);
+            ret |= omv_i2c_regseq_write(&regseq, FORMAT_CONTROL_MUX, 0x00);
             break;
         case PIXFORMAT_BAYER:
-            ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, FORMAT_CONTROL, 0x00);
-            ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, FORMAT_CONTROL_MUX, 0x01);
+            ret |= omv_i2c_regseq_write(&regseq, FORMAT_CONTROL, 0x00);
+            ret |= omv_i2c_regseq_write(&regseq, FORMAT_CONTROL_MUX, 0x01);
             break;
         case PIXFORMAT_JPEG:
-            ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, FORMAT_CONTROL, 0x30);
-            ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, FORMAT_CONTROL_MUX, 0x00);
+            ret |= omv_i2c_regseq_write(&regseq, FORMAT_CONTROL, 0x30);
+            ret |= omv_i2c_regseq_write(&regseq, FORMAT_CONTROL_MUX, 0x00);
             break;
         default:
             return -1;
     }
 
-    ret |= omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_21, &reg);
-    ret |=
-        omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_21,
-                        (reg & 0xDF) | ((pixformat == PIXFORMAT_JPEG) ? 0x20 : 0x00));
+    ret |= omv_i2c_regseq_modify(&regseq, TIMING_TC_REG_21, 0x20, (pixformat == PIXFORMAT_JPEG) ? 0x20 : 0x00);
 
-    ret |= omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, SYSTEM_RESET_02, &reg);
-    ret |=
-        omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, SYSTEM_RESET_02,
-                        (reg & 0xE3) | ((pixformat == PIXFORMAT_JPEG) ? 0x00 : 0x1C));
+    ret |= omv_i2c_regseq_modify(&regseq, SYSTEM_RESET_02, 0x1C, (pixformat == PIXFORMAT_JPEG) ? 0x00 : 0x1C);
 
-    ret |= omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, CLOCK_ENABLE_02, &reg);
-    ret |=
-        omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, CLOCK_ENABLE_02,
-                        (reg & 0xD7) | ((pixformat == PIXFORMAT_JPEG) ? 0x28 : 0x00));
+    ret |= omv_i2c_regseq_modify(&regseq, CLOCK_ENABLE_02, 0x28, (pixformat == PIXFORMAT_JPEG) ? 0x28 : 0x00);
 
     if (hts_target) {
-        uint16_t sensor_hts = calculate_hts(sensor, resolution[sensor->framesize][0]);
+        uint16_t sensor_hts = calculate_hts(sensor, sensor->pixformat, resolution[framesize][0]);
 
-        ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HTS_H, sensor_hts >> 8);
-        ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HTS_L, sensor_hts);
+        ret |= omv_i2c_regseq_write(&regseq, TIMING_HTS_H, sensor_hts >> 8);
+        ret |= omv_i2c_regseq_write(&regseq, TIMING_HTS_L, sensor_hts);
     }
 
     return ret;
 }
 
-static int set_framesize(sensor_t *sensor, framesize_t framesize) {
-    uint8_t reg;
+// Queues the frame size registers, the caller flushes them.
+static int write_framesize(sensor_t *sensor, pixformat_t pixformat, framesize_t framesize) {
     int ret = 0;
     uint16_t w = resolution[framesize][0];
     uint16_t h = resolution[framesize][1];
 
-    // Not a multiple of 8. The JPEG encoder on the OV5640 can't handle this.
-    if ((sensor->pixformat == PIXFORMAT_JPEG) && ((w % 8) || (h % 8))) {
-        return -1;
-    }
-
-    // Readout speed too fast. The DCMI_DMAConvCpltUser() line callback overhead is too much to handle the line transfer speed.
-    // If we were to slow the pixclk down these resolutions would work. As of right now, the image shakes and scrolls with
-    // the current line transfer speed. Note that there's an overhead to the DCMI_DMAConvCpltUser() function. It's not the
-    // memory copy operation that's too slow. It's that there's too much overhead in the DCMI_DMAConvCpltUser() method
-    // to even have time to start the line transfer. If it were possible to slow the line readout speed of the OV5640
-    // this would enable these resolutions below. However, there's nothing in the datasheet that when modified does this.
-    if (((sensor->pixformat == PIXFORMAT_GRAYSCALE) || (sensor->pixformat == PIXFORMAT_BAYER) ||
-         (sensor->pixformat == PIXFORMAT_JPEG))
-        && ((framesize == FRAMESIZE_QQCIF)
-            || (framesize == FRAMESIZE_QQSIF)
-            || (framesize == FRAMESIZE_HQQQVGA)
-            || (framesize == FRAMESIZE_HQQVGA))) {
-        return -1;
-    }
-
-    // Generally doesn't work for anything.
-    if (framesize == FRAMESIZE_QQQQVGA) {
-        return -1;
-    }
-
-    // Invalid resolution.
-    if ((w > ACTIVE_SENSOR_WIDTH) || (h > ACTIVE_SENSOR_HEIGHT)) {
-        return -1;
-    }
-
     // Step 0: Clamp readout settings.
 
     readout_w = IM_MAX(readout_w, w);
@@ -942,7 +929,7 @@ static int set_framesize(sensor_t *sensor, framesize_t framesize) {
 
     hts_target = sensor_w / sensor_div;
 
-    uint16_t sensor_hts = calculate_hts(sensor, w);
+    uint16_t sensor_hts = calculate_hts(sensor, pixformat, w);
     uint16_t sensor_vts = calculate_vts(sensor, sensor_h / sensor_div);
 
     uint16_t sensor_x_inc = (((sensor_div * 2) - 1) << 4) | (1 << 0); // odd[7:4]/even[3:0] pixel inc on the bayer pattern
@@ -950,54 +937,92 @@ static int set_framesize(sensor_t *sensor, framesize_t framesize) {
 
     // Step 5: Write regs.
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HS_H, sensor_ws >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HS_L, sensor_ws);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_HS_H, sensor_ws >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_HS_L, sensor_ws);
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VS_H, sensor_hs >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VS_L, sensor_hs);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_VS_H, sensor_hs >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_VS_L, sensor_hs);
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HW_H, sensor_we >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HW_L, sensor_we);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_HW_H, sensor_we >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_HW_L, sensor_we);
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VH_H, sensor_he >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VH_L, sensor_he);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_VH_H, sensor_he >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_VH_L, sensor_he);
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_DVPHO_H, w >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_DVPHO_L, w);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_DVPHO_H, w >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_DVPHO_L, w);
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_DVPVO_H, h >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_DVPVO_L, h);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_DVPVO_H, h >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_DVPVO_L, h);
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HTS_H, sensor_hts >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HTS_L, sensor_hts);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_HTS_H, sensor_hts >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_HTS_L, sensor_hts);
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VTS_H, sensor_vts >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VTS_L, sensor_vts);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_VTS_H, sensor_vts >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_VTS_L, sensor_vts);
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HOFFSET_H, x_off >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HOFFSET_L, x_off);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_HOFFSET_H, x_off >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_HOFFSET_L, x_off);
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VOFFSET_H, y_off >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VOFFSET_L, y_off);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_VOFFSET_H, y_off >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_VOFFSET_L, y_off);
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_X_INC, sensor_x_inc);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_Y_INC, sensor_y_inc);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_X_INC, sensor_x_inc);
+    ret |= omv_i2c_regseq_write(&regseq, TIMING_Y_INC, sensor_y_inc);
 
-    ret |= omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_20, &reg);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_20, (reg & 0xFE) | (sensor_div > 1));
+    ret |= omv_i2c_regseq_modify(&regseq, TIMING_TC_REG_20, 0x01, (sensor_div > 1));
 
-    ret |= omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_21, &reg);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_21, (reg & 0xFE) | (sensor_div > 1));
+    ret |= omv_i2c_regseq_modify(&regseq, TIMING_TC_REG_21, 0x01, (sensor_div > 1));
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, VFIFO_HSIZE_H, w >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, VFIFO_HSIZE_L, w);
+    ret |= omv_i2c_regseq_write(&regseq, VFIFO_HSIZE_H, w >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, VFIFO_HSIZE_L, w);
 
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, VFIFO_VSIZE_H, h >> 8);
-    ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, VFIFO_VSIZE_L, h);
+    ret |= omv_i2c_regseq_write(&regseq, VFIFO_VSIZE_H, h >> 8);
+    ret |= omv_i2c_regseq_write(&regseq, VFIFO_VSIZE_L, h);
 
     return ret;
 }
 
+static int set_pixformat(sensor_t *sensor, pixformat_t pixformat) {
+    int ret = 0;
+
+    if (check_mode(pixformat, sensor->framesize) != 0) {
+        return -1;
+    }
+
+    ret |= write_pixformat(sensor, pixformat, sensor->framesize);
+    ret |= omv_i2c_regseq_flush(&regseq);
+    return ret;
+}
+
+static int set_framesize(sensor_t *sensor, framesize_t framesize) {
+    int ret = 0;
+
+    if (check_mode(sensor->pixformat, framesize) != 0) {
+        return -1;
+    }
+
+    ret |= write_framesize(sensor, sensor->pixformat, framesize);
+    ret |= omv_i2c_regseq_flush(&regseq);
+    return ret;
+}
+
+// Switches pixel format and frame size together, in the same order as setting them one
+// at a time, so the final HTS is computed for the new pixel format. Registers that already
+// hold the target value are skipped, and the rest are written in as few bursts as possible.
+static int set_mode(sensor_t *sensor, const sensor_mode_t *mode) {
+    int ret = 0;
+
+    if (check_mode(mode->pixformat, mode->framesize) != 0) {
+        return -1;
+    }
+
+    ret |= write_pixformat(sensor, mode->pixformat, mode->framesize);
+    ret |= write_framesize(sensor, mode->pixformat, mode->framesize);
+    ret |= omv_i2c_regseq_flush(&regseq);
+    return ret;
+}
+
 static int set_contrast(sensor_t *sensor, int level) {
     int ret = 0;
 
@@ -1163,11 +1188,11 @@ static int set_auto_exposure(sensor_t *sensor, int enable, int exposure_us) {
         ret |= omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, SC_PLL_CONTRL3, &spc3);
         ret |= omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, SYSTEM_ROOT_DIVIDER, &sysrootdiv);
 
-        ret |= omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HTS_H, &hts_h);
-        ret |= omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_HTS_L, &hts_l);
+        ret |= omv_i2c_regseq_read(&regseq, TIMING_HTS_H, &hts_h);
+        ret |= omv_i2c_regseq_read(&regseq, TIMING_HTS_L, &hts_l);
 
-        ret |= omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VTS_H, &vts_h);
-        ret |= omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VTS_L, &vts_l);
+        ret |= omv_i2c_regseq_read(&regseq, TIMING_VTS_H, &vts_h);
+        ret |= omv_i2c_regseq_read(&regseq, TIMING_VTS_L, &vts_l);
 
         uint16_t hts = (hts_h << 8) | hts_l;
         uint16_t vts = (vts_h << 8) | vts_l;
@@ -1182,8 +1207,9 @@ static int set_auto_exposure(sensor_t *sensor, int enable, int exposure_us) {
         ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, AEC_PK_EXPOSURE_1, exposure >> 4);
         ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, AEC_PK_EXPOSURE_2, exposure << 4);
 
-        ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VTS_H, new_vts >> 8);
-        ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_VTS_L, new_vts);
+        ret |= omv_i2c_regseq_write(&regseq, TIMING_VTS_H, new_vts >> 8);
+        ret |= omv_i2c_regseq_write(&regseq, TIMING_VTS_L, new_vts);
+        ret |= omv_i2c_regseq_flush(&regseq);
     }
 
     return ret;
@@ -1289,24 +1315,14 @@ static int get_blc_regs(sensor_t *sensor, int *regs) {
 }
 
 static int set_hmirror(sensor_t *sensor, int enable) {
-    uint8_t reg;
-    int ret = omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_21, &reg);
-    if (enable) {
-        ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_21, reg | 0x06);
-    } else {
-        ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_21, reg & 0xF9);
-    }
+    int ret = omv_i2c_regseq_modify(&regseq, TIMING_TC_REG_21, 0x06, enable ? 0x06 : 0x00);
+    ret |= omv_i2c_regseq_flush(&regseq);
     return ret;
 }
 
 static int set_vflip(sensor_t *sensor, int enable) {
-    uint8_t reg;
-    int ret = omv_i2c_readb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_20, &reg);
-    if (!enable) {
-        ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_20, reg | 0x06);
-    } else {
-        ret |= omv_i2c_writeb2(&sensor->i2c_bus, sensor->slv_addr, TIMING_TC_REG_20, reg & 0xF9);
-    }
+    int ret = omv_i2c_regseq_modify(&regseq, TIMING_TC_REG_20, 0x06, enable ? 0x00 : 0x06);
+    ret |= omv_i2c_regseq_flush(&regseq);
     return ret;
 }
 
@@ -1437,6 +1453,7 @@ int ov5640_init(sensor_t *sensor) {
     sensor->write_reg = write_reg;
     sensor->set_pixformat = set_pixformat;
     sensor->set_framesize = set_framesize;
+    sensor->set_mode = set_mode;
     sensor->set_contrast = set_contrast;
     sensor->set_brightness = set_brightness;
     sensor->set_saturation = set_saturation;
@@ -1457,6 +1474,8 @@ int ov5640_init(sensor_t *sensor) {
     sensor->set_lens_correction = set_lens_correction;
     sensor->ioctl = ioctl;
 
+    omv_i2c_regseq_init(&regseq, &sensor->i2c_bus, sensor->slv_addr, 2);
+
     // Set sensor flags
     sensor->vsync_pol = 1;
     sensor->hsync_pol = 0;
@@ -0,0 +1,299 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Host test harness for the fixed-point HoG descriptor (imlib/hog.c).
+ * The blocks computed by imlib_hog_compute() are compared with a float reference
+ * that bins the gradient orientation with atan2(), interpolates the votes linearly
+ * between bins and bilinearly between cells, and L2-Hys normalizes each block.
+ * imlib_hog_detect() is then checked to score a window highest against weights
+ * made from its own descriptor.
+ *
+ * hog.c is included directly, with the few imlib types and helpers it needs
+ * provided below instead of imlib.h.
+ *
+ * Build and run from the repository root:
+ *   gcc -O2 -Isrc/omv/imlib -Isrc/omv/alloc tools/hog_test/main.c -lm -o /tmp/hog_test && /tmp/hog_test
+ */
+#define __IMLIB_H__
+#define __FB_ALLOC_H__
+#define __XALLOC_H__
+#define IMLIB_ENABLE_HOG
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define MAX_BIN_ERROR       (0.01)
+#define FB_ALLOC_NO_HINT    (0)
+#define PIXFORMAT_GRAYSCALE (1)
+#define HOG_BINS            (9)
+#define HOG_BLOCK_BINS      (HOG_BINS * 4)
+#define IM_MIN(a, b)        ({ __typeof__ (a) _a = (a); __typeof__ (b) _b = (b); _a < _b ? _a : _b; })
+#define IM_MAX(a, b)        ({ __typeof__ (a) _a = (a); __typeof__ (b) _b = (b); _a > _b ? _a : _b; })
+#define IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y) ((img)->data + ((img)->w * (y)))
+
+typedef struct rectangle {
+    int16_t x, y, w, h;
+} rectangle_t;
+
+typedef struct image {
+    int32_t w, h, pixfmt;
+    union {
+        uint8_t *data;
+        uint8_t *pixels;
+    };
+} image_t;
+
+typedef struct hog {
+    int x, y;
+    int cell_size;
+    int cells_w, cells_h;
+    int blocks_w, blocks_h;
+    uint8_t *blocks;
+} hog_t;
+
+typedef struct bounding_box_lnk_data {
+    rectangle_t rect;
+    float score;
+    int label_index;
+} bounding_box_lnk_data_t;
+
+// Keeps the best box only, which is all the detection check needs.
+typedef struct list {
+    size_t data_len, size;
+    bounding_box_lnk_data_t best;
+} list_t;
+
+// imlib_find_hog() only draws a visualization, it is compiled but not run.
+typedef struct array array_t;
+
+static float cos_table[360], sin_table[360];
+
+// Stack allocator with the fb_alloc() semantics.
+static uint8_t fb[4 << 20];
+static size_t fb_sizes[64], fb_top, fb_count;
+
+static void *fb_alloc(uint32_t size, int hints) {
+    (void) hints;
+    size = (size + 7) & ~7;
+    if ((fb_top + size) > sizeof(fb)) {
+        printf("FAIL: out of fb memory\n");
+        exit(1);
+    }
+    fb_sizes[fb_count++] = size;
+    fb_top += size;
+    return fb + fb_top - size;
+}
+
+static void *fb_alloc0(uint32_t size, int hints) {
+    return memset(fb_alloc(size, hints), 0, size);
+}
+
+static void fb_free() {
+    fb_top -= fb_sizes[--fb_count];
+}
+
+static void xfree(void *ptr) {
+    (void) ptr;
+}
+
+static void array_alloc(array_t **array, void (*free_fn)(void *)) {
+    (void) free_fn;
+    *array = NULL;
+}
+
+static void array_push_back(array_t *array, void *element) {
+    (void) array, (void) element;
+}
+
+static void *array_at(array_t *array, int idx) {
+    (void) array, (void) idx;
+    return NULL;
+}
+
+static void array_sort(array_t *array, int (*comp)(const void *, const void *)) {
+    (void) array, (void) comp;
+}
+
+static void imlib_draw_line(image_t *img, int x0, int y0, int x1, int y1, int c, int thickness) {
+    (void) img, (void) x0, (void) y0, (void) x1, (void) y1, (void) c, (void) thickness;
+}
+
+static float fast_sqrtf(float x) {
+    return sqrtf(x);
+}
+
+static float fast_fabsf(float x) {
+    return fabsf(x);
+}
+
+static void rectangle_init(rectangle_t *ptr, int x, int y, int w, int h) {
+    ptr->x = x;
+    ptr->y = y;
+    ptr->w = w;
+    ptr->h = h;
+}
+
+static void list_init(list_t *list, size_t data_len) {
+    list->data_len = data_len;
+    list->size = 0;
+}
+
+static void rectangle_nms_add_bounding_box(list_t *list, bounding_box_lnk_data_t *box) {
+    if ((!list->size) || (box->score > list->best.score)) {
+        list->best = *box;
+    }
+    list->size += 1;
+}
+
+#include "hog.c"
+
+// Cell histograms with a 1 cell border, same layout as hog_compute_cells().
+static void ref_cells(image_t *img, int cell_size, int cells_w, int cells_h, double *hist) {
+    int stride = (cells_w + 2) * HOG_BINS;
+
+    for (int y = 0; y < (cells_h * cell_size); y++) {
+        for (int x = 0; x < (cells_w * cell_size); x++) {
+            int gx = img->data[(y * img->w) + IM_MIN(x + 1, img->w - 1)] - img->data[(y * img->w) + IM_MAX(x - 1, 0)];
+            int gy = img->data[(IM_MIN(y + 1, img->h - 1) * img->w) + x] - img->data[(IM_MAX(y - 1, 0) * img->w) + x];
+            double m = sqrt((gx * gx) + (gy * gy));
+
+            if (m == 0) {
+                continue;
+            }
+
+            double a = atan2(gy, gx) * 180 / M_PI;
+            a += (a < 0) ? 180 : 0;
+            a -= (a >= 180) ? 180 : 0;
+
+            int k = (int) (a / 20), k1 = (k + 1) % HOG_BINS;
+            double f = (a / 20) - k;
+            double px = ((x + 0.5) / cell_size) + 0.5, py = ((y + 0.5) / cell_size) + 0.5;
+            int cx = (int) floor(px), cy = (int) floor(py);
+            double fx = px - cx, fy = py - cy;
+            double *h = hist + (cy * stride) + (cx * HOG_BINS);
+            double ws[4] = { (1 - fx) * (1 - fy), fx * (1 - fy), (1 - fx) * fy, fx * fy };
+            int off[4] = { 0, HOG_BINS, stride, stride + HOG_BINS };
+
+            for (int i = 0; i < 4; i++) {
+                h[off[i] + k] += m * (1 - f) * ws[i];
+                h[off[i] + k1] += m * f * ws[i];
+            }
+        }
+    }
+}
+
+static void ref_block(double *h, int stride, double *o) {
+    for (int i = 0; i < HOG_BINS; i++) {
+        o[i] = h[i];
+        o[HOG_BINS + i] = h[HOG_BINS + i];
+        o[(HOG_BINS * 2) + i] = h[stride + i];
+        o[(HOG_BINS * 3) + i] = h[stride + HOG_BINS + i];
+    }
+
+    for (int pass = 0; pass < 2; pass++) {
+        double s = 1e-9;
+        for (int i = 0; i < HOG_BLOCK_BINS; i++) {
+            s += o[i] * o[i];
+        }
+        s = sqrt(s);
+        for (int i = 0; i < HOG_BLOCK_BINS; i++) {
+            o[i] = pass ? (o[i] / s) : fmin(o[i] / s, 0.2);
+        }
+    }
+}
+
+static int test_blocks(image_t *img, int cell_size) {
+    rectangle_t roi = { 0, 0, img->w, img->h };
+    hog_t hog;
+    imlib_hog_compute(&hog, img, &roi, cell_size);
+
+    int stride = (hog.cells_w + 2) * HOG_BINS;
+    double *hist = calloc(stride * (hog.cells_h + 2), sizeof(double));
+    ref_cells(img, cell_size, hog.cells_w, hog.cells_h, hist);
+
+    double max_err = 0, sum_err = 0;
+    int n = 0;
+
+    for (int by = 0; by < hog.blocks_h; by++) {
+        for (int bx = 0; bx < hog.blocks_w; bx++) {
+            double o[HOG_BLOCK_BINS];
+            ref_block(hist + ((by + 1) * stride) + ((bx + 1) * HOG_BINS), stride, o);
+
+            for (int i = 0; i < HOG_BLOCK_BINS; i++) {
+                double e = fabs(o[i] - (hog.blocks[(((by * hog.blocks_w) + bx) * HOG_BLOCK_BINS) + i] / 255.0));
+                max_err = fmax(max_err, e);
+                sum_err += e;
+                n += 1;
+            }
+        }
+    }
+
+    imlib_hog_free(&hog);
+    free(hist);
+
+    printf("cell_size %d: %dx%d blocks, max error per bin %.4f, mean %.5f\n",
+           cell_size, hog.blocks_w, hog.blocks_h, max_err, sum_err / n);
+    return max_err <= MAX_BIN_ERROR;
+}
+
+static int test_detect(image_t *img) {
+    rectangle_t roi = { 0, 0, img->w, img->h };
+    int cells_w = 6, cells_h = 8, cell_x = 5, cell_y = 3;
+    hog_t hog;
+    imlib_hog_compute(&hog, img, &roi, 8);
+
+    // Weights matching the descriptor of one window, with the mean removed.
+    int size = imlib_hog_descriptor_size(cells_w, cells_h);
+    uint8_t *d = malloc(size);
+    int16_t *weights = malloc(size * sizeof(int16_t));
+    imlib_hog_get_descriptor(&hog, cell_x, cell_y, cells_w, cells_h, d);
+
+    for (int i = 0; i < size; i++) {
+        weights[i] = (d[i] * 100) - 4000;
+    }
+
+    list_t out;
+    imlib_hog_detect(&out, &hog, cells_w, cells_h, 1, weights, 1e-6f, 0, -1e30f);
+    imlib_hog_free(&hog);
+    free(weights);
+    free(d);
+
+    rectangle_t *r = &out.best.rect;
+    printf("detect: %d windows, best (%d, %d, %d, %d)\n", (int) out.size, r->x, r->y, r->w, r->h);
+    return (r->x == (cell_x * 8)) && (r->y == (cell_y * 8)) && (r->w == (cells_w * 8)) && (r->h == (cells_h * 8));
+}
+
+int main() {
+    int w = 160, h = 120, fails = 0;
+    image_t img = { .w = w, .h = h, .pixfmt = PIXFORMAT_GRAYSCALE };
+    img.data = malloc(w * h);
+
+    // Smooth texture in all orientations plus noise.
+    srand(1);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            double v = 128 + (60 * sin((x * 0.21) + (y * 0.13))) + (40 * cos((x * 0.05) - (y * 0.3))) + ((rand() % 21) - 10);
+            img.data[(y * w) + x] = IM_MAX(0, IM_MIN(255, (int) v));
+        }
+    }
+
+    for (int cell_size = 4; cell_size <= 16; cell_size *= 2) {
+        fails += !test_blocks(&img, cell_size);
+    }
+
+    fails += !test_detect(&img);
+
+    if (fb_count) {
+        printf("FAIL: %d fb allocations left\n", (int) fb_count);
+        fails += 1;
+    }
+
+    printf("%s\n", fails ? "FAIL" : "PASS");
+    free(img.data);
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Host test harness for the I2C register sequence engine (common/omv_i2c_regseq.c).
+ * The I2C bus is mocked by a device with a 64K register file and auto-increment.
+ *
+ * Build and run from the repository root:
+ *   gcc -Itools/i2c_regseq_test -Isrc/omv/common tools/i2c_regseq_test/main.c \
+ *       src/omv/common/omv_i2c_regseq.c -o /tmp/i2c_regseq_test && /tmp/i2c_regseq_test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "omv_i2c.h"
+
+#define SLV_ADDR    (0x78)
+
+static uint8_t dev_regs[65536];
+static int dev_addr_size = 2;
+static int dev_writes, dev_reads, dev_fail_next;
+
+// Mocked bus.
+int omv_i2c_write_bytes(omv_i2c_t *i2c, uint8_t slv_addr, uint8_t *buf, int len, uint32_t flags) {
+    dev_writes++;
+    if (dev_fail_next) {
+        dev_fail_next = 0;
+        return -1;
+    }
+    if (slv_addr != SLV_ADDR || len <= dev_addr_size || flags != OMV_I2C_XFER_NO_FLAGS) {
+        return -1;
+    }
+    uint16_t reg = (dev_addr_size == 2) ? ((buf[0] << 8) | buf[1]) : buf[0];
+    for (int i = dev_addr_size; i < len; i++, reg++) {
+        dev_regs[(dev_addr_size == 2) ? reg : (reg & 0xFF)] = buf[i];
+    }
+    return 0;
+}
+
+int omv_i2c_readb2(omv_i2c_t *i2c, uint8_t slv_addr, uint16_t reg_addr, uint8_t *reg_data) {
+    dev_reads++;
+    *reg_data = dev_regs[reg_addr];
+    return (slv_addr == SLV_ADDR && dev_addr_size == 2) ? 0 : -1;
+}
+
+int omv_i2c_readb(omv_i2c_t *i2c, uint8_t slv_addr, uint8_t reg_addr, uint8_t *reg_data) {
+    dev_reads++;
+    *reg_data = dev_regs[reg_addr];
+    return (slv_addr == SLV_ADDR && dev_addr_size == 1) ? 0 : -1;
+}
+
+static int failures;
+
+#define CHECK(cond)                                                   \
+    do {                                                              \
+        if (!(cond)) {                                                \
+            printf("%s:%d: CHECK(%s) failed\n", __func__, __LINE__, #cond); \
+            failures++;                                               \
+        }                                                             \
+    } while (0)
+
+static void dev_reset(int addr_size) {
+    memset(dev_regs, 0, sizeof(dev_regs));
+    dev_addr_size = addr_size;
+    dev_writes = dev_reads = dev_fail_next = 0;
+}
+
+static void test_burst(omv_i2c_regseq_t *seq) {
+    dev_reset(2);
+    omv_i2c_regseq_init(seq, NULL, SLV_ADDR, 2);
+
+    for (int i = 0; i < 10; i++) {
+        omv_i2c_regseq_write(seq, 0x3800 + i, i + 1);
+    }
+    CHECK(dev_writes == 0);
+    omv_i2c_regseq_write(seq, 0x4602, 0xAA);
+    omv_i2c_regseq_write(seq, 0x4603, 0xBB);
+    CHECK(dev_writes == 1);
+    CHECK(omv_i2c_regseq_flush(seq) == 0);
+    CHECK(dev_writes == 2);
+    for (int i = 0; i < 10; i++) {
+        CHECK(dev_regs[0x3800 + i] == i + 1);
+    }
+    CHECK(dev_regs[0x4602] == 0xAA && dev_regs[0x4603] == 0xBB);
+
+    // Bursts are split at OMV_I2C_REGSEQ_BURST_MAX.
+    dev_writes = 0;
+    for (int i = 0; i < OMV_I2C_REGSEQ_BURST_MAX * 2 + 1; i++) {
+        omv_i2c_regseq_write(seq, 0x5000 + i, 0x80 | i);
+    }
+    CHECK(omv_i2c_regseq_flush(seq) == 0);
+    CHECK(dev_writes == 3);
+    CHECK(dev_regs[0x5000 + OMV_I2C_REGSEQ_BURST_MAX * 2] == (0x80 | (OMV_I2C_REGSEQ_BURST_MAX * 2)));
+}
+
+static void test_shadow(omv_i2c_regseq_t *seq) {
+    uint8_t data;
+    dev_reset(2);
+    omv_i2c_regseq_init(seq, NULL, SLV_ADDR, 2);
+
+    // Redundant writes are skipped, forced writes are not. A write to a register
+    // that's still pending replaces it in the burst.
+    omv_i2c_regseq_write(seq, 0x3212, 0x03);
+    omv_i2c_regseq_flush(seq);
+    dev_writes = 0;
+    omv_i2c_regseq_write(seq, 0x3212, 0x03);
+    CHECK(omv_i2c_regseq_flush(seq) == 0 && dev_writes == 0);
+    omv_i2c_regseq_write_force(seq, 0x3212, 0x03);
+    CHECK(omv_i2c_regseq_flush(seq) == 0 && dev_writes == 1);
+    omv_i2c_regseq_write(seq, 0x3213, 0x01);
+    omv_i2c_regseq_write(seq, 0x3214, 0x02);
+    omv_i2c_regseq_write(seq, 0x3213, 0x04);
+    CHECK(omv_i2c_regseq_flush(seq) == 0 && dev_writes == 2 && dev_regs[0x3213] == 0x04);
+
+    // Reads hit the shadow, misses go to the bus once.
+    dev_regs[0x3820] = 0x40;
+    CHECK(omv_i2c_regseq_read(seq, 0x3820, &data) == 0 && data == 0x40 && dev_reads == 1);
+    CHECK(omv_i2c_regseq_read(seq, 0x3820, &data) == 0 && data == 0x40 && dev_reads == 1);
+
+    // Read-modify-write from the shadow.
+    dev_writes = 0;
+    CHECK(omv_i2c_regseq_modify(seq, 0x3820, 0x06, 0x06) == 0);
+    CHECK(omv_i2c_regseq_modify(seq, 0x3820, 0x01, 0x01) == 0);
+    CHECK(omv_i2c_regseq_flush(seq) == 0);
+    CHECK(dev_regs[0x3820] == 0x47 && dev_reads == 1 && dev_writes == 1);
+
+    // A read miss flushes pending writes first.
+    omv_i2c_regseq_write(seq, 0x3000, 0x11);
+    dev_regs[0x3001] = 0x22;
+    CHECK(omv_i2c_regseq_read(seq, 0x3001, &data) == 0 && data == 0x22);
+    CHECK(dev_regs[0x3000] == 0x11);
+
+    // Invalidation forces bus reads again.
+    dev_regs[0x3820] = 0x00;
+    omv_i2c_regseq_invalidate(seq);
+    CHECK(omv_i2c_regseq_read(seq, 0x3820, &data) == 0 && data == 0x00);
+}
+
+static void test_errors(omv_i2c_regseq_t *seq) {
+    uint8_t data;
+    dev_reset(2);
+    omv_i2c_regseq_init(seq, NULL, SLV_ADDR, 2);
+
+    // A failed burst is reported once and its shadow entries are dropped.
+    omv_i2c_regseq_write(seq, 0x3100, 0x55);
+    dev_fail_next = 1;
+    CHECK(omv_i2c_regseq_flush(seq) == -1);
+    CHECK(omv_i2c_regseq_flush(seq) == 0);
+    CHECK(omv_i2c_regseq_read(seq, 0x3100, &data) == 0 && data == 0x00 && dev_reads == 1);
+
+    // Errors from implicit flushes are sticky until the next explicit flush.
+    omv_i2c_regseq_write(seq, 0x3100, 0x55);
+    dev_fail_next = 1;
+    omv_i2c_regseq_write(seq, 0x3200, 0x66);
+    CHECK(omv_i2c_regseq_flush(seq) == -1);
+    CHECK(dev_regs[0x3200] == 0x66);
+}
+
+static void test_random(omv_i2c_regseq_t *seq, int addr_size) {
+    static uint8_t model[65536];
+    dev_reset(addr_size);
+    memset(model, 0, sizeof(model));
+    omv_i2c_regseq_init(seq, NULL, SLV_ADDR, addr_size);
+
+    int naive = 0;
+    uint16_t base = (addr_size == 2) ? 0x3800 : 0x00;
+    uint16_t span = (addr_size == 2) ? 1024 : 256;
+    uint16_t reg = base;
+
+    for (int i = 0; i < 200000; i++) {
+        int op = rand() % 16;
+        // Mostly sequential registers, like register tables.
+        reg = (rand() % 4) ? (base + ((reg - base + 1) % span)) : (base + rand() % span);
+
+        if (op < 10) {
+            uint8_t v = rand() % 4;
+            omv_i2c_regseq_write(seq, reg, v);
+            model[reg] = v;
+            naive++;
+        } else if (op < 12) {
+            uint8_t v = rand();
+            omv_i2c_regseq_write_force(seq, reg, v);
+            model[reg] = v;
+            naive++;
+        } else if (op < 14) {
+            uint8_t v;
+            CHECK(omv_i2c_regseq_read(seq, reg, &v) == 0);
+            CHECK(v == model[reg]);
+            naive++;
+        } else if (op < 15) {
+            uint8_t mask = rand(), val = rand();
+            omv_i2c_regseq_modify(seq, reg, mask, val);
+            model[reg] = (model[reg] & ~mask) | (val & mask);
+            naive += 2;
+        } else {
+            CHECK(omv_i2c_regseq_flush(seq) == 0);
+            if (rand() % 8 == 0) {
+                omv_i2c_regseq_invalidate(seq);
+            }
+        }
+    }
+
+    CHECK(omv_i2c_regseq_flush(seq) == 0);
+    CHECK(memcmp(dev_regs + base, model + base, span) == 0);
+    printf("addr_size=%d: %d transactions instead of %d\n", addr_size, dev_writes + dev_reads, naive);
+}
+
+int main(int argc, char **argv) {
+    static omv_i2c_regseq_t seq;
+    test_burst(&seq);
+    test_shadow(&seq);
+    test_errors(&seq);
+    test_random(&seq, 2);
+    test_random(&seq, 1);
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,12 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Host port config for the I2C register sequence test harness.
+ */
+#ifndef __OMV_PORTCONFIG_H__
+#define __OMV_PORTCONFIG_H__
+typedef void *omv_gpio_t;
+typedef void *omv_i2c_dev_t;
+#endif // __OMV_PORTCONFIG_H__
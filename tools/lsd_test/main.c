@@ -0,0 +1,470 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Host test harness for the fixed-point line segment detector (imlib/lsd.c).
+ * The segments found by imlib_lsd_find_line_segments() are compared with the
+ * float reference LineSegmentDetection() on synthetic images and on the PGM/PPM
+ * images of the unit test data, and the segments 12-find_line_segments.py
+ * expects on shapes.ppm are checked exactly.
+ *
+ * lsd.c is included directly, with the few imlib types and helpers it needs
+ * provided below instead of imlib.h.
+ *
+ * Build and run from the repository root:
+ *   gcc -O2 -Isrc/omv/imlib tools/lsd_test/main.c -lm -o /tmp/lsd_test && /tmp/lsd_test
+ */
+#define __IMLIB_H__
+#define IMLIB_ENABLE_FIND_LINE_SEGMENTS
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define MATCH_DIST          (2)
+#define MIN_RECALL          (0.85f)
+#define PI                  (3.14159265f)
+#define FB_ALLOC_NO_HINT    (0)
+#define PIXFORMAT_GRAYSCALE (1)
+#define IM_MIN(a, b)        ({ __typeof__ (a) _a = (a); __typeof__ (b) _b = (b); _a < _b ? _a : _b; })
+#define IM_MAX(a, b)        ({ __typeof__ (a) _a = (a); __typeof__ (b) _b = (b); _a > _b ? _a : _b; })
+
+typedef struct rectangle {
+    int16_t x, y, w, h;
+} rectangle_t;
+
+typedef struct line {
+    int16_t x1, y1, x2, y2;
+} line_t;
+
+typedef struct image {
+    int32_t w, h, pixfmt;
+    uint8_t *data;
+} image_t;
+
+typedef struct find_lines_list_lnk_data {
+    line_t line;
+    uint32_t magnitude;
+    int16_t theta, rho;
+} find_lines_list_lnk_data_t;
+
+typedef struct list {
+    size_t data_len, size;
+    uint8_t *data;
+} list_t;
+
+static float cos_table[360], sin_table[360];
+
+// Stack allocator with the fb_alloc() semantics.
+static uint8_t fb[4 << 20];
+static size_t fb_sizes[64], fb_top, fb_count, fb_peak;
+
+static void fb_alloc_fail() {
+    printf("FAIL: out of fb memory\n");
+    exit(1);
+}
+
+static void *fb_alloc(uint32_t size, int hints) {
+    (void) hints;
+    size = (size + 7) & ~7;
+    if ((fb_top + size) > sizeof(fb)) {
+        fb_alloc_fail();
+    }
+    fb_sizes[fb_count++] = size;
+    fb_top += size;
+    fb_peak = IM_MAX(fb_peak, fb_top);
+    return fb + fb_top - size;
+}
+
+static void *fb_alloc0(uint32_t size, int hints) {
+    return memset(fb_alloc(size, hints), 0, size);
+}
+
+static void fb_free() {
+    fb_top -= fb_sizes[--fb_count];
+}
+
+static void *umm_malloc(size_t size) {
+    return malloc(size);
+}
+
+static void *umm_calloc(size_t num, size_t size) {
+    return calloc(num, size);
+}
+
+static void *umm_realloc(void *ptr, size_t size) {
+    return realloc(ptr, size);
+}
+
+static void umm_free(void *ptr) {
+    free(ptr);
+}
+
+static float fast_sqrtf(float x) {
+    return sqrtf(x);
+}
+
+static float fast_floorf(float x) {
+    return floorf(x);
+}
+
+static float fast_ceilf(float x) {
+    return ceilf(x);
+}
+
+static int fast_roundf(float x) {
+    return lroundf(x);
+}
+
+static float fast_atan2f(float y, float x) {
+    return atan2f(y, x);
+}
+
+static float fast_expf(float x) {
+    return expf(x);
+}
+
+static float fast_fabsf(float x) {
+    return fabsf(x);
+}
+
+static float fast_log(float x) {
+    return logf(x);
+}
+
+static void list_init(list_t *list, size_t data_len) {
+    list->data_len = data_len;
+    list->size = 0;
+    list->data = NULL;
+}
+
+static void list_push_back(list_t *list, void *data) {
+    list->data = realloc(list->data, (list->size + 1) * list->data_len);
+    memcpy(list->data + (list->size++ * list->data_len), data, list->data_len);
+}
+
+static void merge_alot(list_t *out, int threshold, int theta_threshold) {
+    (void) out;
+    (void) threshold;
+    (void) theta_threshold;
+}
+
+// Clips to the box, endpoints only need to be inside for the test images.
+static bool lb_clip_line(line_t *l, int x, int y, int w, int h) {
+    l->x1 = IM_MAX(IM_MIN(l->x1, x + w - 1), x);
+    l->y1 = IM_MAX(IM_MIN(l->y1, y + h - 1), y);
+    l->x2 = IM_MAX(IM_MIN(l->x2, x + w - 1), x);
+    l->y2 = IM_MAX(IM_MIN(l->y2, y + h - 1), y);
+    return true;
+}
+
+// Crops a grayscale image (the only case used here).
+static void imlib_draw_image(image_t *dst, image_t *src, int x, int y, float xs, float ys, rectangle_t *roi,
+                             int rgb_channel, int alpha, const uint16_t *color_palette,
+                             const uint8_t *alpha_palette, int hint, void *callback, void *data, void *mask) {
+    (void) x, (void) y, (void) xs, (void) ys, (void) rgb_channel, (void) alpha, (void) color_palette;
+    (void) alpha_palette, (void) hint, (void) callback, (void) data, (void) mask;
+    for (int j = 0; j < roi->h; j++) {
+        memcpy(dst->data + (j * dst->w), src->data + ((roi->y + j) * src->w) + roi->x, roi->w);
+    }
+}
+
+#include "lsd.c"
+
+static uint32_t rng_state = 1;
+
+static int rng(int n) {
+    rng_state = (rng_state * 1103515245) + 12345;
+    return (rng_state >> 16) % n;
+}
+
+// Draws an anti-aliased filled convex polygon by 4x4 supersampling.
+static void draw_polygon(uint8_t *img, int w, int h, float *px, float *py, int n, int color) {
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int hits = 0;
+            for (int s = 0; s < 16; s++) {
+                float sx = x + ((s & 3) + 0.5f) / 4, sy = y + ((s >> 2) + 0.5f) / 4;
+                int inside = 1;
+                for (int i = 0; i < n; i++) {
+                    int j = (i + 1) % n;
+                    float c = ((px[j] - px[i]) * (sy - py[i])) - ((py[j] - py[i]) * (sx - px[i]));
+                    inside &= (c >= 0);
+                }
+                hits += inside;
+            }
+            img[(y * w) + x] = ((img[(y * w) + x] * (16 - hits)) + (color * hits)) / 16;
+        }
+    }
+}
+
+// Random rotated rectangles and triangles over a gradient with noise.
+static void make_synthetic(uint8_t *img, int w, int h) {
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            img[(y * w) + x] = 64 + ((x + y) / 8);
+        }
+    }
+
+    for (int i = 0, n = 2 + rng(5); i < n; i++) {
+        float cx = rng(w), cy = rng(h), a = rng(628) / 100.0f, r = 10 + rng(w / 3);
+        int sides = 3 + rng(2);
+        float px[4], py[4];
+        for (int j = 0; j < sides; j++) {
+            px[j] = cx + (r * cosf(a + (j * 2 * M_PI / sides)));
+            py[j] = cy + (r * sinf(a + (j * 2 * M_PI / sides)));
+        }
+        draw_polygon(img, w, h, px, py, sides, rng(256));
+    }
+
+    for (int i = 0; i < (w * h); i++) {
+        img[i] = IM_MAX(IM_MIN(img[i] + rng(9) - 4, 255), 0);
+    }
+}
+
+// Loads a P5 or P6 image as grayscale. P6 pixels go through RGB565 like the
+// firmware does when it loads a PPM and converts it to grayscale.
+static uint8_t *load_pnm(const char *path, int *w, int *h) {
+    FILE *fp = fopen(path, "rb");
+    char line[256];
+    int maxval, rgb;
+
+    if (!fp || !fgets(line, sizeof(line), fp) || (strncmp(line, "P5", 2) && strncmp(line, "P6", 2))) {
+        return NULL;
+    }
+
+    rgb = line[1] == '6';
+
+    do {
+        if (!fgets(line, sizeof(line), fp)) {
+            return NULL;
+        }
+    } while (line[0] == '#');
+
+    sscanf(line, "%d %d", w, h);
+    if (fscanf(fp, "%d", &maxval) != 1) {
+        return NULL;
+    }
+    fgetc(fp);
+
+    size_t size = (*w) * (*h) * (rgb ? 3 : 1);
+    uint8_t *img = malloc(size);
+    if (fread(img, 1, size, fp) != size) {
+        free(img);
+        img = NULL;
+    } else if (rgb) {
+        for (int i = 0; i < ((*w) * (*h)); i++) {
+            int p = ((img[(3 * i) + 0] & 0xF8) << 8) | ((img[(3 * i) + 1] & 0xFC) << 3) | (img[(3 * i) + 2] >> 3);
+            int r = (p >> 8) & 0xF8, g = (p >> 3) & 0xFC, b = (p << 3) & 0xF8;
+            r |= r >> 5;
+            g |= g >> 6;
+            b |= b >> 5;
+            img[i] = ((r * 38) + (g * 75) + (b * 15)) >> 7;
+        }
+    }
+
+    fclose(fp);
+    return img;
+}
+
+static int segment_match(line_t *a, line_t *b) {
+    int d0 = IM_MAX(IM_MAX(abs(a->x1 - b->x1), abs(a->y1 - b->y1)), IM_MAX(abs(a->x2 - b->x2), abs(a->y2 - b->y2)));
+    int d1 = IM_MAX(IM_MAX(abs(a->x1 - b->x2), abs(a->y1 - b->y2)), IM_MAX(abs(a->x2 - b->x1), abs(a->y2 - b->y1)));
+    return IM_MIN(d0, d1) <= MATCH_DIST;
+}
+
+// Returns how many segments of a have a match in b.
+static int count_matches(line_t *a, int na, line_t *b, int nb) {
+    int count = 0;
+    for (int i = 0; i < na; i++) {
+        for (int j = 0; j < nb; j++) {
+            if (segment_match(a + i, b + j)) {
+                count++;
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+static int ref_total, ref_found, fix_total, fix_found;
+
+static void compare(const char *name, uint8_t *data, int w, int h) {
+    image_t img = { .w = w, .h = h, .pixfmt = PIXFORMAT_GRAYSCALE, .data = data };
+    rectangle_t roi = { 0, 0, w, h };
+    list_t out;
+
+    fb_peak = 0;
+    imlib_lsd_find_line_segments(&out, &img, &roi, 0, 0);
+
+    if (fb_count != 0) {
+        printf("FAIL %s: %d fb allocations leaked\n", name, (int) fb_count);
+        exit(1);
+    }
+
+    int n_ref;
+    float *ls = LineSegmentDetection(&n_ref, data, w, h, 0.8, 0.6, 2.0, 22.5, 0.0, 0.7, 1024, NULL, NULL, NULL);
+    line_t *ref = malloc((n_ref + 1) * sizeof(line_t));
+    line_t *fix = malloc((out.size + 1) * sizeof(line_t));
+
+    for (int i = 0; i < n_ref; i++) {
+        ref[i] = (line_t) { fast_roundf(ls[(7 * i) + 0]), fast_roundf(ls[(7 * i) + 1]),
+                            fast_roundf(ls[(7 * i) + 2]), fast_roundf(ls[(7 * i) + 3]) };
+        lb_clip_line(ref + i, 0, 0, w, h);
+    }
+
+    for (size_t i = 0; i < out.size; i++) {
+        fix[i] = ((find_lines_list_lnk_data_t *) out.data)[i].line;
+    }
+
+    int rf = count_matches(ref, n_ref, fix, out.size);
+    int ff = count_matches(fix, out.size, ref, n_ref);
+    printf("%-14s %4dx%-4d ref %4d fixed %4d recall %5.1f%% precision %5.1f%% fb peak %7u (bound %7u)\n",
+           name, w, h, n_ref, (int) out.size, n_ref ? (100.0f * rf / n_ref) : 100.0f,
+           out.size ? (100.0f * ff / out.size) : 100.0f, (unsigned) fb_peak,
+           (unsigned) ((13 * w * h) + (LSD_MAG_BINS * 4)));
+
+    if (fb_peak > (size_t) ((13 * w * h) + (LSD_MAG_BINS * 4) + 64)) {
+        printf("FAIL %s: peak memory above the documented bound\n", name);
+        exit(1);
+    }
+
+    ref_total += n_ref;
+    ref_found += rf;
+    fix_total += out.size;
+    fix_found += ff;
+
+    free(ls);
+    free(ref);
+    free(fix);
+    free(out.data);
+}
+
+static void test_nfa(void) {
+    // Check the fixed-point NFA against the float reference.
+    int64_t logNT_q = (((5 * (((int64_t) lsdi_log10(320)) + lsdi_log10(240)))) / 2) + lsdi_log10(11);
+    float logNT = (5.0f * (log10f(320) + log10f(240)) / 2.0f) + log10f(11);
+    float max_err = 0;
+
+    for (int n = 1; n < 4000; n += 1 + (n / 16)) {
+        for (int k = 1; k <= n; k += 1 + (k / 8)) {
+            for (int p_log2 = 3; p_log2 <= 8; p_log2++) {
+                float ref = nfa(n, k, 1.0f / (1 << p_log2), logNT);
+                float fix = lsdi_nfa(n, k, p_log2, logNT_q) / 16777216.0f;
+                // Only the meaningful range matters, the reference is approximate near 0.
+                if ((ref > 0) && (ref < 1000)) {
+                    max_err = IM_MAX(max_err, fabsf(ref - fix) / (1 + fabsf(ref) * 0.1f));
+                }
+            }
+        }
+    }
+
+    printf("nfa max error %.3f\n", max_err);
+    if (max_err > 1.0f) {
+        printf("FAIL: nfa error too large\n");
+        exit(1);
+    }
+}
+
+// Checks the segments that 12-find_line_segments.py expects on shapes.ppm,
+// found with the default arguments of find_line_segments().
+static void test_shapes(void) {
+    static const int expected[][8] = {
+        { 23, 40, 23, 74, 34, 20, 0, 23 },
+        { 57, 39, 24, 39, 33, 19, 90, 39 },
+        { 24, 75, 57, 75, 33, 19, 90, 75 },
+        { 58, 74, 58, 40, 34, 20, 0, 58 },
+        { 104, 70, 114, 76, 12, 2, 121, 6 },
+        { 139, 51, 133, 41, 12, 2, 149, -93 },
+        { 109, 37, 100, 46, 13, 17, 45, 103 },
+        { 129, 73, 137, 64, 12, 6, 42, 145 },
+    };
+    int w, h;
+    uint8_t *data = load_pnm("scripts/unittest/data/shapes.ppm", &w, &h);
+
+    if (!data) {
+        printf("skipping shapes.ppm\n");
+        return;
+    }
+
+    image_t img = { .w = w, .h = h, .pixfmt = PIXFORMAT_GRAYSCALE, .data = data };
+    rectangle_t roi = { 0, 0, w, h };
+    list_t out;
+
+    imlib_lsd_find_line_segments(&out, &img, &roi, 0, 15);
+    int fail = out.size != (sizeof(expected) / sizeof(expected[0]));
+
+    for (size_t i = 0; i < out.size; i++) {
+        find_lines_list_lnk_data_t *lnk = ((find_lines_list_lnk_data_t *) out.data) + i;
+        int dx = lnk->line.x2 - lnk->line.x1, dy = lnk->line.y2 - lnk->line.y1;
+        int t[8] = { lnk->line.x1, lnk->line.y1, lnk->line.x2, lnk->line.y2,
+                     fast_roundf(fast_sqrtf((dx * dx) + (dy * dy))), lnk->magnitude, lnk->theta, lnk->rho };
+        printf("shapes.ppm (%d, %d, %d, %d, %d, %d, %d, %d)\n", t[0], t[1], t[2], t[3], t[4], t[5], t[6], t[7]);
+        if (!fail && memcmp(t, expected[i], sizeof(t))) {
+            fail = 1;
+        }
+    }
+
+    if (fail) {
+        printf("FAIL: shapes.ppm segments differ from 12-find_line_segments.py\n");
+        exit(1);
+    }
+
+    free(out.data);
+    free(data);
+}
+
+int main(void) {
+    static const char *images[] = {
+        "scripts/unittest/data/graffiti.pgm",
+        "scripts/unittest/data/dennis.pgm",
+        "scripts/unittest/data/cat.pgm",
+        "scripts/unittest/data/drawing.pgm",
+        "scripts/unittest/data/template.pgm",
+        "scripts/unittest/data/shapes.ppm",
+    };
+
+    for (int i = 0; i < 360; i++) {
+        cos_table[i] = cosf(i * M_PI / 180);
+        sin_table[i] = sinf(i * M_PI / 180);
+    }
+
+    test_nfa();
+    test_shapes();
+
+    for (int i = 0; i < 20; i++) {
+        int w = 64 + rng(257), h = 48 + rng(193);
+        uint8_t *img = malloc(w * h);
+        char name[32];
+        make_synthetic(img, w, h);
+        snprintf(name, sizeof(name), "synthetic%d", i);
+        compare(name, img, w, h);
+        free(img);
+    }
+
+    for (size_t i = 0; i < (sizeof(images) / sizeof(images[0])); i++) {
+        int w, h;
+        uint8_t *img = load_pnm(images[i], &w, &h);
+        if (!img) {
+            printf("skipping %s\n", images[i]);
+            continue;
+        }
+        compare(strrchr(images[i], '/') + 1, img, w, h);
+        free(img);
+    }
+
+    float recall = ref_total ? ((float) ref_found / ref_total) : 1.0f;
+    float precision = fix_total ? ((float) fix_found / fix_total) : 1.0f;
+    printf("total: recall %.1f%% precision %.1f%%\n", 100 * recall, 100 * precision);
+
+    if ((recall < MIN_RECALL) || (precision < MIN_RECALL)) {
+        printf("FAIL\n");
+        return 1;
+    }
+
+    printf("PASS\n");
+    return 0;
+}
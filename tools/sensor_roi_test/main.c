@@ -0,0 +1,122 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2013-2024 OpenMV, LLC.
+ *
+ * Host test harness for the multi-ROI line splitter (common/sensor_roi.c).
+ * Random windows are captured line by line and each ROI image is compared with
+ * a reference crop of the full frame.
+ *
+ * Build and run from the repository root:
+ *   gcc -Isrc/omv/common tools/sensor_roi_test/main.c src/omv/common/sensor_roi.c \
+ *       -o /tmp/sensor_roi_test && /tmp/sensor_roi_test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sensor_roi.h"
+
+#define FRAME_W     (320)
+#define FRAME_H     (240)
+
+static uint8_t frame[FRAME_W * FRAME_H * 2];
+static uint8_t fb[(FRAME_W * FRAME_H * 2 + 32) * SENSOR_ROI_MAX];
+static int failures;
+
+#define CHECK(cond, ...) do { if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                                             printf(__VA_ARGS__); printf("\n"); failures++; } } while (0)
+
+// Reference pixel at (x, y) of the frame for the copy mode.
+static uint32_t ref_pixel(uint32_t copy, uint32_t x, uint32_t y) {
+    const uint8_t *p = frame + (y * FRAME_W + x) * ((copy == SENSOR_ROI_COPY_8) ? 1 : 2);
+    switch (copy) {
+        case SENSOR_ROI_COPY_8:
+        case SENSOR_ROI_COPY_Y:
+            return p[0];
+        case SENSOR_ROI_COPY_16:
+            return p[0] | (p[1] << 8);
+        default:
+            return (p[0] << 8) | p[1];
+    }
+}
+
+static uint32_t dst_pixel(const sensor_roi_list_t *list, const sensor_roi_t *roi, uint32_t x, uint32_t y) {
+    uint32_t bpp = sensor_roi_dst_bpp(list);
+    const uint8_t *p = fb + roi->offset + (y * (roi->w / list->decimation) + x) * bpp;
+    return (bpp == 1) ? p[0] : (p[0] | (p[1] << 8));
+}
+
+static void test_layout(void) {
+    sensor_roi_list_t list = { .count = 3, .decimation = 2, .copy = SENSOR_ROI_COPY_16 };
+    list.rois[0] = (sensor_roi_t) { 0, 0, 11, 7, 0 };
+    list.rois[1] = (sensor_roi_t) { 4, 4, 8, 8, 0 };
+    list.rois[2] = (sensor_roi_t) { 1, 1, 3, 3, 0 };
+
+    uint32_t size = sensor_roi_layout(&list);
+    CHECK(list.rois[0].w == 10 && list.rois[0].h == 6, "trim %dx%d", list.rois[0].w, list.rois[0].h);
+    CHECK(list.rois[0].offset == 0, "offset0 %u", (unsigned) list.rois[0].offset);
+    CHECK(list.rois[1].offset == 32, "offset1 %u", (unsigned) list.rois[1].offset);
+    CHECK(list.rois[2].offset == 64, "offset2 %u", (unsigned) list.rois[2].offset);
+    CHECK(size == 96 && list.size == size, "size %u", (unsigned) size);
+}
+
+static void test_random(uint32_t copy, uint32_t iterations) {
+    uint32_t in_bpp = (copy == SENSOR_ROI_COPY_8) ? 1 : 2;
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        sensor_roi_list_t list = { .count = 1 + rand() % SENSOR_ROI_MAX, .copy = copy };
+        list.decimation = 1 << (rand() % 3);
+
+        for (uint32_t i = 0; i < list.count; i++) {
+            sensor_roi_t *roi = &list.rois[i];
+            roi->w = 1 + rand() % FRAME_W;
+            roi->h = 1 + rand() % FRAME_H;
+            roi->x = rand() % (FRAME_W - roi->w + 1);
+            roi->y = rand() % (FRAME_H - roi->h + 1);
+        }
+
+        sensor_roi_layout(&list);
+        memset(fb, 0xA5, sizeof(fb));
+
+        for (uint32_t y = 0; y < FRAME_H; y++) {
+            sensor_roi_copy_line(&list, y, frame + y * FRAME_W * in_bpp, fb);
+        }
+
+        for (uint32_t i = 0; i < list.count; i++) {
+            const sensor_roi_t *roi = &list.rois[i];
+            uint32_t w = roi->w / list.decimation, h = roi->h / list.decimation;
+            int bad = 0;
+            for (uint32_t y = 0; y < h && !bad; y++) {
+                for (uint32_t x = 0; x < w && !bad; x++) {
+                    uint32_t ref = ref_pixel(copy, roi->x + x * list.decimation, roi->y + y * list.decimation);
+                    bad = (dst_pixel(&list, roi, x, y) != ref);
+                }
+            }
+            CHECK(!bad, "copy %u dec %u roi %u (%d,%d,%d,%d) mismatch", (unsigned) copy,
+                  list.decimation, (unsigned) i, roi->x, roi->y, roi->w, roi->h);
+        }
+
+        // Nothing past the last ROI image may be written.
+        CHECK(fb[list.size] == 0xA5, "copy %u wrote past the end", (unsigned) copy);
+    }
+}
+
+int main(void) {
+    srand(1);
+    for (size_t i = 0; i < sizeof(frame); i++) {
+        frame[i] = rand();
+    }
+
+    test_layout();
+    test_random(SENSOR_ROI_COPY_8, 200);
+    test_random(SENSOR_ROI_COPY_16, 200);
+    test_random(SENSOR_ROI_COPY_16_REV, 200);
+    test_random(SENSOR_ROI_COPY_Y, 200);
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    printf("All tests passed\n");
+    return 0;
+}